@@ -1,6 +1,9 @@
 // Compile shared StupidChess modules inside UE bridge module.
 // This keeps core rules/platform logic in one place while enabling UE usage.
 #include "../../../../../../core/src/MatchReferee.cpp"
+#include "../../../../../../core/src/PackedGameState.cpp"
+#include "../../../../../../core/src/SetupCommitment.cpp"
+#include "../../../../../../core/src/Sha256.cpp"
 #include "../../../../../../protocol/src/ProtocolTypes.cpp"
 #include "../../../../../../protocol/src/ProtocolCodec.cpp"
 #include "../../../../../../server/src/MatchSession.cpp"
@@ -8,3 +11,5 @@
 #include "../../../../../../server/src/ProtocolMapper.cpp"
 #include "../../../../../../server/src/TransportAdapter.cpp"
 #include "../../../../../../server/src/ServerGateway.cpp"
+// Last: it includes the platform file-mapping headers (windows.h on Win64).
+#include "../../../../../../core/src/EndgameTablebase.cpp"
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreRules/EndgameTablebase.h"
+#include "CoreRules/MatchReferee.h"
+#include "CoreRules/TranspositionTable.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+struct FSearchLimits
+{
+    int32_t MaxDepth = 32;
+    // 0 disables the limit. Node and time budgets are only enforced once depth 1 has completed, so a search always
+    // returns a move when one exists.
+    uint64_t MaxNodes = 0;
+    int64_t TimeBudgetMs = 100;
+};
+
+struct FSearchResult
+{
+    bool bHasCommand = false;
+    // Move, Pass or Resign for the side to move.
+    FPlayerCommand BestCommand{};
+    // Side-to-move score of the deepest completed iteration; mates are +-(MateScore - plies to mate).
+    int32_t Score = 0;
+    int32_t CompletedDepth = 0;
+    uint64_t Nodes = 0;
+    double Seconds = 0.0;
+};
+
+// Iterative-deepening alpha-beta over the referee's MakeMove/UnmakeMove/MakePass, so captures reveal and freeze
+// exactly as ApplyCommand does. Search treats the state it is given as perfect information (where the hidden king
+// stands, what a capture reveals); SearchFromView is the entry point for a player that must not peek.
+//
+// Ordering is transposition-table move, MVV-LVA captures, two killers per ply, then history. Leaves are resolved by
+// a capture-only quiescence search (all evasions while in check).
+class FAlphaBetaSearch
+{
+public:
+    static constexpr int32_t MateScore = 30000;
+    static constexpr int32_t MaxPly = 96;
+
+    explicit FAlphaBetaSearch(size_t TranspositionTableMegabytes = 4);
+    // Shares a table owned by the caller, e.g. between Lazy-SMP threads that each run their own searcher. The owner
+    // then calls NewSearch on it once per root search; an owned table is aged by Search itself.
+    explicit FAlphaBetaSearch(FTranspositionTable& SharedTable);
+
+    // The referee must be in an ongoing battle; it is restored to the same state before returning.
+    FSearchResult Search(FMatchReferee& Referee, const FSearchLimits& Limits);
+    // Searches for the side to move using only its player view: the opponent's unrevealed ids are re-dealt with
+    // FIsmctsSearch::LoadDeterminization (seeded by Seed) and that sample is searched. The chosen move is matched
+    // against the real legal moves, which the player view already exposes.
+    FSearchResult SearchFromView(const FMatchReferee& Referee, const FSearchLimits& Limits, uint64_t Seed);
+    // Forgets the transposition table and history scores, e.g. between unrelated games.
+    void Clear() noexcept;
+    FTranspositionTable& GetTranspositionTable() noexcept;
+    // Positions below the root that the tablebase covers are scored from it instead of searched; nullptr disables.
+    // The tablebase must outlive the searches.
+    void SetTablebase(const FEndgameTablebase* InTablebase) noexcept;
+
+    // Static material score of the position from the side to move's point of view. Hidden pieces are not told
+    // apart: each is worth the mean of its surface role and its side's unrevealed roster, so re-dealing hidden
+    // ids leaves the score unchanged.
+    static int32_t Evaluate(const FGameState& State) noexcept;
+
+private:
+    struct FMoveKey
+    {
+        uint8_t PieceId = 0xFF;
+        uint8_t ToCell = 0xFF;
+
+        bool operator==(const FMoveKey& Other) const noexcept = default;
+    };
+
+    // Templated on the referee's rule policy, picked once per Search call, so the recursion runs with fixed rules.
+    template <typename TPolicy>
+    int32_t SearchNode(int32_t Depth, int32_t Alpha, int32_t Beta, int32_t Ply);
+    template <typename TPolicy>
+    int32_t SearchQuiescence(int32_t Alpha, int32_t Beta, int32_t Ply);
+    template <typename TPolicy>
+    int32_t SearchPass(int32_t Depth, int32_t Alpha, int32_t Beta, int32_t Ply);
+    void ScoreMoves(const FMoveList& Moves, FMoveKey TableMove, int32_t Ply, std::array<int32_t, MaxLegalMovesPerPosition>& OutScores) const;
+    bool ShouldStop();
+
+    static FMoveKey ToMoveKey(const FMoveAction& Move) noexcept;
+
+    std::unique_ptr<FTranspositionTable> OwnedTable;
+    FTranspositionTable* Table = nullptr;
+    const FEndgameTablebase* Tablebase = nullptr;
+
+    FMatchReferee* Referee = nullptr;
+    FSearchLimits Limits{};
+    std::chrono::steady_clock::time_point StartTime{};
+    uint64_t Nodes = 0;
+    bool bStopRequested = false;
+    bool bBudgetArmed = false;
+
+    std::array<std::array<FMoveKey, 2>, MaxPly> Killers{};
+    std::array<std::array<int32_t, 90>, 32> History{};
+    FMoveKey RootBestMove{};
+};
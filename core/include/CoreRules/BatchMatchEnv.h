@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreRules/BoardBitboard.h"
+#include "CoreRules/MoveList.h"
+#include "CoreRules/PackedGameState.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+struct FBatchMatchEnvConfig
+{
+    int32_t GameCount = 1;
+    // Episodes reaching this many plies (moves and passes) end as truncated.
+    uint32_t MaxPlies = 400;
+    FRuleConfig RuleConfig{};
+};
+
+// Caller-owned output rows, one per game; any pointer may be null to skip that output.
+struct FBatchStepBuffers
+{
+    float* Observations = nullptr;   // GameCount * ObservationSize
+    uint8_t* ActionMasks = nullptr;  // GameCount * ActionCount
+    float* Rewards = nullptr;        // GameCount, from the acting side's point of view
+    uint8_t* Terminated = nullptr;   // GameCount
+    uint8_t* Truncated = nullptr;    // GameCount
+};
+
+// N self-play games stepped together for RL training. Every game field lives in its own contiguous array indexed
+// by game (board cells, piece cells/roles/flags in the FPackedPiece encoding, occupancy, king cells, turn, pass
+// count), and Step advances the whole batch phase by phase: apply every action, then generate every side to
+// move's legal actions once, which yields the action mask, mate detection and pass legality together. The rules
+// mirror FMatchReferee for the battle phase; finished games restart immediately with a fresh random blind setup,
+// so the returned observation of a done game belongs to its next episode.
+//
+// Actions are FromCell * 90 + ToCell (cell = Y * 9 + X) or PassAction. Observations are seen by the side to
+// move and follow the session's visibility rules: own pieces by actual role, opposing hidden pieces only by
+// surface role. An illegal action ends the episode as a loss for the acting side.
+class FBatchMatchEnv
+{
+public:
+    static constexpr int32_t CellCount = 90;
+    static constexpr int32_t PieceCount = 32;
+    static constexpr int32_t PassAction = CellCount * CellCount;
+    static constexpr int32_t ActionCount = PassAction + 1;
+    static constexpr int32_t ObservationPlaneCount = 27;
+    static constexpr int32_t ObservationSize = ObservationPlaneCount * CellCount;
+
+    explicit FBatchMatchEnv(const FBatchMatchEnvConfig& InConfig);
+
+    int32_t GetGameCount() const noexcept;
+    // Gathers one game into a battle-phase packed state that FMatchReferee::ImportPackedState accepts.
+    FPackedGameState GetGameState(int32_t GameIndex) const noexcept;
+
+    void Reset(uint64_t Seed, const FBatchStepBuffers& Buffers);
+    void Step(const int32_t* Actions, const FBatchStepBuffers& Buffers);
+
+private:
+    void ResetGame(int32_t GameIndex);
+    bool IsActionLegal(int32_t GameIndex, int32_t Action) const noexcept;
+    // Returns whether the mover captured the defending king.
+    bool ApplyMove(int32_t GameIndex, int32_t FromCell, int32_t ToCell) noexcept;
+    void GenerateLegalActions(int32_t GameIndex) noexcept;
+    FBoardBitboard GetPseudoTargets(int32_t GameIndex, int32_t PieceId) const noexcept;
+    bool IsKingSafeAfterMove(int32_t GameIndex, int32_t PieceId, int32_t FromCell, int32_t ToCell) const noexcept;
+    // True when the king on KingCell faces the enemy king or is attacked, under the given occupancy.
+    bool IsKingExposed(
+        int32_t GameIndex,
+        int32_t SideIndex,
+        int32_t KingCell,
+        int32_t EnemyKingCell,
+        const std::array<FBoardBitboard, 2>& Occupancy) const noexcept;
+    ERoleType GetActiveRole(int32_t GameIndex, int32_t PieceId) const noexcept;
+    bool CanPass(int32_t GameIndex) const noexcept;
+
+    void WriteGameOutputs(int32_t GameIndex, const FBatchStepBuffers& Buffers) const;
+    void WriteObservation(int32_t GameIndex, float* OutObservation) const;
+    void WriteActionMask(int32_t GameIndex, uint8_t* OutActionMask) const;
+
+    FBatchMatchEnvConfig Config;
+
+    // [GameCount * CellCount]: piece id or FPackedGameState::EmptyCell.
+    std::vector<uint8_t> BoardCells;
+    // [GameCount * PieceCount], piece id order, FPackedPiece encodings.
+    std::vector<uint8_t> PieceCells;
+    std::vector<uint8_t> PieceRoles;
+    std::vector<uint8_t> PieceFlags;
+    // [GameCount * 2], Red then Black; king cells follow the piece whose actual role is King.
+    std::vector<FBoardBitboard> SideOccupancy;
+    std::vector<int8_t> KingCells;
+    // [GameCount]
+    std::vector<ESide> CurrentTurns;
+    std::vector<int32_t> PassCounts;
+    std::vector<uint64_t> TurnIndices;
+    std::vector<uint64_t> RngStates;
+    std::vector<uint32_t> EpisodePlies;
+
+    // Legal actions of the side to move, refreshed once per step: [GameCount * MaxLegalMovesPerPosition].
+    std::vector<uint16_t> LegalActions;
+    std::vector<uint16_t> LegalActionCounts;
+    std::vector<uint8_t> InCheck;
+
+    // Per-step scratch shared between Step's phases: [GameCount].
+    std::vector<float> StepRewards;
+    std::vector<uint8_t> StepEnds;
+};
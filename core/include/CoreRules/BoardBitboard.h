@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STUPIDCHESS_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define STUPIDCHESS_HAS_SSE2 0
+#endif
+
+// 90-cell occupancy set stored in one 128-bit word. Cell index matches FMatchReferee::ToCellIndex (Y * 9 + X),
+// so cells 0..63 live in Lo and cells 64..89 in the low 26 bits of Hi.
+struct alignas(16) FBoardBitboard
+{
+    uint64_t Lo = 0;
+    uint64_t Hi = 0;
+
+    static constexpr FBoardBitboard FromCell(int32_t Cell) noexcept
+    {
+        return Cell < 64 ? FBoardBitboard{uint64_t{1} << Cell, 0} : FBoardBitboard{0, uint64_t{1} << (Cell - 64)};
+    }
+
+    constexpr bool Test(int32_t Cell) const noexcept
+    {
+        return Cell < 64 ? ((Lo >> Cell) & 1u) != 0 : ((Hi >> (Cell - 64)) & 1u) != 0;
+    }
+
+    constexpr void Set(int32_t Cell) noexcept
+    {
+        if (Cell < 64)
+        {
+            Lo |= uint64_t{1} << Cell;
+        }
+        else
+        {
+            Hi |= uint64_t{1} << (Cell - 64);
+        }
+    }
+
+    constexpr void Clear(int32_t Cell) noexcept
+    {
+        if (Cell < 64)
+        {
+            Lo &= ~(uint64_t{1} << Cell);
+        }
+        else
+        {
+            Hi &= ~(uint64_t{1} << (Cell - 64));
+        }
+    }
+
+    constexpr bool IsEmpty() const noexcept
+    {
+        return (Lo | Hi) == 0;
+    }
+
+    constexpr int32_t Count() const noexcept
+    {
+        return std::popcount(Lo) + std::popcount(Hi);
+    }
+
+    // Callers must check IsEmpty() first.
+    constexpr int32_t LowestCell() const noexcept
+    {
+        return Lo != 0 ? std::countr_zero(Lo) : 64 + std::countr_zero(Hi);
+    }
+
+    constexpr int32_t HighestCell() const noexcept
+    {
+        return Hi != 0 ? 127 - std::countl_zero(Hi) : 63 - std::countl_zero(Lo);
+    }
+
+    constexpr int32_t PopLowestCell() noexcept
+    {
+        const int32_t Cell = LowestCell();
+        Clear(Cell);
+        return Cell;
+    }
+
+    constexpr int32_t PopHighestCell() noexcept
+    {
+        const int32_t Cell = HighestCell();
+        Clear(Cell);
+        return Cell;
+    }
+
+    bool operator==(const FBoardBitboard& Other) const noexcept = default;
+};
+
+#if STUPIDCHESS_HAS_SSE2
+inline __m128i LoadBitboard(const FBoardBitboard& Board) noexcept
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(&Board));
+}
+
+inline FBoardBitboard StoreBitboard(__m128i Value) noexcept
+{
+    FBoardBitboard Board;
+    _mm_store_si128(reinterpret_cast<__m128i*>(&Board), Value);
+    return Board;
+}
+#endif
+
+inline FBoardBitboard operator&(const FBoardBitboard& Lhs, const FBoardBitboard& Rhs) noexcept
+{
+#if STUPIDCHESS_HAS_SSE2
+    return StoreBitboard(_mm_and_si128(LoadBitboard(Lhs), LoadBitboard(Rhs)));
+#else
+    return FBoardBitboard{Lhs.Lo & Rhs.Lo, Lhs.Hi & Rhs.Hi};
+#endif
+}
+
+inline FBoardBitboard operator|(const FBoardBitboard& Lhs, const FBoardBitboard& Rhs) noexcept
+{
+#if STUPIDCHESS_HAS_SSE2
+    return StoreBitboard(_mm_or_si128(LoadBitboard(Lhs), LoadBitboard(Rhs)));
+#else
+    return FBoardBitboard{Lhs.Lo | Rhs.Lo, Lhs.Hi | Rhs.Hi};
+#endif
+}
+
+inline FBoardBitboard operator^(const FBoardBitboard& Lhs, const FBoardBitboard& Rhs) noexcept
+{
+#if STUPIDCHESS_HAS_SSE2
+    return StoreBitboard(_mm_xor_si128(LoadBitboard(Lhs), LoadBitboard(Rhs)));
+#else
+    return FBoardBitboard{Lhs.Lo ^ Rhs.Lo, Lhs.Hi ^ Rhs.Hi};
+#endif
+}
+
+// Lhs & ~Rhs.
+inline FBoardBitboard AndNot(const FBoardBitboard& Lhs, const FBoardBitboard& Rhs) noexcept
+{
+#if STUPIDCHESS_HAS_SSE2
+    return StoreBitboard(_mm_andnot_si128(LoadBitboard(Rhs), LoadBitboard(Lhs)));
+#else
+    return FBoardBitboard{Lhs.Lo & ~Rhs.Lo, Lhs.Hi & ~Rhs.Hi};
+#endif
+}
+
+enum class EBoardDirection : uint8_t
+{
+    East,
+    West,
+    North,
+    South
+};
+
+inline constexpr std::array<EBoardDirection, 4> AllBoardDirections = {
+    EBoardDirection::East, EBoardDirection::West, EBoardDirection::North, EBoardDirection::South};
+
+// East (+X) and North (+Y) rays walk towards higher cell indices, so their nearest cell is the lowest set bit.
+constexpr bool IsIncreasingDirection(EBoardDirection Direction) noexcept
+{
+    return Direction == EBoardDirection::East || Direction == EBoardDirection::North;
+}
+
+namespace BoardBitboardDetail
+{
+constexpr std::array<std::array<FBoardBitboard, 90>, 4> BuildRayMasks()
+{
+    constexpr int32_t StepX[4] = {1, -1, 0, 0};
+    constexpr int32_t StepY[4] = {0, 0, 1, -1};
+
+    std::array<std::array<FBoardBitboard, 90>, 4> Masks{};
+    for (int32_t DirectionIndex = 0; DirectionIndex < 4; ++DirectionIndex)
+    {
+        for (int32_t Cell = 0; Cell < 90; ++Cell)
+        {
+            int32_t CursorX = Cell % 9 + StepX[DirectionIndex];
+            int32_t CursorY = Cell / 9 + StepY[DirectionIndex];
+            while (CursorX >= 0 && CursorX < 9 && CursorY >= 0 && CursorY < 10)
+            {
+                Masks[DirectionIndex][Cell].Set(CursorY * 9 + CursorX);
+                CursorX += StepX[DirectionIndex];
+                CursorY += StepY[DirectionIndex];
+            }
+        }
+    }
+    return Masks;
+}
+}
+
+inline constexpr std::array<std::array<FBoardBitboard, 90>, 4> BoardRayMasks = BoardBitboardDetail::BuildRayMasks();
+
+// Cells strictly after Cell in Direction, up to the board edge.
+constexpr const FBoardBitboard& GetRayMask(EBoardDirection Direction, int32_t Cell) noexcept
+{
+    return BoardRayMasks[static_cast<int32_t>(Direction)][Cell];
+}
+
+// First occupied cell of Ray walking outward, or -1 when the ray is empty.
+constexpr int32_t FindNearestOnRay(const FBoardBitboard& RayOccupancy, EBoardDirection Direction) noexcept
+{
+    if (RayOccupancy.IsEmpty())
+    {
+        return -1;
+    }
+    return IsIncreasingDirection(Direction) ? RayOccupancy.LowestCell() : RayOccupancy.HighestCell();
+}
+
+// Cells strictly between two cells on the same rank or file; empty when they are not aligned.
+inline FBoardBitboard GetBetweenMask(int32_t FromCell, int32_t ToCell) noexcept
+{
+    const int32_t FromX = FromCell % 9;
+    const int32_t FromY = FromCell / 9;
+    const int32_t ToX = ToCell % 9;
+    const int32_t ToY = ToCell / 9;
+
+    EBoardDirection Direction = EBoardDirection::East;
+    if (FromY == ToY && FromX != ToX)
+    {
+        Direction = ToX > FromX ? EBoardDirection::East : EBoardDirection::West;
+    }
+    else if (FromX == ToX && FromY != ToY)
+    {
+        Direction = ToY > FromY ? EBoardDirection::North : EBoardDirection::South;
+    }
+    else
+    {
+        return FBoardBitboard{};
+    }
+
+    const FBoardBitboard& FromRay = GetRayMask(Direction, FromCell);
+    const FBoardBitboard& ToRay = GetRayMask(Direction, ToCell);
+    return AndNot(FromRay, ToRay | FBoardBitboard::FromCell(ToCell));
+}
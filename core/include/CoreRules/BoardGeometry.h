@@ -0,0 +1,237 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+
+#include <array>
+#include <cstdint>
+
+// Reachable cells of a stepping role from one cell, in the referee's generation order. BlockCells holds the
+// horse leg or elephant eye that must be empty for the step (-1 when the step cannot be blocked).
+struct FCellSteps
+{
+    std::array<int8_t, 8> Cells{};
+    std::array<int8_t, 8> BlockCells{};
+    uint8_t Count = 0;
+
+    constexpr void Add(int32_t Cell, int32_t BlockCell = -1) noexcept
+    {
+        Cells[Count] = static_cast<int8_t>(Cell);
+        BlockCells[Count] = static_cast<int8_t>(BlockCell);
+        ++Count;
+    }
+};
+
+// Per-side 90-cell lookup tables for every geometric rule query. Side index 0 is Red, 1 is Black; cell index is
+// Y * 9 + X.
+struct FBoardGeometry
+{
+    std::array<std::array<bool, 90>, 2> Palace{};
+    std::array<std::array<bool, 90>, 2> AdvisorPoint{};
+    std::array<std::array<bool, 90>, 2> ElephantPoint{};
+    std::array<std::array<bool, 90>, 2> CrossedRiver{};
+    std::array<std::array<bool, 90>, 2> SetupSlot{};
+    std::array<std::array<ERoleType, 90>, 2> SurfaceRole{};
+
+    std::array<std::array<FCellSteps, 90>, 2> KingSteps{};
+    std::array<std::array<FCellSteps, 90>, 2> AdvisorSteps{};
+    std::array<std::array<FCellSteps, 90>, 2> ElephantSteps{};
+    std::array<FCellSteps, 90> HorseSteps{};
+    std::array<std::array<FCellSteps, 90>, 2> PawnSteps{};
+
+    // Reverse of the step lists above: cells from which a piece of that role attacks the indexed cell, with the
+    // same block cell.
+    std::array<std::array<FCellSteps, 90>, 2> KingAttackers{};
+    std::array<std::array<FCellSteps, 90>, 2> AdvisorAttackers{};
+    std::array<std::array<FCellSteps, 90>, 2> ElephantAttackers{};
+    std::array<FCellSteps, 90> HorseAttackers{};
+    std::array<std::array<FCellSteps, 90>, 2> PawnAttackers{};
+};
+
+namespace BoardGeometryDetail
+{
+struct FSetupSlot
+{
+    int8_t X = 0;
+    int8_t Y = 0;
+    ERoleType SurfaceRole = ERoleType::Pawn;
+};
+
+inline constexpr std::array<FSetupSlot, 16> RedSetupSlots = {{
+    {0, 0, ERoleType::Rook},
+    {1, 0, ERoleType::Horse},
+    {2, 0, ERoleType::Elephant},
+    {3, 0, ERoleType::Advisor},
+    {4, 0, ERoleType::King},
+    {5, 0, ERoleType::Advisor},
+    {6, 0, ERoleType::Elephant},
+    {7, 0, ERoleType::Horse},
+    {8, 0, ERoleType::Rook},
+    {1, 2, ERoleType::Cannon},
+    {7, 2, ERoleType::Cannon},
+    {0, 3, ERoleType::Pawn},
+    {2, 3, ERoleType::Pawn},
+    {4, 3, ERoleType::Pawn},
+    {6, 3, ERoleType::Pawn},
+    {8, 3, ERoleType::Pawn},
+}};
+
+inline constexpr std::array<std::array<int8_t, 2>, 5> RedAdvisorPoints = {{{3, 0}, {5, 0}, {4, 1}, {3, 2}, {5, 2}}};
+inline constexpr std::array<std::array<int8_t, 2>, 7> RedElephantPoints = {{{2, 0}, {6, 0}, {0, 2}, {4, 2}, {8, 2}, {2, 4}, {6, 4}}};
+
+constexpr bool IsOnBoard(int32_t X, int32_t Y) noexcept
+{
+    return X >= 0 && X < 9 && Y >= 0 && Y < 10;
+}
+
+constexpr int32_t ToCell(int32_t X, int32_t Y) noexcept
+{
+    return Y * 9 + X;
+}
+
+// Mirrors a Red-side rank onto the given side.
+constexpr int32_t ToSideY(int32_t SideIndex, int32_t RedY) noexcept
+{
+    return SideIndex == 0 ? RedY : 9 - RedY;
+}
+
+constexpr void AddReverseSteps(const std::array<FCellSteps, 90>& Steps, std::array<FCellSteps, 90>& OutAttackers)
+{
+    for (int32_t FromCell = 0; FromCell < 90; ++FromCell)
+    {
+        for (uint8_t StepIndex = 0; StepIndex < Steps[FromCell].Count; ++StepIndex)
+        {
+            OutAttackers[Steps[FromCell].Cells[StepIndex]].Add(FromCell, Steps[FromCell].BlockCells[StepIndex]);
+        }
+    }
+}
+
+constexpr FBoardGeometry BuildBoardGeometry()
+{
+    FBoardGeometry Geometry{};
+
+    for (int32_t SideIndex = 0; SideIndex < 2; ++SideIndex)
+    {
+        for (int32_t Cell = 0; Cell < 90; ++Cell)
+        {
+            const int32_t X = Cell % 9;
+            const int32_t Y = Cell / 9;
+            const int32_t RedY = ToSideY(SideIndex, Y);
+            Geometry.Palace[SideIndex][Cell] = X >= 3 && X <= 5 && RedY <= 2;
+            Geometry.CrossedRiver[SideIndex][Cell] = RedY >= 5;
+            Geometry.SurfaceRole[SideIndex][Cell] = ERoleType::Pawn;
+        }
+
+        for (const auto& Point : RedAdvisorPoints)
+        {
+            Geometry.AdvisorPoint[SideIndex][ToCell(Point[0], ToSideY(SideIndex, Point[1]))] = true;
+        }
+        for (const auto& Point : RedElephantPoints)
+        {
+            Geometry.ElephantPoint[SideIndex][ToCell(Point[0], ToSideY(SideIndex, Point[1]))] = true;
+        }
+        for (const FSetupSlot& Slot : RedSetupSlots)
+        {
+            const int32_t Cell = ToCell(Slot.X, ToSideY(SideIndex, Slot.Y));
+            Geometry.SetupSlot[SideIndex][Cell] = true;
+            Geometry.SurfaceRole[SideIndex][Cell] = Slot.SurfaceRole;
+        }
+    }
+
+    constexpr int32_t OrthogonalDelta[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    constexpr int32_t DiagonalDelta[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    // Leg offset followed by target offset, in generation order.
+    constexpr int32_t HorsePattern[8][4] = {
+        {1, 0, 2, 1},
+        {1, 0, 2, -1},
+        {-1, 0, -2, 1},
+        {-1, 0, -2, -1},
+        {0, 1, 1, 2},
+        {0, 1, -1, 2},
+        {0, -1, 1, -2},
+        {0, -1, -1, -2},
+    };
+
+    for (int32_t Cell = 0; Cell < 90; ++Cell)
+    {
+        const int32_t X = Cell % 9;
+        const int32_t Y = Cell / 9;
+
+        for (const auto& Pattern : HorsePattern)
+        {
+            const int32_t LegX = X + Pattern[0];
+            const int32_t LegY = Y + Pattern[1];
+            const int32_t ToX = X + Pattern[2];
+            const int32_t ToY = Y + Pattern[3];
+            if (IsOnBoard(LegX, LegY) && IsOnBoard(ToX, ToY))
+            {
+                Geometry.HorseSteps[Cell].Add(ToCell(ToX, ToY), ToCell(LegX, LegY));
+            }
+        }
+
+        for (int32_t SideIndex = 0; SideIndex < 2; ++SideIndex)
+        {
+            for (const auto& Delta : OrthogonalDelta)
+            {
+                const int32_t ToX = X + Delta[0];
+                const int32_t ToY = Y + Delta[1];
+                if (IsOnBoard(ToX, ToY) && Geometry.Palace[SideIndex][ToCell(ToX, ToY)])
+                {
+                    Geometry.KingSteps[SideIndex][Cell].Add(ToCell(ToX, ToY));
+                }
+            }
+
+            for (const auto& Delta : DiagonalDelta)
+            {
+                const int32_t ToX = X + Delta[0];
+                const int32_t ToY = Y + Delta[1];
+                if (IsOnBoard(ToX, ToY) && Geometry.AdvisorPoint[SideIndex][ToCell(ToX, ToY)])
+                {
+                    Geometry.AdvisorSteps[SideIndex][Cell].Add(ToCell(ToX, ToY));
+                }
+            }
+
+            // Elephants may stand anywhere on their own half (a revealed elephant can be off its points) and
+            // never cross the river.
+            for (const auto& Delta : DiagonalDelta)
+            {
+                const int32_t ToX = X + Delta[0] * 2;
+                const int32_t ToY = Y + Delta[1] * 2;
+                if (IsOnBoard(ToX, ToY) && !Geometry.CrossedRiver[SideIndex][ToCell(ToX, ToY)])
+                {
+                    Geometry.ElephantSteps[SideIndex][Cell].Add(ToCell(ToX, ToY), ToCell(X + Delta[0], Y + Delta[1]));
+                }
+            }
+
+            const int32_t ForwardY = Y + (SideIndex == 0 ? 1 : -1);
+            if (IsOnBoard(X, ForwardY))
+            {
+                Geometry.PawnSteps[SideIndex][Cell].Add(ToCell(X, ForwardY));
+            }
+            if (Geometry.CrossedRiver[SideIndex][Cell])
+            {
+                if (IsOnBoard(X - 1, Y))
+                {
+                    Geometry.PawnSteps[SideIndex][Cell].Add(ToCell(X - 1, Y));
+                }
+                if (IsOnBoard(X + 1, Y))
+                {
+                    Geometry.PawnSteps[SideIndex][Cell].Add(ToCell(X + 1, Y));
+                }
+            }
+        }
+    }
+
+    AddReverseSteps(Geometry.HorseSteps, Geometry.HorseAttackers);
+    for (int32_t SideIndex = 0; SideIndex < 2; ++SideIndex)
+    {
+        AddReverseSteps(Geometry.KingSteps[SideIndex], Geometry.KingAttackers[SideIndex]);
+        AddReverseSteps(Geometry.AdvisorSteps[SideIndex], Geometry.AdvisorAttackers[SideIndex]);
+        AddReverseSteps(Geometry.ElephantSteps[SideIndex], Geometry.ElephantAttackers[SideIndex]);
+        AddReverseSteps(Geometry.PawnSteps[SideIndex], Geometry.PawnAttackers[SideIndex]);
+    }
+
+    return Geometry;
+}
+}
+
+inline constexpr FBoardGeometry BoardGeometry = BoardGeometryDetail::BuildBoardGeometry();
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Every command submitted to one match's referee, in order, rejected ones included.
+struct FRecordedMatch
+{
+    uint64_t MatchId = 0;
+    std::vector<FPlayerCommand> Commands;
+    // FReplayEngine digest observed when the match was recorded, if the recorder kept one.
+    std::optional<uint64_t> ExpectedDigest;
+};
+
+// Text form of a command log, one match per line:
+//
+//   match=<id> commands=<command>,<command>,... [digest=<16 hex>]
+//
+// A command is its side (R/B) followed by:
+//   C<hash>                         commit (C! when the payload is missing)
+//   V<nonce>/<placement>.<placement> reveal, placement "<PieceId>@<X><Y>" (V! when the payload is missing)
+//   <PieceId>:<FromX><FromY><ToX><ToY>  move (M when the payload is missing)
+//   P / R                           pass / resign
+// Coordinates outside 0..9 are written "/"-separated instead ("3:-1/0/4/10"). Bytes of the hash and nonce other than
+// letters and digits are escaped as %XX. Setup payload sides and the move's CapturedPieceId are not stored: the
+// referee takes the side from the command and finds the capture itself.
+class FCommandLog
+{
+public:
+    static void AppendCommand(const FPlayerCommand& Command, std::string& OutText);
+    static std::string FormatCommand(const FPlayerCommand& Command);
+    static bool ParseCommand(std::string_view Token, FPlayerCommand& OutCommand);
+
+    static std::string FormatMatch(const FRecordedMatch& Match);
+    static bool ParseMatch(std::string_view Line, FRecordedMatch& OutMatch, std::string& OutError);
+};
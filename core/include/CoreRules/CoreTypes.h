@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include "CoreRules/BoardBitboard.h"
+
 #include <array>
 #include <cstdint>
 #include <optional>
@@ -52,7 +54,8 @@ enum class EEndReason : uint8_t
     Resign,
     Timeout,
     DoublePassDraw,
-    RuleViolation
+    RuleViolation,
+    Tablebase
 };
 
 enum class ECommandType : uint8_t
@@ -86,6 +89,8 @@ struct FRuleConfig
     bool bFreezeIfIllegalAfterReveal = true;
     bool bAllowPassWhenNoLegalMove = true;
     bool bDoublePassIsDraw = true;
+
+    bool operator==(const FRuleConfig& Other) const noexcept = default;
 };
 
 struct FPieceState
@@ -99,6 +104,8 @@ struct FPieceState
     bool bAlive = true;
     bool bFrozen = false;
     bool bHasCaptured = false;
+
+    bool operator==(const FPieceState& Other) const noexcept = default;
 };
 
 struct FMoveAction
@@ -109,6 +116,16 @@ struct FMoveAction
     std::optional<FPieceId> CapturedPieceId;
 };
 
+struct FMoveUndo
+{
+    FMoveAction Move{};
+    int32_t PreviousPassCount = 0;
+    bool bCapturedWasFrozen = false;
+    bool bMoverRevealed = false;
+    bool bMoverFrozen = false;
+    bool bMoverHadCaptured = false;
+};
+
 struct FSetupPlacement
 {
     FPieceId PieceId = 0;
@@ -150,6 +167,11 @@ struct FGameState
     ESide CurrentTurn = ESide::Red;
     std::array<std::optional<FPieceId>, 90> BoardCells{};
     std::vector<FPieceState> Pieces;
+    std::array<FBoardBitboard, 2> SideOccupancy{};
+    // Board cell of each side's actual-role king, or -1 while it is off the board.
+    std::array<int8_t, 2> KingCells{-1, -1};
+    // Bit N is set while piece (16 * side + N) is alive and not frozen.
+    std::array<uint16_t, 2> MovablePieceMasks{};
     bool bRedCommitted = false;
     bool bBlackCommitted = false;
     bool bRedRevealed = false;
@@ -158,4 +180,8 @@ struct FGameState
     EGameResult Result = EGameResult::Ongoing;
     EEndReason EndReason = EEndReason::None;
     uint64_t TurnIndex = 0;
+    // Zobrist key over piece squares, active roles, reveal/freeze flags, side to move and pass count.
+    uint64_t PositionHash = 0;
+
+    bool operator==(const FGameState& Other) const = default;
 };
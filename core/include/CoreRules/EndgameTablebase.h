@@ -0,0 +1,149 @@
+#pragma once
+
+#include "CoreRules/MatchReferee.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct FTablebasePiece
+{
+    ESide Side = ESide::Red;
+    ERoleType Role = ERoleType::King;
+    bool bFrozen = false;
+};
+
+// One combination of fully revealed pieces, e.g. "KR-KA" (Red before the dash). Letters are K A E H R C P; a lowercase
+// letter is a frozen piece, which only kings, advisors and elephants can be. Each side has exactly one king.
+//
+// Pieces are kept in a canonical order (side, role, frozen) and each one gets a cell domain: unfrozen kings, advisors
+// and elephants stay on their legal points, frozen ones on the cells outside them, everything else may be anywhere.
+// A position index is the mixed-radix number of the pieces' domain ordinals, times two, plus the side to move.
+class FTablebaseMaterial
+{
+public:
+    static constexpr size_t MaxPieces = 6;
+    static constexpr uint64_t InvalidIndex = ~uint64_t{0};
+
+    using FCells = std::array<uint8_t, MaxPieces>;
+
+    static std::optional<FTablebaseMaterial> Parse(std::string_view Name, std::string* OutError = nullptr);
+    static std::optional<FTablebaseMaterial> FromPieces(std::vector<FTablebasePiece> Pieces, std::string* OutError = nullptr);
+
+    std::string GetName() const;
+    // Order-independent identity of the material; equal for equal piece multisets.
+    uint64_t GetKey() const noexcept;
+    size_t GetPieceCount() const noexcept;
+    const FTablebasePiece& GetPiece(size_t Slot) const noexcept;
+    const std::vector<uint8_t>& GetSlotCells(size_t Slot) const noexcept;
+    uint64_t GetEntryCount() const noexcept;
+
+    // The same material with one piece captured.
+    FTablebaseMaterial WithoutPiece(size_t Slot) const;
+
+    // InvalidIndex when a cell lies outside its slot's domain.
+    uint64_t ComputeIndex(const FCells& Cells, ESide SideToMove) const noexcept;
+    void DecodeIndex(uint64_t Index, FCells& OutCells, ESide& OutSideToMove) const noexcept;
+
+private:
+    struct FSlot
+    {
+        FTablebasePiece Piece{};
+        std::vector<uint8_t> Cells;
+        std::array<int16_t, 90> CellOrdinals{};
+    };
+
+    FTablebaseMaterial() = default;
+
+    std::vector<FSlot> Slots;
+    uint64_t EntryCount = 0;
+};
+
+enum class ETablebaseOutcome : uint8_t
+{
+    Draw,
+    Win,
+    Loss
+};
+
+// Result for the side to move. Distance is the number of plies to checkmate with best play: odd for wins, even for
+// losses, 0 when the side to move is already mated.
+struct FTablebaseProbeResult
+{
+    ETablebaseOutcome Outcome = ETablebaseOutcome::Draw;
+    int32_t Distance = 0;
+};
+
+// One byte per position. Entry 0 is a draw (including positions neither side can force), 0xFF an unreachable
+// position (overlapping pieces, or the side that just moved left in check), anything else is distance + 1.
+//
+// On disk a table is a 32-byte little-endian header - "SCTB", version, piece codes, entry count and an FNV-1a
+// checksum of the entries - followed by the entries, which LoadFile maps read-only instead of copying.
+class FEndgameTable
+{
+public:
+    static constexpr uint8_t DrawEntry = 0;
+    static constexpr uint8_t InvalidEntry = 0xFF;
+    static constexpr int32_t MaxDistance = 0xFD;
+
+    FEndgameTable(FTablebaseMaterial InMaterial, std::vector<uint8_t> InEntries);
+    ~FEndgameTable();
+
+    FEndgameTable(const FEndgameTable&) = delete;
+    FEndgameTable& operator=(const FEndgameTable&) = delete;
+
+    static std::unique_ptr<FEndgameTable> LoadFile(const std::string& Path, std::string& OutError);
+    bool SaveFile(const std::string& Path, std::string& OutError) const;
+
+    static uint8_t EncodeDistance(int32_t Distance) noexcept;
+    // False for InvalidEntry.
+    static bool DecodeEntry(uint8_t Entry, FTablebaseProbeResult& OutResult) noexcept;
+
+    const FTablebaseMaterial& GetMaterial() const noexcept;
+    uint64_t GetEntryCount() const noexcept;
+    uint8_t GetEntry(uint64_t Index) const noexcept;
+    bool IsMapped() const noexcept;
+
+private:
+    struct FMapping;
+
+    FEndgameTable(FTablebaseMaterial InMaterial, std::unique_ptr<FMapping> InMapping, const uint8_t* InEntries);
+
+    FTablebaseMaterial Material;
+    std::vector<uint8_t> OwnedEntries;
+    std::unique_ptr<FMapping> Mapping;
+    const uint8_t* Entries = nullptr;
+};
+
+// Set of tables keyed by material, probed with live referee positions by the search and the server.
+class FEndgameTablebase
+{
+public:
+    FEndgameTablebase();
+    ~FEndgameTablebase();
+
+    FEndgameTablebase(const FEndgameTablebase&) = delete;
+    FEndgameTablebase& operator=(const FEndgameTablebase&) = delete;
+
+    // Replaces any table of the same material.
+    void AddTable(std::unique_ptr<FEndgameTable> Table);
+    bool LoadFile(const std::string& Path, std::string& OutError);
+    // Loads every "*.sctb" file in the directory; returns the number of tables loaded.
+    size_t LoadDirectory(const std::string& Directory, std::string& OutError);
+
+    const FEndgameTable* FindTable(const FTablebaseMaterial& Material) const;
+    size_t GetTableCount() const noexcept;
+
+    // Hits only in an ongoing battle where every piece on the board is revealed and a table covers the material.
+    bool Probe(const FMatchReferee& Referee, FTablebaseProbeResult& OutResult) const;
+
+private:
+    std::unordered_map<uint64_t, std::unique_ptr<FEndgameTable>> Tables;
+    size_t MaxPieceCount = 0;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+enum class EGameEventType : uint8_t
+{
+    PieceMoved,
+    PieceCaptured,
+    PieceRevealed,
+    PieceFrozen,
+    CheckGiven,
+    GameEnded
+};
+
+// What one accepted battle command changed, in the order it happened. Fields a type does not use keep defaults:
+// PieceMoved      PieceId/Side of the mover, From -> To.
+// PieceCaptured   PieceId/Side of the captured piece, To the cell it was taken on. Role is its actual role when it
+//                 was revealed or FRuleConfig::bRevealCapturedRole is set, otherwise its surface role.
+// PieceRevealed   PieceId/Side of the capturing piece, Role is its actual role, To its cell.
+// PieceFrozen     PieceId/Side of the revealed piece, Role is its (now public) actual role, To its cell.
+// CheckGiven      Side gives check; To is the defending king's cell once that king is revealed, otherwise invalid.
+// GameEnded       Side is on turn in the final state; Result and EndReason match it.
+struct FGameEvent
+{
+    EGameEventType EventType = EGameEventType::PieceMoved;
+    ESide Side = ESide::Red;
+    FPieceId PieceId = 0;
+    ERoleType Role = ERoleType::Pawn;
+    FBoardPos From{};
+    FBoardPos To{};
+    EGameResult Result = EGameResult::Ongoing;
+    EEndReason EndReason = EEndReason::None;
+
+    bool operator==(const FGameEvent& Other) const noexcept = default;
+};
+
+// A move yields at most moved + captured + revealed + frozen + check + game ended.
+inline constexpr size_t MaxGameEventsPerCommand = 6;
+
+// Stack-resident event buffer filled by FMatchReferee::ApplyCommand; never allocates.
+class FGameEventList
+{
+public:
+    void PushBack(const FGameEvent& Event) noexcept
+    {
+        assert(Count < MaxGameEventsPerCommand);
+        if (Count < MaxGameEventsPerCommand)
+        {
+            Events[Count++] = Event;
+        }
+    }
+
+    void Clear() noexcept
+    {
+        Count = 0;
+    }
+
+    size_t Size() const noexcept
+    {
+        return Count;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return Count == 0;
+    }
+
+    const FGameEvent& operator[](size_t Index) const noexcept
+    {
+        return Events[Index];
+    }
+
+    const FGameEvent* begin() const noexcept
+    {
+        return Events.data();
+    }
+
+    const FGameEvent* end() const noexcept
+    {
+        return Events.data() + Count;
+    }
+
+private:
+    std::array<FGameEvent, MaxGameEventsPerCommand> Events{};
+    uint32_t Count = 0;
+};
+
+// Event log text shared by the match session and verbose replay, so both describe a match identically.
+constexpr const char* GetGameEventDescription(EGameEventType EventType) noexcept
+{
+    switch (EventType)
+    {
+    case EGameEventType::PieceMoved:
+        return "Move applied";
+    case EGameEventType::PieceCaptured:
+        return "Piece captured";
+    case EGameEventType::PieceRevealed:
+        return "Piece revealed";
+    case EGameEventType::PieceFrozen:
+        return "Piece frozen";
+    case EGameEventType::CheckGiven:
+        return "Check given";
+    case EGameEventType::GameEnded:
+        return "Game over";
+    }
+    return "";
+}
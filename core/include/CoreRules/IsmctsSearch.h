@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreRules/MatchReferee.h"
+
+#include <cstdint>
+
+struct FIsmctsConfig
+{
+    int32_t ThreadCount = 1;
+    // 0 disables the limit; at least one of the two budgets should be set.
+    uint64_t MaxIterations = 0;
+    int64_t TimeBudgetMs = 100;
+    // Random plies played past the tree leaf before the position is scored by material.
+    int32_t PlayoutDepth = 24;
+    double Exploration = 0.7;
+    // Visits added to a node while a thread is inside its subtree, steering other threads elsewhere.
+    int32_t VirtualLoss = 3;
+    int32_t MaxDeterminizationAttempts = 32;
+};
+
+struct FIsmctsResult
+{
+    bool bHasCommand = false;
+    FPlayerCommand BestCommand{};
+    uint64_t Iterations = 0;
+    uint32_t BestVisits = 0;
+    // Mean reward of the chosen move for the side to move, in [0, 1].
+    double BestValue = 0.0;
+    double Seconds = 0.0;
+};
+
+// Single-observer information-set MCTS for the side to move. The searcher only uses what that side's player view
+// shows: its own pieces, and for the opponent the squares, surface roles and flags of hidden pieces plus the actual
+// roles of revealed ones. Each iteration samples a determinization that deals the opponent's unrevealed piece ids
+// (alive or captured) over its hidden squares, rejects samples where the side that just moved would be in check,
+// and walks one shared tree whose edges are From/To cells, so they mean the same thing in every sample.
+//
+// Threads share the tree (tree parallelism): each node has its own lock, selection adds a virtual loss to the
+// chosen child, and playouts run without any lock.
+class FIsmctsSearch
+{
+public:
+    static constexpr int32_t PassAction = 90 * 90;
+
+    explicit FIsmctsSearch(const FIsmctsConfig& InConfig = {});
+
+    FIsmctsResult Search(const FMatchReferee& Referee, uint64_t Seed) const;
+
+    // Loads State into OutReferee with the opponent of Observer's unrevealed ids re-dealt at random. Returns false
+    // when every attempt left the side that just moved in check; OutReferee then holds the last rejected sample.
+    static bool LoadDeterminization(
+        const FGameState& State,
+        ESide Observer,
+        uint64_t& RngState,
+        int32_t MaxAttempts,
+        FMatchReferee& OutReferee);
+
+private:
+    FIsmctsConfig Config;
+};
@@ -1,6 +1,12 @@
 ﻿#pragma once
 
 #include "CoreRules/CoreTypes.h"
+#include "CoreRules/GameEvents.h"
+#include "CoreRules/MoveList.h"
+#include "CoreRules/PackedGameState.h"
+#include "CoreRules/RulePolicy.h"
+
+#include <span>
 
 class FMatchReferee
 {
@@ -9,16 +15,80 @@ public:
 
     void ResetNewMatch();
     const FGameState& GetState() const noexcept;
+    const FRuleConfig& GetRuleConfig() const noexcept;
+    // Preset matching the rule config; the untemplated entry points dispatch on it once per call.
+    ERulePolicyKind GetRulePolicyKind() const noexcept;
 
     FCommandResult ApplyCommit(const FSetupCommit& Commit);
     FCommandResult ApplyReveal(const FSetupPlain& SetupPlain);
     FCommandResult ApplyCommand(const FPlayerCommand& Command);
+    // Same as above; also clears OutEvents and fills it with what an accepted command changed, taken from the
+    // transitions the referee performs anyway (no extra move generation). Rejected commands leave it empty.
+    FCommandResult ApplyCommand(const FPlayerCommand& Command, FGameEventList& OutEvents);
+    // Ends an ongoing battle with a result decided outside the move rules, e.g. a tablebase verdict.
+    FCommandResult Adjudicate(EGameResult Result, EEndReason EndReason);
+    // Same as above; a successful adjudication leaves a single GameEnded event in OutEvents.
+    FCommandResult Adjudicate(EGameResult Result, EEndReason EndReason, FGameEventList& OutEvents);
 
     std::vector<FMoveAction> GenerateLegalMoves(ESide Side) const;
+    // Allocation-free variant: clears OutMoves and fills it in the same order as the vector overload.
+    void GenerateLegalMoves(ESide Side, FMoveList& OutMoves) const;
+    // Checks one move for its piece's side without generating the full list. Returns the move with
+    // CapturedPieceId filled in when GenerateLegalMoves would contain it (matched by PieceId/From/To).
+    std::optional<FMoveAction> ValidateMove(const FMoveAction& Move) const;
+    // Same answer as !GenerateLegalMoves(Side).empty(), but stops at the first legal move. When the side is in
+    // check it tries king moves first, then captures of a checker, then blocks.
+    bool HasAnyLegalMove(ESide Side) const;
+    bool CanPass(ESide Side) const;
+    // True while the side's king is attacked, faces the enemy king, or is off the board.
+    bool IsSideInCheck(ESide Side) const;
+
+    // Applies a legal move in place with the same capture/reveal/freeze/turn transitions as ApplyCommand,
+    // without end-of-game adjudication. UnmakeMove must be called with the matching undo record in LIFO order.
+    void MakeMove(const FMoveAction& Move, FMoveUndo& OutUndo);
+    void UnmakeMove(const FMoveUndo& Undo);
+    // Pass counterpart of MakeMove: bumps the pass count and hands over the turn without draw adjudication.
+    // Only PreviousPassCount of the undo record is used.
+    void MakePass(FMoveUndo& OutUndo);
+    void UnmakePass(const FMoveUndo& Undo);
+
+    // Rule-policy specialisations for callers that dispatch once (DispatchRulePolicy on GetRulePolicyKind()) and
+    // keep the policy fixed inside their loop. TPolicy must describe this referee's rule config; FDynamicRulePolicy
+    // and the presets in RulePolicy.h are explicitly instantiated.
+    template <typename TPolicy>
+    void MakeMove(const FMoveAction& Move, FMoveUndo& OutUndo);
+    template <typename TPolicy>
     bool CanPass(ESide Side) const;
 
+    // Snapshot and restore of the whole game state; commit hashes and rule config are not part of it.
+    FPackedGameState ExportPackedState() const noexcept;
+    void ImportPackedState(const FPackedGameState& PackedState);
+
+    // Versioned binary image of the whole referee (rule config, game state, commit hashes and flags) closed by a
+    // CRC-32; see InterfaceSpec §8 for the layout. Deserialize reads straight from the buffer, checks the checksum
+    // and the state's consistency, and leaves the referee untouched when it returns false.
+    static constexpr uint16_t SnapshotVersion = 1;
+    void Serialize(std::vector<uint8_t>& OutBytes) const;
+    bool Deserialize(std::span<const uint8_t> Bytes, std::string& OutError);
+
+    // Full recomputation of FGameState::PositionHash; the referee maintains the same value incrementally.
+    static uint64_t ComputePositionHash(const FGameState& State) noexcept;
+
 private:
+    // Per-position king-safety summary for the side to generate. A non-king move that neither leaves nor enters a
+    // sensitive cell cannot change any attack on that side's king, so its legality equals !bInCheck.
+    struct FLegalityContext
+    {
+        bool bHasKing = false;
+        bool bInCheck = false;
+        FBoardPos KingPos{};
+        FBoardBitboard SensitiveCells{};
+        FBoardBitboard Checkers{};
+    };
+
     static int32_t ToCellIndex(const FBoardPos& Pos) noexcept;
+    static FBoardPos FromCellIndex(int32_t Cell) noexcept;
+    static int32_t ToSideIndex(ESide Side) noexcept;
     static ESide GetOppositeSide(ESide Side) noexcept;
 
     const FPieceState* FindPieceById(FPieceId PieceId) const noexcept;
@@ -26,11 +96,17 @@ private:
 
     const FPieceState* GetPieceAt(const FBoardPos& Pos) const noexcept;
     FPieceState* GetPieceAt(const FBoardPos& Pos) noexcept;
+    FBoardBitboard GetOccupancy() const noexcept;
+    void PlaceOnBoard(FPieceId PieceId, ESide Side, const FBoardPos& Pos) noexcept;
+    void RemoveFromBoard(ESide Side, const FBoardPos& Pos) noexcept;
+    void SyncPieceCaches(const FPieceState& Piece) noexcept;
+    static uint64_t GetPieceHashKey(const FPieceState& Piece) noexcept;
+    void SetCurrentTurn(ESide Side) noexcept;
+    void SetPassCount(int32_t PassCount) noexcept;
 
     bool IsInsidePalace(ESide Side, const FBoardPos& Pos) const noexcept;
     bool IsAdvisorPoint(ESide Side, const FBoardPos& Pos) const noexcept;
     bool IsElephantPoint(ESide Side, const FBoardPos& Pos) const noexcept;
-    bool IsCrossedRiver(ESide Side, const FBoardPos& Pos) const noexcept;
     ERoleType GetInitialSurfaceRoleForPos(ESide Side, const FBoardPos& Pos) const;
     bool IsSetupPositionAllowed(ESide Side, const FBoardPos& Pos) const;
     bool IsPieceIdOwnedBySide(FPieceId PieceId, ESide Side) const noexcept;
@@ -41,26 +117,41 @@ private:
     bool IsPathClearStraight(const FBoardPos& From, const FBoardPos& To) const noexcept;
     int32_t CountPiecesBetweenStraight(const FBoardPos& From, const FBoardPos& To) const noexcept;
 
-    std::vector<FMoveAction> GeneratePseudoMovesForPiece(const FPieceState& Piece) const;
+    void GeneratePseudoMovesForPiece(const FPieceState& Piece, FPieceMoveList& OutMoves) const;
+    bool IsPseudoMoveForPiece(const FPieceState& Piece, int32_t ToCell) const noexcept;
     bool IsSquareAttackedBySide(const FBoardPos& Target, ESide AttackerSide) const;
-    bool CanPieceAttackSquare(const FPieceState& Piece, const FBoardPos& Target) const;
+    FBoardBitboard GetSquareAttackers(const FBoardPos& Target, ESide AttackerSide) const;
+    // Same as above against caller-supplied side occupancies; enemy pieces are looked up in the live board.
+    FBoardBitboard GetSquareAttackers(const FBoardPos& Target, ESide AttackerSide, const std::array<FBoardBitboard, 2>& SideOccupancy) const;
     bool AreKingsFacing() const;
     std::optional<FBoardPos> FindKingPos(ESide Side) const;
-    bool IsSideInCheck(ESide Side) const;
 
-    void ApplyMoveUnchecked(const FMoveAction& Move);
+    void ApplyMoveUnchecked(const FMoveAction& Move, FMoveUndo& OutUndo);
+    void RevertMoveUnchecked(const FMoveUndo& Undo);
     bool IsMoveLegalForSide(const FMoveAction& Move, ESide Side) const;
-    void EvaluateEndAfterMove(ESide MovedSide);
+    FLegalityContext BuildLegalityContext(ESide Side) const;
+    bool IsCandidateLegal(const FLegalityContext& Context, const FPieceState& Piece, const FMoveAction& Move) const;
+    // Returns whether the defending side is now in check.
+    bool EvaluateEndAfterMove(ESide MovedSide);
+    template <typename TPolicy>
+    FCommandResult ApplyBattleCommand(const FPlayerCommand& Command, FGameEventList& OutEvents);
 
-    std::string BuildRevealDigest(const FSetupPlain& SetupPlain) const;
     bool ValidateSetupPlain(const FSetupPlain& SetupPlain, std::string& OutError) const;
     FCommandResult ApplyRevealPlacement(const FSetupPlain& SetupPlain);
     void InitializePieceRoster();
 
     FRuleConfig RuleConfig;
+    ERulePolicyKind RulePolicyKind = ERulePolicyKind::Standard;
     FGameState GameState;
     std::string RedCommitHash;
     std::string BlackCommitHash;
     bool bHasRedCommit = false;
     bool bHasBlackCommit = false;
 };
+
+extern template void FMatchReferee::MakeMove<FStandardRulePolicy>(const FMoveAction& Move, FMoveUndo& OutUndo);
+extern template void FMatchReferee::MakeMove<FNoFreezeRulePolicy>(const FMoveAction& Move, FMoveUndo& OutUndo);
+extern template void FMatchReferee::MakeMove<FDynamicRulePolicy>(const FMoveAction& Move, FMoveUndo& OutUndo);
+extern template bool FMatchReferee::CanPass<FStandardRulePolicy>(ESide Side) const;
+extern template bool FMatchReferee::CanPass<FNoFreezeRulePolicy>(ESide Side) const;
+extern template bool FMatchReferee::CanPass<FDynamicRulePolicy>(ESide Side) const;
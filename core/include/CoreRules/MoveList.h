@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// Stack-resident move buffer with a fixed upper bound; never allocates.
+template <size_t Capacity>
+class TBoundedMoveList
+{
+public:
+    void PushBack(const FMoveAction& Move) noexcept
+    {
+        assert(Count < Capacity);
+        if (Count < Capacity)
+        {
+            Moves[Count++] = Move;
+        }
+    }
+
+    void Clear() noexcept
+    {
+        Count = 0;
+    }
+
+    size_t Size() const noexcept
+    {
+        return Count;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return Count == 0;
+    }
+
+    const FMoveAction& operator[](size_t Index) const noexcept
+    {
+        return Moves[Index];
+    }
+
+    FMoveAction& operator[](size_t Index) noexcept
+    {
+        return Moves[Index];
+    }
+
+    const FMoveAction* begin() const noexcept
+    {
+        return Moves.data();
+    }
+
+    const FMoveAction* end() const noexcept
+    {
+        return Moves.data() + Count;
+    }
+
+    FMoveAction* begin() noexcept
+    {
+        return Moves.data();
+    }
+
+    FMoveAction* end() noexcept
+    {
+        return Moves.data() + Count;
+    }
+
+private:
+    std::array<FMoveAction, Capacity> Moves{};
+    uint32_t Count = 0;
+};
+
+// A rook or cannon reaches at most 8 + 9 cells; every other role has fewer targets.
+inline constexpr size_t MaxPseudoMovesPerPiece = 17;
+
+// Hidden pieces move by their slot's surface role and revealed pieces by their actual role, so at most 4 pieces
+// move as rooks, 4 as cannons and 4 as horses, and the remaining 4 reach at most 4 cells each:
+// 4 * 17 + 4 * 17 + 4 * 8 + 4 * 4 = 184 moves per side.
+inline constexpr size_t MaxLegalMovesPerPosition = 192;
+
+using FPieceMoveList = TBoundedMoveList<MaxPseudoMovesPerPiece>;
+using FMoveList = TBoundedMoveList<MaxLegalMovesPerPosition>;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// One piece in 3 bytes. Flag bits are spelled out instead of using bitfields so the layout is the same on every
+// compiler.
+struct FPackedPiece
+{
+    static constexpr uint8_t OffBoardCell = 0xFF;
+
+    static constexpr uint8_t BlackSideFlag = 1u << 0;
+    static constexpr uint8_t RevealedFlag = 1u << 1;
+    static constexpr uint8_t AliveFlag = 1u << 2;
+    static constexpr uint8_t FrozenFlag = 1u << 3;
+    static constexpr uint8_t HasCapturedFlag = 1u << 4;
+
+    uint8_t Cell = OffBoardCell;
+    // Actual role in the low nibble, surface role in the high nibble.
+    uint8_t Roles = 0;
+    uint8_t Flags = 0;
+};
+
+// Fixed-size, trivially copyable image of FGameState for memcpy snapshots, search stacks and batched storage.
+// Packed piece N is FGameState::Pieces[N]; as in the referee roster, a piece's id is its index.
+struct FPackedGameState
+{
+    static constexpr uint8_t EmptyCell = 0xFF;
+
+    static constexpr uint8_t RedCommittedFlag = 1u << 0;
+    static constexpr uint8_t BlackCommittedFlag = 1u << 1;
+    static constexpr uint8_t RedRevealedFlag = 1u << 2;
+    static constexpr uint8_t BlackRevealedFlag = 1u << 3;
+
+    uint64_t TurnIndex = 0;
+    uint64_t PositionHash = 0;
+    int32_t PassCount = 0;
+    std::array<uint8_t, 90> BoardCells{};
+    std::array<FPackedPiece, 32> Pieces{};
+    uint8_t PieceCount = 0;
+    EGamePhase Phase = EGamePhase::SetupCommit;
+    ESide CurrentTurn = ESide::Red;
+    EGameResult Result = EGameResult::Ongoing;
+    EEndReason EndReason = EEndReason::None;
+    uint8_t SetupFlags = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<FPackedGameState>);
+static_assert(sizeof(FPackedGameState) <= 256);
+
+class FGameStatePacker
+{
+public:
+    static FPackedGameState Pack(const FGameState& State) noexcept;
+
+    // Rebuilds the derived fields (occupancy bitboards, king cells, movable masks) and reuses OutState's piece
+    // storage. The stored position hash is copied as is.
+    static void Unpack(const FPackedGameState& Packed, FGameState& OutState);
+    static FGameState Unpack(const FPackedGameState& Packed);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreRules/BoardGeometry.h"
+#include "CoreRules/CoreTypes.h"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// SplitMix64 step shared by every seeded component (self-play, batch env, ISMCTS, the referee's Zobrist keys) so
+// one seed means one stream. constexpr so the Zobrist table is still built at compile time.
+constexpr uint64_t NextSplitMix64(uint64_t& RngState) noexcept
+{
+    RngState += 0x9e3779b97f4a7c15ull;
+    uint64_t Value = RngState;
+    Value = (Value ^ (Value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    Value = (Value ^ (Value >> 27)) * 0x94d049bb133111ebull;
+    return Value ^ (Value >> 31);
+}
+
+// Fisher-Yates shuffle of the side's 16 piece ids over the standard setup slots.
+inline FSetupPlain BuildRandomSetup(ESide Side, uint64_t& RngState)
+{
+    std::array<FPieceId, 16> PieceOrder{};
+    const FPieceId BasePieceId = Side == ESide::Red ? 0 : 16;
+    for (int32_t Index = 0; Index < 16; ++Index)
+    {
+        PieceOrder[Index] = static_cast<FPieceId>(BasePieceId + Index);
+    }
+    for (int32_t Index = 15; Index > 0; --Index)
+    {
+        const int32_t SwapIndex = static_cast<int32_t>(NextSplitMix64(RngState) % static_cast<uint64_t>(Index + 1));
+        std::swap(PieceOrder[Index], PieceOrder[SwapIndex]);
+    }
+
+    FSetupPlain Setup{};
+    Setup.Side = Side;
+    Setup.Placements.reserve(16);
+    for (int32_t SlotIndex = 0; SlotIndex < 16; ++SlotIndex)
+    {
+        const BoardGeometryDetail::FSetupSlot& Slot = BoardGeometryDetail::RedSetupSlots[SlotIndex];
+        const int8_t Y = Side == ESide::Red ? Slot.Y : static_cast<int8_t>(9 - Slot.Y);
+        Setup.Placements.push_back(FSetupPlacement{PieceOrder[SlotIndex], FBoardPos{Slot.X, Y}});
+    }
+    return Setup;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreRules/MatchReferee.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+class FEndgameTablebase;
+
+enum class EReplayMode : uint8_t
+{
+    // Hashes only; no per-command strings are built.
+    Fast,
+    // Also records the session's event wording for every command, for human inspection.
+    Verbose
+};
+
+struct FReplayConfig
+{
+    FRuleConfig RuleConfig{};
+    EReplayMode Mode = EReplayMode::Fast;
+    bool bRecordPlyHashes = false;
+    // Same adjudication as FInMemoryMatchSession::SetTablebase; must match what the recording session used.
+    const FEndgameTablebase* Tablebase = nullptr;
+};
+
+struct FReplayResult
+{
+    uint32_t CommandCount = 0;
+    uint32_t AcceptedCount = 0;
+    uint32_t RejectedCount = 0;
+    EGamePhase Phase = EGamePhase::SetupCommit;
+    EGameResult Result = EGameResult::Ongoing;
+    EEndReason EndReason = EEndReason::None;
+    uint64_t TurnIndex = 0;
+    uint64_t FinalStateHash = 0;
+    // ChainDigest over the state hash taken after every command, rejected ones included.
+    uint64_t Digest = 0;
+    // One entry per command when bRecordPlyHashes is set.
+    std::vector<uint64_t> PlyHashes;
+    // Verbose mode only: one or two lines per command ("Move applied", the rejection message, "Game over").
+    std::vector<std::string> EventDescriptions;
+};
+
+// Re-runs a recorded command stream through a fresh match with the session's dispatch rules: commits and reveals
+// go through ApplyCommit/ApplyReveal (a missing payload is rejected as ERR_INVALID_PAYLOAD), everything else through
+// ApplyCommand, and accepted moves and passes are followed by tablebase adjudication when one is configured.
+// The referee is reused across Replay calls, so one engine per thread replays an archive without reallocating.
+class FReplayEngine
+{
+public:
+    static constexpr uint64_t DigestSeed = 0x5374757069644368ULL;
+
+    explicit FReplayEngine(FReplayConfig InConfig = {});
+
+    FReplayResult Replay(std::span<const FPlayerCommand> Commands);
+
+    // Position hash extended with the phase, turn index, result and setup flags, so setup and game-over
+    // transitions that leave the pieces untouched still change it.
+    static uint64_t ComputeStateHash(const FGameState& State) noexcept;
+    static uint64_t ChainDigest(uint64_t Digest, uint64_t StateHash) noexcept;
+
+private:
+    FCommandResult Dispatch(const FPlayerCommand& Command, FGameEventList& OutEvents);
+    // Appends the GameEnded event of a decisive verdict to InOutEvents.
+    void AdjudicateByTablebase(FGameEventList& InOutEvents);
+
+    FReplayConfig Config;
+    FMatchReferee Referee;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+
+#include <cstdint>
+#include <utility>
+
+// Compile-time rule set. Each accessor mirrors the FRuleConfig field of the same name and ignores the runtime
+// config, so the referee's specialised paths fold the rule branches away.
+template <bool bRevealOnFirstCaptureValue,
+          bool bRevealCapturedRoleValue,
+          bool bFreezeIfIllegalAfterRevealValue,
+          bool bAllowPassWhenNoLegalMoveValue,
+          bool bDoublePassIsDrawValue>
+struct TStaticRulePolicy
+{
+    static constexpr FRuleConfig Config{
+        bRevealOnFirstCaptureValue,
+        bRevealCapturedRoleValue,
+        bFreezeIfIllegalAfterRevealValue,
+        bAllowPassWhenNoLegalMoveValue,
+        bDoublePassIsDrawValue};
+
+    static constexpr bool RevealOnFirstCapture(const FRuleConfig&) noexcept { return bRevealOnFirstCaptureValue; }
+    static constexpr bool FreezeIfIllegalAfterReveal(const FRuleConfig&) noexcept { return bFreezeIfIllegalAfterRevealValue; }
+    static constexpr bool AllowPassWhenNoLegalMove(const FRuleConfig&) noexcept { return bAllowPassWhenNoLegalMoveValue; }
+    static constexpr bool DoublePassIsDraw(const FRuleConfig&) noexcept { return bDoublePassIsDrawValue; }
+};
+
+// Reads every flag from the referee's FRuleConfig; serves rule sets without a preset instantiation.
+struct FDynamicRulePolicy
+{
+    static bool RevealOnFirstCapture(const FRuleConfig& RuleConfig) noexcept { return RuleConfig.bRevealOnFirstCapture; }
+    static bool FreezeIfIllegalAfterReveal(const FRuleConfig& RuleConfig) noexcept { return RuleConfig.bFreezeIfIllegalAfterReveal; }
+    static bool AllowPassWhenNoLegalMove(const FRuleConfig& RuleConfig) noexcept { return RuleConfig.bAllowPassWhenNoLegalMove; }
+    static bool DoublePassIsDraw(const FRuleConfig& RuleConfig) noexcept { return RuleConfig.bDoublePassIsDraw; }
+};
+
+// FRuleConfig defaults: the ruleset every deployment runs today.
+using FStandardRulePolicy = TStaticRulePolicy<true, true, true, true, true>;
+// Standard rules except that a piece revealed on an illegal point keeps moving by its actual role.
+using FNoFreezeRulePolicy = TStaticRulePolicy<true, true, false, true, true>;
+
+enum class ERulePolicyKind : uint8_t
+{
+    Dynamic,
+    Standard,
+    NoFreeze
+};
+
+constexpr ERulePolicyKind FindRulePolicyKind(const FRuleConfig& RuleConfig) noexcept
+{
+    if (RuleConfig == FStandardRulePolicy::Config)
+    {
+        return ERulePolicyKind::Standard;
+    }
+    if (RuleConfig == FNoFreezeRulePolicy::Config)
+    {
+        return ERulePolicyKind::NoFreeze;
+    }
+    return ERulePolicyKind::Dynamic;
+}
+
+// Calls Function.template operator()<TPolicy>() for the policy of the given kind, e.g.
+// DispatchRulePolicy(Kind, [&]<typename TPolicy>() { return RunSearch<TPolicy>(Referee); }).
+// Dispatch once outside a hot loop and keep the policy fixed inside it.
+template <typename TFunction>
+decltype(auto) DispatchRulePolicy(ERulePolicyKind Kind, TFunction&& Function)
+{
+    switch (Kind)
+    {
+    case ERulePolicyKind::Standard:
+        return std::forward<TFunction>(Function).template operator()<FStandardRulePolicy>();
+    case ERulePolicyKind::NoFreeze:
+        return std::forward<TFunction>(Function).template operator()<FNoFreezeRulePolicy>();
+    case ERulePolicyKind::Dynamic:
+        break;
+    }
+    return std::forward<TFunction>(Function).template operator()<FDynamicRulePolicy>();
+}
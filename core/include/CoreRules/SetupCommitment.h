@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+#include "CoreRules/Sha256.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Commit/reveal hashing for setups. The commit hash is the lowercase hex SHA-256 of a fixed binary layout:
+//
+//   u8  LayoutVersion
+//   u8  Side
+//   u16 PlacementCount                      (little endian)
+//   PlacementCount x { u16 PieceId, i8 X, i8 Y }, sorted by (PieceId, X, Y)
+//   u32 NonceLength                         (little endian)
+//   NonceLength bytes of Nonce
+//
+// Placements are sorted before hashing, so the hash does not depend on the order a client lists them in.
+class FSetupCommitment
+{
+public:
+    static constexpr uint8_t LayoutVersion = 1;
+
+    static void Serialize(const FSetupPlain& SetupPlain, std::vector<uint8_t>& OutBytes);
+    // Same bytes as Serialize, streamed straight into the hasher.
+    static FSha256Digest ComputeDigest(const FSetupPlain& SetupPlain);
+    static std::string BuildCommitHash(const FSetupPlain& SetupPlain);
+
+    // Hex comparison is case-insensitive; a hash that is not 64 hex digits never matches.
+    static bool VerifyCommit(const FSetupCommit& Commit, const FSetupPlain& SetupPlain);
+    // Result[i] = VerifyCommit(Commits[i], Reveals[i]); all reveals are hashed in one batch. Both spans must have the
+    // same size.
+    static std::vector<bool> VerifyCommits(std::span<const FSetupCommit> Commits, std::span<const FSetupPlain> Reveals);
+
+    static std::string ToHex(const FSha256Digest& Digest);
+    static bool ParseHex(std::string_view HashHex, FSha256Digest& OutDigest);
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+using FSha256Digest = std::array<uint8_t, 32>;
+
+enum class ESha256Backend : uint8_t
+{
+    Portable,
+    // x86 SHA extensions, one message at a time.
+    ShaNi,
+    // Eight independent messages per AVX2 register; single messages use the portable rounds.
+    Avx2
+};
+
+// Self-contained SHA-256 (FIPS 180-4). The backend is picked at runtime from CPUID; a requested backend the CPU does
+// not support falls back to Portable, so every backend produces the same digests everywhere.
+class FSha256
+{
+public:
+    explicit FSha256(ESha256Backend InBackend = GetBestBackend()) noexcept;
+
+    void Update(std::span<const uint8_t> Data) noexcept;
+    // Pads and returns the digest; the object must not be updated afterwards.
+    FSha256Digest Finish() noexcept;
+
+    static FSha256Digest Hash(std::span<const uint8_t> Data, ESha256Backend Backend = GetBestBackend()) noexcept;
+    // OutDigests[i] = Hash(Messages[i]). The AVX2 backend groups messages of equal block count into 8-lane batches.
+    static void HashBatch(std::span<const std::span<const uint8_t>> Messages, std::span<FSha256Digest> OutDigests,
+                          ESha256Backend Backend = GetBestBatchBackend()) noexcept;
+
+    static bool IsBackendSupported(ESha256Backend Backend) noexcept;
+    static ESha256Backend GetBestBackend() noexcept;
+    static ESha256Backend GetBestBatchBackend() noexcept;
+
+private:
+    std::array<uint32_t, 8> State{};
+    std::array<uint8_t, 64> Buffer{};
+    size_t BufferSize = 0;
+    uint64_t TotalSize = 0;
+    ESha256Backend Backend = ESha256Backend::Portable;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreRules/EndgameTablebase.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct FTablebaseGeneratorConfig
+{
+    int32_t ThreadCount = 1;
+    // Tables are only valid for the pass rules they were generated with; the file does not record them.
+    FRuleConfig RuleConfig{};
+};
+
+struct FTablebaseGenerationStats
+{
+    std::string Name;
+    uint64_t Entries = 0;
+    uint64_t Wins = 0;
+    uint64_t Losses = 0;
+    uint64_t Draws = 0;
+    uint64_t Invalid = 0;
+    int32_t LongestDistance = 0;
+    double Seconds = 0.0;
+};
+
+// Retrograde analysis over every placement of a material. A forward pass classifies each position (unreachable,
+// mated, stuck) and records its in-table successors; captures are resolved on the spot from the smaller tables. Each
+// following pass settles one distance: odd levels mark positions with a move into a loss as wins, even levels mark
+// positions whose every move reaches a win as losses. Whatever is left after two empty levels is a draw.
+//
+// Both the forward pass and every level pass split the positions into chunks shared by ThreadCount threads.
+class FTablebaseGenerator
+{
+public:
+    explicit FTablebaseGenerator(FTablebaseGeneratorConfig InConfig = {});
+
+    // Generates the material after every capture sub-table it needs that the tablebase does not hold yet; each new
+    // table is added to the tablebase. Does nothing when the material is already there.
+    bool Generate(const FTablebaseMaterial& Material, FEndgameTablebase& Tablebase, std::string& OutError);
+
+    // One record per table generated by this generator, in generation order.
+    const std::vector<FTablebaseGenerationStats>& GetGeneratedStats() const noexcept;
+
+private:
+    bool GenerateTable(const FTablebaseMaterial& Material, FEndgameTablebase& Tablebase, std::string& OutError);
+
+    FTablebaseGeneratorConfig Config;
+    std::vector<FTablebaseGenerationStats> GeneratedStats;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class ETranspositionBound : uint8_t
+{
+    None,
+    Exact,
+    Lower,
+    Upper
+};
+
+// Search result cached for one position. The best move is a piece id + destination cell; 0xFF when there is none.
+struct FTranspositionData
+{
+    int16_t Score = 0;
+    int8_t Depth = 0;
+    ETranspositionBound Bound = ETranspositionBound::None;
+    uint8_t MovePieceId = 0xFF;
+    uint8_t MoveToCell = 0xFF;
+};
+
+struct FTranspositionTableStats
+{
+    uint64_t Probes = 0;
+    uint64_t Hits = 0;
+    uint64_t Stores = 0;
+    // Stores that evicted an entry of another position written during the current search.
+    uint64_t Collisions = 0;
+
+    double GetHitRate() const noexcept
+    {
+        return Probes == 0 ? 0.0 : static_cast<double>(Hits) / static_cast<double>(Probes);
+    }
+};
+
+// Fixed-size table shared by any number of search threads without locks. Each 64-byte bucket holds four entries;
+// an entry is two relaxed 64-bit words, Key ^ Data and Data, so a torn write from a concurrent store fails the key
+// check on probe and reads as a miss. Replacement prefers empty slots, then the shallowest entry, with entries from
+// older searches (see NewSearch) losing 8 plies of depth per generation of age.
+class FTranspositionTable
+{
+public:
+    static constexpr size_t EntriesPerBucket = 4;
+    static constexpr size_t BucketSize = 64;
+
+    // Rounds the size down to a power-of-two bucket count (at least one bucket). Huge pages are a Linux
+    // transparent-huge-page hint and are ignored elsewhere.
+    explicit FTranspositionTable(size_t SizeMegabytes = 16, bool bUseHugePages = false);
+    ~FTranspositionTable();
+
+    FTranspositionTable(const FTranspositionTable&) = delete;
+    FTranspositionTable& operator=(const FTranspositionTable&) = delete;
+
+    // Not thread-safe; call while no search is running.
+    void Clear() noexcept;
+    // Ages every stored entry by one generation. Call once per root search, before the threads start.
+    void NewSearch() noexcept;
+
+    bool Probe(uint64_t Key, FTranspositionData& OutData) noexcept;
+    void Store(uint64_t Key, const FTranspositionData& Data) noexcept;
+
+    size_t GetBucketCount() const noexcept;
+    size_t GetSizeBytes() const noexcept;
+    bool IsUsingHugePages() const noexcept;
+
+    // Counting is off by default: the counters share one cache line, so counting makes every probe and store of
+    // every search thread write to it. Not thread-safe; call while no search is running.
+    void SetStatsEnabled(bool bEnabled) noexcept;
+    bool IsStatsEnabled() const noexcept;
+    FTranspositionTableStats GetStats() const noexcept;
+    void ResetStats() noexcept;
+
+private:
+    struct FEntry
+    {
+        std::atomic<uint64_t> KeyXorData{0};
+        std::atomic<uint64_t> Data{0};
+    };
+
+    struct alignas(BucketSize) FBucket
+    {
+        std::array<FEntry, EntriesPerBucket> Entries;
+    };
+
+    static_assert(sizeof(FBucket) == BucketSize);
+
+    FBucket& GetBucket(uint64_t Key) noexcept;
+
+    FBucket* Buckets = nullptr;
+    size_t BucketCount = 0;
+    size_t AllocatedBytes = 0;
+    bool bHugePages = false;
+    uint8_t Generation = 0;
+    bool bStatsEnabled = false;
+
+    alignas(BucketSize) std::atomic<uint64_t> ProbeCount{0};
+    std::atomic<uint64_t> HitCount{0};
+    std::atomic<uint64_t> StoreCount{0};
+    std::atomic<uint64_t> CollisionCount{0};
+};
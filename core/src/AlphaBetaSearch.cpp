@@ -0,0 +1,586 @@
+#include "CoreRules/AlphaBetaSearch.h"
+
+#include "CoreRules/BoardGeometry.h"
+#include "CoreRules/IsmctsSearch.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace
+{
+constexpr int32_t InfiniteScore = FAlphaBetaSearch::MateScore + 1;
+constexpr int32_t MateThreshold = FAlphaBetaSearch::MateScore - FAlphaBetaSearch::MaxPly;
+
+constexpr int32_t TableMoveOrder = 1 << 30;
+constexpr int32_t CaptureOrder = 1 << 24;
+constexpr int32_t KillerOrder = 1 << 22;
+constexpr int32_t MaxHistoryOrder = 1 << 20;
+
+// Indexed by ERoleType: King, Advisor, Elephant, Horse, Rook, Cannon, Pawn.
+constexpr std::array<int32_t, 7> RoleValues = {0, 200, 200, 400, 900, 450, 100};
+constexpr int32_t CrossedPawnBonus = 100;
+constexpr int32_t KingOrderValue = 10000;
+
+int32_t ToSideIndex(ESide Side) noexcept
+{
+    return Side == ESide::Red ? 0 : 1;
+}
+
+int32_t ToCellIndex(const FBoardPos& Pos) noexcept
+{
+    return static_cast<int32_t>(Pos.Y) * 9 + static_cast<int32_t>(Pos.X);
+}
+
+ERoleType GetActiveRole(const FPieceState& Piece) noexcept
+{
+    return Piece.PieceState == EPieceState::HiddenSurface ? Piece.SurfaceRole : Piece.ActualRole;
+}
+
+int32_t GetRoleValue(ERoleType Role) noexcept
+{
+    return RoleValues[static_cast<size_t>(Role)];
+}
+
+// A hidden piece moves by its surface role until its first capture reveals the actual one, so it is worth the
+// average of its surface role and the expected actual role (HiddenRosterValue, the mean over its side's unrevealed
+// pieces). Frozen pieces can neither move nor attack and keep only a quarter of their value.
+int32_t GetPieceValue(const FPieceState& Piece, int32_t HiddenRosterValue) noexcept
+{
+    int32_t Value = Piece.PieceState == EPieceState::HiddenSurface
+                        ? (GetRoleValue(Piece.SurfaceRole) + HiddenRosterValue) / 2
+                        : GetRoleValue(Piece.ActualRole);
+    if (GetActiveRole(Piece) == ERoleType::Pawn &&
+        BoardGeometry.CrossedRiver[ToSideIndex(Piece.Side)][ToCellIndex(Piece.Pos)])
+    {
+        Value += CrossedPawnBonus;
+    }
+    return Piece.bFrozen ? Value / 4 : Value;
+}
+
+int32_t GetOrderValue(const FPieceState& Piece) noexcept
+{
+    return Piece.ActualRole == ERoleType::King ? KingOrderValue : GetRoleValue(GetActiveRole(Piece));
+}
+
+int32_t ToTableScore(int32_t Score, int32_t Ply) noexcept
+{
+    if (Score >= MateThreshold)
+    {
+        return Score + Ply;
+    }
+    if (Score <= -MateThreshold)
+    {
+        return Score - Ply;
+    }
+    return Score;
+}
+
+int32_t FromTableScore(int32_t Score, int32_t Ply) noexcept
+{
+    if (Score >= MateThreshold)
+    {
+        return Score - Ply;
+    }
+    if (Score <= -MateThreshold)
+    {
+        return Score + Ply;
+    }
+    return Score;
+}
+
+// Moves the highest-ordered remaining move to Index.
+void PickNextMove(FMoveList& Moves, std::array<int32_t, MaxLegalMovesPerPosition>& Scores, size_t Index) noexcept
+{
+    size_t BestIndex = Index;
+    for (size_t Candidate = Index + 1; Candidate < Moves.Size(); ++Candidate)
+    {
+        if (Scores[Candidate] > Scores[BestIndex])
+        {
+            BestIndex = Candidate;
+        }
+    }
+    if (BestIndex != Index)
+    {
+        std::swap(Moves[Index], Moves[BestIndex]);
+        std::swap(Scores[Index], Scores[BestIndex]);
+    }
+}
+}
+
+FAlphaBetaSearch::FAlphaBetaSearch(size_t TranspositionTableMegabytes)
+    : OwnedTable(std::make_unique<FTranspositionTable>(TranspositionTableMegabytes))
+    , Table(OwnedTable.get())
+{
+}
+
+FAlphaBetaSearch::FAlphaBetaSearch(FTranspositionTable& SharedTable)
+    : Table(&SharedTable)
+{
+}
+
+void FAlphaBetaSearch::Clear() noexcept
+{
+    Table->Clear();
+    History = {};
+}
+
+FTranspositionTable& FAlphaBetaSearch::GetTranspositionTable() noexcept
+{
+    return *Table;
+}
+
+void FAlphaBetaSearch::SetTablebase(const FEndgameTablebase* InTablebase) noexcept
+{
+    Tablebase = InTablebase;
+}
+
+int32_t FAlphaBetaSearch::Evaluate(const FGameState& State) noexcept
+{
+    // The roster counts captured unrevealed pieces too: which ids were taken is public, their roles are not, so
+    // only the whole unrevealed set is invariant under a re-deal. The king is worth 0 and only lowers the mean.
+    std::array<int32_t, 2> HiddenValueSum{};
+    std::array<int32_t, 2> HiddenCount{};
+    for (const FPieceState& Piece : State.Pieces)
+    {
+        if (Piece.PieceState == EPieceState::HiddenSurface)
+        {
+            HiddenValueSum[ToSideIndex(Piece.Side)] += GetRoleValue(Piece.ActualRole);
+            ++HiddenCount[ToSideIndex(Piece.Side)];
+        }
+    }
+
+    std::array<int32_t, 2> Material{};
+    for (const FPieceState& Piece : State.Pieces)
+    {
+        if (Piece.bAlive)
+        {
+            const int32_t PieceSideIndex = ToSideIndex(Piece.Side);
+            const int32_t HiddenRosterValue =
+                HiddenCount[PieceSideIndex] > 0 ? HiddenValueSum[PieceSideIndex] / HiddenCount[PieceSideIndex] : 0;
+            Material[PieceSideIndex] += GetPieceValue(Piece, HiddenRosterValue);
+        }
+    }
+
+    const int32_t SideIndex = ToSideIndex(State.CurrentTurn);
+    return Material[SideIndex] - Material[1 - SideIndex];
+}
+
+FSearchResult FAlphaBetaSearch::Search(FMatchReferee& InReferee, const FSearchLimits& InLimits)
+{
+    Referee = &InReferee;
+    Limits = InLimits;
+    StartTime = std::chrono::steady_clock::now();
+    Nodes = 0;
+    bStopRequested = false;
+    bBudgetArmed = false;
+    Killers = {};
+    if (OwnedTable != nullptr)
+    {
+        Table->NewSearch();
+    }
+    for (auto& PieceHistory : History)
+    {
+        for (int32_t& Value : PieceHistory)
+        {
+            Value /= 4;
+        }
+    }
+
+    FSearchResult Result{};
+    const FGameState& State = Referee->GetState();
+    if (State.Phase != EGamePhase::Battle || State.Result != EGameResult::Ongoing)
+    {
+        return Result;
+    }
+
+    const ESide Side = State.CurrentTurn;
+    Result.bHasCommand = true;
+    Result.BestCommand.Side = Side;
+
+    FMoveList RootMoves;
+    Referee->GenerateLegalMoves(Side, RootMoves);
+    if (RootMoves.IsEmpty())
+    {
+        const bool bCanPass = Referee->CanPass(Side);
+        Result.BestCommand.CommandType = bCanPass ? ECommandType::Pass : ECommandType::Resign;
+        Result.Score = bCanPass ? 0 : -MateScore;
+        return Result;
+    }
+
+    FMoveKey BestMove = ToMoveKey(RootMoves[0]);
+    const int32_t MaxDepth = std::clamp(Limits.MaxDepth, 1, MaxPly - 1);
+    for (int32_t Depth = 1; Depth <= MaxDepth; ++Depth)
+    {
+        RootBestMove = FMoveKey{};
+        const int32_t Score = DispatchRulePolicy(Referee->GetRulePolicyKind(), [&]<typename TPolicy>() {
+            return SearchNode<TPolicy>(Depth, -InfiniteScore, InfiniteScore, 0);
+        });
+        if (bStopRequested)
+        {
+            break;
+        }
+
+        Result.Score = Score;
+        Result.CompletedDepth = Depth;
+        if (RootBestMove.PieceId != 0xFF)
+        {
+            BestMove = RootBestMove;
+        }
+        bBudgetArmed = true;
+
+        const bool bOutOfTime = Limits.TimeBudgetMs > 0 &&
+                                std::chrono::steady_clock::now() - StartTime >= std::chrono::milliseconds(Limits.TimeBudgetMs);
+        const bool bOutOfNodes = Limits.MaxNodes > 0 && Nodes >= Limits.MaxNodes;
+        if (bOutOfTime || bOutOfNodes || std::abs(Score) >= MateThreshold)
+        {
+            break;
+        }
+    }
+
+    Result.BestCommand.CommandType = ECommandType::Move;
+    Result.BestCommand.Move = RootMoves[0];
+    for (const FMoveAction& Move : RootMoves)
+    {
+        if (ToMoveKey(Move) == BestMove)
+        {
+            Result.BestCommand.Move = Move;
+            break;
+        }
+    }
+    Result.Nodes = Nodes;
+    Result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    return Result;
+}
+
+FSearchResult FAlphaBetaSearch::SearchFromView(const FMatchReferee& InReferee, const FSearchLimits& InLimits, uint64_t Seed)
+{
+    const FGameState& State = InReferee.GetState();
+    if (State.Phase != EGamePhase::Battle || State.Result != EGameResult::Ongoing)
+    {
+        return FSearchResult{};
+    }
+
+    const ESide Side = State.CurrentTurn;
+    FMoveList RealMoves;
+    InReferee.GenerateLegalMoves(Side, RealMoves);
+    if (RealMoves.IsEmpty())
+    {
+        FSearchResult Result{};
+        const bool bCanPass = InReferee.CanPass(Side);
+        Result.bHasCommand = true;
+        Result.BestCommand.Side = Side;
+        Result.BestCommand.CommandType = bCanPass ? ECommandType::Pass : ECommandType::Resign;
+        Result.Score = bCanPass ? 0 : -MateScore;
+        return Result;
+    }
+
+    // A failed draw leaves the last rejected sample loaded; it still only differs from the truth in hidden ids.
+    constexpr int32_t MaxDeterminizationAttempts = 32;
+    uint64_t RngState = Seed;
+    FMatchReferee Sample(InReferee.GetRuleConfig());
+    FIsmctsSearch::LoadDeterminization(State, Side, RngState, MaxDeterminizationAttempts, Sample);
+    FSearchResult Result = Search(Sample, InLimits);
+
+    // The sample can disagree with the real position about the opposing king (flying general, mate), so the move
+    // is re-validated; ValidateMove also swaps in the real captured piece id.
+    std::optional<FMoveAction> RealMove;
+    if (Result.BestCommand.CommandType == ECommandType::Move && Result.BestCommand.Move.has_value())
+    {
+        RealMove = InReferee.ValidateMove(Result.BestCommand.Move.value());
+    }
+    Result.bHasCommand = true;
+    Result.BestCommand.Side = Side;
+    Result.BestCommand.CommandType = ECommandType::Move;
+    Result.BestCommand.Move = RealMove.value_or(RealMoves[0]);
+    return Result;
+}
+
+template <typename TPolicy>
+int32_t FAlphaBetaSearch::SearchNode(int32_t Depth, int32_t Alpha, int32_t Beta, int32_t Ply)
+{
+    if (ShouldStop())
+    {
+        return 0;
+    }
+
+    const FGameState& State = Referee->GetState();
+    const ESide Side = State.CurrentTurn;
+    if (State.KingCells[ToSideIndex(Side)] < 0)
+    {
+        return -MateScore + Ply;
+    }
+    if (Ply >= MaxPly - 1)
+    {
+        return Evaluate(State);
+    }
+
+    FTablebaseProbeResult ProbeResult{};
+    if (Ply > 0 && Tablebase != nullptr && Tablebase->Probe(*Referee, ProbeResult))
+    {
+        switch (ProbeResult.Outcome)
+        {
+        case ETablebaseOutcome::Win:
+            return MateScore - (Ply + ProbeResult.Distance);
+        case ETablebaseOutcome::Loss:
+            return -MateScore + Ply + ProbeResult.Distance;
+        default:
+            return 0;
+        }
+    }
+
+    const bool bInCheck = Referee->IsSideInCheck(Side);
+    if (bInCheck)
+    {
+        ++Depth;
+    }
+    if (Depth <= 0)
+    {
+        return SearchQuiescence<TPolicy>(Alpha, Beta, Ply);
+    }
+    ++Nodes;
+
+    const uint64_t Key = State.PositionHash;
+    FMoveKey TableMove{};
+    FTranspositionData Entry{};
+    if (Table->Probe(Key, Entry))
+    {
+        TableMove = FMoveKey{Entry.MovePieceId, Entry.MoveToCell};
+        if (Ply > 0 && Entry.Depth >= Depth)
+        {
+            const int32_t TableScore = FromTableScore(Entry.Score, Ply);
+            if (Entry.Bound == ETranspositionBound::Exact || (Entry.Bound == ETranspositionBound::Lower && TableScore >= Beta) ||
+                (Entry.Bound == ETranspositionBound::Upper && TableScore <= Alpha))
+            {
+                return TableScore;
+            }
+        }
+    }
+
+    FMoveList Moves;
+    Referee->GenerateLegalMoves(Side, Moves);
+    if (Moves.IsEmpty())
+    {
+        return bInCheck ? -MateScore + Ply : SearchPass<TPolicy>(Depth, Alpha, Beta, Ply);
+    }
+
+    std::array<int32_t, MaxLegalMovesPerPosition> Scores;
+    ScoreMoves(Moves, TableMove, Ply, Scores);
+
+    const int32_t OriginalAlpha = Alpha;
+    int32_t BestScore = -InfiniteScore;
+    FMoveKey BestMove{};
+    for (size_t Index = 0; Index < Moves.Size(); ++Index)
+    {
+        PickNextMove(Moves, Scores, Index);
+        const FMoveAction& Move = Moves[Index];
+
+        FMoveUndo Undo{};
+        Referee->MakeMove<TPolicy>(Move, Undo);
+        const int32_t Score = -SearchNode<TPolicy>(Depth - 1, -Beta, -Alpha, Ply + 1);
+        Referee->UnmakeMove(Undo);
+        if (bStopRequested)
+        {
+            return 0;
+        }
+
+        if (Score <= BestScore)
+        {
+            continue;
+        }
+        BestScore = Score;
+        BestMove = ToMoveKey(Move);
+        if (Ply == 0)
+        {
+            RootBestMove = BestMove;
+        }
+        if (Score <= Alpha)
+        {
+            continue;
+        }
+        Alpha = Score;
+        if (Alpha < Beta)
+        {
+            continue;
+        }
+
+        if (!Move.CapturedPieceId.has_value())
+        {
+            if (!(Killers[Ply][0] == BestMove))
+            {
+                Killers[Ply][1] = Killers[Ply][0];
+                Killers[Ply][0] = BestMove;
+            }
+            int32_t& HistoryValue = History[Move.PieceId % 32][ToCellIndex(Move.To)];
+            HistoryValue = std::min(HistoryValue + Depth * Depth, MaxHistoryOrder);
+        }
+        break;
+    }
+
+    FTranspositionData Stored{};
+    Stored.Score = static_cast<int16_t>(ToTableScore(BestScore, Ply));
+    Stored.Depth = static_cast<int8_t>(Depth);
+    Stored.Bound = BestScore <= OriginalAlpha ? ETranspositionBound::Upper
+                                              : (BestScore >= Beta ? ETranspositionBound::Lower : ETranspositionBound::Exact);
+    Stored.MovePieceId = BestMove.PieceId;
+    Stored.MoveToCell = BestMove.ToCell;
+    Table->Store(Key, Stored);
+    return BestScore;
+}
+
+template <typename TPolicy>
+int32_t FAlphaBetaSearch::SearchQuiescence(int32_t Alpha, int32_t Beta, int32_t Ply)
+{
+    if (ShouldStop())
+    {
+        return 0;
+    }
+    ++Nodes;
+
+    const FGameState& State = Referee->GetState();
+    const ESide Side = State.CurrentTurn;
+    if (State.KingCells[ToSideIndex(Side)] < 0)
+    {
+        return -MateScore + Ply;
+    }
+    if (Ply >= MaxPly - 1)
+    {
+        return Evaluate(State);
+    }
+
+    const bool bInCheck = Referee->IsSideInCheck(Side);
+    FMoveList Moves;
+    Referee->GenerateLegalMoves(Side, Moves);
+
+    int32_t BestScore = -MateScore + Ply;
+    if (!bInCheck)
+    {
+        BestScore = Evaluate(State);
+        if (BestScore >= Beta)
+        {
+            return BestScore;
+        }
+        Alpha = std::max(Alpha, BestScore);
+    }
+    if (Moves.IsEmpty())
+    {
+        return BestScore;
+    }
+
+    std::array<int32_t, MaxLegalMovesPerPosition> Scores;
+    ScoreMoves(Moves, FMoveKey{}, Ply, Scores);
+    for (size_t Index = 0; Index < Moves.Size(); ++Index)
+    {
+        PickNextMove(Moves, Scores, Index);
+        const FMoveAction& Move = Moves[Index];
+        // Captures sort ahead of every quiet move, so the first quiet move ends the capture list.
+        if (!bInCheck && !Move.CapturedPieceId.has_value())
+        {
+            break;
+        }
+
+        FMoveUndo Undo{};
+        Referee->MakeMove<TPolicy>(Move, Undo);
+        const int32_t Score = -SearchQuiescence<TPolicy>(-Beta, -Alpha, Ply + 1);
+        Referee->UnmakeMove(Undo);
+        if (bStopRequested)
+        {
+            return 0;
+        }
+
+        if (Score > BestScore)
+        {
+            BestScore = Score;
+            if (Score > Alpha)
+            {
+                Alpha = Score;
+                if (Alpha >= Beta)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    return BestScore;
+}
+
+// No legal move and not in check: the side passes when the rules allow it (a second pass in a row is a draw) and
+// has to resign otherwise.
+template <typename TPolicy>
+int32_t FAlphaBetaSearch::SearchPass(int32_t Depth, int32_t Alpha, int32_t Beta, int32_t Ply)
+{
+    const FRuleConfig& RuleConfig = Referee->GetRuleConfig();
+    if (!TPolicy::AllowPassWhenNoLegalMove(RuleConfig))
+    {
+        return -MateScore + Ply;
+    }
+    if (TPolicy::DoublePassIsDraw(RuleConfig) && Referee->GetState().PassCount >= 1)
+    {
+        return 0;
+    }
+
+    FMoveUndo Undo{};
+    Referee->MakePass(Undo);
+    const int32_t Score = -SearchNode<TPolicy>(Depth - 1, -Beta, -Alpha, Ply + 1);
+    Referee->UnmakePass(Undo);
+    return Score;
+}
+
+void FAlphaBetaSearch::ScoreMoves(
+    const FMoveList& Moves,
+    FMoveKey TableMove,
+    int32_t Ply,
+    std::array<int32_t, MaxLegalMovesPerPosition>& OutScores) const
+{
+    const FGameState& State = Referee->GetState();
+    for (size_t Index = 0; Index < Moves.Size(); ++Index)
+    {
+        const FMoveAction& Move = Moves[Index];
+        const FMoveKey MoveKey = ToMoveKey(Move);
+        if (MoveKey == TableMove)
+        {
+            OutScores[Index] = TableMoveOrder;
+        }
+        else if (Move.CapturedPieceId.has_value())
+        {
+            OutScores[Index] = CaptureOrder + GetOrderValue(State.Pieces[Move.CapturedPieceId.value()]) * 16 -
+                               GetOrderValue(State.Pieces[Move.PieceId]) / 16;
+        }
+        else if (MoveKey == Killers[Ply][0])
+        {
+            OutScores[Index] = KillerOrder;
+        }
+        else if (MoveKey == Killers[Ply][1])
+        {
+            OutScores[Index] = KillerOrder - 1;
+        }
+        else
+        {
+            OutScores[Index] = History[Move.PieceId % 32][ToCellIndex(Move.To)];
+        }
+    }
+}
+
+bool FAlphaBetaSearch::ShouldStop()
+{
+    if (bStopRequested || !bBudgetArmed)
+    {
+        return bStopRequested;
+    }
+
+    if (Limits.MaxNodes > 0 && Nodes >= Limits.MaxNodes)
+    {
+        bStopRequested = true;
+    }
+    else if (Limits.TimeBudgetMs > 0 && (Nodes & 1023) == 0 &&
+             std::chrono::steady_clock::now() - StartTime >= std::chrono::milliseconds(Limits.TimeBudgetMs))
+    {
+        bStopRequested = true;
+    }
+    return bStopRequested;
+}
+
+FAlphaBetaSearch::FMoveKey FAlphaBetaSearch::ToMoveKey(const FMoveAction& Move) noexcept
+{
+    return FMoveKey{static_cast<uint8_t>(Move.PieceId), static_cast<uint8_t>(ToCellIndex(Move.To))};
+}
@@ -0,0 +1,631 @@
+#include "CoreRules/BatchMatchEnv.h"
+
+#include "CoreRules/BoardGeometry.h"
+#include "CoreRules/MatchReferee.h"
+#include "CoreRules/RandomSetup.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+enum EObservationPlane : int32_t
+{
+    OwnActualRolePlane = 0,
+    OwnActiveRolePlane = 7,
+    OwnRevealedPlane = 14,
+    OwnFrozenPlane = 15,
+    OpponentVisibleRolePlane = 16,
+    OpponentRevealedPlane = 23,
+    OpponentFrozenPlane = 24,
+    BlackToMovePlane = 25,
+    PassCountPlane = 26
+};
+
+enum EStepEnd : uint8_t
+{
+    StepContinues,
+    StepTerminated,
+    StepTruncated
+};
+
+constexpr uint8_t ActualRoleMask = 0x0F;
+
+// Piece ids are laid out in setup-slot order, so a piece's actual role is the surface role of its own slot.
+constexpr ERoleType GetActualRoleForPieceId(int32_t PieceId) noexcept
+{
+    return BoardGeometryDetail::RedSetupSlots[PieceId % 16].SurfaceRole;
+}
+
+bool IsRolePositionLegal(ERoleType Role, int32_t SideIndex, int32_t Cell) noexcept
+{
+    switch (Role)
+    {
+    case ERoleType::King:
+        return BoardGeometry.Palace[SideIndex][Cell];
+    case ERoleType::Advisor:
+        return BoardGeometry.AdvisorPoint[SideIndex][Cell];
+    case ERoleType::Elephant:
+        return BoardGeometry.ElephantPoint[SideIndex][Cell];
+    default:
+        return true;
+    }
+}
+
+int32_t GetPieceSideIndex(uint8_t Flags) noexcept
+{
+    return (Flags & FPackedPiece::BlackSideFlag) != 0 ? 1 : 0;
+}
+
+ESide GetOppositeSide(ESide Side) noexcept
+{
+    return Side == ESide::Red ? ESide::Black : ESide::Red;
+}
+}
+
+FBatchMatchEnv::FBatchMatchEnv(const FBatchMatchEnvConfig& InConfig)
+    : Config(InConfig)
+{
+    const size_t GameCount = static_cast<size_t>(std::max(Config.GameCount, 0));
+    Config.GameCount = static_cast<int32_t>(GameCount);
+    BoardCells.resize(GameCount * CellCount, FPackedGameState::EmptyCell);
+    PieceCells.resize(GameCount * PieceCount, FPackedPiece::OffBoardCell);
+    PieceRoles.resize(GameCount * PieceCount);
+    PieceFlags.resize(GameCount * PieceCount);
+    SideOccupancy.resize(GameCount * 2);
+    KingCells.resize(GameCount * 2, -1);
+    CurrentTurns.resize(GameCount, ESide::Red);
+    PassCounts.resize(GameCount);
+    TurnIndices.resize(GameCount);
+    RngStates.resize(GameCount);
+    EpisodePlies.resize(GameCount);
+    LegalActions.resize(GameCount * MaxLegalMovesPerPosition);
+    LegalActionCounts.resize(GameCount);
+    InCheck.resize(GameCount);
+    StepRewards.resize(GameCount);
+    StepEnds.resize(GameCount);
+}
+
+int32_t FBatchMatchEnv::GetGameCount() const noexcept
+{
+    return Config.GameCount;
+}
+
+FPackedGameState FBatchMatchEnv::GetGameState(int32_t GameIndex) const noexcept
+{
+    const size_t Game = static_cast<size_t>(GameIndex);
+    FPackedGameState Packed{};
+    Packed.TurnIndex = TurnIndices[Game];
+    Packed.PassCount = PassCounts[Game];
+    std::copy_n(BoardCells.begin() + Game * CellCount, CellCount, Packed.BoardCells.begin());
+    for (int32_t PieceId = 0; PieceId < PieceCount; ++PieceId)
+    {
+        const size_t Slot = Game * PieceCount + PieceId;
+        Packed.Pieces[PieceId] = FPackedPiece{PieceCells[Slot], PieceRoles[Slot], PieceFlags[Slot]};
+    }
+    Packed.PieceCount = static_cast<uint8_t>(PieceCount);
+    Packed.Phase = EGamePhase::Battle;
+    Packed.CurrentTurn = CurrentTurns[Game];
+    Packed.Result = EGameResult::Ongoing;
+    Packed.EndReason = EEndReason::None;
+    Packed.SetupFlags = FPackedGameState::RedCommittedFlag | FPackedGameState::BlackCommittedFlag |
+                        FPackedGameState::RedRevealedFlag | FPackedGameState::BlackRevealedFlag;
+    // The batch does not maintain hashes on its hot path; the gathered image gets the referee's full recompute.
+    Packed.PositionHash = FMatchReferee::ComputePositionHash(FGameStatePacker::Unpack(Packed));
+    return Packed;
+}
+
+void FBatchMatchEnv::Reset(uint64_t Seed, const FBatchStepBuffers& Buffers)
+{
+    uint64_t SeedState = Seed;
+    for (int32_t GameIndex = 0; GameIndex < Config.GameCount; ++GameIndex)
+    {
+        RngStates[GameIndex] = NextSplitMix64(SeedState);
+        ResetGame(GameIndex);
+
+        if (Buffers.Rewards != nullptr)
+        {
+            Buffers.Rewards[GameIndex] = 0.0f;
+        }
+        if (Buffers.Terminated != nullptr)
+        {
+            Buffers.Terminated[GameIndex] = 0;
+        }
+        if (Buffers.Truncated != nullptr)
+        {
+            Buffers.Truncated[GameIndex] = 0;
+        }
+        WriteGameOutputs(GameIndex, Buffers);
+    }
+}
+
+void FBatchMatchEnv::Step(const int32_t* Actions, const FBatchStepBuffers& Buffers)
+{
+    // Apply every game's action against the legal list cached by the previous step.
+    for (int32_t GameIndex = 0; GameIndex < Config.GameCount; ++GameIndex)
+    {
+        const int32_t Action = Actions[GameIndex];
+        StepRewards[GameIndex] = 0.0f;
+        StepEnds[GameIndex] = StepContinues;
+        if (!IsActionLegal(GameIndex, Action))
+        {
+            StepRewards[GameIndex] = -1.0f;
+            StepEnds[GameIndex] = StepTerminated;
+        }
+        else if (Action == PassAction)
+        {
+            ++PassCounts[GameIndex];
+            ++TurnIndices[GameIndex];
+            CurrentTurns[GameIndex] = GetOppositeSide(CurrentTurns[GameIndex]);
+            if (Config.RuleConfig.bDoublePassIsDraw && PassCounts[GameIndex] >= 2)
+            {
+                StepEnds[GameIndex] = StepTerminated;
+            }
+        }
+        else if (ApplyMove(GameIndex, Action / CellCount, Action % CellCount))
+        {
+            StepRewards[GameIndex] = 1.0f;
+            StepEnds[GameIndex] = StepTerminated;
+        }
+    }
+
+    // One legal generation per running game covers its mask, mate detection and pass legality.
+    for (int32_t GameIndex = 0; GameIndex < Config.GameCount; ++GameIndex)
+    {
+        if (StepEnds[GameIndex] != StepContinues)
+        {
+            continue;
+        }
+
+        GenerateLegalActions(GameIndex);
+        if (InCheck[GameIndex] != 0 && LegalActionCounts[GameIndex] == 0)
+        {
+            StepRewards[GameIndex] = 1.0f;
+            StepEnds[GameIndex] = StepTerminated;
+        }
+        else if (++EpisodePlies[GameIndex] >= Config.MaxPlies)
+        {
+            StepEnds[GameIndex] = StepTruncated;
+        }
+    }
+
+    for (int32_t GameIndex = 0; GameIndex < Config.GameCount; ++GameIndex)
+    {
+        if (StepEnds[GameIndex] != StepContinues)
+        {
+            ResetGame(GameIndex);
+        }
+
+        if (Buffers.Rewards != nullptr)
+        {
+            Buffers.Rewards[GameIndex] = StepRewards[GameIndex];
+        }
+        if (Buffers.Terminated != nullptr)
+        {
+            Buffers.Terminated[GameIndex] = StepEnds[GameIndex] == StepTerminated ? 1 : 0;
+        }
+        if (Buffers.Truncated != nullptr)
+        {
+            Buffers.Truncated[GameIndex] = StepEnds[GameIndex] == StepTruncated ? 1 : 0;
+        }
+        WriteGameOutputs(GameIndex, Buffers);
+    }
+}
+
+void FBatchMatchEnv::ResetGame(int32_t GameIndex)
+{
+    const size_t Game = static_cast<size_t>(GameIndex);
+    std::fill_n(BoardCells.begin() + Game * CellCount, CellCount, FPackedGameState::EmptyCell);
+    std::fill_n(PieceCells.begin() + Game * PieceCount, PieceCount, FPackedPiece::OffBoardCell);
+    std::fill_n(PieceFlags.begin() + Game * PieceCount, PieceCount, uint8_t{0});
+
+    // Same placement the referee's commit/reveal produces: every piece hidden under its slot's surface role.
+    for (const ESide Side : {ESide::Red, ESide::Black})
+    {
+        const int32_t SideIndex = Side == ESide::Red ? 0 : 1;
+        FBoardBitboard& Occupancy = SideOccupancy[Game * 2 + SideIndex];
+        Occupancy = FBoardBitboard{};
+        KingCells[Game * 2 + SideIndex] = -1;
+
+        const FSetupPlain Setup = BuildRandomSetup(Side, RngStates[Game]);
+        for (const FSetupPlacement& Placement : Setup.Placements)
+        {
+            const int32_t Cell = Placement.TargetPos.Y * 9 + Placement.TargetPos.X;
+            const size_t Slot = Game * PieceCount + Placement.PieceId;
+            const ERoleType ActualRole = GetActualRoleForPieceId(Placement.PieceId);
+            const ERoleType SurfaceRole = BoardGeometry.SurfaceRole[SideIndex][Cell];
+            BoardCells[Game * CellCount + Cell] = Placement.PieceId;
+            PieceCells[Slot] = static_cast<uint8_t>(Cell);
+            PieceRoles[Slot] = static_cast<uint8_t>(static_cast<uint8_t>(ActualRole) | (static_cast<uint8_t>(SurfaceRole) << 4));
+            PieceFlags[Slot] = static_cast<uint8_t>(FPackedPiece::AliveFlag | (SideIndex == 1 ? FPackedPiece::BlackSideFlag : 0));
+            Occupancy.Set(Cell);
+            if (ActualRole == ERoleType::King)
+            {
+                KingCells[Game * 2 + SideIndex] = static_cast<int8_t>(Cell);
+            }
+        }
+    }
+
+    CurrentTurns[Game] = ESide::Red;
+    PassCounts[Game] = 0;
+    TurnIndices[Game] = 0;
+    EpisodePlies[Game] = 0;
+    GenerateLegalActions(GameIndex);
+}
+
+bool FBatchMatchEnv::IsActionLegal(int32_t GameIndex, int32_t Action) const noexcept
+{
+    if (Action == PassAction)
+    {
+        return CanPass(GameIndex);
+    }
+
+    const uint16_t* Begin = LegalActions.data() + static_cast<size_t>(GameIndex) * MaxLegalMovesPerPosition;
+    const uint16_t* End = Begin + LegalActionCounts[GameIndex];
+    return Action >= 0 && Action < PassAction && std::find(Begin, End, static_cast<uint16_t>(Action)) != End;
+}
+
+bool FBatchMatchEnv::ApplyMove(int32_t GameIndex, int32_t FromCell, int32_t ToCell) noexcept
+{
+    const size_t Game = static_cast<size_t>(GameIndex);
+    uint8_t* Board = BoardCells.data() + Game * CellCount;
+    const int32_t PieceId = Board[FromCell];
+    const size_t MoverSlot = Game * PieceCount + PieceId;
+    const int32_t SideIndex = GetPieceSideIndex(PieceFlags[MoverSlot]);
+    const int32_t OpponentIndex = 1 - SideIndex;
+    const ERoleType ActualRole = static_cast<ERoleType>(PieceRoles[MoverSlot] & ActualRoleMask);
+
+    bool bKingCaptured = false;
+    const uint8_t CapturedId = Board[ToCell];
+    if (CapturedId != FPackedGameState::EmptyCell)
+    {
+        const size_t CapturedSlot = Game * PieceCount + CapturedId;
+        PieceCells[CapturedSlot] = FPackedPiece::OffBoardCell;
+        PieceFlags[CapturedSlot] &= static_cast<uint8_t>(~(FPackedPiece::AliveFlag | FPackedPiece::FrozenFlag));
+        SideOccupancy[Game * 2 + OpponentIndex].Clear(ToCell);
+        if (KingCells[Game * 2 + OpponentIndex] == ToCell)
+        {
+            KingCells[Game * 2 + OpponentIndex] = -1;
+            bKingCaptured = true;
+        }
+
+        uint8_t& MoverFlags = PieceFlags[MoverSlot];
+        if ((MoverFlags & FPackedPiece::RevealedFlag) == 0 && Config.RuleConfig.bRevealOnFirstCapture)
+        {
+            MoverFlags |= FPackedPiece::RevealedFlag;
+            if (Config.RuleConfig.bFreezeIfIllegalAfterReveal && !IsRolePositionLegal(ActualRole, SideIndex, ToCell))
+            {
+                MoverFlags |= FPackedPiece::FrozenFlag;
+            }
+        }
+        MoverFlags |= FPackedPiece::HasCapturedFlag;
+    }
+
+    Board[FromCell] = FPackedGameState::EmptyCell;
+    Board[ToCell] = static_cast<uint8_t>(PieceId);
+    PieceCells[MoverSlot] = static_cast<uint8_t>(ToCell);
+    SideOccupancy[Game * 2 + SideIndex].Clear(FromCell);
+    SideOccupancy[Game * 2 + SideIndex].Set(ToCell);
+    if (ActualRole == ERoleType::King)
+    {
+        KingCells[Game * 2 + SideIndex] = static_cast<int8_t>(ToCell);
+    }
+
+    PassCounts[Game] = 0;
+    ++TurnIndices[Game];
+    CurrentTurns[Game] = GetOppositeSide(CurrentTurns[Game]);
+    return bKingCaptured;
+}
+
+void FBatchMatchEnv::GenerateLegalActions(int32_t GameIndex) noexcept
+{
+    const size_t Game = static_cast<size_t>(GameIndex);
+    const int32_t SideIndex = CurrentTurns[Game] == ESide::Red ? 0 : 1;
+    const int32_t KingCell = KingCells[Game * 2 + SideIndex];
+    uint16_t* OutActions = LegalActions.data() + Game * MaxLegalMovesPerPosition;
+    uint16_t Count = 0;
+    if (KingCell < 0)
+    {
+        InCheck[Game] = 1;
+        LegalActionCounts[Game] = 0;
+        return;
+    }
+
+    const std::array<FBoardBitboard, 2> Occupancy{SideOccupancy[Game * 2], SideOccupancy[Game * 2 + 1]};
+    const bool bInCheck = IsKingExposed(GameIndex, SideIndex, KingCell, KingCells[Game * 2 + 1 - SideIndex], Occupancy);
+    InCheck[Game] = bInCheck ? 1 : 0;
+
+    // Out of check, only the king itself or a piece leaving or entering a line through the king or one of its
+    // diagonal neighbours (horse legs, elephant eyes) can expose it; such moves get the full test.
+    FBoardBitboard SensitiveCells{};
+    for (const EBoardDirection Direction : AllBoardDirections)
+    {
+        SensitiveCells = SensitiveCells | GetRayMask(Direction, KingCell);
+    }
+    const int32_t KingX = KingCell % 9;
+    const int32_t KingY = KingCell / 9;
+    for (const int32_t DeltaX : {-1, 1})
+    {
+        for (const int32_t DeltaY : {-1, 1})
+        {
+            if (BoardGeometryDetail::IsOnBoard(KingX + DeltaX, KingY + DeltaY))
+            {
+                SensitiveCells.Set(BoardGeometryDetail::ToCell(KingX + DeltaX, KingY + DeltaY));
+            }
+        }
+    }
+
+    for (int32_t PieceId = SideIndex * 16; PieceId < SideIndex * 16 + 16; ++PieceId)
+    {
+        const size_t Slot = Game * PieceCount + PieceId;
+        if ((PieceFlags[Slot] & FPackedPiece::AliveFlag) == 0 || (PieceFlags[Slot] & FPackedPiece::FrozenFlag) != 0)
+        {
+            continue;
+        }
+
+        const int32_t FromCell = PieceCells[Slot];
+        const bool bKing = static_cast<ERoleType>(PieceRoles[Slot] & ActualRoleMask) == ERoleType::King;
+        const bool bFromSensitive = bKing || SensitiveCells.Test(FromCell);
+        FBoardBitboard Targets = GetPseudoTargets(GameIndex, PieceId);
+        while (!Targets.IsEmpty())
+        {
+            const int32_t ToCell = Targets.PopLowestCell();
+            const bool bNeedsTest = bInCheck || bFromSensitive || SensitiveCells.Test(ToCell);
+            if (!bNeedsTest || IsKingSafeAfterMove(GameIndex, PieceId, FromCell, ToCell))
+            {
+                OutActions[Count++] = static_cast<uint16_t>(FromCell * CellCount + ToCell);
+            }
+        }
+    }
+    LegalActionCounts[Game] = Count;
+}
+
+FBoardBitboard FBatchMatchEnv::GetPseudoTargets(int32_t GameIndex, int32_t PieceId) const noexcept
+{
+    const size_t Game = static_cast<size_t>(GameIndex);
+    const int32_t SideIndex = GetPieceSideIndex(PieceFlags[Game * PieceCount + PieceId]);
+    const int32_t FromCell = PieceCells[Game * PieceCount + PieceId];
+    const FBoardBitboard& OwnOccupancy = SideOccupancy[Game * 2 + SideIndex];
+    const FBoardBitboard& EnemyOccupancy = SideOccupancy[Game * 2 + 1 - SideIndex];
+    const FBoardBitboard Occupancy = OwnOccupancy | EnemyOccupancy;
+
+    FBoardBitboard Targets{};
+    // Steps whose block cell (horse leg, elephant eye) is occupied are skipped.
+    auto AddSteps = [&Targets, &Occupancy](const FCellSteps& Steps) {
+        for (uint8_t StepIndex = 0; StepIndex < Steps.Count; ++StepIndex)
+        {
+            const int32_t BlockCell = Steps.BlockCells[StepIndex];
+            if (BlockCell < 0 || !Occupancy.Test(BlockCell))
+            {
+                Targets.Set(Steps.Cells[StepIndex]);
+            }
+        }
+    };
+
+    switch (GetActiveRole(GameIndex, PieceId))
+    {
+    case ERoleType::King:
+        AddSteps(BoardGeometry.KingSteps[SideIndex][FromCell]);
+        break;
+    case ERoleType::Advisor:
+        AddSteps(BoardGeometry.AdvisorSteps[SideIndex][FromCell]);
+        break;
+    case ERoleType::Elephant:
+        AddSteps(BoardGeometry.ElephantSteps[SideIndex][FromCell]);
+        break;
+    case ERoleType::Horse:
+        AddSteps(BoardGeometry.HorseSteps[FromCell]);
+        break;
+    case ERoleType::Pawn:
+        AddSteps(BoardGeometry.PawnSteps[SideIndex][FromCell]);
+        break;
+    case ERoleType::Rook:
+        for (const EBoardDirection Direction : AllBoardDirections)
+        {
+            const FBoardBitboard& Ray = GetRayMask(Direction, FromCell);
+            const int32_t BlockerCell = FindNearestOnRay(Ray & Occupancy, Direction);
+            Targets = Targets | (BlockerCell < 0 ? Ray : AndNot(Ray, GetRayMask(Direction, BlockerCell)));
+        }
+        break;
+    case ERoleType::Cannon:
+        for (const EBoardDirection Direction : AllBoardDirections)
+        {
+            const FBoardBitboard& Ray = GetRayMask(Direction, FromCell);
+            const int32_t ScreenCell = FindNearestOnRay(Ray & Occupancy, Direction);
+            if (ScreenCell < 0)
+            {
+                Targets = Targets | Ray;
+                continue;
+            }
+
+            Targets = Targets | AndNot(Ray, GetRayMask(Direction, ScreenCell) | FBoardBitboard::FromCell(ScreenCell));
+            const int32_t TargetCell = FindNearestOnRay(GetRayMask(Direction, ScreenCell) & Occupancy, Direction);
+            if (TargetCell >= 0 && EnemyOccupancy.Test(TargetCell))
+            {
+                Targets.Set(TargetCell);
+            }
+        }
+        break;
+    }
+    return AndNot(Targets, OwnOccupancy);
+}
+
+bool FBatchMatchEnv::IsKingSafeAfterMove(int32_t GameIndex, int32_t PieceId, int32_t FromCell, int32_t ToCell) const noexcept
+{
+    // Same derived-occupancy test as FMatchReferee::IsMoveLegalForSide.
+    const size_t Game = static_cast<size_t>(GameIndex);
+    const size_t Slot = Game * PieceCount + PieceId;
+    const int32_t SideIndex = GetPieceSideIndex(PieceFlags[Slot]);
+    const int32_t OpponentIndex = 1 - SideIndex;
+    std::array<FBoardBitboard, 2> Occupancy{SideOccupancy[Game * 2], SideOccupancy[Game * 2 + 1]};
+    Occupancy[SideIndex].Clear(FromCell);
+    Occupancy[SideIndex].Set(ToCell);
+    Occupancy[OpponentIndex].Clear(ToCell);
+
+    const bool bKing = static_cast<ERoleType>(PieceRoles[Slot] & ActualRoleMask) == ERoleType::King;
+    const int32_t KingCell = bKing ? ToCell : KingCells[Game * 2 + SideIndex];
+    const int32_t EnemyKingCell = KingCells[Game * 2 + OpponentIndex] == ToCell ? -1 : KingCells[Game * 2 + OpponentIndex];
+    return KingCell >= 0 && !IsKingExposed(GameIndex, SideIndex, KingCell, EnemyKingCell, Occupancy);
+}
+
+bool FBatchMatchEnv::IsKingExposed(
+    int32_t GameIndex,
+    int32_t SideIndex,
+    int32_t KingCell,
+    int32_t EnemyKingCell,
+    const std::array<FBoardBitboard, 2>& Occupancy) const noexcept
+{
+    const FBoardBitboard AllOccupancy = Occupancy[0] | Occupancy[1];
+    if (EnemyKingCell >= 0 && KingCell % 9 == EnemyKingCell % 9 &&
+        (AllOccupancy & GetBetweenMask(KingCell, EnemyKingCell)).IsEmpty())
+    {
+        return true;
+    }
+
+    const int32_t AttackerSideIndex = 1 - SideIndex;
+    const FBoardBitboard& AttackerOccupancy = Occupancy[AttackerSideIndex];
+    const uint8_t* Board = BoardCells.data() + static_cast<size_t>(GameIndex) * CellCount;
+    auto IsActiveAttacker = [this, GameIndex, Board, &AttackerOccupancy](int32_t Cell, ERoleType Role) {
+        if (!AttackerOccupancy.Test(Cell))
+        {
+            return false;
+        }
+        const int32_t PieceId = Board[Cell];
+        const uint8_t Flags = PieceFlags[static_cast<size_t>(GameIndex) * PieceCount + PieceId];
+        return (Flags & FPackedPiece::FrozenFlag) == 0 && GetActiveRole(GameIndex, PieceId) == Role;
+    };
+    auto HasStepAttacker = [&AllOccupancy, &IsActiveAttacker](const FCellSteps& Steps, ERoleType Role) {
+        for (uint8_t StepIndex = 0; StepIndex < Steps.Count; ++StepIndex)
+        {
+            const int32_t BlockCell = Steps.BlockCells[StepIndex];
+            if ((BlockCell < 0 || !AllOccupancy.Test(BlockCell)) && IsActiveAttacker(Steps.Cells[StepIndex], Role))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Rooks see the king through the first piece on a line, cannons through the second.
+    for (const EBoardDirection Direction : AllBoardDirections)
+    {
+        const int32_t FirstCell = FindNearestOnRay(GetRayMask(Direction, KingCell) & AllOccupancy, Direction);
+        if (FirstCell < 0)
+        {
+            continue;
+        }
+        if (IsActiveAttacker(FirstCell, ERoleType::Rook))
+        {
+            return true;
+        }
+        const int32_t SecondCell = FindNearestOnRay(GetRayMask(Direction, FirstCell) & AllOccupancy, Direction);
+        if (SecondCell >= 0 && IsActiveAttacker(SecondCell, ERoleType::Cannon))
+        {
+            return true;
+        }
+    }
+
+    return HasStepAttacker(BoardGeometry.HorseAttackers[KingCell], ERoleType::Horse) ||
+           HasStepAttacker(BoardGeometry.PawnAttackers[AttackerSideIndex][KingCell], ERoleType::Pawn) ||
+           HasStepAttacker(BoardGeometry.ElephantAttackers[AttackerSideIndex][KingCell], ERoleType::Elephant) ||
+           HasStepAttacker(BoardGeometry.AdvisorAttackers[AttackerSideIndex][KingCell], ERoleType::Advisor) ||
+           HasStepAttacker(BoardGeometry.KingAttackers[AttackerSideIndex][KingCell], ERoleType::King);
+}
+
+ERoleType FBatchMatchEnv::GetActiveRole(int32_t GameIndex, int32_t PieceId) const noexcept
+{
+    const size_t Slot = static_cast<size_t>(GameIndex) * PieceCount + PieceId;
+    const uint8_t Roles = PieceRoles[Slot];
+    return static_cast<ERoleType>((PieceFlags[Slot] & FPackedPiece::RevealedFlag) != 0 ? (Roles & ActualRoleMask) : (Roles >> 4));
+}
+
+bool FBatchMatchEnv::CanPass(int32_t GameIndex) const noexcept
+{
+    return Config.RuleConfig.bAllowPassWhenNoLegalMove && InCheck[GameIndex] == 0 && LegalActionCounts[GameIndex] == 0;
+}
+
+void FBatchMatchEnv::WriteGameOutputs(int32_t GameIndex, const FBatchStepBuffers& Buffers) const
+{
+    const size_t Row = static_cast<size_t>(GameIndex);
+    if (Buffers.Observations != nullptr)
+    {
+        WriteObservation(GameIndex, Buffers.Observations + Row * ObservationSize);
+    }
+    if (Buffers.ActionMasks != nullptr)
+    {
+        WriteActionMask(GameIndex, Buffers.ActionMasks + Row * ActionCount);
+    }
+}
+
+void FBatchMatchEnv::WriteObservation(int32_t GameIndex, float* OutObservation) const
+{
+    std::fill(OutObservation, OutObservation + ObservationSize, 0.0f);
+
+    const size_t Game = static_cast<size_t>(GameIndex);
+    const ESide Perspective = CurrentTurns[Game];
+    const int32_t PerspectiveIndex = Perspective == ESide::Red ? 0 : 1;
+    auto SetCell = [OutObservation](int32_t Plane, int32_t Cell) {
+        OutObservation[Plane * CellCount + Cell] = 1.0f;
+    };
+
+    for (int32_t PieceId = 0; PieceId < PieceCount; ++PieceId)
+    {
+        const size_t Slot = Game * PieceCount + PieceId;
+        const uint8_t Flags = PieceFlags[Slot];
+        if ((Flags & FPackedPiece::AliveFlag) == 0)
+        {
+            continue;
+        }
+
+        const int32_t Cell = PieceCells[Slot];
+        const bool bRevealed = (Flags & FPackedPiece::RevealedFlag) != 0;
+        const bool bFrozen = (Flags & FPackedPiece::FrozenFlag) != 0;
+        const int32_t ActiveRole = static_cast<int32_t>(GetActiveRole(GameIndex, PieceId));
+        if (GetPieceSideIndex(Flags) == PerspectiveIndex)
+        {
+            SetCell(OwnActualRolePlane + (PieceRoles[Slot] & ActualRoleMask), Cell);
+            SetCell(OwnActiveRolePlane + ActiveRole, Cell);
+            if (bRevealed)
+            {
+                SetCell(OwnRevealedPlane, Cell);
+            }
+            if (bFrozen)
+            {
+                SetCell(OwnFrozenPlane, Cell);
+            }
+        }
+        else
+        {
+            SetCell(OpponentVisibleRolePlane + ActiveRole, Cell);
+            if (bRevealed)
+            {
+                SetCell(OpponentRevealedPlane, Cell);
+            }
+            if (bFrozen)
+            {
+                SetCell(OpponentFrozenPlane, Cell);
+            }
+        }
+    }
+
+    if (Perspective == ESide::Black)
+    {
+        std::fill(OutObservation + BlackToMovePlane * CellCount, OutObservation + (BlackToMovePlane + 1) * CellCount, 1.0f);
+    }
+    std::fill(
+        OutObservation + PassCountPlane * CellCount,
+        OutObservation + (PassCountPlane + 1) * CellCount,
+        static_cast<float>(PassCounts[Game]));
+}
+
+void FBatchMatchEnv::WriteActionMask(int32_t GameIndex, uint8_t* OutActionMask) const
+{
+    std::memset(OutActionMask, 0, ActionCount);
+
+    const uint16_t* Actions = LegalActions.data() + static_cast<size_t>(GameIndex) * MaxLegalMovesPerPosition;
+    for (uint16_t Index = 0; Index < LegalActionCounts[GameIndex]; ++Index)
+    {
+        OutActionMask[Actions[Index]] = 1;
+    }
+    OutActionMask[PassAction] = CanPass(GameIndex) ? 1 : 0;
+}
@@ -0,0 +1,403 @@
+#include "CoreRules/CommandLog.h"
+
+#include <array>
+#include <charconv>
+#include <initializer_list>
+
+namespace
+{
+constexpr char HexDigits[] = "0123456789abcdef";
+
+bool IsPlainByte(char C)
+{
+    return (C >= '0' && C <= '9') || (C >= 'a' && C <= 'z') || (C >= 'A' && C <= 'Z');
+}
+
+int32_t HexValue(char C)
+{
+    if (C >= '0' && C <= '9')
+    {
+        return C - '0';
+    }
+    if (C >= 'a' && C <= 'f')
+    {
+        return C - 'a' + 10;
+    }
+    if (C >= 'A' && C <= 'F')
+    {
+        return C - 'A' + 10;
+    }
+    return -1;
+}
+
+void AppendEscaped(std::string_view Text, std::string& OutText)
+{
+    for (const char C : Text)
+    {
+        if (IsPlainByte(C))
+        {
+            OutText.push_back(C);
+            continue;
+        }
+        const uint8_t Byte = static_cast<uint8_t>(C);
+        OutText.push_back('%');
+        OutText.push_back(HexDigits[Byte >> 4]);
+        OutText.push_back(HexDigits[Byte & 0x0F]);
+    }
+}
+
+bool ParseEscaped(std::string_view Text, std::string& OutText)
+{
+    OutText.clear();
+    OutText.reserve(Text.size());
+    for (size_t Index = 0; Index < Text.size(); ++Index)
+    {
+        if (IsPlainByte(Text[Index]))
+        {
+            OutText.push_back(Text[Index]);
+            continue;
+        }
+        if (Text[Index] != '%' || Index + 2 >= Text.size())
+        {
+            return false;
+        }
+        const int32_t High = HexValue(Text[Index + 1]);
+        const int32_t Low = HexValue(Text[Index + 2]);
+        if (High < 0 || Low < 0)
+        {
+            return false;
+        }
+        OutText.push_back(static_cast<char>((High << 4) | Low));
+        Index += 2;
+    }
+    return true;
+}
+
+template <typename TValue>
+bool ParseNumber(std::string_view Text, TValue& OutValue)
+{
+    const auto [End, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), OutValue);
+    return Error == std::errc() && End == Text.data() + Text.size();
+}
+
+bool IsDigitCoordinate(int8_t Value)
+{
+    return Value >= 0 && Value <= 9;
+}
+
+// "<X><Y>..." as single digits when every value fits, "/"-separated otherwise.
+void AppendCoordinates(std::initializer_list<int8_t> Values, std::string& OutText)
+{
+    bool bCompact = true;
+    for (const int8_t Value : Values)
+    {
+        bCompact = bCompact && IsDigitCoordinate(Value);
+    }
+
+    bool bFirst = true;
+    for (const int8_t Value : Values)
+    {
+        if (!bCompact && !bFirst)
+        {
+            OutText.push_back('/');
+        }
+        OutText += std::to_string(static_cast<int32_t>(Value));
+        bFirst = false;
+    }
+}
+
+template <size_t Count>
+bool ParseCoordinates(std::string_view Text, std::array<int8_t, Count>& OutValues)
+{
+    if (Text.size() == Count)
+    {
+        for (size_t Index = 0; Index < Count; ++Index)
+        {
+            if (Text[Index] < '0' || Text[Index] > '9')
+            {
+                return false;
+            }
+            OutValues[Index] = static_cast<int8_t>(Text[Index] - '0');
+        }
+        return true;
+    }
+
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        const size_t Separator = Index + 1 < Count ? Text.find('/') : Text.size();
+        int32_t Value = 0;
+        if (Separator == std::string_view::npos || !ParseNumber(Text.substr(0, Separator), Value) || Value < -128 || Value > 127)
+        {
+            return false;
+        }
+        OutValues[Index] = static_cast<int8_t>(Value);
+        Text.remove_prefix(Index + 1 < Count ? Separator + 1 : Separator);
+    }
+    return Text.empty();
+}
+
+bool ParsePlacement(std::string_view Text, FSetupPlacement& OutPlacement)
+{
+    const size_t At = Text.find('@');
+    std::array<int8_t, 2> Values{};
+    if (At == std::string_view::npos || !ParseNumber(Text.substr(0, At), OutPlacement.PieceId) ||
+        !ParseCoordinates(Text.substr(At + 1), Values))
+    {
+        return false;
+    }
+    OutPlacement.TargetPos = FBoardPos{Values[0], Values[1]};
+    return true;
+}
+
+bool ParseReveal(std::string_view Body, ESide Side, FSetupPlain& OutSetup)
+{
+    const size_t Slash = Body.find('/');
+    if (Slash == std::string_view::npos || !ParseEscaped(Body.substr(0, Slash), OutSetup.Nonce))
+    {
+        return false;
+    }
+    OutSetup.Side = Side;
+    OutSetup.Placements.clear();
+
+    std::string_view Placements = Body.substr(Slash + 1);
+    while (!Placements.empty())
+    {
+        const size_t Dot = Placements.find('.');
+        FSetupPlacement Placement{};
+        if (!ParsePlacement(Placements.substr(0, Dot), Placement))
+        {
+            return false;
+        }
+        OutSetup.Placements.push_back(Placement);
+        if (Dot == std::string_view::npos)
+        {
+            break;
+        }
+        Placements.remove_prefix(Dot + 1);
+        if (Placements.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+void FCommandLog::AppendCommand(const FPlayerCommand& Command, std::string& OutText)
+{
+    OutText.push_back(Command.Side == ESide::Red ? 'R' : 'B');
+    switch (Command.CommandType)
+    {
+    case ECommandType::CommitSetup:
+        OutText.push_back('C');
+        if (!Command.SetupCommit.has_value())
+        {
+            OutText.push_back('!');
+            break;
+        }
+        AppendEscaped(Command.SetupCommit->HashHex, OutText);
+        break;
+    case ECommandType::RevealSetup:
+        OutText.push_back('V');
+        if (!Command.SetupPlain.has_value())
+        {
+            OutText.push_back('!');
+            break;
+        }
+        AppendEscaped(Command.SetupPlain->Nonce, OutText);
+        OutText.push_back('/');
+        for (size_t Index = 0; Index < Command.SetupPlain->Placements.size(); ++Index)
+        {
+            const FSetupPlacement& Placement = Command.SetupPlain->Placements[Index];
+            if (Index > 0)
+            {
+                OutText.push_back('.');
+            }
+            OutText += std::to_string(Placement.PieceId);
+            OutText.push_back('@');
+            AppendCoordinates({Placement.TargetPos.X, Placement.TargetPos.Y}, OutText);
+        }
+        break;
+    case ECommandType::Move:
+        if (!Command.Move.has_value())
+        {
+            OutText.push_back('M');
+            break;
+        }
+        OutText += std::to_string(Command.Move->PieceId);
+        OutText.push_back(':');
+        AppendCoordinates({Command.Move->From.X, Command.Move->From.Y, Command.Move->To.X, Command.Move->To.Y}, OutText);
+        break;
+    case ECommandType::Pass:
+        OutText.push_back('P');
+        break;
+    case ECommandType::Resign:
+        OutText.push_back('R');
+        break;
+    }
+}
+
+std::string FCommandLog::FormatCommand(const FPlayerCommand& Command)
+{
+    std::string Text;
+    AppendCommand(Command, Text);
+    return Text;
+}
+
+bool FCommandLog::ParseCommand(std::string_view Token, FPlayerCommand& OutCommand)
+{
+    if (Token.size() < 2 || (Token[0] != 'R' && Token[0] != 'B'))
+    {
+        return false;
+    }
+
+    FPlayerCommand Command{};
+    Command.Side = Token[0] == 'R' ? ESide::Red : ESide::Black;
+    const std::string_view Body = Token.substr(1);
+    const char Kind = Body[0];
+    if (Body.size() == 1 && (Kind == 'P' || Kind == 'R' || Kind == 'M'))
+    {
+        Command.CommandType = Kind == 'P' ? ECommandType::Pass : (Kind == 'R' ? ECommandType::Resign : ECommandType::Move);
+    }
+    else if (Kind == 'C')
+    {
+        Command.CommandType = ECommandType::CommitSetup;
+        if (Body != "C!")
+        {
+            FSetupCommit Commit{};
+            Commit.Side = Command.Side;
+            if (!ParseEscaped(Body.substr(1), Commit.HashHex))
+            {
+                return false;
+            }
+            Command.SetupCommit = std::move(Commit);
+        }
+    }
+    else if (Kind == 'V')
+    {
+        Command.CommandType = ECommandType::RevealSetup;
+        if (Body != "V!")
+        {
+            FSetupPlain Setup{};
+            if (!ParseReveal(Body.substr(1), Command.Side, Setup))
+            {
+                return false;
+            }
+            Command.SetupPlain = std::move(Setup);
+        }
+    }
+    else
+    {
+        const size_t Colon = Body.find(':');
+        FMoveAction Move{};
+        std::array<int8_t, 4> Values{};
+        if (Colon == std::string_view::npos || !ParseNumber(Body.substr(0, Colon), Move.PieceId) ||
+            !ParseCoordinates(Body.substr(Colon + 1), Values))
+        {
+            return false;
+        }
+        Move.From = FBoardPos{Values[0], Values[1]};
+        Move.To = FBoardPos{Values[2], Values[3]};
+        Command.CommandType = ECommandType::Move;
+        Command.Move = Move;
+    }
+
+    OutCommand = std::move(Command);
+    return true;
+}
+
+std::string FCommandLog::FormatMatch(const FRecordedMatch& Match)
+{
+    std::string Line = "match=" + std::to_string(Match.MatchId) + " commands=";
+    for (size_t Index = 0; Index < Match.Commands.size(); ++Index)
+    {
+        if (Index > 0)
+        {
+            Line.push_back(',');
+        }
+        AppendCommand(Match.Commands[Index], Line);
+    }
+
+    if (Match.ExpectedDigest.has_value())
+    {
+        Line += " digest=";
+        for (int32_t Shift = 60; Shift >= 0; Shift -= 4)
+        {
+            Line.push_back(HexDigits[(Match.ExpectedDigest.value() >> Shift) & 0x0F]);
+        }
+    }
+    return Line;
+}
+
+bool FCommandLog::ParseMatch(std::string_view Line, FRecordedMatch& OutMatch, std::string& OutError)
+{
+    if (!Line.empty() && Line.back() == '\r')
+    {
+        Line.remove_suffix(1);
+    }
+
+    OutMatch.MatchId = 0;
+    OutMatch.Commands.clear();
+    OutMatch.ExpectedDigest.reset();
+    bool bHasMatchId = false;
+    bool bHasCommands = false;
+    while (!Line.empty())
+    {
+        const size_t Space = Line.find(' ');
+        const std::string_view Field = Line.substr(0, Space);
+        Line.remove_prefix(Space == std::string_view::npos ? Line.size() : Space + 1);
+        if (Field.empty())
+        {
+            continue;
+        }
+
+        const size_t Equals = Field.find('=');
+        const std::string_view Key = Field.substr(0, Equals);
+        const std::string_view Value = Equals == std::string_view::npos ? std::string_view() : Field.substr(Equals + 1);
+        if (Key == "match" && ParseNumber(Value, OutMatch.MatchId))
+        {
+            bHasMatchId = true;
+        }
+        else if (Key == "commands")
+        {
+            std::string_view Commands = Value;
+            while (!Commands.empty())
+            {
+                const size_t Comma = Commands.find(',');
+                const std::string_view Token = Commands.substr(0, Comma);
+                FPlayerCommand Command{};
+                if (!ParseCommand(Token, Command))
+                {
+                    OutError = "Invalid command '" + std::string(Token) + "'.";
+                    return false;
+                }
+                OutMatch.Commands.push_back(std::move(Command));
+                Commands.remove_prefix(Comma == std::string_view::npos ? Commands.size() : Comma + 1);
+            }
+            bHasCommands = true;
+        }
+        else if (Key == "digest" && Value.size() == 16)
+        {
+            uint64_t Digest = 0;
+            const auto [End, Error] = std::from_chars(Value.data(), Value.data() + Value.size(), Digest, 16);
+            if (Error != std::errc() || End != Value.data() + Value.size())
+            {
+                OutError = "Invalid digest '" + std::string(Value) + "'.";
+                return false;
+            }
+            OutMatch.ExpectedDigest = Digest;
+        }
+        else
+        {
+            OutError = "Invalid field '" + std::string(Field) + "'.";
+            return false;
+        }
+    }
+
+    if (!bHasMatchId || !bHasCommands)
+    {
+        OutError = "Match line needs match and commands fields.";
+        return false;
+    }
+    return true;
+}
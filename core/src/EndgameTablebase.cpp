@@ -0,0 +1,671 @@
+#include "CoreRules/EndgameTablebase.h"
+
+#include "CoreRules/BoardGeometry.h"
+
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr std::array<char, 4> FileMagic = {'S', 'C', 'T', 'B'};
+constexpr uint16_t FileVersion = 1;
+constexpr size_t FileHeaderSize = 32;
+constexpr uint8_t UnusedPieceCode = 0xFF;
+
+// Upper-case letters by ERoleType: King, Advisor, Elephant, Horse, Rook, Cannon, Pawn.
+constexpr std::array<char, 7> RoleLetters = {'K', 'A', 'E', 'H', 'R', 'C', 'P'};
+// Piece ids available to one side for each role; a material cannot hold more pieces of a role than the roster.
+constexpr std::array<int32_t, 7> MaxRoleCounts = {1, 2, 2, 2, 2, 2, 5};
+
+int32_t ToSideIndex(ESide Side) noexcept
+{
+    return Side == ESide::Red ? 0 : 1;
+}
+
+uint8_t ToPieceCode(const FTablebasePiece& Piece) noexcept
+{
+    return static_cast<uint8_t>((ToSideIndex(Piece.Side) << 4) | (Piece.bFrozen ? 1 << 3 : 0) | static_cast<int32_t>(Piece.Role));
+}
+
+FTablebasePiece FromPieceCode(uint8_t Code) noexcept
+{
+    FTablebasePiece Piece{};
+    Piece.Side = (Code & 0x10) != 0 ? ESide::Black : ESide::Red;
+    Piece.bFrozen = (Code & 0x08) != 0;
+    Piece.Role = static_cast<ERoleType>(Code & 0x07);
+    return Piece;
+}
+
+bool IsCanonicalBefore(const FTablebasePiece& Left, const FTablebasePiece& Right) noexcept
+{
+    return ToPieceCode(Left) < ToPieceCode(Right);
+}
+
+// Codes are at most 30, so each piece takes one base-32 digit.
+uint64_t FoldPieceKey(uint64_t Key, const FTablebasePiece& Piece) noexcept
+{
+    return Key * 32 + ToPieceCode(Piece) + 1;
+}
+
+std::optional<ERoleType> ParseRoleLetter(char Letter) noexcept
+{
+    const char Upper = Letter >= 'a' && Letter <= 'z' ? static_cast<char>(Letter - 'a' + 'A') : Letter;
+    for (size_t RoleIndex = 0; RoleIndex < RoleLetters.size(); ++RoleIndex)
+    {
+        if (RoleLetters[RoleIndex] == Upper)
+        {
+            return static_cast<ERoleType>(RoleIndex);
+        }
+    }
+    return std::nullopt;
+}
+
+bool IsRoleLegalCell(const FTablebasePiece& Piece, int32_t Cell) noexcept
+{
+    const int32_t SideIndex = ToSideIndex(Piece.Side);
+    switch (Piece.Role)
+    {
+    case ERoleType::King:
+        return BoardGeometry.Palace[SideIndex][Cell];
+    case ERoleType::Advisor:
+        return BoardGeometry.AdvisorPoint[SideIndex][Cell];
+    case ERoleType::Elephant:
+        return BoardGeometry.ElephantPoint[SideIndex][Cell];
+    default:
+        return true;
+    }
+}
+
+void SetError(std::string* OutError, std::string Message)
+{
+    if (OutError != nullptr)
+    {
+        *OutError = std::move(Message);
+    }
+}
+
+uint64_t ComputeChecksum(const uint8_t* Data, uint64_t Size) noexcept
+{
+    uint64_t Hash = 0xCBF29CE484222325ull;
+    for (uint64_t Index = 0; Index < Size; ++Index)
+    {
+        Hash = (Hash ^ Data[Index]) * 0x100000001B3ull;
+    }
+    return Hash;
+}
+
+void WriteLittleEndian(uint8_t* Out, uint64_t Value, size_t Bytes) noexcept
+{
+    for (size_t Index = 0; Index < Bytes; ++Index)
+    {
+        Out[Index] = static_cast<uint8_t>(Value >> (Index * 8));
+    }
+}
+
+uint64_t ReadLittleEndian(const uint8_t* In, size_t Bytes) noexcept
+{
+    uint64_t Value = 0;
+    for (size_t Index = 0; Index < Bytes; ++Index)
+    {
+        Value |= uint64_t{In[Index]} << (Index * 8);
+    }
+    return Value;
+}
+}
+
+std::optional<FTablebaseMaterial> FTablebaseMaterial::Parse(std::string_view Name, std::string* OutError)
+{
+    const size_t DashPos = Name.find('-');
+    if (DashPos == std::string_view::npos || Name.find('-', DashPos + 1) != std::string_view::npos)
+    {
+        SetError(OutError, "Material name must be <red pieces>-<black pieces>.");
+        return std::nullopt;
+    }
+
+    std::vector<FTablebasePiece> Pieces;
+    for (size_t Index = 0; Index < Name.size(); ++Index)
+    {
+        if (Index == DashPos)
+        {
+            continue;
+        }
+
+        const std::optional<ERoleType> Role = ParseRoleLetter(Name[Index]);
+        if (!Role.has_value())
+        {
+            SetError(OutError, std::string("Unknown piece letter '") + Name[Index] + "'.");
+            return std::nullopt;
+        }
+
+        FTablebasePiece Piece{};
+        Piece.Side = Index < DashPos ? ESide::Red : ESide::Black;
+        Piece.Role = Role.value();
+        Piece.bFrozen = Name[Index] >= 'a' && Name[Index] <= 'z';
+        Pieces.push_back(Piece);
+    }
+
+    return FromPieces(std::move(Pieces), OutError);
+}
+
+std::optional<FTablebaseMaterial> FTablebaseMaterial::FromPieces(std::vector<FTablebasePiece> Pieces, std::string* OutError)
+{
+    if (Pieces.size() > MaxPieces)
+    {
+        SetError(OutError, "Material has more than " + std::to_string(MaxPieces) + " pieces.");
+        return std::nullopt;
+    }
+
+    std::array<std::array<int32_t, 7>, 2> RoleCounts{};
+    for (const FTablebasePiece& Piece : Pieces)
+    {
+        if (Piece.bFrozen && Piece.Role != ERoleType::King && Piece.Role != ERoleType::Advisor && Piece.Role != ERoleType::Elephant)
+        {
+            SetError(OutError, "Only kings, advisors and elephants can be frozen.");
+            return std::nullopt;
+        }
+        ++RoleCounts[ToSideIndex(Piece.Side)][static_cast<size_t>(Piece.Role)];
+    }
+    for (const auto& SideCounts : RoleCounts)
+    {
+        if (SideCounts[static_cast<size_t>(ERoleType::King)] != 1)
+        {
+            SetError(OutError, "Each side needs exactly one king.");
+            return std::nullopt;
+        }
+        for (size_t RoleIndex = 0; RoleIndex < SideCounts.size(); ++RoleIndex)
+        {
+            if (SideCounts[RoleIndex] > MaxRoleCounts[RoleIndex])
+            {
+                SetError(OutError, std::string("Too many pieces of role '") + RoleLetters[RoleIndex] + "'.");
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::stable_sort(Pieces.begin(), Pieces.end(), IsCanonicalBefore);
+
+    FTablebaseMaterial Material;
+    uint64_t PlacementCount = 1;
+    for (const FTablebasePiece& Piece : Pieces)
+    {
+        FSlot Slot{};
+        Slot.Piece = Piece;
+        Slot.CellOrdinals.fill(-1);
+        for (int32_t Cell = 0; Cell < 90; ++Cell)
+        {
+            if (IsRoleLegalCell(Piece, Cell) != Piece.bFrozen)
+            {
+                Slot.CellOrdinals[Cell] = static_cast<int16_t>(Slot.Cells.size());
+                Slot.Cells.push_back(static_cast<uint8_t>(Cell));
+            }
+        }
+        PlacementCount *= Slot.Cells.size();
+        Material.Slots.push_back(std::move(Slot));
+    }
+
+    // The generator addresses positions with 32-bit indices.
+    if (PlacementCount * 2 > std::numeric_limits<uint32_t>::max())
+    {
+        SetError(OutError, "Material is too large to index.");
+        return std::nullopt;
+    }
+    Material.EntryCount = PlacementCount * 2;
+    return Material;
+}
+
+std::string FTablebaseMaterial::GetName() const
+{
+    std::string Name;
+    bool bDashWritten = false;
+    for (const FSlot& Slot : Slots)
+    {
+        if (Slot.Piece.Side == ESide::Black && !bDashWritten)
+        {
+            Name.push_back('-');
+            bDashWritten = true;
+        }
+        const char Letter = RoleLetters[static_cast<size_t>(Slot.Piece.Role)];
+        Name.push_back(Slot.Piece.bFrozen ? static_cast<char>(Letter - 'A' + 'a') : Letter);
+    }
+    return Name;
+}
+
+uint64_t FTablebaseMaterial::GetKey() const noexcept
+{
+    uint64_t Key = 0;
+    for (const FSlot& Slot : Slots)
+    {
+        Key = FoldPieceKey(Key, Slot.Piece);
+    }
+    return Key;
+}
+
+size_t FTablebaseMaterial::GetPieceCount() const noexcept
+{
+    return Slots.size();
+}
+
+const FTablebasePiece& FTablebaseMaterial::GetPiece(size_t Slot) const noexcept
+{
+    return Slots[Slot].Piece;
+}
+
+const std::vector<uint8_t>& FTablebaseMaterial::GetSlotCells(size_t Slot) const noexcept
+{
+    return Slots[Slot].Cells;
+}
+
+uint64_t FTablebaseMaterial::GetEntryCount() const noexcept
+{
+    return EntryCount;
+}
+
+FTablebaseMaterial FTablebaseMaterial::WithoutPiece(size_t Slot) const
+{
+    FTablebaseMaterial Material = *this;
+    Material.EntryCount /= Material.Slots[Slot].Cells.size();
+    Material.Slots.erase(Material.Slots.begin() + static_cast<std::ptrdiff_t>(Slot));
+    return Material;
+}
+
+uint64_t FTablebaseMaterial::ComputeIndex(const FCells& Cells, ESide SideToMove) const noexcept
+{
+    uint64_t Index = 0;
+    for (size_t SlotIndex = 0; SlotIndex < Slots.size(); ++SlotIndex)
+    {
+        const FSlot& Slot = Slots[SlotIndex];
+        const int32_t Ordinal = Cells[SlotIndex] < 90 ? Slot.CellOrdinals[Cells[SlotIndex]] : -1;
+        if (Ordinal < 0)
+        {
+            return InvalidIndex;
+        }
+        Index = Index * Slot.Cells.size() + static_cast<uint64_t>(Ordinal);
+    }
+    return Index * 2 + (SideToMove == ESide::Black ? 1 : 0);
+}
+
+void FTablebaseMaterial::DecodeIndex(uint64_t Index, FCells& OutCells, ESide& OutSideToMove) const noexcept
+{
+    OutSideToMove = (Index & 1) != 0 ? ESide::Black : ESide::Red;
+    uint64_t Placement = Index >> 1;
+    for (size_t SlotIndex = Slots.size(); SlotIndex-- > 0;)
+    {
+        const std::vector<uint8_t>& Cells = Slots[SlotIndex].Cells;
+        OutCells[SlotIndex] = Cells[Placement % Cells.size()];
+        Placement /= Cells.size();
+    }
+}
+
+struct FEndgameTable::FMapping
+{
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+#if defined(_WIN32)
+    HANDLE FileHandle = INVALID_HANDLE_VALUE;
+    HANDLE MappingHandle = nullptr;
+#endif
+
+    ~FMapping()
+    {
+#if defined(_WIN32)
+        if (Data != nullptr)
+        {
+            UnmapViewOfFile(Data);
+        }
+        if (MappingHandle != nullptr)
+        {
+            CloseHandle(MappingHandle);
+        }
+        if (FileHandle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(FileHandle);
+        }
+#else
+        if (Data != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(Data), Size);
+        }
+#endif
+    }
+
+    static std::unique_ptr<FMapping> Open(const std::string& Path, std::string& OutError)
+    {
+        auto Mapping = std::make_unique<FMapping>();
+#if defined(_WIN32)
+        Mapping->FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER FileSize{};
+        if (Mapping->FileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(Mapping->FileHandle, &FileSize))
+        {
+            OutError = "Cannot open tablebase file: " + Path;
+            return nullptr;
+        }
+        Mapping->Size = static_cast<size_t>(FileSize.QuadPart);
+        if (Mapping->Size < FileHeaderSize)
+        {
+            OutError = "Tablebase file is truncated: " + Path;
+            return nullptr;
+        }
+        Mapping->MappingHandle = CreateFileMappingA(Mapping->FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (Mapping->MappingHandle == nullptr)
+        {
+            OutError = "Cannot map tablebase file: " + Path;
+            return nullptr;
+        }
+        Mapping->Data = static_cast<const uint8_t*>(MapViewOfFile(Mapping->MappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+        const int FileDescriptor = open(Path.c_str(), O_RDONLY);
+        struct stat FileStat{};
+        if (FileDescriptor < 0 || fstat(FileDescriptor, &FileStat) != 0)
+        {
+            if (FileDescriptor >= 0)
+            {
+                close(FileDescriptor);
+            }
+            OutError = "Cannot open tablebase file: " + Path;
+            return nullptr;
+        }
+        Mapping->Size = static_cast<size_t>(FileStat.st_size);
+        if (Mapping->Size < FileHeaderSize)
+        {
+            close(FileDescriptor);
+            OutError = "Tablebase file is truncated: " + Path;
+            return nullptr;
+        }
+        void* Address = mmap(nullptr, Mapping->Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+        close(FileDescriptor);
+        Mapping->Data = Address == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(Address);
+#endif
+        if (Mapping->Data == nullptr)
+        {
+            OutError = "Cannot map tablebase file: " + Path;
+            return nullptr;
+        }
+        return Mapping;
+    }
+};
+
+FEndgameTable::FEndgameTable(FTablebaseMaterial InMaterial, std::vector<uint8_t> InEntries)
+    : Material(std::move(InMaterial))
+    , OwnedEntries(std::move(InEntries))
+    , Entries(OwnedEntries.data())
+{
+}
+
+FEndgameTable::FEndgameTable(FTablebaseMaterial InMaterial, std::unique_ptr<FMapping> InMapping, const uint8_t* InEntries)
+    : Material(std::move(InMaterial))
+    , Mapping(std::move(InMapping))
+    , Entries(InEntries)
+{
+}
+
+FEndgameTable::~FEndgameTable() = default;
+
+std::unique_ptr<FEndgameTable> FEndgameTable::LoadFile(const std::string& Path, std::string& OutError)
+{
+    std::unique_ptr<FMapping> Mapping = FMapping::Open(Path, OutError);
+    if (Mapping == nullptr)
+    {
+        return nullptr;
+    }
+
+    const uint8_t* Header = Mapping->Data;
+    if (!std::equal(FileMagic.begin(), FileMagic.end(), Header) || ReadLittleEndian(Header + 4, 2) != FileVersion)
+    {
+        OutError = "Not a version " + std::to_string(FileVersion) + " tablebase file: " + Path;
+        return nullptr;
+    }
+
+    const size_t PieceCount = Header[6];
+    if (PieceCount > FTablebaseMaterial::MaxPieces)
+    {
+        OutError = "Tablebase file has too many pieces: " + Path;
+        return nullptr;
+    }
+    std::vector<FTablebasePiece> Pieces;
+    for (size_t Index = 0; Index < PieceCount; ++Index)
+    {
+        Pieces.push_back(FromPieceCode(Header[8 + Index]));
+    }
+
+    std::string MaterialError;
+    std::optional<FTablebaseMaterial> Material = FTablebaseMaterial::FromPieces(std::move(Pieces), &MaterialError);
+    if (!Material.has_value())
+    {
+        OutError = "Tablebase file has an invalid material (" + MaterialError + "): " + Path;
+        return nullptr;
+    }
+
+    const uint64_t EntryCount = ReadLittleEndian(Header + 16, 8);
+    if (EntryCount != Material->GetEntryCount() || Mapping->Size - FileHeaderSize != EntryCount)
+    {
+        OutError = "Tablebase file size does not match its material: " + Path;
+        return nullptr;
+    }
+
+    const uint8_t* EntryData = Mapping->Data + FileHeaderSize;
+    if (ComputeChecksum(EntryData, EntryCount) != ReadLittleEndian(Header + 24, 8))
+    {
+        OutError = "Tablebase file checksum mismatch: " + Path;
+        return nullptr;
+    }
+
+    return std::unique_ptr<FEndgameTable>(new FEndgameTable(std::move(Material.value()), std::move(Mapping), EntryData));
+}
+
+bool FEndgameTable::SaveFile(const std::string& Path, std::string& OutError) const
+{
+    std::array<uint8_t, FileHeaderSize> Header{};
+    std::copy(FileMagic.begin(), FileMagic.end(), Header.begin());
+    WriteLittleEndian(Header.data() + 4, FileVersion, 2);
+    Header[6] = static_cast<uint8_t>(Material.GetPieceCount());
+    for (size_t Index = 0; Index < FTablebaseMaterial::MaxPieces; ++Index)
+    {
+        Header[8 + Index] = Index < Material.GetPieceCount() ? ToPieceCode(Material.GetPiece(Index)) : UnusedPieceCode;
+    }
+    WriteLittleEndian(Header.data() + 16, GetEntryCount(), 8);
+    WriteLittleEndian(Header.data() + 24, ComputeChecksum(Entries, GetEntryCount()), 8);
+
+    std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+    File.write(reinterpret_cast<const char*>(Header.data()), static_cast<std::streamsize>(Header.size()));
+    File.write(reinterpret_cast<const char*>(Entries), static_cast<std::streamsize>(GetEntryCount()));
+    if (!File)
+    {
+        OutError = "Cannot write tablebase file: " + Path;
+        return false;
+    }
+    return true;
+}
+
+uint8_t FEndgameTable::EncodeDistance(int32_t Distance) noexcept
+{
+    return static_cast<uint8_t>(Distance + 1);
+}
+
+bool FEndgameTable::DecodeEntry(uint8_t Entry, FTablebaseProbeResult& OutResult) noexcept
+{
+    if (Entry == InvalidEntry)
+    {
+        return false;
+    }
+
+    OutResult = FTablebaseProbeResult{};
+    if (Entry != DrawEntry)
+    {
+        OutResult.Distance = Entry - 1;
+        OutResult.Outcome = (OutResult.Distance & 1) != 0 ? ETablebaseOutcome::Win : ETablebaseOutcome::Loss;
+    }
+    return true;
+}
+
+const FTablebaseMaterial& FEndgameTable::GetMaterial() const noexcept
+{
+    return Material;
+}
+
+uint64_t FEndgameTable::GetEntryCount() const noexcept
+{
+    return Material.GetEntryCount();
+}
+
+uint8_t FEndgameTable::GetEntry(uint64_t Index) const noexcept
+{
+    return Entries[Index];
+}
+
+bool FEndgameTable::IsMapped() const noexcept
+{
+    return Mapping != nullptr;
+}
+
+FEndgameTablebase::FEndgameTablebase() = default;
+
+FEndgameTablebase::~FEndgameTablebase() = default;
+
+void FEndgameTablebase::AddTable(std::unique_ptr<FEndgameTable> Table)
+{
+    MaxPieceCount = std::max(MaxPieceCount, Table->GetMaterial().GetPieceCount());
+    const uint64_t Key = Table->GetMaterial().GetKey();
+    Tables[Key] = std::move(Table);
+}
+
+bool FEndgameTablebase::LoadFile(const std::string& Path, std::string& OutError)
+{
+    std::unique_ptr<FEndgameTable> Table = FEndgameTable::LoadFile(Path, OutError);
+    if (Table == nullptr)
+    {
+        return false;
+    }
+    AddTable(std::move(Table));
+    return true;
+}
+
+size_t FEndgameTablebase::LoadDirectory(const std::string& Directory, std::string& OutError)
+{
+    std::error_code ErrorCode;
+    std::vector<std::filesystem::path> Paths;
+    for (const auto& Entry : std::filesystem::directory_iterator(Directory, ErrorCode))
+    {
+        if (Entry.is_regular_file() && Entry.path().extension() == ".sctb")
+        {
+            Paths.push_back(Entry.path());
+        }
+    }
+    if (ErrorCode)
+    {
+        OutError = "Cannot list tablebase directory: " + Directory;
+        return 0;
+    }
+
+    std::sort(Paths.begin(), Paths.end());
+    size_t LoadedCount = 0;
+    for (const std::filesystem::path& Path : Paths)
+    {
+        if (LoadFile(Path.string(), OutError))
+        {
+            ++LoadedCount;
+        }
+    }
+    return LoadedCount;
+}
+
+const FEndgameTable* FEndgameTablebase::FindTable(const FTablebaseMaterial& Material) const
+{
+    const auto It = Tables.find(Material.GetKey());
+    return It == Tables.end() ? nullptr : It->second.get();
+}
+
+size_t FEndgameTablebase::GetTableCount() const noexcept
+{
+    return Tables.size();
+}
+
+bool FEndgameTablebase::Probe(const FMatchReferee& Referee, FTablebaseProbeResult& OutResult) const
+{
+    const FGameState& State = Referee.GetState();
+    if (Tables.empty() || State.Phase != EGamePhase::Battle || State.Result != EGameResult::Ongoing)
+    {
+        return false;
+    }
+
+    struct FPlacedPiece
+    {
+        FTablebasePiece Piece{};
+        uint8_t Cell = 0;
+    };
+
+    std::array<FPlacedPiece, FTablebaseMaterial::MaxPieces> Placed{};
+    size_t PlacedCount = 0;
+    for (const FPieceState& Piece : State.Pieces)
+    {
+        if (!Piece.bAlive)
+        {
+            continue;
+        }
+        if (Piece.PieceState != EPieceState::RevealedActual || PlacedCount == MaxPieceCount)
+        {
+            return false;
+        }
+
+        FPlacedPiece& Entry = Placed[PlacedCount++];
+        Entry.Piece.Side = Piece.Side;
+        Entry.Piece.Role = Piece.ActualRole;
+        Entry.Piece.bFrozen = Piece.bFrozen;
+        Entry.Cell = static_cast<uint8_t>(Piece.Pos.Y * 9 + Piece.Pos.X);
+    }
+
+    // Pieces of one kind fill their slots in cell order; the table holds every order, so any would do. An insertion
+    // sort bounded by the array keeps the indices provably in range for at most MaxPieces entries.
+    assert(PlacedCount <= Placed.size());
+    const auto IsPlacedBefore = [](const FPlacedPiece& Left, const FPlacedPiece& Right) {
+        const uint8_t LeftCode = ToPieceCode(Left.Piece);
+        const uint8_t RightCode = ToPieceCode(Right.Piece);
+        return LeftCode != RightCode ? LeftCode < RightCode : Left.Cell < Right.Cell;
+    };
+    for (size_t Index = 1; Index < PlacedCount && Index < Placed.size(); ++Index)
+    {
+        const FPlacedPiece Current = Placed[Index];
+        size_t Insert = Index;
+        for (; Insert > 0 && IsPlacedBefore(Current, Placed[Insert - 1]); --Insert)
+        {
+            Placed[Insert] = Placed[Insert - 1];
+        }
+        Placed[Insert] = Current;
+    }
+
+    uint64_t Key = 0;
+    FTablebaseMaterial::FCells Cells{};
+    for (size_t Index = 0; Index < PlacedCount; ++Index)
+    {
+        Key = FoldPieceKey(Key, Placed[Index].Piece);
+        Cells[Index] = Placed[Index].Cell;
+    }
+
+    const auto It = Tables.find(Key);
+    if (It == Tables.end())
+    {
+        return false;
+    }
+
+    const FEndgameTable& Table = *It->second;
+    const uint64_t Index = Table.GetMaterial().ComputeIndex(Cells, State.CurrentTurn);
+    return Index != FTablebaseMaterial::InvalidIndex && FEndgameTable::DecodeEntry(Table.GetEntry(Index), OutResult);
+}
@@ -0,0 +1,435 @@
+#include "CoreRules/IsmctsSearch.h"
+
+#include "CoreRules/AlphaBetaSearch.h"
+#include "CoreRules/RandomSetup.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr int32_t ActionCount = FIsmctsSearch::PassAction + 1;
+constexpr int32_t MaxTreePly = 160;
+constexpr double EvaluationScale = 400.0;
+
+struct FIsmctsNode
+{
+    FIsmctsNode(FIsmctsNode* InParent, int32_t InAction, ESide InMover)
+        : Parent(InParent)
+        , Action(InAction)
+        , Mover(InMover)
+    {
+    }
+
+    FIsmctsNode* Parent = nullptr;
+    int32_t Action = -1;
+    // Side that played Action; rewards stored here are from its point of view.
+    ESide Mover = ESide::Red;
+
+    // Guards Children and the statistics of every child; the root's own statistics use it as well.
+    std::mutex Mutex;
+    std::vector<std::unique_ptr<FIsmctsNode>> Children;
+    uint32_t Visits = 0;
+    uint32_t Availability = 0;
+    int32_t VirtualVisits = 0;
+    double TotalReward = 0.0;
+};
+
+ESide GetOppositeSide(ESide Side) noexcept
+{
+    return Side == ESide::Red ? ESide::Black : ESide::Red;
+}
+
+int32_t ToAction(const FMoveAction& Move) noexcept
+{
+    return (Move.From.Y * 9 + Move.From.X) * 90 + Move.To.Y * 9 + Move.To.X;
+}
+
+double ToRewardForSide(double RedReward, ESide Side) noexcept
+{
+    return Side == ESide::Red ? RedReward : 1.0 - RedReward;
+}
+
+double EvaluateRedReward(const FGameState& State) noexcept
+{
+    const int32_t Score = FAlphaBetaSearch::Evaluate(State);
+    const double RedScore = static_cast<double>(State.CurrentTurn == ESide::Red ? Score : -Score);
+    return 1.0 / (1.0 + std::exp(-RedScore / EvaluationScale));
+}
+
+// Fills OutMoves for the side to move and returns true when the position is already decided, with the result in
+// OutRedReward. An empty move list on a non-terminal return means the side has to pass.
+bool CollectMoves(const FMatchReferee& Referee, FMoveList& OutMoves, double& OutRedReward)
+{
+    const FGameState& State = Referee.GetState();
+    const ESide Side = State.CurrentTurn;
+    const double LossReward = ToRewardForSide(0.0, Side);
+    if (State.KingCells[Side == ESide::Red ? 0 : 1] < 0)
+    {
+        OutRedReward = LossReward;
+        return true;
+    }
+
+    Referee.GenerateLegalMoves(Side, OutMoves);
+    if (!OutMoves.IsEmpty())
+    {
+        return false;
+    }
+
+    const FRuleConfig& RuleConfig = Referee.GetRuleConfig();
+    if (Referee.IsSideInCheck(Side) || !RuleConfig.bAllowPassWhenNoLegalMove)
+    {
+        OutRedReward = LossReward;
+        return true;
+    }
+    if (RuleConfig.bDoublePassIsDraw && State.PassCount >= 1)
+    {
+        OutRedReward = 0.5;
+        return true;
+    }
+    return false;
+}
+
+void ApplyMoveOrPass(FMatchReferee& Referee, const FMoveList& Moves, size_t MoveIndex)
+{
+    FMoveUndo Undo{};
+    if (Moves.IsEmpty())
+    {
+        Referee.MakePass(Undo);
+    }
+    else
+    {
+        Referee.MakeMove(Moves[MoveIndex], Undo);
+    }
+}
+
+double RunPlayout(FMatchReferee& Referee, int32_t PlayoutDepth, uint64_t& RngState)
+{
+    FMoveList Moves;
+    for (int32_t Ply = 0; Ply < PlayoutDepth; ++Ply)
+    {
+        double RedReward = 0.0;
+        if (CollectMoves(Referee, Moves, RedReward))
+        {
+            return RedReward;
+        }
+        ApplyMoveOrPass(Referee, Moves, Moves.IsEmpty() ? 0 : NextSplitMix64(RngState) % Moves.Size());
+    }
+    return EvaluateRedReward(Referee.GetState());
+}
+
+class FIsmctsWorker
+{
+public:
+    FIsmctsWorker(const FIsmctsConfig& InConfig, const FMatchReferee& InRootReferee, FIsmctsNode& InRoot, uint64_t Seed)
+        : Config(InConfig)
+        , RootState(InRootReferee.GetState())
+        , Referee(InRootReferee.GetRuleConfig())
+        , Root(InRoot)
+        , RngState(Seed)
+        , ActionMarks(ActionCount, 0)
+    {
+    }
+
+    void RunIteration()
+    {
+        FIsmctsSearch::LoadDeterminization(RootState, RootState.CurrentTurn, RngState, Config.MaxDeterminizationAttempts, Referee);
+
+        FIsmctsNode* Node = &Root;
+        double RedReward = 0.0;
+        for (int32_t Ply = 0;; ++Ply)
+        {
+            if (CollectMoves(Referee, Moves, RedReward))
+            {
+                break;
+            }
+            if (Ply >= MaxTreePly)
+            {
+                RedReward = EvaluateRedReward(Referee.GetState());
+                break;
+            }
+
+            bool bExpanded = false;
+            const size_t MoveIndex = SelectChild(Node, bExpanded);
+            ApplyMoveOrPass(Referee, Moves, MoveIndex);
+            if (bExpanded)
+            {
+                RedReward = RunPlayout(Referee, Config.PlayoutDepth, RngState);
+                break;
+            }
+        }
+
+        for (FIsmctsNode* Visited = Node; Visited != nullptr; Visited = Visited->Parent)
+        {
+            std::lock_guard<std::mutex> Lock(Visited->Parent != nullptr ? Visited->Parent->Mutex : Visited->Mutex);
+            ++Visited->Visits;
+            if (Visited != &Root)
+            {
+                Visited->VirtualVisits -= Config.VirtualLoss;
+                Visited->TotalReward += ToRewardForSide(RedReward, Visited->Mover);
+            }
+        }
+    }
+
+private:
+    // Picks the next edge from Node among the actions legal in this determinization, expanding one untried action
+    // when there is any, and advances Node. Returns the index into Moves (0 for a pass).
+    size_t SelectChild(FIsmctsNode*& Node, bool& bOutExpanded)
+    {
+        const ESide Mover = Referee.GetState().CurrentTurn;
+        const size_t ActionTotal = Moves.IsEmpty() ? 1 : Moves.Size();
+        auto GetAction = [this](size_t Index) { return Moves.IsEmpty() ? FIsmctsSearch::PassAction : ToAction(Moves[Index]); };
+
+        // Mark value is 1 + move index for a legal action; it is negated once a child for it is seen.
+        for (size_t Index = 0; Index < ActionTotal; ++Index)
+        {
+            ActionMarks[GetAction(Index)] = static_cast<int16_t>(Index + 1);
+        }
+
+        FIsmctsNode* Selected = nullptr;
+        size_t SelectedIndex = 0;
+        {
+            std::lock_guard<std::mutex> Lock(Node->Mutex);
+            double BestScore = -1.0;
+            for (const std::unique_ptr<FIsmctsNode>& Child : Node->Children)
+            {
+                int16_t& Mark = ActionMarks[Child->Action];
+                if (Mark <= 0)
+                {
+                    continue;
+                }
+                ++Child->Availability;
+                const double ChildVisits = static_cast<double>(Child->Visits) + static_cast<double>(Child->VirtualVisits);
+                const double Score = ChildVisits <= 0.0
+                                         ? 2.0
+                                         : Child->TotalReward / ChildVisits +
+                                               Config.Exploration * std::sqrt(std::log(static_cast<double>(Child->Availability)) / ChildVisits);
+                if (Score > BestScore)
+                {
+                    BestScore = Score;
+                    Selected = Child.get();
+                    SelectedIndex = static_cast<size_t>(Mark - 1);
+                }
+                Mark = static_cast<int16_t>(-Mark);
+            }
+
+            size_t UntriedCount = 0;
+            for (size_t Index = 0; Index < ActionTotal; ++Index)
+            {
+                UntriedCount += ActionMarks[GetAction(Index)] > 0 ? 1 : 0;
+            }
+            bOutExpanded = UntriedCount > 0;
+            if (bOutExpanded)
+            {
+                size_t Pick = NextSplitMix64(RngState) % UntriedCount;
+                for (size_t Index = 0; Index < ActionTotal; ++Index)
+                {
+                    if (ActionMarks[GetAction(Index)] > 0 && Pick-- == 0)
+                    {
+                        SelectedIndex = Index;
+                        break;
+                    }
+                }
+                Node->Children.push_back(std::make_unique<FIsmctsNode>(Node, GetAction(SelectedIndex), Mover));
+                Selected = Node->Children.back().get();
+                Selected->Availability = 1;
+            }
+            Selected->VirtualVisits += Config.VirtualLoss;
+        }
+
+        for (size_t Index = 0; Index < ActionTotal; ++Index)
+        {
+            ActionMarks[GetAction(Index)] = 0;
+        }
+        Node = Selected;
+        return SelectedIndex;
+    }
+
+    const FIsmctsConfig& Config;
+    const FGameState& RootState;
+    FMatchReferee Referee;
+    FIsmctsNode& Root;
+    uint64_t RngState = 0;
+    FMoveList Moves;
+    std::vector<int16_t> ActionMarks;
+};
+}
+
+FIsmctsSearch::FIsmctsSearch(const FIsmctsConfig& InConfig)
+    : Config(InConfig)
+{
+}
+
+bool FIsmctsSearch::LoadDeterminization(
+    const FGameState& State,
+    ESide Observer,
+    uint64_t& RngState,
+    int32_t MaxAttempts,
+    FMatchReferee& OutReferee)
+{
+    const FPackedGameState BasePacked = FGameStatePacker::Pack(State);
+
+    // Unrevealed opponent ids and the slots they fill: squares (alive, by cell) and captured slots (by their public
+    // surface role and flags) are known, the ids on them are not. Both lists are canonical, so a seed yields the same
+    // sample whatever the real deal is.
+    std::array<uint8_t, 16> UnknownIds{};
+    std::array<uint8_t, 16> SlotIds{};
+    size_t UnknownCount = 0;
+    size_t HiddenAliveCount = 0;
+    for (const FPieceState& Piece : State.Pieces)
+    {
+        if (Piece.Side != Observer && Piece.PieceState == EPieceState::HiddenSurface && UnknownCount < UnknownIds.size())
+        {
+            UnknownIds[UnknownCount] = static_cast<uint8_t>(Piece.PieceId);
+            SlotIds[UnknownCount++] = static_cast<uint8_t>(Piece.PieceId);
+            HiddenAliveCount += Piece.bAlive ? 1 : 0;
+        }
+    }
+    const auto GetSlotKey = [&BasePacked](uint8_t PieceId) {
+        const FPackedPiece& Piece = BasePacked.Pieces[PieceId];
+        const bool bAlive = (Piece.Flags & FPackedPiece::AliveFlag) != 0;
+        return std::make_tuple(!bAlive, Piece.Cell, Piece.Roles & 0xF0, Piece.Flags);
+    };
+    std::stable_sort(SlotIds.begin(), SlotIds.begin() + UnknownCount, [&GetSlotKey](uint8_t Lhs, uint8_t Rhs) {
+        return GetSlotKey(Lhs) < GetSlotKey(Rhs);
+    });
+
+    const ESide LastMover = GetOppositeSide(State.CurrentTurn);
+    if (UnknownCount == 0)
+    {
+        OutReferee.ImportPackedState(BasePacked);
+        return !OutReferee.IsSideInCheck(LastMover);
+    }
+
+    FGameState ScratchState;
+    for (int32_t Attempt = 0; Attempt < std::max(MaxAttempts, 1); ++Attempt)
+    {
+        std::array<uint8_t, 16> DealtIds = UnknownIds;
+        for (size_t Index = UnknownCount - 1; Index > 0; --Index)
+        {
+            std::swap(DealtIds[Index], DealtIds[NextSplitMix64(RngState) % (Index + 1)]);
+        }
+
+        // The game is still on, so an unrevealed king must be dealt onto a board square.
+        for (size_t Index = HiddenAliveCount; Index < UnknownCount && HiddenAliveCount > 0; ++Index)
+        {
+            if (State.Pieces[DealtIds[Index]].ActualRole == ERoleType::King)
+            {
+                std::swap(DealtIds[Index], DealtIds[NextSplitMix64(RngState) % HiddenAliveCount]);
+                break;
+            }
+        }
+
+        FPackedGameState Packed = BasePacked;
+        for (size_t Index = 0; Index < UnknownCount; ++Index)
+        {
+            const FPackedPiece& Source = BasePacked.Pieces[SlotIds[Index]];
+            FPackedPiece& Target = Packed.Pieces[DealtIds[Index]];
+            Target.Cell = Source.Cell;
+            Target.Roles = static_cast<uint8_t>((BasePacked.Pieces[DealtIds[Index]].Roles & 0x0F) | (Source.Roles & 0xF0));
+            Target.Flags = Source.Flags;
+            if (Source.Cell != FPackedPiece::OffBoardCell)
+            {
+                Packed.BoardCells[Source.Cell] = DealtIds[Index];
+            }
+        }
+
+        FGameStatePacker::Unpack(Packed, ScratchState);
+        Packed.PositionHash = FMatchReferee::ComputePositionHash(ScratchState);
+        OutReferee.ImportPackedState(Packed);
+        if (!OutReferee.IsSideInCheck(LastMover))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+FIsmctsResult FIsmctsSearch::Search(const FMatchReferee& Referee, uint64_t Seed) const
+{
+    const auto StartTime = std::chrono::steady_clock::now();
+    FIsmctsResult Result{};
+    const FGameState& State = Referee.GetState();
+    if (State.Phase != EGamePhase::Battle || State.Result != EGameResult::Ongoing)
+    {
+        return Result;
+    }
+
+    const ESide Side = State.CurrentTurn;
+    Result.bHasCommand = true;
+    Result.BestCommand.Side = Side;
+
+    FMoveList RootMoves;
+    Referee.GenerateLegalMoves(Side, RootMoves);
+    if (RootMoves.IsEmpty())
+    {
+        Result.BestCommand.CommandType = Referee.CanPass(Side) ? ECommandType::Pass : ECommandType::Resign;
+        return Result;
+    }
+    Result.BestCommand.CommandType = ECommandType::Move;
+    Result.BestCommand.Move = RootMoves[0];
+    if (RootMoves.Size() == 1)
+    {
+        return Result;
+    }
+
+    FIsmctsNode Root(nullptr, -1, GetOppositeSide(Side));
+    std::atomic<uint64_t> StartedIterations{0};
+    const auto Deadline = StartTime + std::chrono::milliseconds(Config.TimeBudgetMs);
+
+    auto RunWorker = [this, &Referee, &Root, &StartedIterations, Deadline, Seed](int32_t WorkerIndex) {
+        FIsmctsWorker Worker(Config, Referee, Root, Seed ^ (0xd1b54a32d192ed03ull * static_cast<uint64_t>(WorkerIndex + 1)));
+        while (true)
+        {
+            const uint64_t Iteration = StartedIterations.fetch_add(1, std::memory_order_relaxed);
+            if (Config.MaxIterations > 0 && Iteration >= Config.MaxIterations)
+            {
+                break;
+            }
+            if (Config.TimeBudgetMs > 0 && std::chrono::steady_clock::now() >= Deadline)
+            {
+                break;
+            }
+            Worker.RunIteration();
+        }
+    };
+
+    const int32_t ThreadCount = std::max(Config.ThreadCount, 1);
+    std::vector<std::thread> Threads;
+    Threads.reserve(static_cast<size_t>(ThreadCount - 1));
+    for (int32_t WorkerIndex = 1; WorkerIndex < ThreadCount; ++WorkerIndex)
+    {
+        Threads.emplace_back(RunWorker, WorkerIndex);
+    }
+    RunWorker(0);
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    for (const FMoveAction& Move : RootMoves)
+    {
+        const int32_t Action = ToAction(Move);
+        for (const std::unique_ptr<FIsmctsNode>& Child : Root.Children)
+        {
+            if (Child->Action == Action && Child->Visits > Result.BestVisits)
+            {
+                Result.BestVisits = Child->Visits;
+                Result.BestValue = Child->TotalReward / static_cast<double>(Child->Visits);
+                Result.BestCommand.Move = Move;
+            }
+        }
+    }
+    Result.Iterations = Root.Visits;
+    Result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    return Result;
+}
@@ -1,43 +1,129 @@
 ﻿#include "CoreRules/MatchReferee.h"
 
+#include "CoreRules/BoardGeometry.h"
+#include "CoreRules/RandomSetup.h"
+#include "CoreRules/SetupCommitment.h"
+
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
-#include <iomanip>
-#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace
 {
-struct FSetupSlot
+struct FZobristKeys
 {
-    FBoardPos Pos{};
-    ERoleType SurfaceRole = ERoleType::Pawn;
+    std::array<std::array<uint64_t, 90>, 32> PieceSquare{};
+    std::array<std::array<uint64_t, 7>, 32> PieceRole{};
+    std::array<uint64_t, 32> PieceRevealed{};
+    std::array<uint64_t, 32> PieceFrozen{};
+    uint64_t BlackToMove = 0;
+    std::array<uint64_t, 4> PassCount{};
 };
 
-constexpr std::array<FSetupSlot, 16> RedSetupSlots = {{
-    {{0, 0}, ERoleType::Rook},
-    {{1, 0}, ERoleType::Horse},
-    {{2, 0}, ERoleType::Elephant},
-    {{3, 0}, ERoleType::Advisor},
-    {{4, 0}, ERoleType::King},
-    {{5, 0}, ERoleType::Advisor},
-    {{6, 0}, ERoleType::Elephant},
-    {{7, 0}, ERoleType::Horse},
-    {{8, 0}, ERoleType::Rook},
-    {{1, 2}, ERoleType::Cannon},
-    {{7, 2}, ERoleType::Cannon},
-    {{0, 3}, ERoleType::Pawn},
-    {{2, 3}, ERoleType::Pawn},
-    {{4, 3}, ERoleType::Pawn},
-    {{6, 3}, ERoleType::Pawn},
-    {{8, 3}, ERoleType::Pawn},
-}};
-
-constexpr uint64_t FnvOffset = 1469598103934665603ull;
-constexpr uint64_t FnvPrime = 1099511628211ull;
+constexpr FZobristKeys BuildZobristKeys()
+{
+    FZobristKeys Keys{};
+    uint64_t Seed = 0x5374757069644368ull;
+    for (auto& SquareKeys : Keys.PieceSquare)
+    {
+        for (uint64_t& Key : SquareKeys)
+        {
+            Key = NextSplitMix64(Seed);
+        }
+    }
+    for (auto& RoleKeys : Keys.PieceRole)
+    {
+        for (uint64_t& Key : RoleKeys)
+        {
+            Key = NextSplitMix64(Seed);
+        }
+    }
+    for (uint64_t& Key : Keys.PieceRevealed)
+    {
+        Key = NextSplitMix64(Seed);
+    }
+    for (uint64_t& Key : Keys.PieceFrozen)
+    {
+        Key = NextSplitMix64(Seed);
+    }
+    Keys.BlackToMove = NextSplitMix64(Seed);
+    // PassCount 0 contributes nothing so an empty board hashes to zero.
+    for (size_t Index = 1; Index < Keys.PassCount.size(); ++Index)
+    {
+        Keys.PassCount[Index] = NextSplitMix64(Seed);
+    }
+    return Keys;
+}
+
+constexpr FZobristKeys ZobristKeys = BuildZobristKeys();
+
+uint64_t GetPassCountHashKey(int32_t PassCount) noexcept
+{
+    return ZobristKeys.PassCount[static_cast<size_t>(std::clamp(PassCount, 0, 3))];
+}
+
+constexpr std::array<uint8_t, 4> SnapshotMagic = {'S', 'C', 'R', 'F'};
+// Magic, version, rule flags, commit flags, turn index, position hash, pass count, six state bytes, board cells.
+constexpr size_t SnapshotFixedSize = 4 + 2 + 1 + 1 + 8 + 8 + 4 + 6 + 90;
+constexpr size_t SnapshotChecksumSize = 4;
+
+constexpr std::array<uint32_t, 256> BuildSnapshotCrc32Table()
+{
+    std::array<uint32_t, 256> Table{};
+    for (uint32_t Index = 0; Index < Table.size(); ++Index)
+    {
+        uint32_t Value = Index;
+        for (int32_t Bit = 0; Bit < 8; ++Bit)
+        {
+            Value = (Value & 1u) != 0 ? (Value >> 1) ^ 0xEDB88320u : Value >> 1;
+        }
+        Table[Index] = Value;
+    }
+    return Table;
+}
+
+constexpr std::array<uint32_t, 256> SnapshotCrc32Table = BuildSnapshotCrc32Table();
+
+uint32_t ComputeSnapshotCrc32(std::span<const uint8_t> Bytes) noexcept
+{
+    uint32_t Crc = 0xFFFFFFFFu;
+    for (const uint8_t Byte : Bytes)
+    {
+        Crc = SnapshotCrc32Table[(Crc ^ Byte) & 0xFFu] ^ (Crc >> 8);
+    }
+    return Crc ^ 0xFFFFFFFFu;
+}
+
+void AppendSnapshotInteger(std::vector<uint8_t>& OutBytes, uint64_t Value, size_t ByteCount)
+{
+    for (size_t Index = 0; Index < ByteCount; ++Index)
+    {
+        OutBytes.push_back(static_cast<uint8_t>(Value >> (8 * Index)));
+    }
+}
+
+// push_back rather than insert: GCC 12 reports false -Wstringop-overflow for range inserts into a reserved vector.
+void AppendSnapshotBytes(std::vector<uint8_t>& OutBytes, std::span<const uint8_t> Bytes)
+{
+    for (const uint8_t Byte : Bytes)
+    {
+        OutBytes.push_back(Byte);
+    }
+}
+
+uint64_t ReadSnapshotInteger(const uint8_t* Bytes, size_t ByteCount) noexcept
+{
+    uint64_t Value = 0;
+    for (size_t Index = 0; Index < ByteCount; ++Index)
+    {
+        Value |= static_cast<uint64_t>(Bytes[Index]) << (8 * Index);
+    }
+    return Value;
+}
 
 FCommandResult BuildAcceptedResult()
 {
@@ -48,6 +134,59 @@ FCommandResult BuildRejectedResult(std::string ErrorCode, std::string ErrorMessa
 {
     return FCommandResult{false, std::move(ErrorCode), std::move(ErrorMessage)};
 }
+
+FGameEvent BuildGameEndedEvent(const FGameState& State) noexcept
+{
+    FGameEvent Event{};
+    Event.EventType = EGameEventType::GameEnded;
+    Event.Side = State.CurrentTurn;
+    Event.Result = State.Result;
+    Event.EndReason = State.EndReason;
+    return Event;
+}
+
+// Reads the move's transitions back from the undo record MakeMove already filled in. Roles are the ones both
+// players may see, since the session logs these events for both sides.
+void AppendMoveEvents(const FGameState& State, const FMoveUndo& Undo, bool bRevealCapturedRole, FGameEventList& OutEvents) noexcept
+{
+    const FPieceState& Mover = State.Pieces[Undo.Move.PieceId];
+    FGameEvent Event{};
+    Event.EventType = EGameEventType::PieceMoved;
+    Event.Side = Mover.Side;
+    Event.PieceId = Mover.PieceId;
+    Event.From = Undo.Move.From;
+    Event.To = Undo.Move.To;
+    OutEvents.PushBack(Event);
+
+    if (Undo.Move.CapturedPieceId.has_value())
+    {
+        const FPieceState& Captured = State.Pieces[Undo.Move.CapturedPieceId.value()];
+        FGameEvent CaptureEvent{};
+        CaptureEvent.EventType = EGameEventType::PieceCaptured;
+        CaptureEvent.Side = Captured.Side;
+        CaptureEvent.PieceId = Captured.PieceId;
+        const bool bCapturedRolePublic = bRevealCapturedRole || Captured.PieceState == EPieceState::RevealedActual;
+        CaptureEvent.Role = bCapturedRolePublic ? Captured.ActualRole : Captured.SurfaceRole;
+        CaptureEvent.To = Undo.Move.To;
+        OutEvents.PushBack(CaptureEvent);
+    }
+
+    Event = FGameEvent{};
+    Event.Side = Mover.Side;
+    Event.PieceId = Mover.PieceId;
+    Event.Role = Mover.ActualRole;
+    Event.To = Undo.Move.To;
+    if (Undo.bMoverRevealed)
+    {
+        Event.EventType = EGameEventType::PieceRevealed;
+        OutEvents.PushBack(Event);
+    }
+    if (Undo.bMoverFrozen)
+    {
+        Event.EventType = EGameEventType::PieceFrozen;
+        OutEvents.PushBack(Event);
+    }
+}
 }
 
 int32_t FMatchReferee::ToCellIndex(const FBoardPos& Pos) noexcept
@@ -55,6 +194,16 @@ int32_t FMatchReferee::ToCellIndex(const FBoardPos& Pos) noexcept
     return static_cast<int32_t>(Pos.Y) * 9 + static_cast<int32_t>(Pos.X);
 }
 
+FBoardPos FMatchReferee::FromCellIndex(int32_t Cell) noexcept
+{
+    return FBoardPos{static_cast<int8_t>(Cell % 9), static_cast<int8_t>(Cell / 9)};
+}
+
+int32_t FMatchReferee::ToSideIndex(ESide Side) noexcept
+{
+    return Side == ESide::Red ? 0 : 1;
+}
+
 ESide FMatchReferee::GetOppositeSide(ESide Side) noexcept
 {
     return Side == ESide::Red ? ESide::Black : ESide::Red;
@@ -62,6 +211,7 @@ ESide FMatchReferee::GetOppositeSide(ESide Side) noexcept
 
 FMatchReferee::FMatchReferee(FRuleConfig InRuleConfig)
     : RuleConfig(InRuleConfig)
+    , RulePolicyKind(FindRulePolicyKind(InRuleConfig))
 {
     ResetNewMatch();
 }
@@ -98,6 +248,8 @@ void FMatchReferee::ResetNewMatch()
     GameState.TurnIndex = 0;
     GameState.BoardCells.fill(std::nullopt);
 
+    GameState.PositionHash = ComputePositionHash(GameState);
+
     RedCommitHash.clear();
     BlackCommitHash.clear();
     bHasRedCommit = false;
@@ -106,11 +258,185 @@ void FMatchReferee::ResetNewMatch()
     InitializePieceRoster();
 }
 
+FPackedGameState FMatchReferee::ExportPackedState() const noexcept
+{
+    return FGameStatePacker::Pack(GameState);
+}
+
+void FMatchReferee::ImportPackedState(const FPackedGameState& PackedState)
+{
+    FGameStatePacker::Unpack(PackedState, GameState);
+}
+
+void FMatchReferee::Serialize(std::vector<uint8_t>& OutBytes) const
+{
+    const FPackedGameState Packed = FGameStatePacker::Pack(GameState);
+    OutBytes.clear();
+    OutBytes.reserve(SnapshotFixedSize + Packed.PieceCount * 3 + 8 + RedCommitHash.size() + BlackCommitHash.size() +
+                     SnapshotChecksumSize);
+
+    AppendSnapshotBytes(OutBytes, SnapshotMagic);
+    AppendSnapshotInteger(OutBytes, SnapshotVersion, 2);
+    OutBytes.push_back(static_cast<uint8_t>((RuleConfig.bRevealOnFirstCapture ? 1u << 0 : 0u) |
+                                            (RuleConfig.bRevealCapturedRole ? 1u << 1 : 0u) |
+                                            (RuleConfig.bFreezeIfIllegalAfterReveal ? 1u << 2 : 0u) |
+                                            (RuleConfig.bAllowPassWhenNoLegalMove ? 1u << 3 : 0u) |
+                                            (RuleConfig.bDoublePassIsDraw ? 1u << 4 : 0u)));
+    OutBytes.push_back(static_cast<uint8_t>((bHasRedCommit ? 1u << 0 : 0u) | (bHasBlackCommit ? 1u << 1 : 0u)));
+    AppendSnapshotInteger(OutBytes, Packed.TurnIndex, 8);
+    AppendSnapshotInteger(OutBytes, Packed.PositionHash, 8);
+    AppendSnapshotInteger(OutBytes, static_cast<uint32_t>(Packed.PassCount), 4);
+    OutBytes.push_back(static_cast<uint8_t>(Packed.Phase));
+    OutBytes.push_back(static_cast<uint8_t>(Packed.CurrentTurn));
+    OutBytes.push_back(static_cast<uint8_t>(Packed.Result));
+    OutBytes.push_back(static_cast<uint8_t>(Packed.EndReason));
+    OutBytes.push_back(Packed.SetupFlags);
+    OutBytes.push_back(Packed.PieceCount);
+    AppendSnapshotBytes(OutBytes, Packed.BoardCells);
+    for (size_t Index = 0; Index < Packed.PieceCount; ++Index)
+    {
+        OutBytes.push_back(Packed.Pieces[Index].Cell);
+        OutBytes.push_back(Packed.Pieces[Index].Roles);
+        OutBytes.push_back(Packed.Pieces[Index].Flags);
+    }
+    for (const std::string* CommitHash : {&RedCommitHash, &BlackCommitHash})
+    {
+        AppendSnapshotInteger(OutBytes, CommitHash->size(), 4);
+        AppendSnapshotBytes(OutBytes, std::span(reinterpret_cast<const uint8_t*>(CommitHash->data()), CommitHash->size()));
+    }
+    AppendSnapshotInteger(OutBytes, ComputeSnapshotCrc32(OutBytes), SnapshotChecksumSize);
+}
+
+bool FMatchReferee::Deserialize(std::span<const uint8_t> Bytes, std::string& OutError)
+{
+    if (Bytes.size() < SnapshotFixedSize + SnapshotChecksumSize ||
+        !std::equal(SnapshotMagic.begin(), SnapshotMagic.end(), Bytes.begin()))
+    {
+        OutError = "Not a referee snapshot.";
+        return false;
+    }
+    if (ReadSnapshotInteger(&Bytes[4], 2) != SnapshotVersion)
+    {
+        OutError = "Unsupported referee snapshot version " + std::to_string(ReadSnapshotInteger(&Bytes[4], 2)) + ".";
+        return false;
+    }
+    const std::span<const uint8_t> Body = Bytes.first(Bytes.size() - SnapshotChecksumSize);
+    if (ReadSnapshotInteger(&Bytes[Body.size()], SnapshotChecksumSize) != ComputeSnapshotCrc32(Body))
+    {
+        OutError = "Referee snapshot checksum mismatch.";
+        return false;
+    }
+
+    const uint8_t RuleFlags = Bytes[6];
+    const uint8_t CommitFlags = Bytes[7];
+    FPackedGameState Packed{};
+    Packed.TurnIndex = ReadSnapshotInteger(&Bytes[8], 8);
+    Packed.PositionHash = ReadSnapshotInteger(&Bytes[16], 8);
+    Packed.PassCount = static_cast<int32_t>(static_cast<uint32_t>(ReadSnapshotInteger(&Bytes[24], 4)));
+    Packed.Phase = static_cast<EGamePhase>(Bytes[28]);
+    Packed.CurrentTurn = static_cast<ESide>(Bytes[29]);
+    Packed.Result = static_cast<EGameResult>(Bytes[30]);
+    Packed.EndReason = static_cast<EEndReason>(Bytes[31]);
+    Packed.SetupFlags = Bytes[32];
+    Packed.PieceCount = Bytes[33];
+    std::copy_n(&Bytes[34], Packed.BoardCells.size(), Packed.BoardCells.begin());
+    if (RuleFlags >= (1u << 5) || CommitFlags >= (1u << 2) || Packed.PassCount < 0 || Bytes[28] > static_cast<uint8_t>(EGamePhase::GameOver) ||
+        Bytes[29] > static_cast<uint8_t>(ESide::Black) || Bytes[30] > static_cast<uint8_t>(EGameResult::Draw) ||
+        Bytes[31] > static_cast<uint8_t>(EEndReason::Tablebase) || Packed.SetupFlags >= (1u << 4) ||
+        Packed.PieceCount != Packed.Pieces.size())
+    {
+        OutError = "Referee snapshot has an invalid header.";
+        return false;
+    }
+
+    size_t Offset = SnapshotFixedSize;
+    if (Body.size() < Offset + Packed.PieceCount * 3)
+    {
+        OutError = "Referee snapshot is truncated.";
+        return false;
+    }
+    for (size_t Index = 0; Index < Packed.PieceCount; ++Index, Offset += 3)
+    {
+        FPackedPiece& Piece = Packed.Pieces[Index];
+        Piece = FPackedPiece{Bytes[Offset], Bytes[Offset + 1], Bytes[Offset + 2]};
+        const bool bOnBoard = Piece.Cell != FPackedPiece::OffBoardCell;
+        const bool bAlive = (Piece.Flags & FPackedPiece::AliveFlag) != 0;
+        if ((bOnBoard && Piece.Cell >= Packed.BoardCells.size()) || (Piece.Roles & 0x0F) > static_cast<uint8_t>(ERoleType::Pawn) ||
+            (Piece.Roles >> 4) > static_cast<uint8_t>(ERoleType::Pawn) || Piece.Flags >= (1u << 5) ||
+            (bAlive && (!bOnBoard || Packed.BoardCells[Piece.Cell] != Index)) ||
+            ((Piece.Flags & FPackedPiece::BlackSideFlag) != 0) != (Index >= 16))
+        {
+            OutError = "Referee snapshot has an invalid piece " + std::to_string(Index) + ".";
+            return false;
+        }
+    }
+    for (size_t Cell = 0; Cell < Packed.BoardCells.size(); ++Cell)
+    {
+        const uint8_t Occupant = Packed.BoardCells[Cell];
+        if (Occupant != FPackedGameState::EmptyCell &&
+            (Occupant >= Packed.PieceCount || (Packed.Pieces[Occupant].Flags & FPackedPiece::AliveFlag) == 0 ||
+             Packed.Pieces[Occupant].Cell != Cell))
+        {
+            OutError = "Referee snapshot has an invalid board cell " + std::to_string(Cell) + ".";
+            return false;
+        }
+    }
+
+    std::array<std::string, 2> CommitHashes;
+    for (std::string& CommitHash : CommitHashes)
+    {
+        const size_t Length = Body.size() - Offset >= 4 ? static_cast<size_t>(ReadSnapshotInteger(&Bytes[Offset], 4)) : 0;
+        if (Body.size() - Offset < 4 || Body.size() - Offset - 4 < Length)
+        {
+            OutError = "Referee snapshot is truncated.";
+            return false;
+        }
+        CommitHash.assign(reinterpret_cast<const char*>(&Bytes[Offset + 4]), Length);
+        Offset += 4 + Length;
+    }
+    if (Offset != Body.size())
+    {
+        OutError = "Referee snapshot has trailing bytes.";
+        return false;
+    }
+
+    FGameState State;
+    FGameStatePacker::Unpack(Packed, State);
+    if (ComputePositionHash(State) != State.PositionHash)
+    {
+        OutError = "Referee snapshot position hash does not match its pieces.";
+        return false;
+    }
+
+    RuleConfig.bRevealOnFirstCapture = (RuleFlags & (1u << 0)) != 0;
+    RuleConfig.bRevealCapturedRole = (RuleFlags & (1u << 1)) != 0;
+    RuleConfig.bFreezeIfIllegalAfterReveal = (RuleFlags & (1u << 2)) != 0;
+    RuleConfig.bAllowPassWhenNoLegalMove = (RuleFlags & (1u << 3)) != 0;
+    RuleConfig.bDoublePassIsDraw = (RuleFlags & (1u << 4)) != 0;
+    RulePolicyKind = FindRulePolicyKind(RuleConfig);
+    GameState = std::move(State);
+    RedCommitHash = std::move(CommitHashes[0]);
+    BlackCommitHash = std::move(CommitHashes[1]);
+    bHasRedCommit = (CommitFlags & (1u << 0)) != 0;
+    bHasBlackCommit = (CommitFlags & (1u << 1)) != 0;
+    return true;
+}
+
 const FGameState& FMatchReferee::GetState() const noexcept
 {
     return GameState;
 }
 
+const FRuleConfig& FMatchReferee::GetRuleConfig() const noexcept
+{
+    return RuleConfig;
+}
+
+ERulePolicyKind FMatchReferee::GetRulePolicyKind() const noexcept
+{
+    return RulePolicyKind;
+}
+
 const FPieceState* FMatchReferee::FindPieceById(FPieceId PieceId) const noexcept
 {
     const int32_t Index = static_cast<int32_t>(PieceId);
@@ -163,97 +489,117 @@ FPieceState* FMatchReferee::GetPieceAt(const FBoardPos& Pos) noexcept
     return FindPieceById(Cell.value());
 }
 
-bool FMatchReferee::IsInsidePalace(ESide Side, const FBoardPos& Pos) const noexcept
+FBoardBitboard FMatchReferee::GetOccupancy() const noexcept
+{
+    return GameState.SideOccupancy[0] | GameState.SideOccupancy[1];
+}
+
+uint64_t FMatchReferee::GetPieceHashKey(const FPieceState& Piece) noexcept
 {
-    if (!Pos.IsValid() || Pos.X < 3 || Pos.X > 5)
+    if (!Piece.bAlive || !Piece.Pos.IsValid() || Piece.PieceId >= ZobristKeys.PieceSquare.size())
     {
-        return false;
+        return 0;
     }
 
-    if (Side == ESide::Red)
+    const ERoleType ActiveRole = Piece.PieceState == EPieceState::HiddenSurface ? Piece.SurfaceRole : Piece.ActualRole;
+    uint64_t Key = ZobristKeys.PieceSquare[Piece.PieceId][ToCellIndex(Piece.Pos)] ^
+                   ZobristKeys.PieceRole[Piece.PieceId][static_cast<size_t>(ActiveRole)];
+    if (Piece.PieceState == EPieceState::RevealedActual)
     {
-        return Pos.Y >= 0 && Pos.Y <= 2;
+        Key ^= ZobristKeys.PieceRevealed[Piece.PieceId];
     }
-
-    return Pos.Y >= 7 && Pos.Y <= 9;
+    if (Piece.bFrozen)
+    {
+        Key ^= ZobristKeys.PieceFrozen[Piece.PieceId];
+    }
+    return Key;
 }
 
-bool FMatchReferee::IsAdvisorPoint(ESide Side, const FBoardPos& Pos) const noexcept
+uint64_t FMatchReferee::ComputePositionHash(const FGameState& State) noexcept
 {
-    if (!IsInsidePalace(Side, Pos))
+    uint64_t Hash = 0;
+    for (const FPieceState& Piece : State.Pieces)
     {
-        return false;
+        Hash ^= GetPieceHashKey(Piece);
     }
+    if (State.CurrentTurn == ESide::Black)
+    {
+        Hash ^= ZobristKeys.BlackToMove;
+    }
+    return Hash ^ GetPassCountHashKey(State.PassCount);
+}
 
-    static constexpr std::array<FBoardPos, 5> RedAdvisorPoints = {{{3, 0}, {5, 0}, {4, 1}, {3, 2}, {5, 2}}};
-
-    for (const FBoardPos& RedPoint : RedAdvisorPoints)
+void FMatchReferee::SetCurrentTurn(ESide Side) noexcept
+{
+    if (GameState.CurrentTurn != Side)
     {
-        const FBoardPos Candidate = Side == ESide::Red ? RedPoint : FBoardPos{RedPoint.X, static_cast<int8_t>(9 - RedPoint.Y)};
-        if (Candidate == Pos)
-        {
-            return true;
-        }
+        GameState.PositionHash ^= ZobristKeys.BlackToMove;
+        GameState.CurrentTurn = Side;
     }
+}
 
-    return false;
+void FMatchReferee::SetPassCount(int32_t PassCount) noexcept
+{
+    GameState.PositionHash ^= GetPassCountHashKey(GameState.PassCount) ^ GetPassCountHashKey(PassCount);
+    GameState.PassCount = PassCount;
 }
 
-bool FMatchReferee::IsElephantPoint(ESide Side, const FBoardPos& Pos) const noexcept
+void FMatchReferee::PlaceOnBoard(FPieceId PieceId, ESide Side, const FBoardPos& Pos) noexcept
 {
-    if (!Pos.IsValid())
+    const int32_t Cell = ToCellIndex(Pos);
+    GameState.BoardCells[Cell] = PieceId;
+    GameState.SideOccupancy[ToSideIndex(Side)].Set(Cell);
+}
+
+void FMatchReferee::RemoveFromBoard(ESide Side, const FBoardPos& Pos) noexcept
+{
+    const int32_t Cell = ToCellIndex(Pos);
+    GameState.BoardCells[Cell] = std::nullopt;
+    GameState.SideOccupancy[ToSideIndex(Side)].Clear(Cell);
+}
+
+void FMatchReferee::SyncPieceCaches(const FPieceState& Piece) noexcept
+{
+    const int32_t SideIndex = ToSideIndex(Piece.Side);
+    const uint16_t PieceBit = static_cast<uint16_t>(1u << (Piece.PieceId % 16));
+    if (Piece.bAlive && !Piece.bFrozen)
     {
-        return false;
+        GameState.MovablePieceMasks[SideIndex] |= PieceBit;
+    }
+    else
+    {
+        GameState.MovablePieceMasks[SideIndex] &= static_cast<uint16_t>(~PieceBit);
     }
 
-    static constexpr std::array<FBoardPos, 7> RedElephantPoints = {{{2, 0}, {6, 0}, {0, 2}, {4, 2}, {8, 2}, {2, 4}, {6, 4}}};
-
-    for (const FBoardPos& RedPoint : RedElephantPoints)
+    if (Piece.ActualRole == ERoleType::King)
     {
-        const FBoardPos Candidate = Side == ESide::Red ? RedPoint : FBoardPos{RedPoint.X, static_cast<int8_t>(9 - RedPoint.Y)};
-        if (Candidate == Pos)
-        {
-            return true;
-        }
+        GameState.KingCells[SideIndex] = Piece.bAlive ? static_cast<int8_t>(ToCellIndex(Piece.Pos)) : int8_t{-1};
     }
+}
 
-    return false;
+bool FMatchReferee::IsInsidePalace(ESide Side, const FBoardPos& Pos) const noexcept
+{
+    return Pos.IsValid() && BoardGeometry.Palace[ToSideIndex(Side)][ToCellIndex(Pos)];
 }
 
-bool FMatchReferee::IsCrossedRiver(ESide Side, const FBoardPos& Pos) const noexcept
+bool FMatchReferee::IsAdvisorPoint(ESide Side, const FBoardPos& Pos) const noexcept
 {
-    if (Side == ESide::Red)
-    {
-        return Pos.Y >= 5;
-    }
-    return Pos.Y <= 4;
+    return Pos.IsValid() && BoardGeometry.AdvisorPoint[ToSideIndex(Side)][ToCellIndex(Pos)];
 }
 
-ERoleType FMatchReferee::GetInitialSurfaceRoleForPos(ESide Side, const FBoardPos& Pos) const
+bool FMatchReferee::IsElephantPoint(ESide Side, const FBoardPos& Pos) const noexcept
 {
-    for (const FSetupSlot& RedSlot : RedSetupSlots)
-    {
-        const FBoardPos CandidatePos = Side == ESide::Red ? RedSlot.Pos : FBoardPos{RedSlot.Pos.X, static_cast<int8_t>(9 - RedSlot.Pos.Y)};
-        if (CandidatePos == Pos)
-        {
-            return RedSlot.SurfaceRole;
-        }
-    }
+    return Pos.IsValid() && BoardGeometry.ElephantPoint[ToSideIndex(Side)][ToCellIndex(Pos)];
+}
 
-    return ERoleType::Pawn;
+ERoleType FMatchReferee::GetInitialSurfaceRoleForPos(ESide Side, const FBoardPos& Pos) const
+{
+    return Pos.IsValid() ? BoardGeometry.SurfaceRole[ToSideIndex(Side)][ToCellIndex(Pos)] : ERoleType::Pawn;
 }
 
 bool FMatchReferee::IsSetupPositionAllowed(ESide Side, const FBoardPos& Pos) const
 {
-    for (const FSetupSlot& RedSlot : RedSetupSlots)
-    {
-        const FBoardPos CandidatePos = Side == ESide::Red ? RedSlot.Pos : FBoardPos{RedSlot.Pos.X, static_cast<int8_t>(9 - RedSlot.Pos.Y)};
-        if (CandidatePos == Pos)
-        {
-            return true;
-        }
-    }
-    return false;
+    return Pos.IsValid() && BoardGeometry.SetupSlot[ToSideIndex(Side)][ToCellIndex(Pos)];
 }
 
 bool FMatchReferee::IsPieceIdOwnedBySide(FPieceId PieceId, ESide Side) const noexcept
@@ -335,302 +681,279 @@ int32_t FMatchReferee::CountPiecesBetweenStraight(const FBoardPos& From, const F
         return -1;
     }
 
-    const int32_t StepX = To.X == From.X ? 0 : (To.X > From.X ? 1 : -1);
-    const int32_t StepY = To.Y == From.Y ? 0 : (To.Y > From.Y ? 1 : -1);
-    int32_t CursorX = static_cast<int32_t>(From.X) + StepX;
-    int32_t CursorY = static_cast<int32_t>(From.Y) + StepY;
-    int32_t Count = 0;
-
-    while (CursorX != To.X || CursorY != To.Y)
-    {
-        const FBoardPos CursorPos{static_cast<int8_t>(CursorX), static_cast<int8_t>(CursorY)};
-        if (GetPieceAt(CursorPos) != nullptr)
-        {
-            ++Count;
-        }
-        CursorX += StepX;
-        CursorY += StepY;
-    }
-
-    return Count;
+    return (GetOccupancy() & GetBetweenMask(ToCellIndex(From), ToCellIndex(To))).Count();
 }
 
-std::vector<FMoveAction> FMatchReferee::GeneratePseudoMovesForPiece(const FPieceState& Piece) const
+void FMatchReferee::GeneratePseudoMovesForPiece(const FPieceState& Piece, FPieceMoveList& OutMoves) const
 {
-    std::vector<FMoveAction> Moves;
+    OutMoves.Clear();
     if (!Piece.bAlive || Piece.bFrozen || !Piece.Pos.IsValid())
     {
-        return Moves;
+        return;
     }
 
-    auto TryAddMove = [this, &Piece, &Moves](const FBoardPos& To, bool bCaptureOnly, bool bMoveOnly) {
-        if (!To.IsValid())
+    const FBoardBitboard Occupancy = GetOccupancy();
+    const FBoardBitboard& EnemyOccupancy = GameState.SideOccupancy[ToSideIndex(GetOppositeSide(Piece.Side))];
+    const int32_t FromCell = ToCellIndex(Piece.Pos);
+
+    auto AddCapture = [this, &Piece, &OutMoves](int32_t Cell) {
+        OutMoves.PushBack(FMoveAction{Piece.PieceId, Piece.Pos, FromCellIndex(Cell), GameState.BoardCells[Cell]});
+    };
+
+    auto TryAddCell = [&Piece, &OutMoves, &Occupancy, &EnemyOccupancy, &AddCapture](int32_t ToCell) {
+        if (!Occupancy.Test(ToCell))
+        {
+            OutMoves.PushBack(FMoveAction{Piece.PieceId, Piece.Pos, FromCellIndex(ToCell), std::nullopt});
+        }
+        else if (EnemyOccupancy.Test(ToCell))
         {
-            return;
+            AddCapture(ToCell);
         }
+    };
 
-        const FPieceState* Occupant = GetPieceAt(To);
-        if (Occupant == nullptr)
+    // Steps whose block cell (horse leg, elephant eye) is occupied are skipped.
+    auto AddSteps = [&Occupancy, &TryAddCell](const FCellSteps& Steps) {
+        for (uint8_t StepIndex = 0; StepIndex < Steps.Count; ++StepIndex)
         {
-            if (!bCaptureOnly)
+            const int32_t BlockCell = Steps.BlockCells[StepIndex];
+            if (BlockCell >= 0 && Occupancy.Test(BlockCell))
             {
-                Moves.push_back(FMoveAction{Piece.PieceId, Piece.Pos, To, std::nullopt});
+                continue;
             }
-            return;
+            TryAddCell(Steps.Cells[StepIndex]);
         }
+    };
 
-        if (Occupant->Side == Piece.Side || bMoveOnly)
+    // Quiet cells of a ray are emitted nearest first, matching a square-by-square walk.
+    auto AddQuietRayMoves = [&Piece, &OutMoves](FBoardBitboard Cells, EBoardDirection Direction) {
+        while (!Cells.IsEmpty())
         {
-            return;
+            const int32_t Cell = IsIncreasingDirection(Direction) ? Cells.PopLowestCell() : Cells.PopHighestCell();
+            OutMoves.PushBack(FMoveAction{Piece.PieceId, Piece.Pos, FromCellIndex(Cell), std::nullopt});
         }
-
-        Moves.push_back(FMoveAction{Piece.PieceId, Piece.Pos, To, Occupant->PieceId});
     };
 
+    const int32_t SideIndex = ToSideIndex(Piece.Side);
     const ERoleType ActiveRole = GetActiveRole(Piece);
     switch (ActiveRole)
     {
     case ERoleType::King:
-    {
-        static constexpr std::array<FBoardPos, 4> Delta = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
-        for (const FBoardPos& D : Delta)
-        {
-            const FBoardPos To{static_cast<int8_t>(Piece.Pos.X + D.X), static_cast<int8_t>(Piece.Pos.Y + D.Y)};
-            if (IsInsidePalace(Piece.Side, To))
-            {
-                TryAddMove(To, false, false);
-            }
-        }
+        AddSteps(BoardGeometry.KingSteps[SideIndex][FromCell]);
         break;
-    }
     case ERoleType::Advisor:
-    {
-        static constexpr std::array<FBoardPos, 4> Delta = {{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
-        for (const FBoardPos& D : Delta)
-        {
-            const FBoardPos To{static_cast<int8_t>(Piece.Pos.X + D.X), static_cast<int8_t>(Piece.Pos.Y + D.Y)};
-            if (IsAdvisorPoint(Piece.Side, To))
-            {
-                TryAddMove(To, false, false);
-            }
-        }
+        AddSteps(BoardGeometry.AdvisorSteps[SideIndex][FromCell]);
         break;
-    }
     case ERoleType::Elephant:
+        AddSteps(BoardGeometry.ElephantSteps[SideIndex][FromCell]);
+        break;
+    case ERoleType::Horse:
+        AddSteps(BoardGeometry.HorseSteps[FromCell]);
+        break;
+    case ERoleType::Rook:
     {
-        static constexpr std::array<FBoardPos, 4> Delta = {{{2, 2}, {2, -2}, {-2, 2}, {-2, -2}}};
-        for (const FBoardPos& D : Delta)
+        for (const EBoardDirection Direction : AllBoardDirections)
         {
-            const FBoardPos Eye{static_cast<int8_t>(Piece.Pos.X + D.X / 2), static_cast<int8_t>(Piece.Pos.Y + D.Y / 2)};
-            const FBoardPos To{static_cast<int8_t>(Piece.Pos.X + D.X), static_cast<int8_t>(Piece.Pos.Y + D.Y)};
-            if (!To.IsValid())
-            {
-                continue;
-            }
-            if (Piece.Side == ESide::Red && To.Y > 4)
-            {
-                continue;
-            }
-            if (Piece.Side == ESide::Black && To.Y < 5)
+            const FBoardBitboard& Ray = GetRayMask(Direction, FromCell);
+            const int32_t BlockerCell = FindNearestOnRay(Ray & Occupancy, Direction);
+            if (BlockerCell < 0)
             {
+                AddQuietRayMoves(Ray, Direction);
                 continue;
             }
-            if (GetPieceAt(Eye) != nullptr)
+
+            AddQuietRayMoves(AndNot(Ray, GetRayMask(Direction, BlockerCell) | FBoardBitboard::FromCell(BlockerCell)), Direction);
+            if (EnemyOccupancy.Test(BlockerCell))
             {
-                continue;
+                AddCapture(BlockerCell);
             }
-            TryAddMove(To, false, false);
         }
         break;
     }
-    case ERoleType::Horse:
+    case ERoleType::Cannon:
     {
-        struct FHorsePattern
-        {
-            FBoardPos Leg;
-            FBoardPos To;
-        };
-        static constexpr std::array<FHorsePattern, 8> Patterns = {{
-            {{1, 0}, {2, 1}},
-            {{1, 0}, {2, -1}},
-            {{-1, 0}, {-2, 1}},
-            {{-1, 0}, {-2, -1}},
-            {{0, 1}, {1, 2}},
-            {{0, 1}, {-1, 2}},
-            {{0, -1}, {1, -2}},
-            {{0, -1}, {-1, -2}},
-        }};
-
-        for (const FHorsePattern& Pattern : Patterns)
+        for (const EBoardDirection Direction : AllBoardDirections)
         {
-            const FBoardPos LegPos{static_cast<int8_t>(Piece.Pos.X + Pattern.Leg.X), static_cast<int8_t>(Piece.Pos.Y + Pattern.Leg.Y)};
-            if (!LegPos.IsValid() || GetPieceAt(LegPos) != nullptr)
+            const FBoardBitboard& Ray = GetRayMask(Direction, FromCell);
+            const int32_t ScreenCell = FindNearestOnRay(Ray & Occupancy, Direction);
+            if (ScreenCell < 0)
             {
+                AddQuietRayMoves(Ray, Direction);
                 continue;
             }
-            const FBoardPos To{static_cast<int8_t>(Piece.Pos.X + Pattern.To.X), static_cast<int8_t>(Piece.Pos.Y + Pattern.To.Y)};
-            TryAddMove(To, false, false);
-        }
-        break;
-    }
-    case ERoleType::Rook:
-    {
-        static constexpr std::array<FBoardPos, 4> Delta = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
-        for (const FBoardPos& D : Delta)
-        {
-            int32_t CursorX = Piece.Pos.X + D.X;
-            int32_t CursorY = Piece.Pos.Y + D.Y;
-            while (CursorX >= 0 && CursorX < 9 && CursorY >= 0 && CursorY < 10)
+
+            AddQuietRayMoves(AndNot(Ray, GetRayMask(Direction, ScreenCell) | FBoardBitboard::FromCell(ScreenCell)), Direction);
+            const int32_t TargetCell = FindNearestOnRay(GetRayMask(Direction, ScreenCell) & Occupancy, Direction);
+            if (TargetCell >= 0 && EnemyOccupancy.Test(TargetCell))
             {
-                const FBoardPos To{static_cast<int8_t>(CursorX), static_cast<int8_t>(CursorY)};
-                const FPieceState* Occupant = GetPieceAt(To);
-                if (Occupant == nullptr)
-                {
-                    Moves.push_back(FMoveAction{Piece.PieceId, Piece.Pos, To, std::nullopt});
-                }
-                else
-                {
-                    if (Occupant->Side != Piece.Side)
-                    {
-                        Moves.push_back(FMoveAction{Piece.PieceId, Piece.Pos, To, Occupant->PieceId});
-                    }
-                    break;
-                }
-                CursorX += D.X;
-                CursorY += D.Y;
+                AddCapture(TargetCell);
             }
         }
         break;
     }
-    case ERoleType::Cannon:
+    case ERoleType::Pawn:
+        AddSteps(BoardGeometry.PawnSteps[SideIndex][FromCell]);
+        break;
+    }
+}
+
+bool FMatchReferee::IsPseudoMoveForPiece(const FPieceState& Piece, int32_t ToCell) const noexcept
+{
+    const int32_t FromCell = ToCellIndex(Piece.Pos);
+    const int32_t SideIndex = ToSideIndex(Piece.Side);
+    const FBoardBitboard Occupancy = GetOccupancy();
+    if (ToCell == FromCell || GameState.SideOccupancy[SideIndex].Test(ToCell))
     {
-        static constexpr std::array<FBoardPos, 4> Delta = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
-        for (const FBoardPos& D : Delta)
+        return false;
+    }
+
+    auto ContainsStep = [&Occupancy, ToCell](const FCellSteps& Steps) {
+        for (uint8_t StepIndex = 0; StepIndex < Steps.Count; ++StepIndex)
         {
-            int32_t CursorX = Piece.Pos.X + D.X;
-            int32_t CursorY = Piece.Pos.Y + D.Y;
-            bool bScreenFound = false;
-            while (CursorX >= 0 && CursorX < 9 && CursorY >= 0 && CursorY < 10)
+            if (Steps.Cells[StepIndex] == ToCell)
             {
-                const FBoardPos To{static_cast<int8_t>(CursorX), static_cast<int8_t>(CursorY)};
-                const FPieceState* Occupant = GetPieceAt(To);
-
-                if (!bScreenFound)
-                {
-                    if (Occupant == nullptr)
-                    {
-                        Moves.push_back(FMoveAction{Piece.PieceId, Piece.Pos, To, std::nullopt});
-                    }
-                    else
-                    {
-                        bScreenFound = true;
-                    }
-                }
-                else if (Occupant != nullptr)
-                {
-                    if (Occupant->Side != Piece.Side)
-                    {
-                        Moves.push_back(FMoveAction{Piece.PieceId, Piece.Pos, To, Occupant->PieceId});
-                    }
-                    break;
-                }
-
-                CursorX += D.X;
-                CursorY += D.Y;
+                const int32_t BlockCell = Steps.BlockCells[StepIndex];
+                return BlockCell < 0 || !Occupancy.Test(BlockCell);
             }
         }
-        break;
-    }
+        return false;
+    };
+
+    const ERoleType ActiveRole = GetActiveRole(Piece);
+    switch (ActiveRole)
+    {
+    case ERoleType::King:
+        return ContainsStep(BoardGeometry.KingSteps[SideIndex][FromCell]);
+    case ERoleType::Advisor:
+        return ContainsStep(BoardGeometry.AdvisorSteps[SideIndex][FromCell]);
+    case ERoleType::Elephant:
+        return ContainsStep(BoardGeometry.ElephantSteps[SideIndex][FromCell]);
+    case ERoleType::Horse:
+        return ContainsStep(BoardGeometry.HorseSteps[FromCell]);
     case ERoleType::Pawn:
+        return ContainsStep(BoardGeometry.PawnSteps[SideIndex][FromCell]);
+    case ERoleType::Rook:
+    case ERoleType::Cannon:
     {
-        const int8_t ForwardY = Piece.Side == ESide::Red ? 1 : -1;
-        const FBoardPos Forward{Piece.Pos.X, static_cast<int8_t>(Piece.Pos.Y + ForwardY)};
-        TryAddMove(Forward, false, false);
-
-        if (IsCrossedRiver(Piece.Side, Piece.Pos))
+        if (FromCell % 9 != ToCell % 9 && FromCell / 9 != ToCell / 9)
         {
-            const FBoardPos Left{static_cast<int8_t>(Piece.Pos.X - 1), Piece.Pos.Y};
-            const FBoardPos Right{static_cast<int8_t>(Piece.Pos.X + 1), Piece.Pos.Y};
-            TryAddMove(Left, false, false);
-            TryAddMove(Right, false, false);
+            return false;
         }
-        break;
+        const int32_t PiecesBetween = (Occupancy & GetBetweenMask(FromCell, ToCell)).Count();
+        const bool bCapture = Occupancy.Test(ToCell);
+        if (ActiveRole == ERoleType::Cannon && bCapture)
+        {
+            return PiecesBetween == 1;
+        }
+        return PiecesBetween == 0;
     }
     }
+    return false;
+}
 
-    return Moves;
+FBoardBitboard FMatchReferee::GetSquareAttackers(const FBoardPos& Target, ESide AttackerSide) const
+{
+    return GetSquareAttackers(Target, AttackerSide, GameState.SideOccupancy);
 }
 
-bool FMatchReferee::CanPieceAttackSquare(const FPieceState& Piece, const FBoardPos& Target) const
+FBoardBitboard FMatchReferee::GetSquareAttackers(
+    const FBoardPos& Target,
+    ESide AttackerSide,
+    const std::array<FBoardBitboard, 2>& SideOccupancy) const
 {
-    if (!Piece.bAlive || Piece.bFrozen || !Target.IsValid())
+    FBoardBitboard Attackers{};
+    if (!Target.IsValid())
     {
-        return false;
+        return Attackers;
     }
 
-    const FPieceState* TargetPiece = GetPieceAt(Target);
-    if (TargetPiece == nullptr || TargetPiece->Side == Piece.Side)
+    const int32_t TargetCell = ToCellIndex(Target);
+    const int32_t AttackerSideIndex = ToSideIndex(AttackerSide);
+    const FBoardBitboard Occupancy = SideOccupancy[0] | SideOccupancy[1];
+    const FBoardBitboard& AttackerOccupancy = SideOccupancy[AttackerSideIndex];
+
+    // Only pieces that hold an opposing piece can be captured, so an empty or friendly target is never attacked.
+    if (!Occupancy.Test(TargetCell) || AttackerOccupancy.Test(TargetCell))
     {
-        return false;
+        return Attackers;
     }
 
-    const std::vector<FMoveAction> PseudoMoves = GeneratePseudoMovesForPiece(Piece);
-    for (const FMoveAction& Move : PseudoMoves)
-    {
-        if (Move.To == Target && Move.CapturedPieceId.has_value())
+    auto IsActiveAttacker = [this, &AttackerOccupancy](int32_t Cell, ERoleType Role) {
+        if (!AttackerOccupancy.Test(Cell))
         {
-            return true;
+            return false;
         }
-    }
+        const FPieceState& Piece = GameState.Pieces[GameState.BoardCells[Cell].value()];
+        return !Piece.bFrozen && GetActiveRole(Piece) == Role;
+    };
 
-    return false;
-}
+    auto AddStepAttackers = [&Attackers, &Occupancy, &IsActiveAttacker](const FCellSteps& Steps, ERoleType Role) {
+        for (uint8_t StepIndex = 0; StepIndex < Steps.Count; ++StepIndex)
+        {
+            const int32_t BlockCell = Steps.BlockCells[StepIndex];
+            if (BlockCell >= 0 && Occupancy.Test(BlockCell))
+            {
+                continue;
+            }
+            if (IsActiveAttacker(Steps.Cells[StepIndex], Role))
+            {
+                Attackers.Set(Steps.Cells[StepIndex]);
+            }
+        }
+    };
 
-bool FMatchReferee::IsSquareAttackedBySide(const FBoardPos& Target, ESide AttackerSide) const
-{
-    for (const FPieceState& Piece : GameState.Pieces)
+    // Rooks see the target through the first piece on a line, cannons through the second.
+    for (const EBoardDirection Direction : AllBoardDirections)
     {
-        if (!Piece.bAlive || Piece.Side != AttackerSide)
+        const int32_t FirstCell = FindNearestOnRay(GetRayMask(Direction, TargetCell) & Occupancy, Direction);
+        if (FirstCell < 0)
         {
             continue;
         }
+        if (IsActiveAttacker(FirstCell, ERoleType::Rook))
+        {
+            Attackers.Set(FirstCell);
+        }
 
-        if (CanPieceAttackSquare(Piece, Target))
+        const int32_t SecondCell = FindNearestOnRay(GetRayMask(Direction, FirstCell) & Occupancy, Direction);
+        if (SecondCell >= 0 && IsActiveAttacker(SecondCell, ERoleType::Cannon))
         {
-            return true;
+            Attackers.Set(SecondCell);
         }
     }
 
-    return false;
+    AddStepAttackers(BoardGeometry.HorseAttackers[TargetCell], ERoleType::Horse);
+    AddStepAttackers(BoardGeometry.PawnAttackers[AttackerSideIndex][TargetCell], ERoleType::Pawn);
+    AddStepAttackers(BoardGeometry.ElephantAttackers[AttackerSideIndex][TargetCell], ERoleType::Elephant);
+    AddStepAttackers(BoardGeometry.AdvisorAttackers[AttackerSideIndex][TargetCell], ERoleType::Advisor);
+    AddStepAttackers(BoardGeometry.KingAttackers[AttackerSideIndex][TargetCell], ERoleType::King);
+    return Attackers;
+}
+
+bool FMatchReferee::IsSquareAttackedBySide(const FBoardPos& Target, ESide AttackerSide) const
+{
+    return !GetSquareAttackers(Target, AttackerSide).IsEmpty();
 }
 
 std::optional<FBoardPos> FMatchReferee::FindKingPos(ESide Side) const
 {
-    for (const FPieceState& Piece : GameState.Pieces)
+    const int32_t KingCell = GameState.KingCells[ToSideIndex(Side)];
+    if (KingCell < 0)
     {
-        if (Piece.bAlive && Piece.Side == Side && Piece.ActualRole == ERoleType::King)
-        {
-            return Piece.Pos;
-        }
+        return std::nullopt;
     }
-    return std::nullopt;
+    return FromCellIndex(KingCell);
 }
 
 bool FMatchReferee::AreKingsFacing() const
 {
-    const std::optional<FBoardPos> RedKingPos = FindKingPos(ESide::Red);
-    const std::optional<FBoardPos> BlackKingPos = FindKingPos(ESide::Black);
-    if (!RedKingPos.has_value() || !BlackKingPos.has_value())
-    {
-        return false;
-    }
-
-    if (RedKingPos->X != BlackKingPos->X)
+    const int32_t RedKingCell = GameState.KingCells[0];
+    const int32_t BlackKingCell = GameState.KingCells[1];
+    if (RedKingCell < 0 || BlackKingCell < 0 || RedKingCell % 9 != BlackKingCell % 9)
     {
         return false;
     }
 
-    return CountPiecesBetweenStraight(RedKingPos.value(), BlackKingPos.value()) == 0;
+    return (GetOccupancy() & GetBetweenMask(RedKingCell, BlackKingCell)).IsEmpty();
 }
 
 bool FMatchReferee::IsSideInCheck(ESide Side) const
@@ -649,79 +972,266 @@ bool FMatchReferee::IsSideInCheck(ESide Side) const
     return IsSquareAttackedBySide(KingPos.value(), GetOppositeSide(Side));
 }
 
-void FMatchReferee::ApplyMoveUnchecked(const FMoveAction& Move)
+void FMatchReferee::ApplyMoveUnchecked(const FMoveAction& Move, FMoveUndo& OutUndo)
 {
+    OutUndo.Move = Move;
+    OutUndo.Move.CapturedPieceId = std::nullopt;
+
     FPieceState* MovingPiece = FindPieceById(Move.PieceId);
     if (MovingPiece == nullptr)
     {
         return;
     }
 
-    std::optional<FPieceId>& FromCell = GameState.BoardCells[ToCellIndex(Move.From)];
-    std::optional<FPieceId>& ToCell = GameState.BoardCells[ToCellIndex(Move.To)];
+    FPieceState* CapturedPiece = GetPieceAt(Move.To);
+    if (CapturedPiece != nullptr)
+    {
+        OutUndo.Move.CapturedPieceId = CapturedPiece->PieceId;
+        OutUndo.bCapturedWasFrozen = CapturedPiece->bFrozen;
+        GameState.PositionHash ^= GetPieceHashKey(*CapturedPiece);
+        RemoveFromBoard(CapturedPiece->Side, Move.To);
+        CapturedPiece->bAlive = false;
+        CapturedPiece->Pos = FBoardPos{};
+        CapturedPiece->bFrozen = false;
+        SyncPieceCaches(*CapturedPiece);
+    }
+
+    RemoveFromBoard(MovingPiece->Side, Move.From);
+    PlaceOnBoard(Move.PieceId, MovingPiece->Side, Move.To);
+    GameState.PositionHash ^= GetPieceHashKey(*MovingPiece);
+    MovingPiece->Pos = Move.To;
+    GameState.PositionHash ^= GetPieceHashKey(*MovingPiece);
+    SyncPieceCaches(*MovingPiece);
+}
+
+void FMatchReferee::RevertMoveUnchecked(const FMoveUndo& Undo)
+{
+    FPieceState* MovingPiece = FindPieceById(Undo.Move.PieceId);
+    if (MovingPiece == nullptr)
+    {
+        return;
+    }
+
+    RemoveFromBoard(MovingPiece->Side, Undo.Move.To);
+    PlaceOnBoard(Undo.Move.PieceId, MovingPiece->Side, Undo.Move.From);
+    GameState.PositionHash ^= GetPieceHashKey(*MovingPiece);
+    MovingPiece->Pos = Undo.Move.From;
+    GameState.PositionHash ^= GetPieceHashKey(*MovingPiece);
+    SyncPieceCaches(*MovingPiece);
 
-    if (ToCell.has_value())
+    if (Undo.Move.CapturedPieceId.has_value())
     {
-        FPieceState* CapturedPiece = FindPieceById(ToCell.value());
+        FPieceState* CapturedPiece = FindPieceById(Undo.Move.CapturedPieceId.value());
         if (CapturedPiece != nullptr)
         {
-            CapturedPiece->bAlive = false;
-            CapturedPiece->Pos = FBoardPos{};
-            CapturedPiece->bFrozen = false;
+            CapturedPiece->bAlive = true;
+            CapturedPiece->Pos = Undo.Move.To;
+            CapturedPiece->bFrozen = Undo.bCapturedWasFrozen;
+            PlaceOnBoard(CapturedPiece->PieceId, CapturedPiece->Side, Undo.Move.To);
+            GameState.PositionHash ^= GetPieceHashKey(*CapturedPiece);
+            SyncPieceCaches(*CapturedPiece);
         }
     }
+}
 
-    ToCell = Move.PieceId;
-    FromCell = std::nullopt;
-    MovingPiece->Pos = Move.To;
+void FMatchReferee::MakeMove(const FMoveAction& Move, FMoveUndo& OutUndo)
+{
+    DispatchRulePolicy(RulePolicyKind, [&]<typename TPolicy>() { MakeMove<TPolicy>(Move, OutUndo); });
+}
+
+template <typename TPolicy>
+void FMatchReferee::MakeMove(const FMoveAction& Move, FMoveUndo& OutUndo)
+{
+    OutUndo = FMoveUndo{};
+    OutUndo.PreviousPassCount = GameState.PassCount;
+    ApplyMoveUnchecked(Move, OutUndo);
+
+    FPieceState* MovedPiece = FindPieceById(Move.PieceId);
+    if (MovedPiece == nullptr)
+    {
+        return;
+    }
+
+    OutUndo.bMoverHadCaptured = MovedPiece->bHasCaptured;
+    if (OutUndo.Move.CapturedPieceId.has_value())
+    {
+        const uint64_t MoverKeyBefore = GetPieceHashKey(*MovedPiece);
+        if (MovedPiece->PieceState == EPieceState::HiddenSurface && TPolicy::RevealOnFirstCapture(RuleConfig))
+        {
+            MovedPiece->PieceState = EPieceState::RevealedActual;
+            OutUndo.bMoverRevealed = true;
+            if (TPolicy::FreezeIfIllegalAfterReveal(RuleConfig) &&
+                !IsRolePositionLegal(MovedPiece->ActualRole, MovedPiece->Side, MovedPiece->Pos))
+            {
+                MovedPiece->bFrozen = true;
+                OutUndo.bMoverFrozen = true;
+            }
+        }
+        MovedPiece->bHasCaptured = true;
+        GameState.PositionHash ^= MoverKeyBefore ^ GetPieceHashKey(*MovedPiece);
+        SyncPieceCaches(*MovedPiece);
+    }
+
+    SetPassCount(0);
+    ++GameState.TurnIndex;
+    SetCurrentTurn(GetOppositeSide(MovedPiece->Side));
+}
+
+void FMatchReferee::UnmakeMove(const FMoveUndo& Undo)
+{
+    FPieceState* MovedPiece = FindPieceById(Undo.Move.PieceId);
+    if (MovedPiece == nullptr)
+    {
+        return;
+    }
+
+    const uint64_t MoverKeyBefore = GetPieceHashKey(*MovedPiece);
+    if (Undo.bMoverRevealed)
+    {
+        MovedPiece->PieceState = EPieceState::HiddenSurface;
+    }
+    if (Undo.bMoverFrozen)
+    {
+        MovedPiece->bFrozen = false;
+    }
+    MovedPiece->bHasCaptured = Undo.bMoverHadCaptured;
+    GameState.PositionHash ^= MoverKeyBefore ^ GetPieceHashKey(*MovedPiece);
+    SyncPieceCaches(*MovedPiece);
+
+    RevertMoveUnchecked(Undo);
+
+    SetPassCount(Undo.PreviousPassCount);
+    --GameState.TurnIndex;
+    SetCurrentTurn(MovedPiece->Side);
+}
+
+void FMatchReferee::MakePass(FMoveUndo& OutUndo)
+{
+    OutUndo = FMoveUndo{};
+    OutUndo.PreviousPassCount = GameState.PassCount;
+    SetPassCount(GameState.PassCount + 1);
+    ++GameState.TurnIndex;
+    SetCurrentTurn(GetOppositeSide(GameState.CurrentTurn));
+}
+
+void FMatchReferee::UnmakePass(const FMoveUndo& Undo)
+{
+    SetPassCount(Undo.PreviousPassCount);
+    --GameState.TurnIndex;
+    SetCurrentTurn(GetOppositeSide(GameState.CurrentTurn));
 }
 
 bool FMatchReferee::IsMoveLegalForSide(const FMoveAction& Move, ESide Side) const
 {
-    FMatchReferee Simulation = *this;
-    const FPieceState* Piece = Simulation.FindPieceById(Move.PieceId);
+    const FPieceState* Piece = FindPieceById(Move.PieceId);
     if (Piece == nullptr || !Piece->bAlive || Piece->Side != Side)
     {
         return false;
     }
 
-    Simulation.ApplyMoveUnchecked(Move);
-    return !Simulation.IsSideInCheck(Side);
+    // Answers IsSideInCheck for the position after the move without touching the state: only occupancy and the
+    // king cells can change the mover's king safety, and a captured piece drops out with its occupancy bit.
+    const int32_t SideIndex = ToSideIndex(Side);
+    const int32_t OpponentIndex = 1 - SideIndex;
+    const int32_t FromCell = ToCellIndex(Move.From);
+    const int32_t ToCell = ToCellIndex(Move.To);
+    std::array<FBoardBitboard, 2> SideOccupancy = GameState.SideOccupancy;
+    SideOccupancy[SideIndex].Clear(FromCell);
+    SideOccupancy[SideIndex].Set(ToCell);
+    SideOccupancy[OpponentIndex].Clear(ToCell);
+
+    const int32_t KingCell = Piece->ActualRole == ERoleType::King ? ToCell : GameState.KingCells[SideIndex];
+    const int32_t EnemyKingCell = GameState.KingCells[OpponentIndex] == ToCell ? -1 : GameState.KingCells[OpponentIndex];
+    if (KingCell < 0)
+    {
+        return false;
+    }
+    if (EnemyKingCell >= 0 && KingCell % 9 == EnemyKingCell % 9 &&
+        ((SideOccupancy[0] | SideOccupancy[1]) & GetBetweenMask(KingCell, EnemyKingCell)).IsEmpty())
+    {
+        return false;
+    }
+    return GetSquareAttackers(FromCellIndex(KingCell), GetOppositeSide(Side), SideOccupancy).IsEmpty();
 }
 
-std::string FMatchReferee::BuildRevealDigest(const FSetupPlain& SetupPlain) const
+FMatchReferee::FLegalityContext FMatchReferee::BuildLegalityContext(ESide Side) const
 {
-    std::vector<FSetupPlacement> SortedPlacements = SetupPlain.Placements;
-    std::sort(SortedPlacements.begin(), SortedPlacements.end(), [](const FSetupPlacement& Lhs, const FSetupPlacement& Rhs) {
-        return Lhs.PieceId < Rhs.PieceId;
-    });
+    FLegalityContext Context{};
+    const std::optional<FBoardPos> KingPos = FindKingPos(Side);
+    if (!KingPos.has_value())
+    {
+        return Context;
+    }
+
+    Context.bHasKing = true;
+    Context.KingPos = KingPos.value();
+    Context.bInCheck = IsSideInCheck(Side);
+
+    // Pin, cannon-screen and flying-general lines: a ray from the king matters only up to the farthest enemy
+    // slider (or the enemy king on the file) on it; occupancy changes beyond that point cannot expose the king.
+    const int32_t KingCell = ToCellIndex(Context.KingPos);
+    const FBoardBitboard& EnemyOccupancy = GameState.SideOccupancy[ToSideIndex(GetOppositeSide(Side))];
+    for (const EBoardDirection Direction : AllBoardDirections)
+    {
+        const FBoardBitboard& Ray = GetRayMask(Direction, KingCell);
+        FBoardBitboard EnemyOnRay = Ray & EnemyOccupancy;
+        int32_t FarthestRelevantCell = -1;
+        while (!EnemyOnRay.IsEmpty())
+        {
+            const int32_t Cell = IsIncreasingDirection(Direction) ? EnemyOnRay.PopLowestCell() : EnemyOnRay.PopHighestCell();
+            const FPieceState& Occupant = GameState.Pieces[GameState.BoardCells[Cell].value()];
+            const ERoleType ActiveRole = GetActiveRole(Occupant);
+            const bool bSlider = !Occupant.bFrozen && (ActiveRole == ERoleType::Rook || ActiveRole == ERoleType::Cannon);
+            const bool bFacingKing = (Direction == EBoardDirection::North || Direction == EBoardDirection::South) &&
+                                     Occupant.ActualRole == ERoleType::King;
+            if (bSlider || bFacingKing)
+            {
+                FarthestRelevantCell = Cell;
+            }
+        }
 
-    uint64_t Hash = FnvOffset;
-    auto MixString = [&Hash](const std::string& Value) {
-        for (unsigned char C : Value)
+        if (FarthestRelevantCell >= 0)
         {
-            Hash ^= static_cast<uint64_t>(C);
-            Hash *= FnvPrime;
+            Context.SensitiveCells = Context.SensitiveCells | AndNot(Ray, GetRayMask(Direction, FarthestRelevantCell));
         }
-    };
-    auto MixInt = [&MixString](int32_t Value) {
-        MixString(std::to_string(Value));
-        MixString("|");
-    };
+    }
+
+    // Horse legs and elephant eyes that can block an attack on the king are its diagonal neighbours.
+    static constexpr std::array<FBoardPos, 4> DiagonalDelta = {{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+    for (const FBoardPos& D : DiagonalDelta)
+    {
+        const FBoardPos Cell{static_cast<int8_t>(Context.KingPos.X + D.X), static_cast<int8_t>(Context.KingPos.Y + D.Y)};
+        if (Cell.IsValid())
+        {
+            Context.SensitiveCells.Set(ToCellIndex(Cell));
+        }
+    }
+
+    // Checkers: capturing one is the only way a non-king move can remove a non-sliding attack.
+    if (Context.bInCheck)
+    {
+        Context.Checkers = GetSquareAttackers(Context.KingPos, GetOppositeSide(Side));
+        Context.SensitiveCells = Context.SensitiveCells | Context.Checkers;
+    }
 
-    MixInt(static_cast<int32_t>(SetupPlain.Side));
-    MixString(SetupPlain.Nonce);
-    MixString("|");
-    for (const FSetupPlacement& Placement : SortedPlacements)
+    return Context;
+}
+
+bool FMatchReferee::IsCandidateLegal(const FLegalityContext& Context, const FPieceState& Piece, const FMoveAction& Move) const
+{
+    if (!Context.bHasKing)
+    {
+        return false;
+    }
+
+    if (Piece.ActualRole != ERoleType::King &&
+        !Context.SensitiveCells.Test(ToCellIndex(Move.From)) &&
+        !Context.SensitiveCells.Test(ToCellIndex(Move.To)))
     {
-        MixInt(static_cast<int32_t>(Placement.PieceId));
-        MixInt(Placement.TargetPos.X);
-        MixInt(Placement.TargetPos.Y);
+        return !Context.bInCheck;
     }
 
-    std::ostringstream Stream;
-    Stream << std::hex << std::setfill('0') << std::setw(16) << Hash;
-    return Stream.str();
+    return IsMoveLegalForSide(Move, Piece.Side);
 }
 
 bool FMatchReferee::ValidateSetupPlain(const FSetupPlain& SetupPlain, std::string& OutError) const
@@ -792,7 +1302,7 @@ FCommandResult FMatchReferee::ApplyRevealPlacement(const FSetupPlain& SetupPlain
 
         if (Piece.Pos.IsValid())
         {
-            GameState.BoardCells[ToCellIndex(Piece.Pos)] = std::nullopt;
+            RemoveFromBoard(Piece.Side, Piece.Pos);
         }
 
         Piece.PieceState = EPieceState::HiddenSurface;
@@ -801,6 +1311,7 @@ FCommandResult FMatchReferee::ApplyRevealPlacement(const FSetupPlain& SetupPlain
         Piece.bAlive = false;
         Piece.bFrozen = false;
         Piece.bHasCaptured = false;
+        SyncPieceCaches(Piece);
     }
 
     for (const FSetupPlacement& Placement : SetupPlain.Placements)
@@ -818,12 +1329,12 @@ FCommandResult FMatchReferee::ApplyRevealPlacement(const FSetupPlain& SetupPlain
         Piece->bFrozen = false;
         Piece->bHasCaptured = false;
 
-        std::optional<FPieceId>& Cell = GameState.BoardCells[ToCellIndex(Placement.TargetPos)];
-        if (Cell.has_value())
+        if (GameState.BoardCells[ToCellIndex(Placement.TargetPos)].has_value())
         {
             return BuildRejectedResult("ERR_POSITION_CONFLICT", "Placement position conflicts with existing piece.");
         }
-        Cell = Piece->PieceId;
+        PlaceOnBoard(Piece->PieceId, Piece->Side, Placement.TargetPos);
+        SyncPieceCaches(*Piece);
     }
 
     return BuildAcceptedResult();
@@ -883,11 +1394,10 @@ FCommandResult FMatchReferee::ApplyReveal(const FSetupPlain& SetupPlain)
         return BuildRejectedResult("ERR_MISSING_COMMIT", "Reveal requires prior commit.");
     }
 
-    const std::string StoredHash = bIsRed ? RedCommitHash : BlackCommitHash;
+    const std::string& StoredHash = bIsRed ? RedCommitHash : BlackCommitHash;
     if (!StoredHash.empty())
     {
-        const std::string ComputedHash = BuildRevealDigest(SetupPlain);
-        if (ComputedHash != StoredHash)
+        if (!FSetupCommitment::VerifyCommit(FSetupCommit{SetupPlain.Side, StoredHash}, SetupPlain))
         {
             return BuildRejectedResult("ERR_COMMIT_MISMATCH", "Reveal payload does not match commit hash.");
         }
@@ -900,6 +1410,7 @@ FCommandResult FMatchReferee::ApplyReveal(const FSetupPlain& SetupPlain)
     }
 
     const FCommandResult PlacementResult = ApplyRevealPlacement(SetupPlain);
+    GameState.PositionHash = ComputePositionHash(GameState);
     if (!PlacementResult.bAccepted)
     {
         return PlacementResult;
@@ -925,35 +1436,159 @@ FCommandResult FMatchReferee::ApplyReveal(const FSetupPlain& SetupPlain)
 
 std::vector<FMoveAction> FMatchReferee::GenerateLegalMoves(ESide Side) const
 {
+    FMoveList LegalMoves;
+    GenerateLegalMoves(Side, LegalMoves);
+    return std::vector<FMoveAction>(LegalMoves.begin(), LegalMoves.end());
+}
+
+std::optional<FMoveAction> FMatchReferee::ValidateMove(const FMoveAction& Move) const
+{
+    if (GameState.Phase != EGamePhase::Battle || GameState.Result != EGameResult::Ongoing)
+    {
+        return std::nullopt;
+    }
+
+    const FPieceState* Piece = FindPieceById(Move.PieceId);
+    if (Piece == nullptr || !Piece->bAlive || Piece->bFrozen || !(Piece->Pos == Move.From) || !Move.To.IsValid())
+    {
+        return std::nullopt;
+    }
+
+    const int32_t ToCell = ToCellIndex(Move.To);
+    if (!IsPseudoMoveForPiece(*Piece, ToCell))
+    {
+        return std::nullopt;
+    }
+
+    const FMoveAction ValidatedMove{Move.PieceId, Move.From, Move.To, GameState.BoardCells[ToCell]};
+    if (!IsMoveLegalForSide(ValidatedMove, Piece->Side))
+    {
+        return std::nullopt;
+    }
+    return ValidatedMove;
+}
+
+void FMatchReferee::GenerateLegalMoves(ESide Side, FMoveList& OutMoves) const
+{
+    OutMoves.Clear();
     if (GameState.Phase != EGamePhase::Battle || GameState.Result != EGameResult::Ongoing)
     {
-        return {};
+        return;
+    }
+
+    const FLegalityContext Context = BuildLegalityContext(Side);
+    if (!Context.bHasKing)
+    {
+        return;
     }
 
-    std::vector<FMoveAction> LegalMoves;
-    for (const FPieceState& Piece : GameState.Pieces)
+    // Lowest bit first keeps pieces in id order.
+    const int32_t SideIndex = ToSideIndex(Side);
+    FPieceMoveList CandidateMoves;
+    for (uint16_t PieceMask = GameState.MovablePieceMasks[SideIndex]; PieceMask != 0; PieceMask &= PieceMask - 1)
     {
-        if (!Piece.bAlive || Piece.Side != Side || Piece.bFrozen)
+        const FPieceState& Piece = GameState.Pieces[SideIndex * 16 + std::countr_zero(PieceMask)];
+        GeneratePseudoMovesForPiece(Piece, CandidateMoves);
+        for (const FMoveAction& Candidate : CandidateMoves)
         {
-            continue;
+            if (IsCandidateLegal(Context, Piece, Candidate))
+            {
+                OutMoves.PushBack(Candidate);
+            }
+        }
+    }
+}
+
+bool FMatchReferee::HasAnyLegalMove(ESide Side) const
+{
+    if (GameState.Phase != EGamePhase::Battle || GameState.Result != EGameResult::Ongoing)
+    {
+        return false;
+    }
+
+    const FLegalityContext Context = BuildLegalityContext(Side);
+    if (!Context.bHasKing)
+    {
+        return false;
+    }
+
+    const int32_t SideIndex = ToSideIndex(Side);
+    const uint16_t MovableMask = GameState.MovablePieceMasks[SideIndex];
+    FPieceMoveList CandidateMoves;
+    if (!Context.bInCheck)
+    {
+        for (uint16_t PieceMask = MovableMask; PieceMask != 0; PieceMask &= PieceMask - 1)
+        {
+            const FPieceState& Piece = GameState.Pieces[SideIndex * 16 + std::countr_zero(PieceMask)];
+            GeneratePseudoMovesForPiece(Piece, CandidateMoves);
+            for (const FMoveAction& Candidate : CandidateMoves)
+            {
+                if (IsCandidateLegal(Context, Piece, Candidate))
+                {
+                    return true;
+                }
+            }
         }
+        return false;
+    }
 
-        const std::vector<FMoveAction> CandidateMoves = GeneratePseudoMovesForPiece(Piece);
+    // In check, a non-king move can only help by landing on or leaving a sensitive cell.
+    const FPieceId KingPieceId = GameState.BoardCells[ToCellIndex(Context.KingPos)].value();
+    const uint16_t KingBit = static_cast<uint16_t>(1u << (KingPieceId % 16));
+    if ((MovableMask & KingBit) != 0)
+    {
+        const FPieceState& King = GameState.Pieces[KingPieceId];
+        GeneratePseudoMovesForPiece(King, CandidateMoves);
         for (const FMoveAction& Candidate : CandidateMoves)
         {
             if (IsMoveLegalForSide(Candidate, Side))
             {
-                LegalMoves.push_back(Candidate);
+                return true;
+            }
+        }
+    }
+
+    FMoveList DeferredMoves;
+    for (uint16_t PieceMask = MovableMask & static_cast<uint16_t>(~KingBit); PieceMask != 0; PieceMask &= PieceMask - 1)
+    {
+        const FPieceState& Piece = GameState.Pieces[SideIndex * 16 + std::countr_zero(PieceMask)];
+        GeneratePseudoMovesForPiece(Piece, CandidateMoves);
+        for (const FMoveAction& Candidate : CandidateMoves)
+        {
+            const int32_t ToCell = ToCellIndex(Candidate.To);
+            if (Context.Checkers.Test(ToCell))
+            {
+                if (IsMoveLegalForSide(Candidate, Side))
+                {
+                    return true;
+                }
+            }
+            else if (Context.SensitiveCells.Test(ToCell) || Context.SensitiveCells.Test(ToCellIndex(Candidate.From)))
+            {
+                DeferredMoves.PushBack(Candidate);
             }
         }
     }
 
-    return LegalMoves;
+    for (const FMoveAction& Candidate : DeferredMoves)
+    {
+        if (IsMoveLegalForSide(Candidate, Side))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FMatchReferee::CanPass(ESide Side) const
+{
+    return DispatchRulePolicy(RulePolicyKind, [&]<typename TPolicy>() { return CanPass<TPolicy>(Side); });
 }
 
+template <typename TPolicy>
 bool FMatchReferee::CanPass(ESide Side) const
 {
-    if (!RuleConfig.bAllowPassWhenNoLegalMove)
+    if (!TPolicy::AllowPassWhenNoLegalMove(RuleConfig))
     {
         return false;
     }
@@ -968,15 +1603,10 @@ bool FMatchReferee::CanPass(ESide Side) const
         return false;
     }
 
-    if (IsSideInCheck(Side))
-    {
-        return false;
-    }
-
-    return GenerateLegalMoves(Side).empty();
+    return !IsSideInCheck(Side) && !HasAnyLegalMove(Side);
 }
 
-void FMatchReferee::EvaluateEndAfterMove(ESide MovedSide)
+bool FMatchReferee::EvaluateEndAfterMove(ESide MovedSide)
 {
     const ESide DefenderSide = GetOppositeSide(MovedSide);
     if (!FindKingPos(DefenderSide).has_value())
@@ -984,22 +1614,64 @@ void FMatchReferee::EvaluateEndAfterMove(ESide MovedSide)
         GameState.Result = MovedSide == ESide::Red ? EGameResult::RedWin : EGameResult::BlackWin;
         GameState.EndReason = EEndReason::Checkmate;
         GameState.Phase = EGamePhase::GameOver;
-        return;
+        return false;
     }
 
-    if (IsSideInCheck(DefenderSide))
+    const bool bDefenderInCheck = IsSideInCheck(DefenderSide);
+    if (bDefenderInCheck && !HasAnyLegalMove(DefenderSide))
     {
-        const std::vector<FMoveAction> DefenderMoves = GenerateLegalMoves(DefenderSide);
-        if (DefenderMoves.empty())
-        {
-            GameState.Result = MovedSide == ESide::Red ? EGameResult::RedWin : EGameResult::BlackWin;
-            GameState.EndReason = EEndReason::Checkmate;
-            GameState.Phase = EGamePhase::GameOver;
-        }
+        GameState.Result = MovedSide == ESide::Red ? EGameResult::RedWin : EGameResult::BlackWin;
+        GameState.EndReason = EEndReason::Checkmate;
+        GameState.Phase = EGamePhase::GameOver;
+    }
+    return bDefenderInCheck;
+}
+
+FCommandResult FMatchReferee::Adjudicate(EGameResult Result, EEndReason EndReason)
+{
+    FGameEventList Events;
+    return Adjudicate(Result, EndReason, Events);
+}
+
+FCommandResult FMatchReferee::Adjudicate(EGameResult Result, EEndReason EndReason, FGameEventList& OutEvents)
+{
+    OutEvents.Clear();
+    if (GameState.Phase != EGamePhase::Battle)
+    {
+        return BuildRejectedResult("ERR_INVALID_PHASE", "Adjudication is only allowed during battle.");
+    }
+
+    if (GameState.Result != EGameResult::Ongoing)
+    {
+        return BuildRejectedResult("ERR_GAME_OVER", "Game already ended.");
+    }
+
+    if (Result == EGameResult::Ongoing)
+    {
+        return BuildRejectedResult("ERR_INVALID_PAYLOAD", "Adjudication needs a final result.");
     }
+
+    GameState.Result = Result;
+    GameState.EndReason = EndReason;
+    GameState.Phase = EGamePhase::GameOver;
+    OutEvents.PushBack(BuildGameEndedEvent(GameState));
+    return BuildAcceptedResult();
 }
 
 FCommandResult FMatchReferee::ApplyCommand(const FPlayerCommand& Command)
+{
+    FGameEventList Events;
+    return ApplyCommand(Command, Events);
+}
+
+FCommandResult FMatchReferee::ApplyCommand(const FPlayerCommand& Command, FGameEventList& OutEvents)
+{
+    OutEvents.Clear();
+    return DispatchRulePolicy(RulePolicyKind, [&]<typename TPolicy>() { return ApplyBattleCommand<TPolicy>(Command, OutEvents); });
+}
+
+template <typename TPolicy>
+FCommandResult FMatchReferee::ApplyBattleCommand(const FPlayerCommand& Command, FGameEventList& OutEvents)
 {
     if (GameState.Phase != EGamePhase::Battle)
     {
@@ -1020,23 +1692,21 @@ FCommandResult FMatchReferee::ApplyCommand(const FPlayerCommand& Command)
     {
     case ECommandType::Pass:
     {
-        if (!CanPass(Command.Side))
+        if (!CanPass<TPolicy>(Command.Side))
         {
             return BuildRejectedResult("ERR_PASS_NOT_ALLOWED", "Pass is not allowed now.");
         }
 
-        ++GameState.PassCount;
-        ++GameState.TurnIndex;
+        FMoveUndo Undo{};
+        MakePass(Undo);
 
-        if (RuleConfig.bDoublePassIsDraw && GameState.PassCount >= 2)
+        if (TPolicy::DoublePassIsDraw(RuleConfig) && GameState.PassCount >= 2)
         {
             GameState.Result = EGameResult::Draw;
             GameState.EndReason = EEndReason::DoublePassDraw;
             GameState.Phase = EGamePhase::GameOver;
-        }
-        else
-        {
-            GameState.CurrentTurn = GetOppositeSide(GameState.CurrentTurn);
+            SetCurrentTurn(Command.Side);
+            OutEvents.PushBack(BuildGameEndedEvent(GameState));
         }
         return BuildAcceptedResult();
     }
@@ -1046,6 +1716,7 @@ FCommandResult FMatchReferee::ApplyCommand(const FPlayerCommand& Command)
         GameState.EndReason = EEndReason::Resign;
         GameState.Phase = EGamePhase::GameOver;
         ++GameState.TurnIndex;
+        OutEvents.PushBack(BuildGameEndedEvent(GameState));
         return BuildAcceptedResult();
     }
     case ECommandType::Move:
@@ -1070,45 +1741,34 @@ FCommandResult FMatchReferee::ApplyCommand(const FPlayerCommand& Command)
             return BuildRejectedResult("ERR_INVALID_FROM", "Move from position does not match piece position.");
         }
 
-        const std::vector<FMoveAction> LegalMoves = GenerateLegalMoves(Command.Side);
-        auto It = std::find_if(LegalMoves.begin(), LegalMoves.end(), [&InputMove](const FMoveAction& Candidate) {
-            return Candidate.PieceId == InputMove.PieceId && Candidate.From == InputMove.From && Candidate.To == InputMove.To;
-        });
-        if (It == LegalMoves.end())
+        const std::optional<FMoveAction> LegalMove = ValidateMove(InputMove);
+        if (!LegalMove.has_value())
         {
             return BuildRejectedResult("ERR_ILLEGAL_MOVE", "Move is not legal.");
         }
 
-        const FMoveAction Move = *It;
-        ApplyMoveUnchecked(Move);
-
-        FPieceState* MovedPiece = FindPieceById(Move.PieceId);
-        if (MovedPiece == nullptr)
-        {
-            return BuildRejectedResult("ERR_INTERNAL", "Moved piece cannot be found after move.");
-        }
+        FMoveUndo Undo{};
+        MakeMove<TPolicy>(LegalMove.value(), Undo);
+        AppendMoveEvents(GameState, Undo, RuleConfig.bRevealCapturedRole, OutEvents);
 
-        if (Move.CapturedPieceId.has_value())
+        const bool bCheckGiven = EvaluateEndAfterMove(Command.Side);
+        if (bCheckGiven)
         {
-            if (MovedPiece->PieceState == EPieceState::HiddenSurface && RuleConfig.bRevealOnFirstCapture)
+            FGameEvent CheckEvent{};
+            CheckEvent.EventType = EGameEventType::CheckGiven;
+            CheckEvent.Side = Command.Side;
+            // A hidden king's cell would tell the attacker which piece is the king, so To stays invalid until then.
+            const int32_t KingCell = GameState.KingCells[ToSideIndex(GetOppositeSide(Command.Side))];
+            if (KingCell >= 0 && GameState.Pieces[GameState.BoardCells[KingCell].value()].PieceState == EPieceState::RevealedActual)
             {
-                MovedPiece->PieceState = EPieceState::RevealedActual;
-                if (RuleConfig.bFreezeIfIllegalAfterReveal &&
-                    !IsRolePositionLegal(MovedPiece->ActualRole, MovedPiece->Side, MovedPiece->Pos))
-                {
-                    MovedPiece->bFrozen = true;
-                }
+                CheckEvent.To = FromCellIndex(KingCell);
             }
-            MovedPiece->bHasCaptured = true;
+            OutEvents.PushBack(CheckEvent);
         }
-
-        GameState.PassCount = 0;
-        ++GameState.TurnIndex;
-
-        EvaluateEndAfterMove(Command.Side);
-        if (GameState.Phase != EGamePhase::GameOver)
+        if (GameState.Phase == EGamePhase::GameOver)
         {
-            GameState.CurrentTurn = GetOppositeSide(GameState.CurrentTurn);
+            SetCurrentTurn(Command.Side);
+            OutEvents.PushBack(BuildGameEndedEvent(GameState));
         }
 
         return BuildAcceptedResult();
@@ -1117,3 +1777,10 @@ FCommandResult FMatchReferee::ApplyCommand(const FPlayerCommand& Command)
         return BuildRejectedResult("ERR_UNSUPPORTED_COMMAND", "Command is not implemented.");
     }
 }
+
+template void FMatchReferee::MakeMove<FStandardRulePolicy>(const FMoveAction& Move, FMoveUndo& OutUndo);
+template void FMatchReferee::MakeMove<FNoFreezeRulePolicy>(const FMoveAction& Move, FMoveUndo& OutUndo);
+template void FMatchReferee::MakeMove<FDynamicRulePolicy>(const FMoveAction& Move, FMoveUndo& OutUndo);
+template bool FMatchReferee::CanPass<FStandardRulePolicy>(ESide Side) const;
+template bool FMatchReferee::CanPass<FNoFreezeRulePolicy>(ESide Side) const;
+template bool FMatchReferee::CanPass<FDynamicRulePolicy>(ESide Side) const;
@@ -0,0 +1,113 @@
+#include "CoreRules/PackedGameState.h"
+
+#include <algorithm>
+#include <cstddef>
+
+FPackedGameState FGameStatePacker::Pack(const FGameState& State) noexcept
+{
+    FPackedGameState Packed{};
+    Packed.TurnIndex = State.TurnIndex;
+    Packed.PositionHash = State.PositionHash;
+    Packed.PassCount = State.PassCount;
+    Packed.Phase = State.Phase;
+    Packed.CurrentTurn = State.CurrentTurn;
+    Packed.Result = State.Result;
+    Packed.EndReason = State.EndReason;
+    Packed.SetupFlags = static_cast<uint8_t>((State.bRedCommitted ? FPackedGameState::RedCommittedFlag : 0) |
+                                            (State.bBlackCommitted ? FPackedGameState::BlackCommittedFlag : 0) |
+                                            (State.bRedRevealed ? FPackedGameState::RedRevealedFlag : 0) |
+                                            (State.bBlackRevealed ? FPackedGameState::BlackRevealedFlag : 0));
+
+    for (size_t Cell = 0; Cell < State.BoardCells.size(); ++Cell)
+    {
+        const std::optional<FPieceId>& Occupant = State.BoardCells[Cell];
+        Packed.BoardCells[Cell] = Occupant.has_value() ? static_cast<uint8_t>(Occupant.value()) : FPackedGameState::EmptyCell;
+    }
+
+    const size_t PieceCount = std::min(State.Pieces.size(), Packed.Pieces.size());
+    Packed.PieceCount = static_cast<uint8_t>(PieceCount);
+    for (size_t Index = 0; Index < PieceCount; ++Index)
+    {
+        const FPieceState& Piece = State.Pieces[Index];
+        FPackedPiece& PackedPiece = Packed.Pieces[Index];
+        PackedPiece.Cell = Piece.Pos.IsValid() ? static_cast<uint8_t>(Piece.Pos.Y * 9 + Piece.Pos.X) : FPackedPiece::OffBoardCell;
+        PackedPiece.Roles = static_cast<uint8_t>(static_cast<uint8_t>(Piece.ActualRole) | (static_cast<uint8_t>(Piece.SurfaceRole) << 4));
+        PackedPiece.Flags = static_cast<uint8_t>((Piece.Side == ESide::Black ? FPackedPiece::BlackSideFlag : 0) |
+                                                 (Piece.PieceState == EPieceState::RevealedActual ? FPackedPiece::RevealedFlag : 0) |
+                                                 (Piece.bAlive ? FPackedPiece::AliveFlag : 0) |
+                                                 (Piece.bFrozen ? FPackedPiece::FrozenFlag : 0) |
+                                                 (Piece.bHasCaptured ? FPackedPiece::HasCapturedFlag : 0));
+    }
+
+    return Packed;
+}
+
+void FGameStatePacker::Unpack(const FPackedGameState& Packed, FGameState& OutState)
+{
+    OutState.Phase = Packed.Phase;
+    OutState.CurrentTurn = Packed.CurrentTurn;
+    OutState.PassCount = Packed.PassCount;
+    OutState.Result = Packed.Result;
+    OutState.EndReason = Packed.EndReason;
+    OutState.TurnIndex = Packed.TurnIndex;
+    OutState.PositionHash = Packed.PositionHash;
+    OutState.bRedCommitted = (Packed.SetupFlags & FPackedGameState::RedCommittedFlag) != 0;
+    OutState.bBlackCommitted = (Packed.SetupFlags & FPackedGameState::BlackCommittedFlag) != 0;
+    OutState.bRedRevealed = (Packed.SetupFlags & FPackedGameState::RedRevealedFlag) != 0;
+    OutState.bBlackRevealed = (Packed.SetupFlags & FPackedGameState::BlackRevealedFlag) != 0;
+
+    OutState.SideOccupancy = {};
+    OutState.KingCells = {-1, -1};
+    OutState.MovablePieceMasks = {};
+    OutState.Pieces.resize(Packed.PieceCount);
+    for (size_t Index = 0; Index < OutState.Pieces.size(); ++Index)
+    {
+        const FPackedPiece& PackedPiece = Packed.Pieces[Index];
+        FPieceState& Piece = OutState.Pieces[Index];
+        Piece.PieceId = static_cast<FPieceId>(Index);
+        Piece.Side = (PackedPiece.Flags & FPackedPiece::BlackSideFlag) != 0 ? ESide::Black : ESide::Red;
+        Piece.ActualRole = static_cast<ERoleType>(PackedPiece.Roles & 0x0F);
+        Piece.SurfaceRole = static_cast<ERoleType>(PackedPiece.Roles >> 4);
+        Piece.PieceState = (PackedPiece.Flags & FPackedPiece::RevealedFlag) != 0 ? EPieceState::RevealedActual : EPieceState::HiddenSurface;
+        Piece.Pos = PackedPiece.Cell == FPackedPiece::OffBoardCell
+                        ? FBoardPos{}
+                        : FBoardPos{static_cast<int8_t>(PackedPiece.Cell % 9), static_cast<int8_t>(PackedPiece.Cell / 9)};
+        Piece.bAlive = (PackedPiece.Flags & FPackedPiece::AliveFlag) != 0;
+        Piece.bFrozen = (PackedPiece.Flags & FPackedPiece::FrozenFlag) != 0;
+        Piece.bHasCaptured = (PackedPiece.Flags & FPackedPiece::HasCapturedFlag) != 0;
+
+        const int32_t SideIndex = Piece.Side == ESide::Red ? 0 : 1;
+        if (Piece.bAlive && !Piece.bFrozen)
+        {
+            OutState.MovablePieceMasks[SideIndex] |= static_cast<uint16_t>(1u << (Piece.PieceId % 16));
+        }
+        if (Piece.bAlive && Piece.ActualRole == ERoleType::King)
+        {
+            OutState.KingCells[SideIndex] = static_cast<int8_t>(PackedPiece.Cell);
+        }
+    }
+
+    for (size_t Cell = 0; Cell < OutState.BoardCells.size(); ++Cell)
+    {
+        const uint8_t Occupant = Packed.BoardCells[Cell];
+        if (Occupant == FPackedGameState::EmptyCell)
+        {
+            OutState.BoardCells[Cell] = std::nullopt;
+            continue;
+        }
+
+        OutState.BoardCells[Cell] = static_cast<FPieceId>(Occupant);
+        if (Occupant < OutState.Pieces.size())
+        {
+            const int32_t SideIndex = OutState.Pieces[Occupant].Side == ESide::Red ? 0 : 1;
+            OutState.SideOccupancy[SideIndex].Set(static_cast<int32_t>(Cell));
+        }
+    }
+}
+
+FGameState FGameStatePacker::Unpack(const FPackedGameState& Packed)
+{
+    FGameState State;
+    Unpack(Packed, State);
+    return State;
+}
@@ -0,0 +1,170 @@
+#include "CoreRules/ReplayEngine.h"
+
+#include "CoreRules/EndgameTablebase.h"
+
+#include <utility>
+
+namespace
+{
+uint64_t Mix64(uint64_t Value) noexcept
+{
+    Value ^= Value >> 30;
+    Value *= 0xBF58476D1CE4E5B9ULL;
+    Value ^= Value >> 27;
+    Value *= 0x94D049BB133111EBULL;
+    Value ^= Value >> 31;
+    return Value;
+}
+
+// Session log text for accepted commands that carry no game event of their own.
+const char* DescribeAccepted(ECommandType CommandType) noexcept
+{
+    switch (CommandType)
+    {
+    case ECommandType::CommitSetup:
+        return "Setup committed";
+    case ECommandType::RevealSetup:
+        return "Setup revealed";
+    case ECommandType::Move:
+        return nullptr;
+    case ECommandType::Pass:
+        return "Pass applied";
+    case ECommandType::Resign:
+        return "Resign applied";
+    }
+    return "";
+}
+} // namespace
+
+FReplayEngine::FReplayEngine(FReplayConfig InConfig)
+    : Config(std::move(InConfig))
+    , Referee(Config.RuleConfig)
+{
+}
+
+FReplayResult FReplayEngine::Replay(std::span<const FPlayerCommand> Commands)
+{
+    Referee.ResetNewMatch();
+
+    FReplayResult Result{};
+    Result.Digest = DigestSeed;
+    if (Config.bRecordPlyHashes)
+    {
+        Result.PlyHashes.reserve(Commands.size());
+    }
+
+    FGameEventList Events;
+    for (const FPlayerCommand& Command : Commands)
+    {
+        const FCommandResult CommandResult = Dispatch(Command, Events);
+        ++Result.CommandCount;
+        if (CommandResult.bAccepted)
+        {
+            ++Result.AcceptedCount;
+            if (Command.CommandType == ECommandType::Move || Command.CommandType == ECommandType::Pass)
+            {
+                AdjudicateByTablebase(Events);
+            }
+        }
+        else
+        {
+            ++Result.RejectedCount;
+        }
+
+        if (Config.Mode == EReplayMode::Verbose)
+        {
+            if (!CommandResult.bAccepted)
+            {
+                Result.EventDescriptions.push_back(CommandResult.ErrorMessage);
+            }
+            else if (const char* Description = DescribeAccepted(Command.CommandType))
+            {
+                Result.EventDescriptions.emplace_back(Description);
+            }
+            for (const FGameEvent& Event : Events)
+            {
+                Result.EventDescriptions.emplace_back(GetGameEventDescription(Event.EventType));
+            }
+        }
+
+        const uint64_t StateHash = ComputeStateHash(Referee.GetState());
+        Result.Digest = ChainDigest(Result.Digest, StateHash);
+        if (Config.bRecordPlyHashes)
+        {
+            Result.PlyHashes.push_back(StateHash);
+        }
+    }
+
+    const FGameState& State = Referee.GetState();
+    Result.Phase = State.Phase;
+    Result.Result = State.Result;
+    Result.EndReason = State.EndReason;
+    Result.TurnIndex = State.TurnIndex;
+    Result.FinalStateHash = ComputeStateHash(State);
+    return Result;
+}
+
+uint64_t FReplayEngine::ComputeStateHash(const FGameState& State) noexcept
+{
+    const uint64_t Flags = static_cast<uint64_t>(State.Phase) | (static_cast<uint64_t>(State.Result) << 8) |
+                           (static_cast<uint64_t>(State.EndReason) << 16) | (static_cast<uint64_t>(State.bRedCommitted) << 24) |
+                           (static_cast<uint64_t>(State.bBlackCommitted) << 25) | (static_cast<uint64_t>(State.bRedRevealed) << 26) |
+                           (static_cast<uint64_t>(State.bBlackRevealed) << 27);
+    return Mix64(State.PositionHash ^ Mix64(State.TurnIndex ^ (Flags << 32)));
+}
+
+uint64_t FReplayEngine::ChainDigest(uint64_t Digest, uint64_t StateHash) noexcept
+{
+    return Mix64(Digest ^ Mix64(StateHash + 0x9E3779B97F4A7C15ULL));
+}
+
+FCommandResult FReplayEngine::Dispatch(const FPlayerCommand& Command, FGameEventList& OutEvents)
+{
+    OutEvents.Clear();
+    switch (Command.CommandType)
+    {
+    case ECommandType::CommitSetup:
+        if (!Command.SetupCommit.has_value())
+        {
+            return {false, "ERR_INVALID_PAYLOAD", "Commit command missing setup commit payload."};
+        }
+        if (Command.SetupCommit->Side != Command.Side)
+        {
+            FSetupCommit Commit = Command.SetupCommit.value();
+            Commit.Side = Command.Side;
+            return Referee.ApplyCommit(Commit);
+        }
+        return Referee.ApplyCommit(Command.SetupCommit.value());
+    case ECommandType::RevealSetup:
+        if (!Command.SetupPlain.has_value())
+        {
+            return {false, "ERR_INVALID_PAYLOAD", "Reveal command missing setup plain payload."};
+        }
+        if (Command.SetupPlain->Side != Command.Side)
+        {
+            FSetupPlain SetupPlain = Command.SetupPlain.value();
+            SetupPlain.Side = Command.Side;
+            return Referee.ApplyReveal(SetupPlain);
+        }
+        return Referee.ApplyReveal(Command.SetupPlain.value());
+    default:
+        return Referee.ApplyCommand(Command, OutEvents);
+    }
+}
+
+void FReplayEngine::AdjudicateByTablebase(FGameEventList& InOutEvents)
+{
+    FTablebaseProbeResult ProbeResult{};
+    if (Config.Tablebase == nullptr || !Config.Tablebase->Probe(Referee, ProbeResult) || ProbeResult.Outcome == ETablebaseOutcome::Draw)
+    {
+        return;
+    }
+
+    const bool bRedWins = (Referee.GetState().CurrentTurn == ESide::Red) == (ProbeResult.Outcome == ETablebaseOutcome::Win);
+    FGameEventList AdjudicationEvents;
+    Referee.Adjudicate(bRedWins ? EGameResult::RedWin : EGameResult::BlackWin, EEndReason::Tablebase, AdjudicationEvents);
+    for (const FGameEvent& Event : AdjudicationEvents)
+    {
+        InOutEvents.PushBack(Event);
+    }
+}
@@ -0,0 +1,209 @@
+#include "CoreRules/SetupCommitment.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace
+{
+constexpr size_t InlinePlacementCount = 32;
+constexpr size_t HeaderSize = 4;
+constexpr size_t PlacementSize = 4;
+constexpr size_t NonceLengthSize = 4;
+
+bool IsPlacementLess(const FSetupPlacement& Lhs, const FSetupPlacement& Rhs)
+{
+    if (Lhs.PieceId != Rhs.PieceId)
+    {
+        return Lhs.PieceId < Rhs.PieceId;
+    }
+    if (Lhs.TargetPos.X != Rhs.TargetPos.X)
+    {
+        return Lhs.TargetPos.X < Rhs.TargetPos.X;
+    }
+    return Lhs.TargetPos.Y < Rhs.TargetPos.Y;
+}
+
+size_t GetSerializedSize(const FSetupPlain& SetupPlain)
+{
+    return HeaderSize + SetupPlain.Placements.size() * PlacementSize + NonceLengthSize + SetupPlain.Nonce.size();
+}
+
+// Writes the layout documented in SetupCommitment.h to Sink(std::span<const uint8_t>). Setups of up to
+// InlinePlacementCount placements are sorted on the stack.
+template <typename TSink>
+void WriteLayout(const FSetupPlain& SetupPlain, TSink&& Sink)
+{
+    const size_t PlacementCount = SetupPlain.Placements.size();
+    std::array<FSetupPlacement, InlinePlacementCount> InlinePlacements{};
+    std::vector<FSetupPlacement> HeapPlacements;
+    std::span<FSetupPlacement> Sorted;
+    if (PlacementCount <= InlinePlacementCount)
+    {
+        std::copy(SetupPlain.Placements.begin(), SetupPlain.Placements.end(), InlinePlacements.begin());
+        Sorted = std::span<FSetupPlacement>(InlinePlacements.data(), PlacementCount);
+    }
+    else
+    {
+        HeapPlacements = SetupPlain.Placements;
+        Sorted = HeapPlacements;
+    }
+    std::sort(Sorted.begin(), Sorted.end(), IsPlacementLess);
+
+    const uint16_t Count = static_cast<uint16_t>(PlacementCount);
+    const uint8_t Header[HeaderSize] = {
+        FSetupCommitment::LayoutVersion,
+        static_cast<uint8_t>(SetupPlain.Side),
+        static_cast<uint8_t>(Count & 0xFF),
+        static_cast<uint8_t>(Count >> 8)};
+    Sink(std::span<const uint8_t>(Header, HeaderSize));
+
+    // Placements go out in small runs so the sink sees few calls without a heap buffer.
+    constexpr size_t RunLength = 16;
+    uint8_t Run[RunLength * PlacementSize];
+    size_t RunSize = 0;
+    for (const FSetupPlacement& Placement : Sorted)
+    {
+        Run[RunSize++] = static_cast<uint8_t>(Placement.PieceId & 0xFF);
+        Run[RunSize++] = static_cast<uint8_t>(Placement.PieceId >> 8);
+        Run[RunSize++] = static_cast<uint8_t>(Placement.TargetPos.X);
+        Run[RunSize++] = static_cast<uint8_t>(Placement.TargetPos.Y);
+        if (RunSize == sizeof(Run))
+        {
+            Sink(std::span<const uint8_t>(Run, RunSize));
+            RunSize = 0;
+        }
+    }
+    if (RunSize > 0)
+    {
+        Sink(std::span<const uint8_t>(Run, RunSize));
+    }
+
+    const uint32_t NonceLength = static_cast<uint32_t>(SetupPlain.Nonce.size());
+    const uint8_t NonceHeader[NonceLengthSize] = {
+        static_cast<uint8_t>(NonceLength & 0xFF),
+        static_cast<uint8_t>((NonceLength >> 8) & 0xFF),
+        static_cast<uint8_t>((NonceLength >> 16) & 0xFF),
+        static_cast<uint8_t>(NonceLength >> 24)};
+    Sink(std::span<const uint8_t>(NonceHeader, NonceLengthSize));
+    Sink(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(SetupPlain.Nonce.data()), SetupPlain.Nonce.size()));
+}
+
+int32_t HexDigitValue(char C)
+{
+    if (C >= '0' && C <= '9')
+    {
+        return C - '0';
+    }
+    if (C >= 'a' && C <= 'f')
+    {
+        return C - 'a' + 10;
+    }
+    if (C >= 'A' && C <= 'F')
+    {
+        return C - 'A' + 10;
+    }
+    return -1;
+}
+} // namespace
+
+void FSetupCommitment::Serialize(const FSetupPlain& SetupPlain, std::vector<uint8_t>& OutBytes)
+{
+    OutBytes.clear();
+    OutBytes.reserve(GetSerializedSize(SetupPlain));
+    WriteLayout(SetupPlain, [&OutBytes](std::span<const uint8_t> Bytes) {
+        OutBytes.insert(OutBytes.end(), Bytes.begin(), Bytes.end());
+    });
+}
+
+FSha256Digest FSetupCommitment::ComputeDigest(const FSetupPlain& SetupPlain)
+{
+    FSha256 Hasher;
+    WriteLayout(SetupPlain, [&Hasher](std::span<const uint8_t> Bytes) { Hasher.Update(Bytes); });
+    return Hasher.Finish();
+}
+
+std::string FSetupCommitment::BuildCommitHash(const FSetupPlain& SetupPlain)
+{
+    return ToHex(ComputeDigest(SetupPlain));
+}
+
+bool FSetupCommitment::VerifyCommit(const FSetupCommit& Commit, const FSetupPlain& SetupPlain)
+{
+    FSha256Digest Expected{};
+    if (!ParseHex(Commit.HashHex, Expected))
+    {
+        return false;
+    }
+    return ComputeDigest(SetupPlain) == Expected;
+}
+
+std::vector<bool> FSetupCommitment::VerifyCommits(std::span<const FSetupCommit> Commits, std::span<const FSetupPlain> Reveals)
+{
+    assert(Commits.size() == Reveals.size());
+    const size_t Count = std::min(Commits.size(), Reveals.size());
+
+    // One contiguous buffer for every reveal; the message spans are built after it stops growing.
+    size_t TotalSize = 0;
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        TotalSize += GetSerializedSize(Reveals[Index]);
+    }
+    std::vector<uint8_t> Bytes;
+    Bytes.reserve(TotalSize);
+    std::vector<size_t> Offsets(Count + 1, 0);
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        WriteLayout(Reveals[Index], [&Bytes](std::span<const uint8_t> Chunk) {
+            Bytes.insert(Bytes.end(), Chunk.begin(), Chunk.end());
+        });
+        Offsets[Index + 1] = Bytes.size();
+    }
+
+    std::vector<std::span<const uint8_t>> Messages(Count);
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        Messages[Index] = std::span<const uint8_t>(Bytes.data() + Offsets[Index], Offsets[Index + 1] - Offsets[Index]);
+    }
+    std::vector<FSha256Digest> Digests(Count);
+    FSha256::HashBatch(Messages, Digests);
+
+    std::vector<bool> Results(Count, false);
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        FSha256Digest Expected{};
+        Results[Index] = ParseHex(Commits[Index].HashHex, Expected) && Digests[Index] == Expected;
+    }
+    return Results;
+}
+
+std::string FSetupCommitment::ToHex(const FSha256Digest& Digest)
+{
+    static constexpr char Digits[] = "0123456789abcdef";
+    std::string Hex(Digest.size() * 2, '0');
+    for (size_t Index = 0; Index < Digest.size(); ++Index)
+    {
+        Hex[Index * 2] = Digits[Digest[Index] >> 4];
+        Hex[Index * 2 + 1] = Digits[Digest[Index] & 0x0F];
+    }
+    return Hex;
+}
+
+bool FSetupCommitment::ParseHex(std::string_view HashHex, FSha256Digest& OutDigest)
+{
+    if (HashHex.size() != OutDigest.size() * 2)
+    {
+        return false;
+    }
+    for (size_t Index = 0; Index < OutDigest.size(); ++Index)
+    {
+        const int32_t High = HexDigitValue(HashHex[Index * 2]);
+        const int32_t Low = HexDigitValue(HashHex[Index * 2 + 1]);
+        if (High < 0 || Low < 0)
+        {
+            return false;
+        }
+        OutDigest[Index] = static_cast<uint8_t>((High << 4) | Low);
+    }
+    return true;
+}
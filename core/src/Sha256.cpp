@@ -0,0 +1,495 @@
+#include "CoreRules/Sha256.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STUPIDCHESS_SHA256_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define STUPIDCHESS_SHA256_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define STUPIDCHESS_SHA256_TARGET(Features) __attribute__((target(Features)))
+#else
+#define STUPIDCHESS_SHA256_TARGET(Features)
+#endif
+
+namespace
+{
+constexpr size_t BlockSize = 64;
+constexpr size_t LaneCount = 8;
+
+constexpr std::array<uint32_t, 8> InitialState = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+alignas(16) constexpr std::array<uint32_t, 64> RoundConstants = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+using FCompressFunction = void (*)(uint32_t* State, const uint8_t* Blocks, size_t BlockCount);
+
+uint32_t LoadBigEndian32(const uint8_t* Bytes) noexcept
+{
+    return (uint32_t{Bytes[0]} << 24) | (uint32_t{Bytes[1]} << 16) | (uint32_t{Bytes[2]} << 8) | uint32_t{Bytes[3]};
+}
+
+void StoreBigEndian32(uint8_t* Bytes, uint32_t Value) noexcept
+{
+    Bytes[0] = static_cast<uint8_t>(Value >> 24);
+    Bytes[1] = static_cast<uint8_t>(Value >> 16);
+    Bytes[2] = static_cast<uint8_t>(Value >> 8);
+    Bytes[3] = static_cast<uint8_t>(Value);
+}
+
+uint32_t RotateRight(uint32_t Value, int32_t Bits) noexcept
+{
+    return (Value >> Bits) | (Value << (32 - Bits));
+}
+
+FSha256Digest ToDigest(const uint32_t* State) noexcept
+{
+    FSha256Digest Digest{};
+    for (size_t Index = 0; Index < 8; ++Index)
+    {
+        StoreBigEndian32(Digest.data() + Index * 4, State[Index]);
+    }
+    return Digest;
+}
+
+size_t GetPaddedBlockCount(size_t MessageSize) noexcept
+{
+    return (MessageSize + 9 + BlockSize - 1) / BlockSize;
+}
+
+// Block BlockIndex of the message after SHA-256 padding (0x80, zeros, 64-bit big-endian bit length).
+void LoadPaddedBlock(std::span<const uint8_t> Message, size_t BlockIndex, uint8_t* OutBlock) noexcept
+{
+    const size_t Offset = BlockIndex * BlockSize;
+    const size_t Available = Offset < Message.size() ? std::min(BlockSize, Message.size() - Offset) : 0;
+    std::memcpy(OutBlock, Message.data() + Offset, Available);
+    std::memset(OutBlock + Available, 0, BlockSize - Available);
+    if (Offset <= Message.size() && Message.size() < Offset + BlockSize)
+    {
+        OutBlock[Message.size() - Offset] = 0x80;
+    }
+    if (BlockIndex + 1 == GetPaddedBlockCount(Message.size()))
+    {
+        const uint64_t BitCount = uint64_t{Message.size()} * 8;
+        StoreBigEndian32(OutBlock + 56, static_cast<uint32_t>(BitCount >> 32));
+        StoreBigEndian32(OutBlock + 60, static_cast<uint32_t>(BitCount));
+    }
+}
+
+void CompressPortable(uint32_t* State, const uint8_t* Blocks, size_t BlockCount)
+{
+    for (size_t BlockIndex = 0; BlockIndex < BlockCount; ++BlockIndex)
+    {
+        const uint8_t* Block = Blocks + BlockIndex * BlockSize;
+        std::array<uint32_t, 16> W{};
+        for (size_t Index = 0; Index < 16; ++Index)
+        {
+            W[Index] = LoadBigEndian32(Block + Index * 4);
+        }
+
+        uint32_t A = State[0], B = State[1], C = State[2], D = State[3];
+        uint32_t E = State[4], F = State[5], G = State[6], H = State[7];
+        for (size_t Round = 0; Round < 64; ++Round)
+        {
+            // W is a 16-word ring: slot Round & 15 holds W[Round - 16] until it is replaced by W[Round].
+            if (Round >= 16)
+            {
+                const uint32_t W15 = W[(Round + 1) & 15];
+                const uint32_t W2 = W[(Round + 14) & 15];
+                W[Round & 15] += (RotateRight(W15, 7) ^ RotateRight(W15, 18) ^ (W15 >> 3)) + W[(Round + 9) & 15] +
+                                 (RotateRight(W2, 17) ^ RotateRight(W2, 19) ^ (W2 >> 10));
+            }
+
+            const uint32_t T1 = H + (RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25)) + ((E & F) ^ (~E & G)) +
+                                RoundConstants[Round] + W[Round & 15];
+            const uint32_t T2 = (RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22)) + ((A & B) ^ (A & C) ^ (B & C));
+            H = G;
+            G = F;
+            F = E;
+            E = D + T1;
+            D = C;
+            C = B;
+            B = A;
+            A = T1 + T2;
+        }
+
+        State[0] += A;
+        State[1] += B;
+        State[2] += C;
+        State[3] += D;
+        State[4] += E;
+        State[5] += F;
+        State[6] += G;
+        State[7] += H;
+    }
+}
+
+#if STUPIDCHESS_SHA256_X86
+struct FCpuFeatures
+{
+    bool bShaNi = false;
+    bool bAvx2 = false;
+};
+
+FCpuFeatures DetectCpuFeatures() noexcept
+{
+    uint32_t Leaf1[4] = {};
+    uint32_t Leaf7[4] = {};
+    uint64_t EnabledStates = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int Registers[4] = {};
+    __cpuid(Registers, 0);
+    const int MaxLeaf = Registers[0];
+    __cpuid(Registers, 1);
+    std::memcpy(Leaf1, Registers, sizeof(Leaf1));
+    if (MaxLeaf >= 7)
+    {
+        __cpuidex(Registers, 7, 0);
+        std::memcpy(Leaf7, Registers, sizeof(Leaf7));
+    }
+    const bool bOsXsave = (Leaf1[2] & (1u << 27)) != 0;
+    EnabledStates = bOsXsave ? _xgetbv(0) : 0;
+#else
+    __get_cpuid(1, &Leaf1[0], &Leaf1[1], &Leaf1[2], &Leaf1[3]);
+    __get_cpuid_count(7, 0, &Leaf7[0], &Leaf7[1], &Leaf7[2], &Leaf7[3]);
+    if ((Leaf1[2] & (1u << 27)) != 0)
+    {
+        uint32_t Low = 0;
+        uint32_t High = 0;
+        __asm__("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+        EnabledStates = (uint64_t{High} << 32) | Low;
+    }
+#endif
+
+    const bool bSsse3 = (Leaf1[2] & (1u << 9)) != 0;
+    const bool bSse41 = (Leaf1[2] & (1u << 19)) != 0;
+    const bool bAvx = (Leaf1[2] & (1u << 28)) != 0;
+    // The OS must save the XMM and YMM registers before 256-bit instructions are usable.
+    const bool bYmmEnabled = (EnabledStates & 0x6) == 0x6;
+
+    FCpuFeatures Features{};
+    Features.bShaNi = (Leaf7[1] & (1u << 29)) != 0 && bSsse3 && bSse41;
+    Features.bAvx2 = (Leaf7[1] & (1u << 5)) != 0 && bAvx && bYmmEnabled;
+    return Features;
+}
+
+const FCpuFeatures& GetCpuFeatures() noexcept
+{
+    static const FCpuFeatures Features = DetectCpuFeatures();
+    return Features;
+}
+
+STUPIDCHESS_SHA256_TARGET("sha,sse4.1,ssse3")
+void CompressShaNi(uint32_t* State, const uint8_t* Blocks, size_t BlockCount)
+{
+    const __m128i ByteSwapMask = _mm_set_epi64x(0x0C0D0E0F08090A0Bll, 0x0405060700010203ll);
+
+    // The rounds instruction wants the state as ABEF / CDGH lanes.
+    __m128i Temp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(State)), 0xB1);
+    __m128i State1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(State + 4)), 0x1B);
+    __m128i State0 = _mm_alignr_epi8(Temp, State1, 8);
+    State1 = _mm_blend_epi16(State1, Temp, 0xF0);
+
+    for (size_t BlockIndex = 0; BlockIndex < BlockCount; ++BlockIndex)
+    {
+        const uint8_t* Block = Blocks + BlockIndex * BlockSize;
+        const __m128i SavedState0 = State0;
+        const __m128i SavedState1 = State1;
+
+        // Four rounds per group; group G uses W[4G..4G+3] and schedules W for group G + 1 (msg2) and G + 3 (msg1).
+        __m128i W[4] = {};
+        for (size_t Group = 0; Group < 16; ++Group)
+        {
+            __m128i& Current = W[Group & 3];
+            if (Group < 4)
+            {
+                Current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Block + Group * 16)), ByteSwapMask);
+            }
+
+            __m128i Message = _mm_add_epi32(Current, _mm_load_si128(reinterpret_cast<const __m128i*>(RoundConstants.data() + Group * 4)));
+            State1 = _mm_sha256rnds2_epu32(State1, State0, Message);
+            if (Group >= 3 && Group < 15)
+            {
+                __m128i& Next = W[(Group + 1) & 3];
+                Next = _mm_add_epi32(Next, _mm_alignr_epi8(Current, W[(Group - 1) & 3], 4));
+                Next = _mm_sha256msg2_epu32(Next, Current);
+            }
+            Message = _mm_shuffle_epi32(Message, 0x0E);
+            State0 = _mm_sha256rnds2_epu32(State0, State1, Message);
+            if (Group >= 1 && Group < 13)
+            {
+                __m128i& Previous = W[(Group - 1) & 3];
+                Previous = _mm_sha256msg1_epu32(Previous, Current);
+            }
+        }
+
+        State0 = _mm_add_epi32(State0, SavedState0);
+        State1 = _mm_add_epi32(State1, SavedState1);
+    }
+
+    Temp = _mm_shuffle_epi32(State0, 0x1B);
+    State1 = _mm_shuffle_epi32(State1, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(State), _mm_blend_epi16(Temp, State1, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(State + 4), _mm_alignr_epi8(State1, Temp, 8));
+}
+
+STUPIDCHESS_SHA256_TARGET("avx2")
+__m256i RotateRight8(__m256i Value, int Bits) noexcept
+{
+    return _mm256_or_si256(_mm256_srli_epi32(Value, Bits), _mm256_slli_epi32(Value, 32 - Bits));
+}
+
+// One block of eight independent messages; lane L of every vector belongs to message L.
+STUPIDCHESS_SHA256_TARGET("avx2")
+void CompressAvx2(__m256i (&State)[8], const uint32_t (&Words)[16][LaneCount]) noexcept
+{
+    __m256i W[16];
+    for (size_t Index = 0; Index < 16; ++Index)
+    {
+        W[Index] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Words[Index]));
+    }
+
+    __m256i A = State[0], B = State[1], C = State[2], D = State[3];
+    __m256i E = State[4], F = State[5], G = State[6], H = State[7];
+    for (size_t Round = 0; Round < 64; ++Round)
+    {
+        if (Round >= 16)
+        {
+            const __m256i W15 = W[(Round + 1) & 15];
+            const __m256i W2 = W[(Round + 14) & 15];
+            const __m256i Sigma0 = _mm256_xor_si256(_mm256_xor_si256(RotateRight8(W15, 7), RotateRight8(W15, 18)), _mm256_srli_epi32(W15, 3));
+            const __m256i Sigma1 = _mm256_xor_si256(_mm256_xor_si256(RotateRight8(W2, 17), RotateRight8(W2, 19)), _mm256_srli_epi32(W2, 10));
+            W[Round & 15] = _mm256_add_epi32(_mm256_add_epi32(W[Round & 15], Sigma0), _mm256_add_epi32(W[(Round + 9) & 15], Sigma1));
+        }
+
+        const __m256i BigSigma1 = _mm256_xor_si256(_mm256_xor_si256(RotateRight8(E, 6), RotateRight8(E, 11)), RotateRight8(E, 25));
+        const __m256i Choose = _mm256_xor_si256(_mm256_and_si256(E, F), _mm256_andnot_si256(E, G));
+        const __m256i T1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(H, BigSigma1), _mm256_add_epi32(Choose, W[Round & 15])),
+                                            _mm256_set1_epi32(static_cast<int>(RoundConstants[Round])));
+        const __m256i BigSigma0 = _mm256_xor_si256(_mm256_xor_si256(RotateRight8(A, 2), RotateRight8(A, 13)), RotateRight8(A, 22));
+        const __m256i Majority = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(A, B), _mm256_and_si256(A, C)), _mm256_and_si256(B, C));
+        H = G;
+        G = F;
+        F = E;
+        E = _mm256_add_epi32(D, T1);
+        D = C;
+        C = B;
+        B = A;
+        A = _mm256_add_epi32(T1, _mm256_add_epi32(BigSigma0, Majority));
+    }
+
+    const __m256i Rounds[8] = {A, B, C, D, E, F, G, H};
+    for (size_t Index = 0; Index < 8; ++Index)
+    {
+        State[Index] = _mm256_add_epi32(State[Index], Rounds[Index]);
+    }
+}
+
+// Messages are taken in order of padded length so the lanes of a group finish together.
+STUPIDCHESS_SHA256_TARGET("avx2")
+void HashBatchAvx2(std::span<const std::span<const uint8_t>> Messages, std::span<FSha256Digest> OutDigests)
+{
+    std::vector<size_t> Order(Messages.size());
+    std::iota(Order.begin(), Order.end(), size_t{0});
+    std::stable_sort(Order.begin(), Order.end(), [&Messages](size_t Left, size_t Right) {
+        return GetPaddedBlockCount(Messages[Left].size()) < GetPaddedBlockCount(Messages[Right].size());
+    });
+
+    for (size_t GroupBegin = 0; GroupBegin < Order.size(); GroupBegin += LaneCount)
+    {
+        const size_t GroupSize = std::min(LaneCount, Order.size() - GroupBegin);
+        std::array<size_t, LaneCount> BlockCounts{};
+        for (size_t Lane = 0; Lane < GroupSize; ++Lane)
+        {
+            BlockCounts[Lane] = GetPaddedBlockCount(Messages[Order[GroupBegin + Lane]].size());
+        }
+
+        __m256i State[8];
+        for (size_t Index = 0; Index < 8; ++Index)
+        {
+            State[Index] = _mm256_set1_epi32(static_cast<int>(InitialState[Index]));
+        }
+
+        const size_t GroupBlockCount = BlockCounts[GroupSize - 1];
+        for (size_t BlockIndex = 0; BlockIndex < GroupBlockCount; ++BlockIndex)
+        {
+            alignas(32) uint32_t Words[16][LaneCount] = {};
+            for (size_t Lane = 0; Lane < GroupSize; ++Lane)
+            {
+                if (BlockIndex >= BlockCounts[Lane])
+                {
+                    continue;
+                }
+                uint8_t Block[BlockSize];
+                LoadPaddedBlock(Messages[Order[GroupBegin + Lane]], BlockIndex, Block);
+                for (size_t Index = 0; Index < 16; ++Index)
+                {
+                    Words[Index][Lane] = LoadBigEndian32(Block + Index * 4);
+                }
+            }
+            CompressAvx2(State, Words);
+
+            alignas(32) uint32_t Lanes[8][LaneCount];
+            bool bStored = false;
+            for (size_t Lane = 0; Lane < GroupSize; ++Lane)
+            {
+                if (BlockCounts[Lane] != BlockIndex + 1)
+                {
+                    continue;
+                }
+                if (!bStored)
+                {
+                    for (size_t Index = 0; Index < 8; ++Index)
+                    {
+                        _mm256_store_si256(reinterpret_cast<__m256i*>(Lanes[Index]), State[Index]);
+                    }
+                    bStored = true;
+                }
+                uint32_t LaneState[8];
+                for (size_t Index = 0; Index < 8; ++Index)
+                {
+                    LaneState[Index] = Lanes[Index][Lane];
+                }
+                OutDigests[Order[GroupBegin + Lane]] = ToDigest(LaneState);
+            }
+        }
+    }
+}
+#endif
+
+FCompressFunction GetCompressFunction(ESha256Backend Backend) noexcept
+{
+#if STUPIDCHESS_SHA256_X86
+    if (Backend == ESha256Backend::ShaNi && GetCpuFeatures().bShaNi)
+    {
+        return CompressShaNi;
+    }
+#else
+    (void)Backend;
+#endif
+    return CompressPortable;
+}
+}
+
+FSha256::FSha256(ESha256Backend InBackend) noexcept
+    : Backend(IsBackendSupported(InBackend) ? InBackend : ESha256Backend::Portable)
+{
+    State = InitialState;
+}
+
+void FSha256::Update(std::span<const uint8_t> Data) noexcept
+{
+    if (Data.empty())
+    {
+        return;
+    }
+
+    const FCompressFunction Compress = GetCompressFunction(Backend);
+    TotalSize += Data.size();
+    if (BufferSize > 0)
+    {
+        const size_t Copied = std::min(BlockSize - BufferSize, Data.size());
+        std::memcpy(Buffer.data() + BufferSize, Data.data(), Copied);
+        BufferSize += Copied;
+        Data = Data.subspan(Copied);
+        if (BufferSize < BlockSize)
+        {
+            return;
+        }
+        Compress(State.data(), Buffer.data(), 1);
+        BufferSize = 0;
+    }
+
+    const size_t FullBlocks = Data.size() / BlockSize;
+    Compress(State.data(), Data.data(), FullBlocks);
+    Data = Data.subspan(FullBlocks * BlockSize);
+    std::memcpy(Buffer.data(), Data.data(), Data.size());
+    BufferSize = Data.size();
+}
+
+FSha256Digest FSha256::Finish() noexcept
+{
+    std::array<uint8_t, BlockSize * 2> Tail{};
+    std::memcpy(Tail.data(), Buffer.data(), BufferSize);
+    Tail[BufferSize] = 0x80;
+    const size_t TailBlocks = BufferSize + 9 > BlockSize ? 2 : 1;
+    const uint64_t BitCount = TotalSize * 8;
+    StoreBigEndian32(Tail.data() + TailBlocks * BlockSize - 8, static_cast<uint32_t>(BitCount >> 32));
+    StoreBigEndian32(Tail.data() + TailBlocks * BlockSize - 4, static_cast<uint32_t>(BitCount));
+    GetCompressFunction(Backend)(State.data(), Tail.data(), TailBlocks);
+    return ToDigest(State.data());
+}
+
+FSha256Digest FSha256::Hash(std::span<const uint8_t> Data, ESha256Backend Backend) noexcept
+{
+    FSha256 Hasher(Backend);
+    Hasher.Update(Data);
+    return Hasher.Finish();
+}
+
+void FSha256::HashBatch(std::span<const std::span<const uint8_t>> Messages, std::span<FSha256Digest> OutDigests, ESha256Backend Backend) noexcept
+{
+#if STUPIDCHESS_SHA256_X86
+    if (Backend == ESha256Backend::Avx2 && GetCpuFeatures().bAvx2)
+    {
+        HashBatchAvx2(Messages, OutDigests);
+        return;
+    }
+#endif
+    for (size_t Index = 0; Index < Messages.size(); ++Index)
+    {
+        OutDigests[Index] = Hash(Messages[Index], Backend);
+    }
+}
+
+bool FSha256::IsBackendSupported(ESha256Backend Backend) noexcept
+{
+    switch (Backend)
+    {
+#if STUPIDCHESS_SHA256_X86
+    case ESha256Backend::ShaNi:
+        return GetCpuFeatures().bShaNi;
+    case ESha256Backend::Avx2:
+        return GetCpuFeatures().bAvx2;
+#endif
+    case ESha256Backend::Portable:
+        return true;
+    default:
+        return false;
+    }
+}
+
+ESha256Backend FSha256::GetBestBackend() noexcept
+{
+    return IsBackendSupported(ESha256Backend::ShaNi) ? ESha256Backend::ShaNi : ESha256Backend::Portable;
+}
+
+ESha256Backend FSha256::GetBestBatchBackend() noexcept
+{
+    if (IsBackendSupported(ESha256Backend::ShaNi))
+    {
+        return ESha256Backend::ShaNi;
+    }
+    return IsBackendSupported(ESha256Backend::Avx2) ? ESha256Backend::Avx2 : ESha256Backend::Portable;
+}
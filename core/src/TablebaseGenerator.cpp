@@ -0,0 +1,381 @@
+#include "CoreRules/TablebaseGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+namespace
+{
+constexpr uint64_t ChunkSize = 1024;
+// Loss level of a position that can never lose: a capture reaches a non-losing sub-position, or the side is stuck.
+constexpr uint8_t BlockedLevel = 0xFF;
+
+// Piece ids of one side by role, in roster order (Black adds 16).
+const std::array<std::vector<uint8_t>, 7> RolePieceIds = {{
+    {4},
+    {3, 5},
+    {2, 6},
+    {1, 7},
+    {0, 8},
+    {9, 10},
+    {11, 12, 13, 14, 15},
+}};
+
+ESide GetOppositeSide(ESide Side) noexcept
+{
+    return Side == ESide::Red ? ESide::Black : ESide::Red;
+}
+
+uint8_t LoadEntry(std::vector<uint8_t>& Entries, uint64_t Index) noexcept
+{
+    return std::atomic_ref<uint8_t>(Entries[Index]).load(std::memory_order_relaxed);
+}
+
+void StoreEntry(std::vector<uint8_t>& Entries, uint64_t Index, uint8_t Entry) noexcept
+{
+    std::atomic_ref<uint8_t>(Entries[Index]).store(Entry, std::memory_order_relaxed);
+}
+
+// Runs Body(Chunk, Begin, End, WorkerIndex) over [0, Count) in fixed chunks pulled by ThreadCount workers; the caller
+// is worker 0.
+template <typename FBody>
+void ParallelForChunks(uint64_t Count, int32_t ThreadCount, const FBody& Body)
+{
+    const uint64_t ChunkCount = (Count + ChunkSize - 1) / ChunkSize;
+    std::atomic<uint64_t> NextChunk{0};
+    const auto RunWorker = [&](int32_t WorkerIndex) {
+        for (uint64_t Chunk = NextChunk.fetch_add(1); Chunk < ChunkCount; Chunk = NextChunk.fetch_add(1))
+        {
+            Body(Chunk, Chunk * ChunkSize, std::min(Count, (Chunk + 1) * ChunkSize), WorkerIndex);
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    Threads.reserve(static_cast<size_t>(ThreadCount - 1));
+    for (int32_t WorkerIndex = 1; WorkerIndex < ThreadCount; ++WorkerIndex)
+    {
+        Threads.emplace_back(RunWorker, WorkerIndex);
+    }
+    RunWorker(0);
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+}
+
+struct FPositionWorker
+{
+    explicit FPositionWorker(const FRuleConfig& RuleConfig)
+        : Referee(RuleConfig)
+    {
+    }
+
+    FMatchReferee Referee;
+    FMoveList Moves;
+};
+
+// Per-material lookup data shared read-only by the workers.
+class FMaterialContext
+{
+public:
+    FMaterialContext(const FTablebaseMaterial& InMaterial, const FEndgameTablebase& Tablebase, const FRuleConfig& InRuleConfig)
+        : Material(InMaterial)
+        , RuleConfig(InRuleConfig)
+    {
+        PieceSlots.fill(-1);
+        Template.Phase = EGamePhase::Battle;
+        Template.PieceCount = static_cast<uint8_t>(Template.Pieces.size());
+        Template.BoardCells.fill(FPackedGameState::EmptyCell);
+        for (size_t RoleIndex = 0; RoleIndex < RolePieceIds.size(); ++RoleIndex)
+        {
+            for (const uint8_t RedId : RolePieceIds[RoleIndex])
+            {
+                for (const uint8_t SideOffset : {0, 16})
+                {
+                    FPackedPiece& Piece = Template.Pieces[RedId + SideOffset];
+                    Piece.Roles = static_cast<uint8_t>(RoleIndex | (RoleIndex << 4));
+                    Piece.Flags = static_cast<uint8_t>(FPackedPiece::RevealedFlag | (SideOffset != 0 ? FPackedPiece::BlackSideFlag : 0));
+                }
+            }
+        }
+
+        // The k-th slot of a side and role takes the k-th roster id of that role.
+        std::array<std::array<size_t, 7>, 2> UsedIds{};
+        for (size_t Slot = 0; Slot < Material.GetPieceCount(); ++Slot)
+        {
+            const FTablebasePiece& Piece = Material.GetPiece(Slot);
+            const size_t SideIndex = Piece.Side == ESide::Red ? 0 : 1;
+            const size_t RoleIndex = static_cast<size_t>(Piece.Role);
+            const uint8_t PieceId = static_cast<uint8_t>(RolePieceIds[RoleIndex][UsedIds[SideIndex][RoleIndex]++] + SideIndex * 16);
+            SlotPieceIds[Slot] = PieceId;
+            PieceSlots[PieceId] = static_cast<int8_t>(Slot);
+            Template.Pieces[PieceId].Flags |= FPackedPiece::AliveFlag | (Piece.bFrozen ? FPackedPiece::FrozenFlag : 0);
+
+            if (Piece.Role != ERoleType::King)
+            {
+                SubTables[Slot] = Tablebase.FindTable(Material.WithoutPiece(Slot));
+            }
+        }
+    }
+
+    // Fills the worker's referee with the position; false when two pieces share a cell.
+    bool LoadPosition(FPositionWorker& Worker, const FTablebaseMaterial::FCells& Cells, ESide SideToMove) const
+    {
+        FPackedGameState Packed = Template;
+        Packed.CurrentTurn = SideToMove;
+        for (size_t Slot = 0; Slot < Material.GetPieceCount(); ++Slot)
+        {
+            if (Packed.BoardCells[Cells[Slot]] != FPackedGameState::EmptyCell)
+            {
+                return false;
+            }
+            Packed.BoardCells[Cells[Slot]] = SlotPieceIds[Slot];
+            Packed.Pieces[SlotPieceIds[Slot]].Cell = Cells[Slot];
+        }
+        Worker.Referee.ImportPackedState(Packed);
+        return true;
+    }
+
+    // Forward pass for one position: sets its entry when it is decided without search (unreachable, mated),
+    // summarizes its captures and appends its in-table successors.
+    void ClassifyPosition(FPositionWorker& Worker, uint64_t Index, std::vector<uint8_t>& Entries, std::vector<uint8_t>& WinLevels,
+                          std::vector<uint8_t>& LossLevels, std::vector<uint32_t>& OutSuccessors) const
+    {
+        FTablebaseMaterial::FCells Cells{};
+        ESide Side = ESide::Red;
+        Material.DecodeIndex(Index, Cells, Side);
+        const ESide Opponent = GetOppositeSide(Side);
+
+        // The side that just moved can never be left in check; that covers facing kings as well.
+        if (!LoadPosition(Worker, Cells, Side) || Worker.Referee.IsSideInCheck(Opponent))
+        {
+            Entries[Index] = FEndgameTable::InvalidEntry;
+            return;
+        }
+
+        Worker.Referee.GenerateLegalMoves(Side, Worker.Moves);
+        if (Worker.Moves.IsEmpty())
+        {
+            if (Worker.Referee.IsSideInCheck(Side))
+            {
+                Entries[Index] = FEndgameTable::EncodeDistance(0);
+            }
+            else if (RuleConfig.bAllowPassWhenNoLegalMove && Worker.Referee.HasAnyLegalMove(Opponent))
+            {
+                OutSuccessors.push_back(static_cast<uint32_t>(Material.ComputeIndex(Cells, Opponent)));
+            }
+            else
+            {
+                LossLevels[Index] = BlockedLevel;
+            }
+            return;
+        }
+
+        uint8_t WinLevel = 0;
+        uint8_t LossLevel = 0;
+        for (const FMoveAction& Move : Worker.Moves)
+        {
+            FTablebaseMaterial::FCells NextCells = Cells;
+            NextCells[static_cast<size_t>(PieceSlots[Move.PieceId])] = static_cast<uint8_t>(Move.To.Y * 9 + Move.To.X);
+            if (!Move.CapturedPieceId.has_value())
+            {
+                OutSuccessors.push_back(static_cast<uint32_t>(Material.ComputeIndex(NextCells, Opponent)));
+                continue;
+            }
+
+            const size_t CapturedSlot = static_cast<size_t>(PieceSlots[Move.CapturedPieceId.value()]);
+            const FEndgameTable* SubTable = SubTables[CapturedSlot];
+            FTablebaseMaterial::FCells SubCells{};
+            std::copy(NextCells.begin(), NextCells.begin() + static_cast<std::ptrdiff_t>(CapturedSlot), SubCells.begin());
+            std::copy(NextCells.begin() + static_cast<std::ptrdiff_t>(CapturedSlot) + 1, NextCells.end(),
+                      SubCells.begin() + static_cast<std::ptrdiff_t>(CapturedSlot));
+
+            FTablebaseProbeResult Reply{};
+            if (SubTable == nullptr ||
+                !FEndgameTable::DecodeEntry(SubTable->GetEntry(SubTable->GetMaterial().ComputeIndex(SubCells, Opponent)), Reply))
+            {
+                LossLevel = BlockedLevel;
+                continue;
+            }
+
+            const uint8_t ReplyLevel = static_cast<uint8_t>(Reply.Distance + 1);
+            if (Reply.Outcome == ETablebaseOutcome::Loss)
+            {
+                WinLevel = WinLevel == 0 ? ReplyLevel : std::min(WinLevel, ReplyLevel);
+            }
+            else if (Reply.Outcome == ETablebaseOutcome::Win)
+            {
+                LossLevel = std::max(LossLevel, ReplyLevel);
+            }
+            else
+            {
+                LossLevel = BlockedLevel;
+            }
+        }
+        WinLevels[Index] = WinLevel;
+        LossLevels[Index] = LossLevel;
+    }
+
+    uint64_t GetEntryCount() const noexcept
+    {
+        return Material.GetEntryCount();
+    }
+
+private:
+    const FTablebaseMaterial& Material;
+    const FRuleConfig& RuleConfig;
+    FPackedGameState Template{};
+    std::array<uint8_t, FTablebaseMaterial::MaxPieces> SlotPieceIds{};
+    std::array<int8_t, 32> PieceSlots{};
+    std::array<const FEndgameTable*, FTablebaseMaterial::MaxPieces> SubTables{};
+};
+}
+
+FTablebaseGenerator::FTablebaseGenerator(FTablebaseGeneratorConfig InConfig)
+    : Config(std::move(InConfig))
+{
+    Config.ThreadCount = std::max(Config.ThreadCount, 1);
+}
+
+bool FTablebaseGenerator::Generate(const FTablebaseMaterial& Material, FEndgameTablebase& Tablebase, std::string& OutError)
+{
+    if (Tablebase.FindTable(Material) != nullptr)
+    {
+        return true;
+    }
+
+    for (size_t Slot = 0; Slot < Material.GetPieceCount(); ++Slot)
+    {
+        if (Material.GetPiece(Slot).Role != ERoleType::King && !Generate(Material.WithoutPiece(Slot), Tablebase, OutError))
+        {
+            return false;
+        }
+    }
+    return GenerateTable(Material, Tablebase, OutError);
+}
+
+const std::vector<FTablebaseGenerationStats>& FTablebaseGenerator::GetGeneratedStats() const noexcept
+{
+    return GeneratedStats;
+}
+
+bool FTablebaseGenerator::GenerateTable(const FTablebaseMaterial& Material, FEndgameTablebase& Tablebase, std::string& OutError)
+{
+    const auto StartTime = std::chrono::steady_clock::now();
+    const FMaterialContext Context(Material, Tablebase, Config.RuleConfig);
+    const uint64_t EntryCount = Context.GetEntryCount();
+    const uint64_t ChunkCount = (EntryCount + ChunkSize - 1) / ChunkSize;
+
+    std::vector<uint8_t> Entries(EntryCount, FEndgameTable::DrawEntry);
+    std::vector<uint8_t> WinLevels(EntryCount, 0);
+    std::vector<uint8_t> LossLevels(EntryCount, 0);
+    std::vector<uint64_t> SuccessorOffsets(EntryCount + 1, 0);
+    std::vector<std::vector<uint32_t>> ChunkSuccessors(ChunkCount);
+
+    std::vector<FPositionWorker> Workers(static_cast<size_t>(Config.ThreadCount), FPositionWorker(Config.RuleConfig));
+    ParallelForChunks(EntryCount, Config.ThreadCount, [&](uint64_t Chunk, uint64_t Begin, uint64_t End, int32_t WorkerIndex) {
+        std::vector<uint32_t>& Successors = ChunkSuccessors[Chunk];
+        for (uint64_t Index = Begin; Index < End; ++Index)
+        {
+            const size_t SizeBefore = Successors.size();
+            Context.ClassifyPosition(Workers[static_cast<size_t>(WorkerIndex)], Index, Entries, WinLevels, LossLevels, Successors);
+            SuccessorOffsets[Index + 1] = Successors.size() - SizeBefore;
+        }
+    });
+
+    std::vector<uint32_t> Successors;
+    Successors.reserve(std::accumulate(ChunkSuccessors.begin(), ChunkSuccessors.end(), size_t{0},
+                                       [](size_t Sum, const std::vector<uint32_t>& Chunk) { return Sum + Chunk.size(); }));
+    for (std::vector<uint32_t>& Chunk : ChunkSuccessors)
+    {
+        Successors.insert(Successors.end(), Chunk.begin(), Chunk.end());
+        std::vector<uint32_t>().swap(Chunk);
+    }
+    int32_t LastCaptureLevel = 0;
+    for (uint64_t Index = 0; Index < EntryCount; ++Index)
+    {
+        SuccessorOffsets[Index + 1] += SuccessorOffsets[Index];
+        LastCaptureLevel = std::max<int32_t>(LastCaptureLevel, WinLevels[Index]);
+        if (LossLevels[Index] != BlockedLevel)
+        {
+            LastCaptureLevel = std::max<int32_t>(LastCaptureLevel, LossLevels[Index]);
+        }
+    }
+
+    // Level N settles exactly the positions at distance N; entries written during a level pass have distance N and
+    // are never what that pass looks for, so positions can be decided concurrently.
+    int32_t EmptyLevels = 0;
+    for (int32_t Level = 1; Level <= LastCaptureLevel || EmptyLevels < 2; ++Level)
+    {
+        if (Level > FEndgameTable::MaxDistance)
+        {
+            OutError = "Tablebase " + Material.GetName() + " has distances beyond " + std::to_string(FEndgameTable::MaxDistance) + " plies.";
+            return false;
+        }
+
+        const bool bWinLevel = (Level & 1) != 0;
+        const uint8_t LevelEntry = FEndgameTable::EncodeDistance(Level);
+        std::atomic<uint64_t> ResolvedCount{0};
+        ParallelForChunks(EntryCount, Config.ThreadCount, [&](uint64_t, uint64_t Begin, uint64_t End, int32_t) {
+            uint64_t ChunkResolved = 0;
+            for (uint64_t Index = Begin; Index < End; ++Index)
+            {
+                if (LoadEntry(Entries, Index) != FEndgameTable::DrawEntry)
+                {
+                    continue;
+                }
+
+                const uint32_t* SuccessorBegin = Successors.data() + SuccessorOffsets[Index];
+                const uint32_t* SuccessorEnd = Successors.data() + SuccessorOffsets[Index + 1];
+                bool bResolved = false;
+                if (bWinLevel)
+                {
+                    const uint8_t PreviousLoss = FEndgameTable::EncodeDistance(Level - 1);
+                    bResolved = WinLevels[Index] == Level ||
+                                std::any_of(SuccessorBegin, SuccessorEnd, [&](uint32_t Successor) { return LoadEntry(Entries, Successor) == PreviousLoss; });
+                }
+                else if (WinLevels[Index] == 0 && LossLevels[Index] <= Level)
+                {
+                    // A capture into a lost sub-table wins at WinLevels[Index], so such a position is never lost.
+                    bResolved = std::all_of(SuccessorBegin, SuccessorEnd, [&](uint32_t Successor) {
+                        const uint8_t Entry = LoadEntry(Entries, Successor);
+                        return Entry != FEndgameTable::DrawEntry && Entry < LevelEntry && ((Entry - 1) & 1) != 0;
+                    });
+                }
+
+                if (bResolved)
+                {
+                    StoreEntry(Entries, Index, LevelEntry);
+                    ++ChunkResolved;
+                }
+            }
+            ResolvedCount.fetch_add(ChunkResolved, std::memory_order_relaxed);
+        });
+        EmptyLevels = ResolvedCount.load() == 0 ? EmptyLevels + 1 : 0;
+    }
+
+    FTablebaseGenerationStats Stats{};
+    Stats.Name = Material.GetName();
+    Stats.Entries = EntryCount;
+    for (const uint8_t Entry : Entries)
+    {
+        FTablebaseProbeResult Result{};
+        if (!FEndgameTable::DecodeEntry(Entry, Result))
+        {
+            ++Stats.Invalid;
+            continue;
+        }
+        Stats.Wins += Result.Outcome == ETablebaseOutcome::Win ? 1 : 0;
+        Stats.Losses += Result.Outcome == ETablebaseOutcome::Loss ? 1 : 0;
+        Stats.Draws += Result.Outcome == ETablebaseOutcome::Draw ? 1 : 0;
+        Stats.LongestDistance = std::max(Stats.LongestDistance, Result.Distance);
+    }
+    Stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    GeneratedStats.push_back(std::move(Stats));
+
+    Tablebase.AddTable(std::make_unique<FEndgameTable>(Material, std::move(Entries)));
+    return true;
+}
@@ -0,0 +1,254 @@
+#include "CoreRules/TranspositionTable.h"
+
+#include <bit>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+constexpr size_t HugePageSize = size_t{2} << 20;
+constexpr uint64_t GenerationMask = 0x3F;
+constexpr int32_t AgePenaltyPlies = 8;
+
+// Data word layout: Score (16) | Depth (8) | Bound (2) | Generation (6) | MovePieceId (8) | MoveToCell (8).
+uint64_t PackData(const FTranspositionData& Data, uint8_t Generation) noexcept
+{
+    return uint64_t{static_cast<uint16_t>(Data.Score)} | (uint64_t{static_cast<uint8_t>(Data.Depth)} << 16) |
+           (uint64_t{static_cast<uint8_t>(Data.Bound)} << 24) | ((uint64_t{Generation} & GenerationMask) << 26) |
+           (uint64_t{Data.MovePieceId} << 32) | (uint64_t{Data.MoveToCell} << 40);
+}
+
+FTranspositionData UnpackData(uint64_t Word) noexcept
+{
+    FTranspositionData Data{};
+    Data.Score = static_cast<int16_t>(static_cast<uint16_t>(Word));
+    Data.Depth = static_cast<int8_t>(static_cast<uint8_t>(Word >> 16));
+    Data.Bound = static_cast<ETranspositionBound>((Word >> 24) & 0x3);
+    Data.MovePieceId = static_cast<uint8_t>(Word >> 32);
+    Data.MoveToCell = static_cast<uint8_t>(Word >> 40);
+    return Data;
+}
+
+uint8_t GetDataGeneration(uint64_t Word) noexcept
+{
+    return static_cast<uint8_t>((Word >> 26) & GenerationMask);
+}
+
+size_t RoundUp(size_t Value, size_t Alignment) noexcept
+{
+    return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+void* AllocateAligned(size_t Bytes, size_t Alignment)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(Bytes, Alignment);
+#else
+    return std::aligned_alloc(Alignment, Bytes);
+#endif
+}
+
+void FreeAligned(void* Memory) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(Memory);
+#else
+    std::free(Memory);
+#endif
+}
+}
+
+FTranspositionTable::FTranspositionTable(size_t SizeMegabytes, bool bUseHugePages)
+{
+    const size_t RequestedBuckets = (SizeMegabytes << 20) / BucketSize;
+    BucketCount = RequestedBuckets == 0 ? 1 : std::bit_floor(RequestedBuckets);
+
+    const size_t TableBytes = BucketCount * BucketSize;
+#if defined(__linux__)
+    bHugePages = bUseHugePages && TableBytes >= HugePageSize;
+#else
+    (void)bUseHugePages;
+#endif
+    const size_t Alignment = bHugePages ? HugePageSize : BucketSize;
+    AllocatedBytes = RoundUp(TableBytes, Alignment);
+
+    void* Memory = AllocateAligned(AllocatedBytes, Alignment);
+    if (Memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+#if defined(__linux__)
+    if (bHugePages)
+    {
+        bHugePages = madvise(Memory, AllocatedBytes, MADV_HUGEPAGE) == 0;
+    }
+#endif
+
+    Buckets = static_cast<FBucket*>(Memory);
+    std::uninitialized_value_construct_n(Buckets, BucketCount);
+}
+
+FTranspositionTable::~FTranspositionTable()
+{
+    std::destroy_n(Buckets, BucketCount);
+    FreeAligned(Buckets);
+}
+
+void FTranspositionTable::Clear() noexcept
+{
+    for (size_t BucketIndex = 0; BucketIndex < BucketCount; ++BucketIndex)
+    {
+        for (FEntry& Entry : Buckets[BucketIndex].Entries)
+        {
+            Entry.KeyXorData.store(0, std::memory_order_relaxed);
+            Entry.Data.store(0, std::memory_order_relaxed);
+        }
+    }
+    Generation = 0;
+}
+
+void FTranspositionTable::NewSearch() noexcept
+{
+    Generation = static_cast<uint8_t>((Generation + 1) & GenerationMask);
+}
+
+FTranspositionTable::FBucket& FTranspositionTable::GetBucket(uint64_t Key) noexcept
+{
+    // The low key bits pick the bucket; entries still verify the full key.
+    return Buckets[Key & (BucketCount - 1)];
+}
+
+bool FTranspositionTable::Probe(uint64_t Key, FTranspositionData& OutData) noexcept
+{
+    if (bStatsEnabled)
+    {
+        ProbeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (FEntry& Entry : GetBucket(Key).Entries)
+    {
+        const uint64_t Data = Entry.Data.load(std::memory_order_relaxed);
+        const uint64_t KeyXorData = Entry.KeyXorData.load(std::memory_order_relaxed);
+        if ((KeyXorData ^ Data) != Key)
+        {
+            continue;
+        }
+
+        FTranspositionData Decoded = UnpackData(Data);
+        if (Decoded.Bound == ETranspositionBound::None)
+        {
+            continue;
+        }
+        OutData = Decoded;
+        if (bStatsEnabled)
+        {
+            HitCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    return false;
+}
+
+void FTranspositionTable::Store(uint64_t Key, const FTranspositionData& Data) noexcept
+{
+    if (bStatsEnabled)
+    {
+        StoreCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FBucket& Bucket = GetBucket(Key);
+    FEntry* Victim = nullptr;
+    uint64_t VictimData = 0;
+    int32_t VictimWorth = std::numeric_limits<int32_t>::max();
+    for (FEntry& Entry : Bucket.Entries)
+    {
+        const uint64_t StoredData = Entry.Data.load(std::memory_order_relaxed);
+        const uint64_t StoredKey = Entry.KeyXorData.load(std::memory_order_relaxed) ^ StoredData;
+        const FTranspositionData Stored = UnpackData(StoredData);
+        if (Stored.Bound != ETranspositionBound::None && StoredKey == Key)
+        {
+            // Same position: keep a deeper bound from this search, and keep its move when the new result has none.
+            if (Data.Bound != ETranspositionBound::Exact && Stored.Depth > Data.Depth &&
+                GetDataGeneration(StoredData) == Generation)
+            {
+                return;
+            }
+            FTranspositionData Merged = Data;
+            if (Merged.MovePieceId == 0xFF)
+            {
+                Merged.MovePieceId = Stored.MovePieceId;
+                Merged.MoveToCell = Stored.MoveToCell;
+            }
+            const uint64_t NewData = PackData(Merged, Generation);
+            Entry.KeyXorData.store(Key ^ NewData, std::memory_order_relaxed);
+            Entry.Data.store(NewData, std::memory_order_relaxed);
+            return;
+        }
+
+        const int32_t Age = static_cast<int32_t>((Generation - GetDataGeneration(StoredData)) & GenerationMask);
+        const int32_t Worth = Stored.Bound == ETranspositionBound::None ? std::numeric_limits<int32_t>::min()
+                                                                        : Stored.Depth - Age * AgePenaltyPlies;
+        if (Worth < VictimWorth)
+        {
+            VictimWorth = Worth;
+            Victim = &Entry;
+            VictimData = StoredData;
+        }
+    }
+
+    if (bStatsEnabled && UnpackData(VictimData).Bound != ETranspositionBound::None && GetDataGeneration(VictimData) == Generation)
+    {
+        CollisionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    const uint64_t NewData = PackData(Data, Generation);
+    Victim->KeyXorData.store(Key ^ NewData, std::memory_order_relaxed);
+    Victim->Data.store(NewData, std::memory_order_relaxed);
+}
+
+size_t FTranspositionTable::GetBucketCount() const noexcept
+{
+    return BucketCount;
+}
+
+size_t FTranspositionTable::GetSizeBytes() const noexcept
+{
+    return BucketCount * BucketSize;
+}
+
+bool FTranspositionTable::IsUsingHugePages() const noexcept
+{
+    return bHugePages;
+}
+
+void FTranspositionTable::SetStatsEnabled(bool bEnabled) noexcept
+{
+    bStatsEnabled = bEnabled;
+}
+
+bool FTranspositionTable::IsStatsEnabled() const noexcept
+{
+    return bStatsEnabled;
+}
+
+FTranspositionTableStats FTranspositionTable::GetStats() const noexcept
+{
+    FTranspositionTableStats Stats{};
+    Stats.Probes = ProbeCount.load(std::memory_order_relaxed);
+    Stats.Hits = HitCount.load(std::memory_order_relaxed);
+    Stats.Stores = StoreCount.load(std::memory_order_relaxed);
+    Stats.Collisions = CollisionCount.load(std::memory_order_relaxed);
+    return Stats;
+}
+
+void FTranspositionTable::ResetStats() noexcept
+{
+    ProbeCount.store(0, std::memory_order_relaxed);
+    HitCount.store(0, std::memory_order_relaxed);
+    StoreCount.store(0, std::memory_order_relaxed);
+    CollisionCount.store(0, std::memory_order_relaxed);
+}
@@ -22,6 +22,9 @@ bool DecodePullSyncPayload(const std::string& Json, FProtocolPullSyncPayload& Ou
 bool EncodeAckPayload(const FProtocolAckPayload& Payload, std::string& OutJson);
 bool DecodeAckPayload(const std::string& Json, FProtocolAckPayload& OutPayload);
 
+bool EncodeQueryLegalMovesPayload(const FProtocolQueryLegalMovesPayload& Payload, std::string& OutJson);
+bool DecodeQueryLegalMovesPayload(const std::string& Json, FProtocolQueryLegalMovesPayload& OutPayload);
+
 bool EncodeJoinAckPayload(const FProtocolJoinAckPayload& Payload, std::string& OutJson);
 bool DecodeJoinAckPayload(const std::string& Json, FProtocolJoinAckPayload& OutPayload);
 
@@ -37,6 +40,9 @@ bool DecodeEventDeltaPayload(const std::string& Json, FProtocolEventDeltaPayload
 bool EncodeGameOverPayload(const FProtocolGameOverPayload& Payload, std::string& OutJson);
 bool DecodeGameOverPayload(const std::string& Json, FProtocolGameOverPayload& OutPayload);
 
+bool EncodeLegalMovesPayload(const FProtocolLegalMovesPayload& Payload, std::string& OutJson);
+bool DecodeLegalMovesPayload(const std::string& Json, FProtocolLegalMovesPayload& OutPayload);
+
 bool EncodeErrorPayload(const FProtocolErrorPayload& Payload, std::string& OutJson);
 bool DecodeErrorPayload(const std::string& Json, FProtocolErrorPayload& OutPayload);
 }
@@ -11,13 +11,15 @@ enum class EProtocolMessageType : uint16_t
     C2S_Ping = 102,
     C2S_PullSync = 103,
     C2S_Ack = 104,
+    C2S_QueryLegalMoves = 105,
 
     S2C_JoinAck = 200,
     S2C_CommandAck = 201,
     S2C_Snapshot = 202,
     S2C_EventDelta = 203,
     S2C_GameOver = 204,
-    S2C_Error = 205
+    S2C_Error = 205,
+    S2C_LegalMoves = 206
 };
 
 struct FProtocolEnvelope
@@ -94,6 +96,11 @@ struct FProtocolAckPayload
     uint64_t Sequence = 0;
 };
 
+struct FProtocolQueryLegalMovesPayload
+{
+    uint64_t PlayerId = 0;
+};
+
 struct FProtocolJoinAckPayload
 {
     bool bAccepted = false;
@@ -158,6 +165,13 @@ struct FProtocolGameOverPayload
     uint64_t TurnIndex = 0;
 };
 
+struct FProtocolLegalMovesPayload
+{
+    int32_t Side = 0;
+    uint64_t TurnIndex = 0;
+    std::vector<FProtocolMovePayload> Moves;
+};
+
 struct FProtocolErrorPayload
 {
     std::string ErrorMessage;
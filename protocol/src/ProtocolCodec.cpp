@@ -432,6 +432,45 @@ bool ReadArray(const FProtocolJsonValue& ObjectValue, const char* FieldName, con
     return true;
 }
 
+void AppendMovePayload(std::ostringstream& Stream, const FProtocolMovePayload& Move)
+{
+    Stream << "{\"pieceId\":" << Move.PieceId
+           << ",\"fromX\":" << Move.FromX
+           << ",\"fromY\":" << Move.FromY
+           << ",\"toX\":" << Move.ToX
+           << ",\"toY\":" << Move.ToY
+           << ",\"hasCapturedPieceId\":" << (Move.bHasCapturedPieceId ? "true" : "false")
+           << ",\"capturedPieceId\":" << Move.CapturedPieceId
+           << '}';
+}
+
+bool ReadMovePayload(const FProtocolJsonValue& MoveObject, FProtocolMovePayload& OutMove)
+{
+    int64_t PieceIdValue = 0;
+    int64_t FromX = 0;
+    int64_t FromY = 0;
+    int64_t ToX = 0;
+    int64_t ToY = 0;
+    int64_t CapturedPieceIdValue = 0;
+    if (!ReadInt(MoveObject, "pieceId", PieceIdValue) ||
+        !ReadInt(MoveObject, "fromX", FromX) ||
+        !ReadInt(MoveObject, "fromY", FromY) ||
+        !ReadInt(MoveObject, "toX", ToX) ||
+        !ReadInt(MoveObject, "toY", ToY) ||
+        !ReadBool(MoveObject, "hasCapturedPieceId", OutMove.bHasCapturedPieceId) ||
+        !ReadInt(MoveObject, "capturedPieceId", CapturedPieceIdValue))
+    {
+        return false;
+    }
+
+    OutMove.PieceId = static_cast<uint16_t>(PieceIdValue);
+    OutMove.FromX = static_cast<int32_t>(FromX);
+    OutMove.FromY = static_cast<int32_t>(FromY);
+    OutMove.ToX = static_cast<int32_t>(ToX);
+    OutMove.ToY = static_cast<int32_t>(ToY);
+    OutMove.CapturedPieceId = static_cast<uint16_t>(CapturedPieceIdValue);
+    return true;
+}
 }
 
 namespace ProtocolCodec
@@ -516,14 +555,8 @@ bool EncodeCommandPayload(const FProtocolCommandPayload& Payload, std::string& O
 
     if (Payload.bHasMove)
     {
-        Stream << ",\"move\":{\"pieceId\":" << Payload.Move.PieceId
-               << ",\"fromX\":" << Payload.Move.FromX
-               << ",\"fromY\":" << Payload.Move.FromY
-               << ",\"toX\":" << Payload.Move.ToX
-               << ",\"toY\":" << Payload.Move.ToY
-               << ",\"hasCapturedPieceId\":" << (Payload.Move.bHasCapturedPieceId ? "true" : "false")
-               << ",\"capturedPieceId\":" << Payload.Move.CapturedPieceId
-               << '}';
+        Stream << ",\"move\":";
+        AppendMovePayload(Stream, Payload.Move);
     }
 
     if (Payload.bHasSetupCommit)
@@ -592,34 +625,10 @@ bool DecodeCommandPayload(const std::string& Json, FProtocolCommandPayload& OutP
     if (OutPayload.bHasMove)
     {
         const FProtocolJsonValue* MoveObject = nullptr;
-        if (!ReadObject(Root, "move", MoveObject))
+        if (!ReadObject(Root, "move", MoveObject) || !ReadMovePayload(*MoveObject, OutPayload.Move))
         {
             return false;
         }
-
-        int64_t PieceIdValue = 0;
-        int64_t FromX = 0;
-        int64_t FromY = 0;
-        int64_t ToX = 0;
-        int64_t ToY = 0;
-        int64_t CapturedPieceIdValue = 0;
-        if (!ReadInt(*MoveObject, "pieceId", PieceIdValue) ||
-            !ReadInt(*MoveObject, "fromX", FromX) ||
-            !ReadInt(*MoveObject, "fromY", FromY) ||
-            !ReadInt(*MoveObject, "toX", ToX) ||
-            !ReadInt(*MoveObject, "toY", ToY) ||
-            !ReadBool(*MoveObject, "hasCapturedPieceId", OutPayload.Move.bHasCapturedPieceId) ||
-            !ReadInt(*MoveObject, "capturedPieceId", CapturedPieceIdValue))
-        {
-            return false;
-        }
-
-        OutPayload.Move.PieceId = static_cast<uint16_t>(PieceIdValue);
-        OutPayload.Move.FromX = static_cast<int32_t>(FromX);
-        OutPayload.Move.FromY = static_cast<int32_t>(FromY);
-        OutPayload.Move.ToX = static_cast<int32_t>(ToX);
-        OutPayload.Move.ToY = static_cast<int32_t>(ToY);
-        OutPayload.Move.CapturedPieceId = static_cast<uint16_t>(CapturedPieceIdValue);
     }
 
     if (OutPayload.bHasSetupCommit)
@@ -745,6 +754,32 @@ bool DecodeAckPayload(const std::string& Json, FProtocolAckPayload& OutPayload)
     return true;
 }
 
+bool EncodeQueryLegalMovesPayload(const FProtocolQueryLegalMovesPayload& Payload, std::string& OutJson)
+{
+    std::ostringstream Stream;
+    Stream << "{\"playerId\":" << Payload.PlayerId << '}';
+    OutJson = Stream.str();
+    return true;
+}
+
+bool DecodeQueryLegalMovesPayload(const std::string& Json, FProtocolQueryLegalMovesPayload& OutPayload)
+{
+    FProtocolJsonValue Root;
+    if (!ParseJsonRootObject(Json, Root))
+    {
+        return false;
+    }
+
+    int64_t PlayerIdValue = 0;
+    if (!ReadInt(Root, "playerId", PlayerIdValue))
+    {
+        return false;
+    }
+
+    OutPayload.PlayerId = static_cast<uint64_t>(PlayerIdValue);
+    return true;
+}
+
 bool EncodeJoinAckPayload(const FProtocolJoinAckPayload& Payload, std::string& OutJson)
 {
     std::ostringstream Stream;
@@ -1031,6 +1066,60 @@ bool DecodeGameOverPayload(const std::string& Json, FProtocolGameOverPayload& Ou
     return true;
 }
 
+bool EncodeLegalMovesPayload(const FProtocolLegalMovesPayload& Payload, std::string& OutJson)
+{
+    std::ostringstream Stream;
+    Stream << "{\"side\":" << Payload.Side
+           << ",\"turnIndex\":" << Payload.TurnIndex
+           << ",\"moves\":[";
+    for (size_t Index = 0; Index < Payload.Moves.size(); ++Index)
+    {
+        if (Index > 0)
+        {
+            Stream << ',';
+        }
+        AppendMovePayload(Stream, Payload.Moves[Index]);
+    }
+    Stream << "]}";
+    OutJson = Stream.str();
+    return true;
+}
+
+bool DecodeLegalMovesPayload(const std::string& Json, FProtocolLegalMovesPayload& OutPayload)
+{
+    FProtocolJsonValue Root;
+    if (!ParseJsonRootObject(Json, Root))
+    {
+        return false;
+    }
+
+    int64_t Side = 0;
+    int64_t TurnIndex = 0;
+    const FProtocolJsonValue* MovesArray = nullptr;
+    if (!ReadInt(Root, "side", Side) ||
+        !ReadInt(Root, "turnIndex", TurnIndex) ||
+        !ReadArray(Root, "moves", MovesArray))
+    {
+        return false;
+    }
+
+    OutPayload.Side = static_cast<int32_t>(Side);
+    OutPayload.TurnIndex = static_cast<uint64_t>(TurnIndex);
+    OutPayload.Moves.clear();
+    OutPayload.Moves.reserve(MovesArray->ArrayValue.size());
+    for (const FProtocolJsonValue& MoveValue : MovesArray->ArrayValue)
+    {
+        FProtocolMovePayload Move{};
+        if (!ReadMovePayload(MoveValue, Move))
+        {
+            return false;
+        }
+        OutPayload.Moves.push_back(Move);
+    }
+
+    return true;
+}
+
 bool EncodeErrorPayload(const FProtocolErrorPayload& Payload, std::string& OutJson)
 {
     std::ostringstream Stream;
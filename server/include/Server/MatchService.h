@@ -21,6 +21,17 @@ struct FMatchSyncResponse
     std::vector<FMatchEventRecord> Events;
 };
 
+struct FMatchLegalMovesResponse
+{
+    bool bAccepted = false;
+    std::string ErrorCode;
+    std::string ErrorMessage;
+    FMatchId MatchId = 0;
+    ESide Side = ESide::Red;
+    uint64_t TurnIndex = 0;
+    std::vector<FMoveAction> Moves;
+};
+
 class FInMemoryMatchService
 {
 public:
@@ -28,6 +39,7 @@ public:
     FCommandResult SubmitPlayerCommand(FPlayerId PlayerId, const FPlayerCommand& Command);
     FMatchSyncResponse PullPlayerSync(FPlayerId PlayerId, std::optional<uint64_t> AfterSequenceOverride = std::nullopt) const;
     bool AckPlayerEvents(FPlayerId PlayerId, uint64_t Sequence);
+    FMatchLegalMovesResponse QueryLegalMoves(FPlayerId PlayerId);
 
     std::optional<FMatchId> FindPlayerMatch(FPlayerId PlayerId) const;
     std::optional<uint64_t> GetPlayerAckSequence(FPlayerId PlayerId) const;
@@ -1,7 +1,9 @@
 ﻿#pragma once
 
+#include "CoreRules/EndgameTablebase.h"
 #include "CoreRules/MatchReferee.h"
 
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -56,7 +58,11 @@ enum class EMatchEventType : uint8_t
     PassApplied,
     ResignApplied,
     CommandRejected,
-    GameOver
+    GameOver,
+    PieceCaptured,
+    PieceRevealed,
+    PieceFrozen,
+    CheckGiven
 };
 
 struct FMatchEventRecord
@@ -67,6 +73,8 @@ struct FMatchEventRecord
     FPlayerId ActorPlayerId = 0;
     std::string ErrorCode;
     std::string Description;
+    // Set when only that side may pull the event, e.g. a check on a king that is still hidden.
+    std::optional<ESide> VisibleSide;
 };
 
 class FInMemoryMatchSession
@@ -79,11 +87,39 @@ public:
 
     const FGameState& GetState() const noexcept;
     FMatchPlayerView GetPlayerView(FPlayerId PlayerId) const;
+    // Events after AfterSequence that the player's side may see.
     std::vector<FMatchEventRecord> PullEvents(FPlayerId PlayerId, uint64_t AfterSequence) const;
     uint64_t GetLatestEventSequence() const noexcept;
+    // Legal moves for the player's side in the current battle position; empty outside Battle or for non-players.
+    // Generated at most once per side and TurnIndex, so repeated queries within a turn are served from the cache.
+    std::vector<FMoveAction> GetLegalMoves(FPlayerId PlayerId);
+    uint64_t GetLegalMoveGenerationCount() const noexcept;
+    // After each accepted move or pass, a decisive tablebase verdict ends the game with EEndReason::Tablebase.
+    // nullptr disables adjudication; the tablebase must outlive the session.
+    void SetTablebase(const FEndgameTablebase* InTablebase) noexcept;
+    // Every command submitted by a joined player, rejected ones included, with sides normalized to the player's
+    // seat; FReplayEngine reproduces the match from it.
+    const std::vector<FPlayerCommand>& GetCommandLog() const noexcept;
+    // Typed events of the last accepted battle command, including a tablebase GameEnded; empty after any other
+    // command. The event log is written from the same list.
+    const FGameEventList& GetLastGameEvents() const noexcept;
 
 private:
-    void AppendEvent(EMatchEventType EventType, FPlayerId ActorPlayerId, std::string Description, std::string ErrorCode = {});
+    struct FLegalMovesCacheEntry
+    {
+        bool bValid = false;
+        uint64_t TurnIndex = 0;
+        std::vector<FMoveAction> Moves;
+    };
+
+    void AppendEvent(
+        EMatchEventType EventType,
+        FPlayerId ActorPlayerId,
+        std::string Description,
+        std::string ErrorCode = {},
+        std::optional<ESide> VisibleSide = std::nullopt);
+    void AppendGameEvents(FPlayerId ActorPlayerId);
+    void AdjudicateByTablebase();
     std::optional<ESide> GetPlayerSide(FPlayerId PlayerId) const;
 
 private:
@@ -91,5 +127,10 @@ private:
     FMatchReferee MatchReferee;
     std::unordered_map<FPlayerId, ESide> PlayerSides;
     std::vector<FMatchEventRecord> EventLog;
+    std::vector<FPlayerCommand> CommandLog;
+    FGameEventList LastGameEvents;
     uint64_t NextEventSequence = 1;
+    std::array<FLegalMovesCacheEntry, 2> LegalMovesCache{};
+    uint64_t LegalMoveGenerationCount = 0;
+    const FEndgameTablebase* Tablebase = nullptr;
 };
@@ -17,5 +17,6 @@ public:
     static FProtocolSnapshotPayload BuildSnapshotPayload(const FMatchPlayerView& View, uint64_t LastEventSequence);
     static FProtocolEventDeltaPayload BuildEventDeltaPayload(const FMatchSyncResponse& SyncResponse);
     static FProtocolGameOverPayload BuildGameOverPayload(const FMatchPlayerView& View);
+    static FProtocolLegalMovesPayload BuildLegalMovesPayload(const FMatchLegalMovesResponse& LegalMovesResponse);
     static FProtocolSyncBundle BuildSyncBundle(const FMatchSyncResponse& SyncResponse);
 };
@@ -19,6 +19,7 @@ struct FOutboundProtocolMessage
     std::optional<FProtocolSnapshotPayload> Snapshot;
     std::optional<FProtocolEventDeltaPayload> EventDelta;
     std::optional<FProtocolGameOverPayload> GameOver;
+    std::optional<FProtocolLegalMovesPayload> LegalMoves;
     std::string ErrorMessage;
 };
 
@@ -51,6 +52,7 @@ public:
     bool HandlePlayerCommand(FPlayerId PlayerId, const FPlayerCommand& Command);
     bool HandlePullSync(FPlayerId PlayerId, std::optional<uint64_t> AfterSequenceOverride = std::nullopt);
     bool HandleAck(FPlayerId PlayerId, uint64_t Sequence);
+    bool HandleQueryLegalMoves(FPlayerId PlayerId);
 
     uint64_t GetNextServerSequence() const noexcept;
 
@@ -59,6 +61,7 @@ private:
     void SendCommandAck(FPlayerId PlayerId, FMatchId MatchId, const FProtocolCommandAckPayload& Payload);
     void SendSnapshotAndDelta(FPlayerId PlayerId, const FMatchSyncResponse& SyncResponse);
     void SendGameOver(FPlayerId PlayerId, FMatchId MatchId, const FProtocolGameOverPayload& Payload);
+    void SendLegalMoves(FPlayerId PlayerId, FMatchId MatchId, const FProtocolLegalMovesPayload& Payload);
     void SendError(FPlayerId PlayerId, FMatchId MatchId, std::string ErrorMessage);
 
     FOutboundProtocolMessage BuildMessageBase(FPlayerId PlayerId, FMatchId MatchId, EProtocolMessageType MessageType);
@@ -112,6 +112,30 @@ bool FInMemoryMatchService::AckPlayerEvents(FPlayerId PlayerId, uint64_t Sequenc
     return true;
 }
 
+FMatchLegalMovesResponse FInMemoryMatchService::QueryLegalMoves(FPlayerId PlayerId)
+{
+    const auto BindingIt = PlayerBindings.find(PlayerId);
+    if (BindingIt == PlayerBindings.end())
+    {
+        return {false, "ERR_PLAYER_NOT_BOUND", "Player is not bound to any match.", 0, ESide::Red, 0, {}};
+    }
+
+    const FPlayerBinding& Binding = BindingIt->second;
+    FInMemoryMatchSession* Session = FindMutableSession(Binding.MatchId);
+    if (Session == nullptr)
+    {
+        return {false, "ERR_MATCH_NOT_FOUND", "Bound match does not exist.", 0, ESide::Red, 0, {}};
+    }
+
+    FMatchLegalMovesResponse Response{};
+    Response.bAccepted = true;
+    Response.MatchId = Binding.MatchId;
+    Response.Side = Binding.Side;
+    Response.TurnIndex = Session->GetState().TurnIndex;
+    Response.Moves = Session->GetLegalMoves(PlayerId);
+    return Response;
+}
+
 std::optional<FMatchId> FInMemoryMatchService::FindPlayerMatch(FPlayerId PlayerId) const
 {
     const auto It = PlayerBindings.find(PlayerId);
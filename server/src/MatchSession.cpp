@@ -3,12 +3,40 @@
 #include <algorithm>
 #include <sstream>
 
+namespace
+{
+EMatchEventType ToMatchEventType(EGameEventType EventType) noexcept
+{
+    switch (EventType)
+    {
+    case EGameEventType::PieceMoved:
+        return EMatchEventType::MoveApplied;
+    case EGameEventType::PieceCaptured:
+        return EMatchEventType::PieceCaptured;
+    case EGameEventType::PieceRevealed:
+        return EMatchEventType::PieceRevealed;
+    case EGameEventType::PieceFrozen:
+        return EMatchEventType::PieceFrozen;
+    case EGameEventType::CheckGiven:
+        return EMatchEventType::CheckGiven;
+    case EGameEventType::GameEnded:
+        break;
+    }
+    return EMatchEventType::GameOver;
+}
+} // namespace
+
 FInMemoryMatchSession::FInMemoryMatchSession(FMatchId InMatchId)
     : MatchId(InMatchId)
 {
 }
 
-void FInMemoryMatchSession::AppendEvent(EMatchEventType EventType, FPlayerId ActorPlayerId, std::string Description, std::string ErrorCode)
+void FInMemoryMatchSession::AppendEvent(
+    EMatchEventType EventType,
+    FPlayerId ActorPlayerId,
+    std::string Description,
+    std::string ErrorCode,
+    std::optional<ESide> VisibleSide)
 {
     EventLog.push_back(FMatchEventRecord{
         NextEventSequence++,
@@ -16,7 +44,22 @@ void FInMemoryMatchSession::AppendEvent(EMatchEventType EventType, FPlayerId Act
         EventType,
         ActorPlayerId,
         std::move(ErrorCode),
-        std::move(Description)});
+        std::move(Description),
+        VisibleSide});
+}
+
+void FInMemoryMatchSession::AppendGameEvents(FPlayerId ActorPlayerId)
+{
+    for (const FGameEvent& Event : LastGameEvents)
+    {
+        // A check on a hidden king (To left invalid) would tell the attacker which piece is the king.
+        std::optional<ESide> VisibleSide;
+        if (Event.EventType == EGameEventType::CheckGiven && !Event.To.IsValid())
+        {
+            VisibleSide = Event.Side == ESide::Red ? ESide::Black : ESide::Red;
+        }
+        AppendEvent(ToMatchEventType(Event.EventType), ActorPlayerId, GetGameEventDescription(Event.EventType), {}, VisibleSide);
+    }
 }
 
 FMatchJoinResponse FInMemoryMatchSession::Join(const FMatchJoinRequest& Request)
@@ -44,6 +87,7 @@ FMatchJoinResponse FInMemoryMatchSession::Join(const FMatchJoinRequest& Request)
 
 FCommandResult FInMemoryMatchSession::SubmitCommand(FPlayerId PlayerId, const FPlayerCommand& Command)
 {
+    LastGameEvents.Clear();
     const std::optional<ESide> PlayerSide = GetPlayerSide(PlayerId);
     if (!PlayerSide.has_value())
     {
@@ -54,7 +98,6 @@ FCommandResult FInMemoryMatchSession::SubmitCommand(FPlayerId PlayerId, const FP
 
     FPlayerCommand NormalizedCommand = Command;
     NormalizedCommand.Side = PlayerSide.value();
-    const EGamePhase PhaseBefore = MatchReferee.GetState().Phase;
 
     FCommandResult Result{};
     switch (NormalizedCommand.CommandType)
@@ -82,9 +125,10 @@ FCommandResult FInMemoryMatchSession::SubmitCommand(FPlayerId PlayerId, const FP
         }
         break;
     default:
-        Result = MatchReferee.ApplyCommand(NormalizedCommand);
+        Result = MatchReferee.ApplyCommand(NormalizedCommand, LastGameEvents);
         break;
     }
+    CommandLog.push_back(NormalizedCommand);
 
     if (!Result.bAccepted)
     {
@@ -100,9 +144,6 @@ FCommandResult FInMemoryMatchSession::SubmitCommand(FPlayerId PlayerId, const FP
     case ECommandType::RevealSetup:
         AppendEvent(EMatchEventType::SetupRevealed, PlayerId, "Setup revealed");
         break;
-    case ECommandType::Move:
-        AppendEvent(EMatchEventType::MoveApplied, PlayerId, "Move applied");
-        break;
     case ECommandType::Pass:
         AppendEvent(EMatchEventType::PassApplied, PlayerId, "Pass applied");
         break;
@@ -113,10 +154,12 @@ FCommandResult FInMemoryMatchSession::SubmitCommand(FPlayerId PlayerId, const FP
         break;
     }
 
-    if (PhaseBefore != EGamePhase::GameOver && MatchReferee.GetState().Phase == EGamePhase::GameOver)
+    if (NormalizedCommand.CommandType == ECommandType::Move || NormalizedCommand.CommandType == ECommandType::Pass)
     {
-        AppendEvent(EMatchEventType::GameOver, PlayerId, "Game over");
+        AdjudicateByTablebase();
     }
+    // PieceMoved stands in for the MoveApplied summary, so a move is logged entirely from the referee's events.
+    AppendGameEvents(PlayerId);
 
     return Result;
 }
@@ -162,7 +205,8 @@ FMatchPlayerView FInMemoryMatchSession::GetPlayerView(FPlayerId PlayerId) const
 
 std::vector<FMatchEventRecord> FInMemoryMatchSession::PullEvents(FPlayerId PlayerId, uint64_t AfterSequence) const
 {
-    if (!GetPlayerSide(PlayerId).has_value())
+    const std::optional<ESide> PlayerSide = GetPlayerSide(PlayerId);
+    if (!PlayerSide.has_value())
     {
         return {};
     }
@@ -170,7 +214,7 @@ std::vector<FMatchEventRecord> FInMemoryMatchSession::PullEvents(FPlayerId Playe
     std::vector<FMatchEventRecord> Result;
     for (const FMatchEventRecord& Event : EventLog)
     {
-        if (Event.Sequence > AfterSequence)
+        if (Event.Sequence > AfterSequence && (!Event.VisibleSide.has_value() || Event.VisibleSide == PlayerSide))
         {
             Result.push_back(Event);
         }
@@ -183,6 +227,65 @@ uint64_t FInMemoryMatchSession::GetLatestEventSequence() const noexcept
     return NextEventSequence == 0 ? 0 : NextEventSequence - 1;
 }
 
+std::vector<FMoveAction> FInMemoryMatchSession::GetLegalMoves(FPlayerId PlayerId)
+{
+    const std::optional<ESide> PlayerSide = GetPlayerSide(PlayerId);
+    const FGameState& State = MatchReferee.GetState();
+    if (!PlayerSide.has_value() || State.Phase != EGamePhase::Battle)
+    {
+        return {};
+    }
+
+    // Every accepted move or pass bumps TurnIndex; the only other battle transition is GameOver, excluded above.
+    FLegalMovesCacheEntry& Entry = LegalMovesCache[static_cast<size_t>(PlayerSide.value())];
+    if (!Entry.bValid || Entry.TurnIndex != State.TurnIndex)
+    {
+        Entry.Moves = MatchReferee.GenerateLegalMoves(PlayerSide.value());
+        Entry.TurnIndex = State.TurnIndex;
+        Entry.bValid = true;
+        ++LegalMoveGenerationCount;
+    }
+
+    return Entry.Moves;
+}
+
+uint64_t FInMemoryMatchSession::GetLegalMoveGenerationCount() const noexcept
+{
+    return LegalMoveGenerationCount;
+}
+
+void FInMemoryMatchSession::SetTablebase(const FEndgameTablebase* InTablebase) noexcept
+{
+    Tablebase = InTablebase;
+}
+
+const FGameEventList& FInMemoryMatchSession::GetLastGameEvents() const noexcept
+{
+    return LastGameEvents;
+}
+
+const std::vector<FPlayerCommand>& FInMemoryMatchSession::GetCommandLog() const noexcept
+{
+    return CommandLog;
+}
+
+void FInMemoryMatchSession::AdjudicateByTablebase()
+{
+    FTablebaseProbeResult ProbeResult{};
+    if (Tablebase == nullptr || !Tablebase->Probe(MatchReferee, ProbeResult) || ProbeResult.Outcome == ETablebaseOutcome::Draw)
+    {
+        return;
+    }
+
+    const bool bRedWins = (MatchReferee.GetState().CurrentTurn == ESide::Red) == (ProbeResult.Outcome == ETablebaseOutcome::Win);
+    FGameEventList AdjudicationEvents;
+    MatchReferee.Adjudicate(bRedWins ? EGameResult::RedWin : EGameResult::BlackWin, EEndReason::Tablebase, AdjudicationEvents);
+    for (const FGameEvent& Event : AdjudicationEvents)
+    {
+        LastGameEvents.PushBack(Event);
+    }
+}
+
 std::optional<ESide> FInMemoryMatchSession::GetPlayerSide(FPlayerId PlayerId) const
 {
     const auto It = PlayerSides.find(PlayerId);
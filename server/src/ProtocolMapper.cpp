@@ -111,6 +111,29 @@ FProtocolGameOverPayload FProtocolMapper::BuildGameOverPayload(const FMatchPlaye
     return Payload;
 }
 
+FProtocolLegalMovesPayload FProtocolMapper::BuildLegalMovesPayload(const FMatchLegalMovesResponse& LegalMovesResponse)
+{
+    FProtocolLegalMovesPayload Payload{};
+    Payload.Side = ToInt(LegalMovesResponse.Side);
+    Payload.TurnIndex = LegalMovesResponse.TurnIndex;
+    Payload.Moves.reserve(LegalMovesResponse.Moves.size());
+
+    for (const FMoveAction& Move : LegalMovesResponse.Moves)
+    {
+        FProtocolMovePayload MovePayload{};
+        MovePayload.PieceId = Move.PieceId;
+        MovePayload.FromX = Move.From.X;
+        MovePayload.FromY = Move.From.Y;
+        MovePayload.ToX = Move.To.X;
+        MovePayload.ToY = Move.To.Y;
+        MovePayload.bHasCapturedPieceId = Move.CapturedPieceId.has_value();
+        MovePayload.CapturedPieceId = Move.CapturedPieceId.value_or(0);
+        Payload.Moves.push_back(MovePayload);
+    }
+
+    return Payload;
+}
+
 FProtocolSyncBundle FProtocolMapper::BuildSyncBundle(const FMatchSyncResponse& SyncResponse)
 {
     FProtocolSyncBundle Bundle{};
@@ -67,6 +67,16 @@ bool FServerGateway::ProcessEnvelope(const FProtocolEnvelope& Envelope)
 
         return TransportAdapter->HandleAck(Payload.PlayerId, Payload.Sequence);
     }
+    case EProtocolMessageType::C2S_QueryLegalMoves:
+    {
+        FProtocolQueryLegalMovesPayload Payload{};
+        if (!ProtocolCodec::DecodeQueryLegalMovesPayload(Envelope.PayloadJson, Payload))
+        {
+            return false;
+        }
+
+        return TransportAdapter->HandleQueryLegalMoves(Payload.PlayerId);
+    }
     case EProtocolMessageType::C2S_Ping:
         return true;
     default:
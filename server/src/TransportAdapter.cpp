@@ -136,6 +136,24 @@ bool FServerTransportAdapter::HandleAck(FPlayerId PlayerId, uint64_t Sequence)
     return false;
 }
 
+bool FServerTransportAdapter::HandleQueryLegalMoves(FPlayerId PlayerId)
+{
+    if (MatchService == nullptr || MessageSink == nullptr)
+    {
+        return false;
+    }
+
+    const FMatchLegalMovesResponse Response = MatchService->QueryLegalMoves(PlayerId);
+    if (!Response.bAccepted)
+    {
+        SendError(PlayerId, Response.MatchId, Response.ErrorMessage);
+        return false;
+    }
+
+    SendLegalMoves(PlayerId, Response.MatchId, FProtocolMapper::BuildLegalMovesPayload(Response));
+    return true;
+}
+
 uint64_t FServerTransportAdapter::GetNextServerSequence() const noexcept
 {
     return NextServerSequence;
@@ -200,6 +218,17 @@ void FServerTransportAdapter::SendGameOver(FPlayerId PlayerId, FMatchId MatchId,
     MessageSink->Send(Message);
 }
 
+void FServerTransportAdapter::SendLegalMoves(FPlayerId PlayerId, FMatchId MatchId, const FProtocolLegalMovesPayload& Payload)
+{
+    FOutboundProtocolMessage Message = BuildMessageBase(PlayerId, MatchId, EProtocolMessageType::S2C_LegalMoves);
+    Message.LegalMoves = Payload;
+    if (!ProtocolCodec::EncodeLegalMovesPayload(Payload, Message.Envelope.PayloadJson))
+    {
+        Message.Envelope.PayloadJson = "{}";
+    }
+    MessageSink->Send(Message);
+}
+
 void FServerTransportAdapter::SendError(FPlayerId PlayerId, FMatchId MatchId, std::string ErrorMessage)
 {
     FOutboundProtocolMessage Message = BuildMessageBase(PlayerId, MatchId, EProtocolMessageType::S2C_Error);
@@ -0,0 +1,127 @@
+#include "CoreRules/AlphaBetaSearch.h"
+#include "Perft/Perft.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct FPlacedPiece
+{
+    FPieceId PieceId = 0;
+    FBoardPos Pos{};
+};
+
+// Keeps only the listed pieces, revealed on the given cells, with Red to move.
+FMatchReferee BuildRevealedEndgame(const std::vector<FPlacedPiece>& PlacedPieces)
+{
+    FMatchReferee Referee = Perft::BuildBattleReferee(*Perft::FindSetup("Standard"));
+    FPackedGameState Packed = Referee.ExportPackedState();
+    Packed.BoardCells.fill(FPackedGameState::EmptyCell);
+    for (FPackedPiece& Piece : Packed.Pieces)
+    {
+        Piece.Cell = FPackedPiece::OffBoardCell;
+        Piece.Flags &= static_cast<uint8_t>(~FPackedPiece::AliveFlag);
+    }
+    for (const FPlacedPiece& Placed : PlacedPieces)
+    {
+        const uint8_t Cell = static_cast<uint8_t>(Placed.Pos.Y * 9 + Placed.Pos.X);
+        FPackedPiece& Piece = Packed.Pieces[Placed.PieceId];
+        Piece.Cell = Cell;
+        Piece.Flags |= FPackedPiece::AliveFlag | FPackedPiece::RevealedFlag;
+        Packed.BoardCells[Cell] = static_cast<uint8_t>(Placed.PieceId);
+    }
+    Packed.PositionHash = FMatchReferee::ComputePositionHash(FGameStatePacker::Unpack(Packed));
+    Referee.ImportPackedState(Packed);
+    return Referee;
+}
+}
+
+TEST(AlphaBetaSearchTests, ShouldFindRookMateInOne)
+{
+    // Red king (4) on (4,0) keeps the black king (20) off file 4 and rook 8 covers rank 8, so rook 0 mates on
+    // (0,9) or (3,7).
+    FMatchReferee Referee = BuildRevealedEndgame({
+        {4, FBoardPos{4, 0}},
+        {0, FBoardPos{0, 7}},
+        {8, FBoardPos{8, 8}},
+        {20, FBoardPos{3, 9}},
+    });
+
+    FAlphaBetaSearch Search(1);
+    FSearchLimits Limits{};
+    Limits.MaxDepth = 3;
+    Limits.TimeBudgetMs = 0;
+    const FSearchResult Result = Search.Search(Referee, Limits);
+
+    ASSERT_TRUE(Result.bHasCommand);
+    ASSERT_EQ(Result.BestCommand.CommandType, ECommandType::Move);
+    ASSERT_TRUE(Result.BestCommand.Move.has_value());
+    EXPECT_EQ(Result.BestCommand.Move->PieceId, 0);
+    EXPECT_EQ(Result.Score, FAlphaBetaSearch::MateScore - 1);
+
+    ASSERT_TRUE(Referee.ApplyCommand(Result.BestCommand).bAccepted);
+    EXPECT_EQ(Referee.GetState().Result, EGameResult::RedWin);
+    EXPECT_EQ(Referee.GetState().EndReason, EEndReason::Checkmate);
+}
+
+TEST(AlphaBetaSearchTests, ShouldReturnLegalEvasionAndRestoreRefereeWithinNodeBudget)
+{
+    FMatchReferee Referee = Perft::BuildBattleReferee(*Perft::FindSetup("RedKingOnHorseSlot"));
+    const FGameState StateBefore = Referee.GetState();
+
+    FAlphaBetaSearch Search(1);
+    FSearchLimits Limits{};
+    Limits.MaxNodes = 2000;
+    Limits.TimeBudgetMs = 0;
+    const FSearchResult Result = Search.Search(Referee, Limits);
+
+    EXPECT_TRUE(Referee.GetState() == StateBefore);
+    EXPECT_GE(Result.CompletedDepth, 1);
+    ASSERT_TRUE(Result.bHasCommand);
+    ASSERT_TRUE(Result.BestCommand.Move.has_value());
+
+    const std::vector<FMoveAction> LegalMoves = Referee.GenerateLegalMoves(ESide::Red);
+    const bool bIsLegal = std::any_of(LegalMoves.begin(), LegalMoves.end(), [&Result](const FMoveAction& Move) {
+        return Move.PieceId == Result.BestCommand.Move->PieceId && Move.To == Result.BestCommand.Move->To;
+    });
+    EXPECT_TRUE(bIsLegal);
+    EXPECT_TRUE(Referee.ApplyCommand(Result.BestCommand).bAccepted);
+}
+
+TEST(AlphaBetaSearchTests, ShouldIgnoreOpposingHiddenRolesWhenSearchingFromView)
+{
+    // Swapping two hidden black ids changes only what Red must not see.
+    const FMatchReferee Referee = Perft::BuildBattleReferee(*Perft::FindSetup("Standard"));
+    FPackedGameState Packed = Referee.ExportPackedState();
+    FPackedPiece& BlackRook = Packed.Pieces[16];
+    FPackedPiece& BlackHorse = Packed.Pieces[17];
+    std::swap(BlackRook.Cell, BlackHorse.Cell);
+    Packed.BoardCells[BlackRook.Cell] = 16;
+    Packed.BoardCells[BlackHorse.Cell] = 17;
+    Packed.PositionHash = FMatchReferee::ComputePositionHash(FGameStatePacker::Unpack(Packed));
+    FMatchReferee SwappedReferee(Referee.GetRuleConfig());
+    SwappedReferee.ImportPackedState(Packed);
+    ASSERT_EQ(SwappedReferee.GetState().Pieces[16].PieceState, EPieceState::HiddenSurface);
+
+    EXPECT_EQ(FAlphaBetaSearch::Evaluate(Referee.GetState()), FAlphaBetaSearch::Evaluate(SwappedReferee.GetState()));
+
+    FSearchLimits Limits{};
+    Limits.MaxNodes = 2000;
+    Limits.TimeBudgetMs = 0;
+    FAlphaBetaSearch Search(1);
+    FAlphaBetaSearch SwappedSearch(1);
+    const FSearchResult Result = Search.SearchFromView(Referee, Limits, 7);
+    const FSearchResult SwappedResult = SwappedSearch.SearchFromView(SwappedReferee, Limits, 7);
+
+    ASSERT_TRUE(Result.bHasCommand);
+    ASSERT_TRUE(Result.BestCommand.Move.has_value());
+    ASSERT_TRUE(SwappedResult.BestCommand.Move.has_value());
+    EXPECT_EQ(Result.BestCommand.Move->PieceId, SwappedResult.BestCommand.Move->PieceId);
+    EXPECT_EQ(Result.BestCommand.Move->To, SwappedResult.BestCommand.Move->To);
+    EXPECT_EQ(Result.Score, SwappedResult.Score);
+    EXPECT_TRUE(Referee.ValidateMove(*Result.BestCommand.Move).has_value());
+}
@@ -0,0 +1,242 @@
+#include "CoreRules/BatchMatchEnv.h"
+#include "CoreRules/MatchReferee.h"
+#include "CoreRules/RandomSetup.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct FBatchBuffers
+{
+    explicit FBatchBuffers(int32_t GameCount)
+        : Observations(static_cast<size_t>(GameCount) * FBatchMatchEnv::ObservationSize)
+        , ActionMasks(static_cast<size_t>(GameCount) * FBatchMatchEnv::ActionCount)
+        , Rewards(GameCount)
+        , Terminated(GameCount)
+        , Truncated(GameCount)
+    {
+    }
+
+    FBatchStepBuffers View()
+    {
+        return FBatchStepBuffers{Observations.data(), ActionMasks.data(), Rewards.data(), Terminated.data(), Truncated.data()};
+    }
+
+    std::vector<float> Observations;
+    std::vector<uint8_t> ActionMasks;
+    std::vector<float> Rewards;
+    std::vector<uint8_t> Terminated;
+    std::vector<uint8_t> Truncated;
+};
+
+// Picks the index-th legal action of each game's mask, wrapping around.
+std::vector<int32_t> PickMaskedActions(const std::vector<uint8_t>& ActionMasks, int32_t GameCount, uint32_t Index)
+{
+    std::vector<int32_t> Actions(GameCount, FBatchMatchEnv::PassAction);
+    for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+    {
+        const uint8_t* Mask = ActionMasks.data() + static_cast<size_t>(GameIndex) * FBatchMatchEnv::ActionCount;
+        const int32_t LegalCount = static_cast<int32_t>(std::count(Mask, Mask + FBatchMatchEnv::ActionCount, uint8_t{1}));
+        if (LegalCount == 0)
+        {
+            continue;
+        }
+
+        int32_t Remaining = static_cast<int32_t>(Index % static_cast<uint32_t>(LegalCount));
+        for (int32_t Action = 0; Action < FBatchMatchEnv::ActionCount; ++Action)
+        {
+            if (Mask[Action] != 0 && Remaining-- == 0)
+            {
+                Actions[GameIndex] = Action;
+                break;
+            }
+        }
+    }
+    return Actions;
+}
+}
+
+TEST(BatchMatchEnvTests, ShouldWriteMasksMatchingRefereeLegalMoves)
+{
+    constexpr int32_t GameCount = 4;
+    FBatchMatchEnv Env(FBatchMatchEnvConfig{GameCount, 400, {}});
+    FBatchBuffers Buffers(GameCount);
+    Env.Reset(7, Buffers.View());
+
+    for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+    {
+        FMatchReferee Referee;
+        Referee.ImportPackedState(Env.GetGameState(GameIndex));
+        EXPECT_EQ(Referee.GetState().Phase, EGamePhase::Battle);
+
+        const uint8_t* Mask = Buffers.ActionMasks.data() + static_cast<size_t>(GameIndex) * FBatchMatchEnv::ActionCount;
+        const size_t MaskedCount = static_cast<size_t>(std::count(Mask, Mask + FBatchMatchEnv::PassAction, uint8_t{1}));
+        EXPECT_EQ(MaskedCount, Referee.GenerateLegalMoves(ESide::Red).size());
+        EXPECT_EQ(Mask[FBatchMatchEnv::PassAction], 0);
+
+        // Red to move sees its own 16 pieces by actual role and Black's by surface role.
+        const float* Observation = Buffers.Observations.data() + static_cast<size_t>(GameIndex) * FBatchMatchEnv::ObservationSize;
+        EXPECT_EQ(std::count(Observation, Observation + 7 * 90, 1.0f), 16);
+        EXPECT_EQ(std::count(Observation + 16 * 90, Observation + 23 * 90, 1.0f), 16);
+        EXPECT_EQ(Observation[16 * 90 + static_cast<int32_t>(ERoleType::King) * 90 + 9 * 9 + 4], 1.0f);
+    }
+}
+
+TEST(BatchMatchEnvTests, ShouldBeDeterministicForSameSeedAndActions)
+{
+    constexpr int32_t GameCount = 3;
+    FBatchMatchEnv FirstEnv(FBatchMatchEnvConfig{GameCount, 60, {}});
+    FBatchMatchEnv SecondEnv(FBatchMatchEnvConfig{GameCount, 60, {}});
+    FBatchBuffers FirstBuffers(GameCount);
+    FBatchBuffers SecondBuffers(GameCount);
+    FirstEnv.Reset(42, FirstBuffers.View());
+    SecondEnv.Reset(42, SecondBuffers.View());
+
+    uint32_t TruncatedCount = 0;
+    for (uint32_t StepIndex = 0; StepIndex < 150; ++StepIndex)
+    {
+        const std::vector<int32_t> Actions = PickMaskedActions(FirstBuffers.ActionMasks, GameCount, StepIndex * 31 + 5);
+        FirstEnv.Step(Actions.data(), FirstBuffers.View());
+        SecondEnv.Step(Actions.data(), SecondBuffers.View());
+
+        ASSERT_EQ(FirstBuffers.ActionMasks, SecondBuffers.ActionMasks);
+        ASSERT_EQ(FirstBuffers.Observations, SecondBuffers.Observations);
+        ASSERT_EQ(FirstBuffers.Rewards, SecondBuffers.Rewards);
+        for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+        {
+            EXPECT_TRUE(
+                FGameStatePacker::Unpack(FirstEnv.GetGameState(GameIndex)) ==
+                FGameStatePacker::Unpack(SecondEnv.GetGameState(GameIndex)));
+            TruncatedCount += FirstBuffers.Truncated[GameIndex];
+            if (FirstBuffers.Terminated[GameIndex] == 0)
+            {
+                EXPECT_EQ(FirstBuffers.Rewards[GameIndex], 0.0f);
+            }
+        }
+    }
+
+    // 150 steps with a 60-ply cap must end some episode, and every game keeps running afterwards.
+    EXPECT_GT(TruncatedCount, 0u);
+    for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+    {
+        EXPECT_EQ(FirstEnv.GetGameState(GameIndex).Phase, EGamePhase::Battle);
+    }
+}
+
+TEST(BatchMatchEnvTests, ShouldEndEpisodeAsLossOnIllegalAction)
+{
+    constexpr int32_t GameCount = 2;
+    FBatchMatchEnv Env(FBatchMatchEnvConfig{GameCount, 400, {}});
+    FBatchBuffers Buffers(GameCount);
+    Env.Reset(3, Buffers.View());
+
+    std::vector<int32_t> Actions = PickMaskedActions(Buffers.ActionMasks, GameCount, 0);
+    Actions[1] = FBatchMatchEnv::PassAction; // Pass is illegal while moves exist.
+    Env.Step(Actions.data(), Buffers.View());
+
+    EXPECT_EQ(Buffers.Terminated[0], 0);
+    EXPECT_EQ(Buffers.Rewards[0], 0.0f);
+    EXPECT_EQ(Env.GetGameState(0).TurnIndex, 1u);
+
+    EXPECT_EQ(Buffers.Terminated[1], 1);
+    EXPECT_EQ(Buffers.Rewards[1], -1.0f);
+    EXPECT_EQ(Env.GetGameState(1).TurnIndex, 0u);
+    EXPECT_EQ(Env.GetGameState(1).Phase, EGamePhase::Battle);
+}
+
+// Replays every game of the batch on its own referee, seeded the way the env seeds it, and checks that states,
+// masks and rewards agree after each step, across captures, reveals, freezes and episode restarts.
+TEST(BatchMatchEnvTests, ShouldMatchRefereeAlongRandomPlayouts)
+{
+    constexpr int32_t GameCount = 6;
+    constexpr uint64_t Seed = 11;
+    FBatchMatchEnv Env(FBatchMatchEnvConfig{GameCount, 120, {}});
+    FBatchBuffers Buffers(GameCount);
+    Env.Reset(Seed, Buffers.View());
+
+    std::vector<FMatchReferee> Referees(GameCount);
+    std::vector<uint64_t> RngStates(GameCount);
+    uint64_t SeedState = Seed;
+    auto StartEpisode = [&Referees, &RngStates](int32_t GameIndex) {
+        FMatchReferee& Referee = Referees[GameIndex];
+        Referee.ResetNewMatch();
+        Referee.ApplyCommit({ESide::Red, ""});
+        Referee.ApplyCommit({ESide::Black, ""});
+        Referee.ApplyReveal(BuildRandomSetup(ESide::Red, RngStates[GameIndex]));
+        Referee.ApplyReveal(BuildRandomSetup(ESide::Black, RngStates[GameIndex]));
+    };
+    for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+    {
+        RngStates[GameIndex] = NextSplitMix64(SeedState);
+        StartEpisode(GameIndex);
+    }
+
+    uint32_t CaptureCount = 0;
+    uint32_t EpisodeCount = 0;
+    uint64_t ActionRngState = 99;
+    for (uint32_t StepIndex = 0; StepIndex < 400; ++StepIndex)
+    {
+        for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+        {
+            const FMatchReferee& Referee = Referees[GameIndex];
+            const ESide Side = Referee.GetState().CurrentTurn;
+            ASSERT_TRUE(Referee.GetState() == FGameStatePacker::Unpack(Env.GetGameState(GameIndex))) << "step " << StepIndex;
+
+            std::vector<uint8_t> ExpectedMask(FBatchMatchEnv::ActionCount, 0);
+            for (const FMoveAction& Move : Referee.GenerateLegalMoves(Side))
+            {
+                ExpectedMask[(Move.From.Y * 9 + Move.From.X) * FBatchMatchEnv::CellCount + Move.To.Y * 9 + Move.To.X] = 1;
+            }
+            ExpectedMask[FBatchMatchEnv::PassAction] = Referee.CanPass(Side) ? 1 : 0;
+            const auto MaskBegin = Buffers.ActionMasks.begin() + static_cast<ptrdiff_t>(GameIndex) * FBatchMatchEnv::ActionCount;
+            ASSERT_TRUE(std::equal(ExpectedMask.begin(), ExpectedMask.end(), MaskBegin)) << "step " << StepIndex;
+        }
+
+        const std::vector<int32_t> Actions =
+            PickMaskedActions(Buffers.ActionMasks, GameCount, static_cast<uint32_t>(NextSplitMix64(ActionRngState)));
+        Env.Step(Actions.data(), Buffers.View());
+
+        for (int32_t GameIndex = 0; GameIndex < GameCount; ++GameIndex)
+        {
+            FMatchReferee& Referee = Referees[GameIndex];
+            const ESide Side = Referee.GetState().CurrentTurn;
+            const int32_t Action = Actions[GameIndex];
+            FPlayerCommand Command{};
+            Command.Side = Side;
+            Command.CommandType = Action == FBatchMatchEnv::PassAction ? ECommandType::Pass : ECommandType::Move;
+            if (Action != FBatchMatchEnv::PassAction)
+            {
+                const int32_t FromCell = Action / FBatchMatchEnv::CellCount;
+                const int32_t ToCell = Action % FBatchMatchEnv::CellCount;
+                const FBoardPos From{static_cast<int8_t>(FromCell % 9), static_cast<int8_t>(FromCell / 9)};
+                const FBoardPos To{static_cast<int8_t>(ToCell % 9), static_cast<int8_t>(ToCell / 9)};
+                CaptureCount += Referee.GetState().BoardCells[ToCell].has_value() ? 1 : 0;
+                Command.Move = FMoveAction{Referee.GetState().BoardCells[FromCell].value(), From, To, std::nullopt};
+            }
+            // An empty mask (a random setup can start with the kings facing and no way out) makes the fallback
+            // pass illegal, which the env scores as a loss.
+            const bool bAccepted = Referee.ApplyCommand(Command).bAccepted;
+            const FGameState& State = Referee.GetState();
+            const bool bGameOver = !bAccepted || State.Phase == EGamePhase::GameOver;
+            const EGameResult WinResult = Side == ESide::Red ? EGameResult::RedWin : EGameResult::BlackWin;
+            float ExpectedReward = !bAccepted ? -1.0f : 0.0f;
+            if (bAccepted && bGameOver && State.Result != EGameResult::Draw)
+            {
+                ExpectedReward = State.Result == WinResult ? 1.0f : -1.0f;
+            }
+            EXPECT_EQ(Buffers.Terminated[GameIndex], bGameOver ? 1 : 0);
+            EXPECT_EQ(Buffers.Rewards[GameIndex], ExpectedReward);
+            if (bGameOver || Buffers.Truncated[GameIndex] != 0)
+            {
+                ++EpisodeCount;
+                StartEpisode(GameIndex);
+            }
+        }
+    }
+
+    EXPECT_GT(CaptureCount, 0u);
+    EXPECT_GT(EpisodeCount, 0u);
+}
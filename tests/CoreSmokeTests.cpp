@@ -1,8 +1,13 @@
+#include "CoreRules/BoardGeometry.h"
 #include "CoreRules/MatchReferee.h"
+#include "CoreRules/SetupCommitment.h"
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -113,6 +118,38 @@ const FPieceState* FindPieceOrNull(const FGameState& State, FPieceId PieceId)
     }
     return &State.Pieces[Index];
 }
+
+void ExpectOccupancyMatchesBoardCells(const FGameState& State)
+{
+    for (int32_t Cell = 0; Cell < 90; ++Cell)
+    {
+        const std::optional<FPieceId>& Occupant = State.BoardCells[Cell];
+        const bool bRed = Occupant.has_value() && State.Pieces[Occupant.value()].Side == ESide::Red;
+        const bool bBlack = Occupant.has_value() && State.Pieces[Occupant.value()].Side == ESide::Black;
+        EXPECT_EQ(State.SideOccupancy[0].Test(Cell), bRed) << "Cell " << Cell;
+        EXPECT_EQ(State.SideOccupancy[1].Test(Cell), bBlack) << "Cell " << Cell;
+    }
+}
+
+void ExpectPieceCachesMatchPieces(const FGameState& State)
+{
+    std::array<int8_t, 2> ExpectedKingCells{-1, -1};
+    std::array<uint16_t, 2> ExpectedMovableMasks{};
+    for (const FPieceState& Piece : State.Pieces)
+    {
+        const int32_t SideIndex = Piece.Side == ESide::Red ? 0 : 1;
+        if (Piece.bAlive && !Piece.bFrozen)
+        {
+            ExpectedMovableMasks[SideIndex] |= static_cast<uint16_t>(1u << (Piece.PieceId % 16));
+        }
+        if (Piece.bAlive && Piece.ActualRole == ERoleType::King)
+        {
+            ExpectedKingCells[SideIndex] = static_cast<int8_t>(Piece.Pos.Y * 9 + Piece.Pos.X);
+        }
+    }
+    EXPECT_EQ(State.KingCells, ExpectedKingCells);
+    EXPECT_EQ(State.MovablePieceMasks, ExpectedMovableMasks);
+}
 }
 
 TEST(CoreSmokeTests, ShouldStartInSetupCommit)
@@ -374,3 +411,460 @@ TEST(CoreSmokeTests, ShouldRevealAndFreezePieceAfterFirstCaptureIfActualRoleIlle
     });
     EXPECT_FALSE(bFrozenPieceHasMove);
 }
+
+TEST(CoreSmokeTests, ShouldRestoreStateAfterMakeAndUnmakeCaptureMove)
+{
+    FMatchReferee MatchReferee;
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[3], RedPieceOrder[9]); // Put red advisor (piece 3) at cannon slot (1,2)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedUndoNonce"),
+        BuildStandardSetup(ESide::Black));
+
+    const FGameState StateBefore = MatchReferee.GetState();
+    const std::vector<FMoveAction> RedMoves = MatchReferee.GenerateLegalMoves(ESide::Red);
+    const std::optional<FMoveAction> CaptureMove = FindMove(RedMoves, static_cast<FPieceId>(3), FBoardPos{1, 9});
+    ASSERT_TRUE(CaptureMove.has_value());
+
+    FMoveUndo Undo{};
+    MatchReferee.MakeMove(CaptureMove.value(), Undo);
+
+    const FPieceState* MovedPiece = FindPieceOrNull(MatchReferee.GetState(), static_cast<FPieceId>(3));
+    ASSERT_NE(MovedPiece, nullptr);
+    EXPECT_EQ(MovedPiece->PieceState, EPieceState::RevealedActual);
+    EXPECT_TRUE(MovedPiece->bFrozen);
+    EXPECT_EQ(MatchReferee.GetState().CurrentTurn, ESide::Black);
+    EXPECT_EQ(MatchReferee.GetState().TurnIndex, StateBefore.TurnIndex + 1);
+    ASSERT_TRUE(Undo.Move.CapturedPieceId.has_value());
+    EXPECT_EQ(Undo.Move.CapturedPieceId.value(), CaptureMove->CapturedPieceId.value());
+
+    MatchReferee.UnmakeMove(Undo);
+    EXPECT_TRUE(MatchReferee.GetState() == StateBefore);
+    EXPECT_EQ(MatchReferee.GenerateLegalMoves(ESide::Red).size(), RedMoves.size());
+}
+
+TEST(CoreSmokeTests, ShouldOnlyGenerateEvasionsWhenKingIsCheckedThroughCannonScreen)
+{
+    FMatchReferee MatchReferee;
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[1], RedPieceOrder[4]); // Put red king (piece 4) at slot (1,0)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedEvasionNonce"),
+        BuildStandardSetup(ESide::Black));
+
+    // Red cannon (piece 9) at (1,2) screens black cannon (1,7) onto the king at (1,0).
+    const std::vector<FMoveAction> RedMoves = MatchReferee.GenerateLegalMoves(ESide::Red);
+    ASSERT_FALSE(RedMoves.empty());
+    EXPECT_TRUE(FindMove(RedMoves, static_cast<FPieceId>(9), FBoardPos{2, 2}).has_value());
+    EXPECT_FALSE(FindMove(RedMoves, static_cast<FPieceId>(9), FBoardPos{1, 1}).has_value());
+    EXPECT_FALSE(FindMove(RedMoves, static_cast<FPieceId>(15), FBoardPos{8, 4}).has_value());
+
+    for (const FMoveAction& Move : RedMoves)
+    {
+        FMoveUndo Undo{};
+        MatchReferee.MakeMove(Move, Undo);
+        const std::vector<FMoveAction> BlackReplies = MatchReferee.GenerateLegalMoves(ESide::Black);
+        const bool bKingCapturable = std::any_of(BlackReplies.begin(), BlackReplies.end(), [](const FMoveAction& Reply) {
+            return Reply.CapturedPieceId.has_value() && Reply.CapturedPieceId.value() == static_cast<FPieceId>(4);
+        });
+        EXPECT_FALSE(bKingCapturable);
+        MatchReferee.UnmakeMove(Undo);
+    }
+}
+
+TEST(CoreSmokeTests, ShouldKeepSideOccupancyInSyncWithBoardCells)
+{
+    FMatchReferee MatchReferee;
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[3], RedPieceOrder[9]); // Put red advisor (piece 3) at cannon slot (1,2)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedOccupancyNonce"),
+        BuildStandardSetup(ESide::Black));
+    ExpectOccupancyMatchesBoardCells(MatchReferee.GetState());
+    EXPECT_EQ(MatchReferee.GetState().SideOccupancy[0].Count(), 16);
+    EXPECT_EQ(MatchReferee.GetState().SideOccupancy[1].Count(), 16);
+
+    const std::vector<FMoveAction> RedMoves = MatchReferee.GenerateLegalMoves(ESide::Red);
+    const std::optional<FMoveAction> CaptureMove = FindMove(RedMoves, static_cast<FPieceId>(3), FBoardPos{1, 9});
+    ASSERT_TRUE(CaptureMove.has_value());
+
+    FPlayerCommand MoveCommand{};
+    MoveCommand.CommandType = ECommandType::Move;
+    MoveCommand.Side = ESide::Red;
+    MoveCommand.Move = CaptureMove;
+    ASSERT_TRUE(MatchReferee.ApplyCommand(MoveCommand).bAccepted);
+
+    ExpectOccupancyMatchesBoardCells(MatchReferee.GetState());
+    EXPECT_EQ(MatchReferee.GetState().SideOccupancy[0].Count(), 16);
+    EXPECT_EQ(MatchReferee.GetState().SideOccupancy[1].Count(), 15);
+}
+
+TEST(CoreSmokeTests, ShouldKeepKingCellsAndMovablePiecesInSync)
+{
+    FMatchReferee MatchReferee;
+    EXPECT_EQ(MatchReferee.GetState().MovablePieceMasks[0], 0);
+    EXPECT_EQ(MatchReferee.GetState().KingCells[0], -1);
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[3], RedPieceOrder[9]); // Put red advisor (piece 3) at cannon slot (1,2)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedCacheNonce"),
+        BuildStandardSetup(ESide::Black));
+    ExpectPieceCachesMatchPieces(MatchReferee.GetState());
+    EXPECT_EQ(MatchReferee.GetState().KingCells[1], 9 * 9 + 4);
+
+    const FGameState StateBefore = MatchReferee.GetState();
+    const std::vector<FMoveAction> RedMoves = MatchReferee.GenerateLegalMoves(ESide::Red);
+    const std::optional<FMoveAction> CaptureMove = FindMove(RedMoves, static_cast<FPieceId>(3), FBoardPos{1, 9});
+    ASSERT_TRUE(CaptureMove.has_value());
+
+    // The capturing advisor is frozen and the captured horse is gone, so neither may move.
+    FMoveUndo Undo{};
+    MatchReferee.MakeMove(CaptureMove.value(), Undo);
+    ExpectPieceCachesMatchPieces(MatchReferee.GetState());
+    EXPECT_EQ(MatchReferee.GetState().MovablePieceMasks[0] & (1u << 3), 0u);
+
+    MatchReferee.UnmakeMove(Undo);
+    ExpectPieceCachesMatchPieces(MatchReferee.GetState());
+    EXPECT_TRUE(MatchReferee.GetState() == StateBefore);
+}
+
+TEST(CoreSmokeTests, ShouldMaintainIncrementalPositionHash)
+{
+    FMatchReferee MatchReferee;
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[3], RedPieceOrder[9]); // Put red advisor (piece 3) at cannon slot (1,2)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedHashNonce"),
+        BuildStandardSetup(ESide::Black));
+
+    const uint64_t InitialHash = MatchReferee.GetState().PositionHash;
+    EXPECT_NE(InitialHash, 0u);
+    EXPECT_EQ(InitialHash, FMatchReferee::ComputePositionHash(MatchReferee.GetState()));
+
+    const std::vector<FMoveAction> RedMoves = MatchReferee.GenerateLegalMoves(ESide::Red);
+    const std::optional<FMoveAction> CaptureMove = FindMove(RedMoves, static_cast<FPieceId>(3), FBoardPos{1, 9});
+    ASSERT_TRUE(CaptureMove.has_value());
+
+    FMoveUndo Undo{};
+    MatchReferee.MakeMove(CaptureMove.value(), Undo);
+    const uint64_t HashAfterCapture = MatchReferee.GetState().PositionHash;
+    EXPECT_NE(HashAfterCapture, InitialHash);
+    EXPECT_EQ(HashAfterCapture, FMatchReferee::ComputePositionHash(MatchReferee.GetState()));
+
+    MatchReferee.UnmakeMove(Undo);
+    EXPECT_EQ(MatchReferee.GetState().PositionHash, InitialHash);
+
+    FPlayerCommand MoveCommand{};
+    MoveCommand.CommandType = ECommandType::Move;
+    MoveCommand.Side = ESide::Red;
+    MoveCommand.Move = CaptureMove;
+    ASSERT_TRUE(MatchReferee.ApplyCommand(MoveCommand).bAccepted);
+    EXPECT_EQ(MatchReferee.GetState().PositionHash, HashAfterCapture);
+
+    // Same squares with the other side to move must hash differently.
+    FGameState FlippedTurn = MatchReferee.GetState();
+    FlippedTurn.CurrentTurn = ESide::Red;
+    EXPECT_NE(FMatchReferee::ComputePositionHash(FlippedTurn), HashAfterCapture);
+}
+
+TEST(CoreSmokeTests, ShouldFillCallerMoveListInVectorOrder)
+{
+    FMatchReferee MatchReferee;
+    StartStandardBattle(MatchReferee);
+
+    const std::vector<FMoveAction> RedMoves = MatchReferee.GenerateLegalMoves(ESide::Red);
+    FMoveList RedMoveList;
+    RedMoveList.PushBack(FMoveAction{}); // Stale entries must be cleared by the generator.
+    MatchReferee.GenerateLegalMoves(ESide::Red, RedMoveList);
+
+    ASSERT_EQ(RedMoveList.Size(), RedMoves.size());
+    for (size_t Index = 0; Index < RedMoves.size(); ++Index)
+    {
+        EXPECT_EQ(RedMoveList[Index].PieceId, RedMoves[Index].PieceId);
+        EXPECT_EQ(RedMoveList[Index].From, RedMoves[Index].From);
+        EXPECT_EQ(RedMoveList[Index].To, RedMoves[Index].To);
+        EXPECT_EQ(RedMoveList[Index].CapturedPieceId, RedMoves[Index].CapturedPieceId);
+    }
+}
+
+TEST(CoreSmokeTests, ShouldMirrorBoardGeometryBetweenSides)
+{
+    int32_t SetupSlotCount = 0;
+    for (int32_t Cell = 0; Cell < 90; ++Cell)
+    {
+        const int32_t MirroredCell = (9 - Cell / 9) * 9 + Cell % 9;
+        EXPECT_EQ(BoardGeometry.Palace[0][Cell], BoardGeometry.Palace[1][MirroredCell]);
+        EXPECT_EQ(BoardGeometry.AdvisorPoint[0][Cell], BoardGeometry.AdvisorPoint[1][MirroredCell]);
+        EXPECT_EQ(BoardGeometry.ElephantPoint[0][Cell], BoardGeometry.ElephantPoint[1][MirroredCell]);
+        EXPECT_EQ(BoardGeometry.CrossedRiver[0][Cell], BoardGeometry.CrossedRiver[1][MirroredCell]);
+        EXPECT_EQ(BoardGeometry.SurfaceRole[0][Cell], BoardGeometry.SurfaceRole[1][MirroredCell]);
+        EXPECT_EQ(BoardGeometry.ElephantSteps[0][Cell].Count, BoardGeometry.ElephantSteps[1][MirroredCell].Count);
+        SetupSlotCount += BoardGeometry.SetupSlot[0][Cell] ? 1 : 0;
+    }
+    EXPECT_EQ(SetupSlotCount, 16);
+
+    // Corner horse has two targets; the palace centre king reaches all four neighbours.
+    EXPECT_EQ(BoardGeometry.HorseSteps[0].Count, 2);
+    EXPECT_EQ(BoardGeometry.KingSteps[0][1 * 9 + 4].Count, 4);
+    EXPECT_EQ(BoardGeometry.SurfaceRole[1][9 * 9 + 4], ERoleType::King);
+}
+
+TEST(CoreSmokeTests, ShouldValidateSingleMoveLikeLegalMoveGeneration)
+{
+    FMatchReferee MatchReferee;
+    StartStandardBattle(MatchReferee);
+
+    // Cannon jumps need exactly one screen; the captured id is filled in from the board.
+    const std::optional<FMoveAction> Capture = MatchReferee.ValidateMove(FMoveAction{10, {7, 2}, {7, 9}, std::nullopt});
+    ASSERT_TRUE(Capture.has_value());
+    ASSERT_TRUE(Capture->CapturedPieceId.has_value());
+    EXPECT_EQ(Capture->CapturedPieceId.value(), static_cast<FPieceId>(23));
+    EXPECT_FALSE(MatchReferee.ValidateMove(FMoveAction{10, {7, 2}, {7, 8}, std::nullopt}).has_value());
+    EXPECT_FALSE(MatchReferee.ValidateMove(FMoveAction{1, {1, 0}, {3, 1}, std::nullopt}).has_value());
+
+    for (const FMoveAction& Move : MatchReferee.GenerateLegalMoves(ESide::Red))
+    {
+        const std::optional<FMoveAction> Validated = MatchReferee.ValidateMove(FMoveAction{Move.PieceId, Move.From, Move.To, std::nullopt});
+        ASSERT_TRUE(Validated.has_value());
+        EXPECT_EQ(Validated->CapturedPieceId, Move.CapturedPieceId);
+    }
+}
+
+TEST(CoreSmokeTests, ShouldRejectValidatedMoveThatLeavesKingInCheck)
+{
+    FMatchReferee MatchReferee;
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[1], RedPieceOrder[4]); // Put red king (piece 4) at slot (1,0)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedValidateNonce"),
+        BuildStandardSetup(ESide::Black));
+
+    // Black cannon (1,7) checks through red cannon (1,2): moving the screen off the file evades, sliding it
+    // along the file or capturing elsewhere does not.
+    EXPECT_TRUE(MatchReferee.ValidateMove(FMoveAction{9, {1, 2}, {2, 2}, std::nullopt}).has_value());
+    EXPECT_FALSE(MatchReferee.ValidateMove(FMoveAction{9, {1, 2}, {1, 1}, std::nullopt}).has_value());
+    EXPECT_FALSE(MatchReferee.ValidateMove(FMoveAction{10, {7, 2}, {7, 9}, std::nullopt}).has_value());
+}
+
+TEST(CoreSmokeTests, ShouldFindAnyLegalMoveOnlyDuringBattle)
+{
+    FMatchReferee MatchReferee;
+    EXPECT_FALSE(MatchReferee.HasAnyLegalMove(ESide::Red));
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[1], RedPieceOrder[4]); // Put red king (piece 4) at slot (1,0)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedAnyMoveNonce"),
+        BuildStandardSetup(ESide::Black));
+
+    // Red is in check through the cannon screen but still has evasions; Black is not in check.
+    EXPECT_TRUE(MatchReferee.HasAnyLegalMove(ESide::Red));
+    EXPECT_TRUE(MatchReferee.HasAnyLegalMove(ESide::Black));
+    EXPECT_FALSE(MatchReferee.CanPass(ESide::Red));
+}
+
+TEST(CoreSmokeTests, ShouldRoundTripPackedGameState)
+{
+    FMatchReferee MatchReferee;
+    EXPECT_TRUE(FGameStatePacker::Unpack(MatchReferee.ExportPackedState()) == MatchReferee.GetState());
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[3], RedPieceOrder[9]); // Put red advisor (piece 3) at cannon slot (1,2)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedPackNonce"),
+        BuildStandardSetup(ESide::Black));
+    const FPackedGameState OpeningSnapshot = MatchReferee.ExportPackedState();
+
+    // Capture with reveal and freeze so every packed flag is exercised.
+    const std::optional<FMoveAction> CaptureMove = FindMove(MatchReferee.GenerateLegalMoves(ESide::Red), static_cast<FPieceId>(3), FBoardPos{1, 9});
+    ASSERT_TRUE(CaptureMove.has_value());
+    FPlayerCommand MoveCommand{};
+    MoveCommand.CommandType = ECommandType::Move;
+    MoveCommand.Side = ESide::Red;
+    MoveCommand.Move = CaptureMove;
+    ASSERT_TRUE(MatchReferee.ApplyCommand(MoveCommand).bAccepted);
+
+    const FGameState StateAfterCapture = MatchReferee.GetState();
+    FPackedGameState CaptureSnapshot{};
+    const FPackedGameState Exported = MatchReferee.ExportPackedState();
+    std::memcpy(&CaptureSnapshot, &Exported, sizeof(FPackedGameState));
+    EXPECT_TRUE(FGameStatePacker::Unpack(CaptureSnapshot) == StateAfterCapture);
+
+    MatchReferee.ImportPackedState(OpeningSnapshot);
+    EXPECT_EQ(MatchReferee.GetState().TurnIndex, 0u);
+    EXPECT_EQ(MatchReferee.GetState().PositionHash, FMatchReferee::ComputePositionHash(MatchReferee.GetState()));
+    EXPECT_TRUE(FindMove(MatchReferee.GenerateLegalMoves(ESide::Red), static_cast<FPieceId>(3), FBoardPos{1, 9}).has_value());
+
+    MatchReferee.ImportPackedState(CaptureSnapshot);
+    EXPECT_TRUE(MatchReferee.GetState() == StateAfterCapture);
+}
+
+TEST(CoreSmokeTests, ShouldRestoreRefereeFromBinarySnapshot)
+{
+    FRuleConfig RuleConfig{};
+    RuleConfig.bDoublePassIsDraw = false;
+    FMatchReferee MatchReferee(RuleConfig);
+
+    const FSetupPlain RedSetup = BuildStandardSetup(ESide::Red);
+    ASSERT_TRUE(MatchReferee.ApplyCommit({ESide::Red, FSetupCommitment::BuildCommitHash(RedSetup)}).bAccepted);
+    std::vector<uint8_t> SetupSnapshot;
+    MatchReferee.Serialize(SetupSnapshot);
+
+    // The restored referee keeps the commit secret and the rule config it was saved with.
+    FMatchReferee Restored;
+    std::string Error;
+    ASSERT_TRUE(Restored.Deserialize(SetupSnapshot, Error)) << Error;
+    EXPECT_FALSE(Restored.GetRuleConfig().bDoublePassIsDraw);
+    EXPECT_TRUE(Restored.GetState() == MatchReferee.GetState());
+    ASSERT_TRUE(Restored.ApplyCommit({ESide::Black, ""}).bAccepted);
+    EXPECT_FALSE(Restored.ApplyReveal(BuildSetupFromPieceOrder(ESide::Red, BuildDefaultPieceOrder(ESide::Red), "Other")).bAccepted);
+    ASSERT_TRUE(Restored.ApplyReveal(RedSetup).bAccepted);
+    ASSERT_TRUE(Restored.ApplyReveal(BuildStandardSetup(ESide::Black)).bAccepted);
+
+    const std::vector<FMoveAction> Moves = Restored.GenerateLegalMoves(ESide::Red);
+    ASSERT_FALSE(Moves.empty());
+    FPlayerCommand MoveCommand{};
+    MoveCommand.CommandType = ECommandType::Move;
+    MoveCommand.Side = ESide::Red;
+    MoveCommand.Move = Moves.front();
+    ASSERT_TRUE(Restored.ApplyCommand(MoveCommand).bAccepted);
+
+    std::vector<uint8_t> BattleSnapshot;
+    Restored.Serialize(BattleSnapshot);
+    ASSERT_TRUE(MatchReferee.Deserialize(BattleSnapshot, Error)) << Error;
+    EXPECT_TRUE(MatchReferee.GetState() == Restored.GetState());
+    EXPECT_EQ(MatchReferee.GenerateLegalMoves(ESide::Black).size(), Restored.GenerateLegalMoves(ESide::Black).size());
+
+    std::vector<uint8_t> Reserialized;
+    MatchReferee.Serialize(Reserialized);
+    EXPECT_EQ(Reserialized, BattleSnapshot);
+}
+
+TEST(CoreSmokeTests, ShouldRejectDamagedBinarySnapshotWithoutChangingState)
+{
+    FMatchReferee MatchReferee;
+    StartStandardBattle(MatchReferee);
+    std::vector<uint8_t> Snapshot;
+    MatchReferee.Serialize(Snapshot);
+
+    FMatchReferee Target;
+    const FGameState InitialState = Target.GetState();
+    std::string Error;
+
+    std::vector<uint8_t> Damaged = Snapshot;
+    Damaged[40] ^= 0x01;
+    EXPECT_FALSE(Target.Deserialize(Damaged, Error));
+    EXPECT_NE(Error.find("checksum"), std::string::npos);
+
+    Damaged = Snapshot;
+    Damaged[4] = 9;
+    EXPECT_FALSE(Target.Deserialize(Damaged, Error));
+    EXPECT_NE(Error.find("version"), std::string::npos);
+
+    Damaged.assign(Snapshot.begin(), Snapshot.begin() + 100);
+    EXPECT_FALSE(Target.Deserialize(Damaged, Error));
+    Damaged.clear();
+    EXPECT_FALSE(Target.Deserialize(Damaged, Error));
+
+    EXPECT_TRUE(Target.GetState() == InitialState);
+    ASSERT_TRUE(Target.Deserialize(Snapshot, Error)) << Error;
+    EXPECT_TRUE(Target.GetState() == MatchReferee.GetState());
+}
+
+TEST(CoreSmokeTests, ShouldReportTypedGameEventsForAppliedCommand)
+{
+    FMatchReferee MatchReferee;
+
+    std::array<FPieceId, 16> RedPieceOrder = BuildDefaultPieceOrder(ESide::Red);
+    std::swap(RedPieceOrder[3], RedPieceOrder[9]); // Put red advisor (piece 3) at cannon slot (1,2)
+
+    StartBattle(
+        MatchReferee,
+        BuildSetupFromPieceOrder(ESide::Red, RedPieceOrder, "RedEventNonce"),
+        BuildStandardSetup(ESide::Black));
+
+    FPlayerCommand MoveCommand{};
+    MoveCommand.CommandType = ECommandType::Move;
+    MoveCommand.Side = ESide::Red;
+    MoveCommand.Move = FMoveAction{static_cast<FPieceId>(3), FBoardPos{1, 2}, FBoardPos{1, 9}, std::nullopt};
+
+    FGameEventList Events;
+    ASSERT_TRUE(MatchReferee.ApplyCommand(MoveCommand, Events).bAccepted);
+    ASSERT_EQ(Events.Size(), static_cast<size_t>(4));
+    EXPECT_EQ(Events[0].EventType, EGameEventType::PieceMoved);
+    EXPECT_EQ(Events[0].PieceId, static_cast<FPieceId>(3));
+    EXPECT_EQ(Events[0].From, (FBoardPos{1, 2}));
+    EXPECT_EQ(Events[0].To, (FBoardPos{1, 9}));
+    EXPECT_EQ(Events[1].EventType, EGameEventType::PieceCaptured);
+    EXPECT_EQ(Events[1].Side, ESide::Black);
+    EXPECT_EQ(Events[1].PieceId, static_cast<FPieceId>(17));
+    EXPECT_EQ(Events[2].EventType, EGameEventType::PieceRevealed);
+    EXPECT_EQ(Events[2].Role, ERoleType::Advisor);
+    EXPECT_EQ(Events[3].EventType, EGameEventType::PieceFrozen);
+    EXPECT_EQ(Events[3].Role, ERoleType::Advisor);
+    EXPECT_EQ(Events[3].To, (FBoardPos{1, 9}));
+
+    // Rejected commands clear the list.
+    EXPECT_FALSE(MatchReferee.ApplyCommand(MoveCommand, Events).bAccepted);
+    EXPECT_TRUE(Events.IsEmpty());
+
+    FPlayerCommand ResignCommand{};
+    ResignCommand.CommandType = ECommandType::Resign;
+    ResignCommand.Side = ESide::Black;
+    ASSERT_TRUE(MatchReferee.ApplyCommand(ResignCommand, Events).bAccepted);
+    ASSERT_EQ(Events.Size(), static_cast<size_t>(1));
+    EXPECT_EQ(Events[0].EventType, EGameEventType::GameEnded);
+    EXPECT_EQ(Events[0].Result, EGameResult::RedWin);
+    EXPECT_EQ(Events[0].EndReason, EEndReason::Resign);
+}
+
+TEST(CoreSmokeTests, ShouldReportHiddenCapturedRoleOnlyWhenRuleRevealsIt)
+{
+    std::array<FPieceId, 16> BlackPieceOrder = BuildDefaultPieceOrder(ESide::Black);
+    std::swap(BlackPieceOrder[1], BlackPieceOrder[3]); // Hide black advisor (piece 19) on the horse slot (1,9)
+
+    for (const bool bRevealCapturedRole : {true, false})
+    {
+        FRuleConfig RuleConfig{};
+        RuleConfig.bRevealCapturedRole = bRevealCapturedRole;
+        FMatchReferee MatchReferee(RuleConfig);
+        StartBattle(
+            MatchReferee,
+            BuildStandardSetup(ESide::Red),
+            BuildSetupFromPieceOrder(ESide::Black, BlackPieceOrder, "BlackEventNonce"));
+
+        FPlayerCommand MoveCommand{};
+        MoveCommand.CommandType = ECommandType::Move;
+        MoveCommand.Side = ESide::Red;
+        MoveCommand.Move = FMoveAction{static_cast<FPieceId>(9), FBoardPos{1, 2}, FBoardPos{1, 9}, std::nullopt};
+
+        FGameEventList Events;
+        ASSERT_TRUE(MatchReferee.ApplyCommand(MoveCommand, Events).bAccepted);
+        ASSERT_GE(Events.Size(), static_cast<size_t>(2));
+        EXPECT_EQ(Events[1].EventType, EGameEventType::PieceCaptured);
+        EXPECT_EQ(Events[1].PieceId, static_cast<FPieceId>(19));
+        EXPECT_EQ(Events[1].Role, bRevealCapturedRole ? ERoleType::Advisor : ERoleType::Horse);
+    }
+}
@@ -0,0 +1,158 @@
+#include "Differential/Differential.h"
+#include "Differential/ReferenceReferee.h"
+
+#include "CoreRules/MatchReferee.h"
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+bool IsAlive(const FPackedPiece& Piece)
+{
+    return (Piece.Flags & FPackedPiece::AliveFlag) != 0;
+}
+
+FDifferentialCase BuildPlayedCase(uint64_t Seed, int32_t PlyCount)
+{
+    FDifferentialCase Case{};
+    uint64_t RngState = Seed;
+    Case.Start = Differential::BuildAdversarialStart(RngState, FRuleConfig{});
+
+    FReferenceReferee Referee;
+    Referee.LoadState(FGameStatePacker::Unpack(Case.Start));
+    for (int32_t Ply = 0; Ply < PlyCount && Referee.GetState().Phase == EGamePhase::Battle; ++Ply)
+    {
+        const ESide Turn = Referee.GetState().CurrentTurn;
+        const std::vector<FMoveAction> Moves = Referee.GenerateLegalMoves(Turn);
+        FPlayerCommand Command{};
+        Command.Side = Turn;
+        Command.CommandType = Moves.empty() ? ECommandType::Resign : ECommandType::Move;
+        if (!Moves.empty())
+        {
+            FMoveAction Move = Moves[static_cast<size_t>(Ply) % Moves.size()];
+            Move.CapturedPieceId.reset();
+            Command.Move = Move;
+        }
+        Referee.ApplyCommand(Command);
+        Case.Commands.push_back(Command);
+    }
+    return Case;
+}
+} // namespace
+
+TEST(DifferentialTests, ShouldAgreeWithReferenceOnRandomAndAdversarialGames)
+{
+    FDifferentialConfig Config{};
+    Config.GameCount = 24;
+    Config.ThreadCount = 2;
+    Config.Seed = 7;
+    Config.MaxPlies = 60;
+
+    const FDifferentialStats Stats = Differential::Run(Config);
+    EXPECT_EQ(Stats.Games, Config.GameCount);
+    EXPECT_GT(Stats.AdversarialGames, 0u);
+    EXPECT_LT(Stats.AdversarialGames, Config.GameCount);
+    EXPECT_GT(Stats.Probes, 0u);
+    EXPECT_EQ(Stats.DivergentGames, 0u);
+    for (const FDifferentialDivergence& Divergence : Stats.Divergences)
+    {
+        ADD_FAILURE() << "game " << Divergence.GameIndex << ": " << Divergence.Mismatch.Description << "\n"
+                      << Differential::FormatCase(Divergence.Case);
+    }
+}
+
+TEST(DifferentialTests, ShouldScrambleIntoFrozenPiecesAndHiddenKings)
+{
+    bool bSawFrozen = false;
+    bool bSawHiddenKingOutsidePalace = false;
+    uint64_t RngState = 11;
+    for (int32_t Index = 0; Index < 64; ++Index)
+    {
+        const FGameState State = FGameStatePacker::Unpack(Differential::BuildAdversarialStart(RngState, FRuleConfig{}));
+        EXPECT_EQ(State.PositionHash, FMatchReferee::ComputePositionHash(State));
+
+        FReferenceReferee Referee;
+        Referee.LoadState(State);
+        EXPECT_FALSE(Referee.IsSideInCheck(State.CurrentTurn == ESide::Red ? ESide::Black : ESide::Red));
+        for (const FPieceState& Piece : State.Pieces)
+        {
+            bSawFrozen = bSawFrozen || (Piece.bAlive && Piece.bFrozen);
+            bSawHiddenKingOutsidePalace = bSawHiddenKingOutsidePalace ||
+                                          (Piece.bAlive && Piece.ActualRole == ERoleType::King &&
+                                           Piece.PieceState == EPieceState::HiddenSurface && (Piece.Pos.X < 3 || Piece.Pos.X > 5));
+        }
+    }
+    EXPECT_TRUE(bSawFrozen);
+    EXPECT_TRUE(bSawHiddenKingOutsidePalace);
+}
+
+TEST(DifferentialTests, ShouldRoundTripCaseText)
+{
+    FDifferentialCase Case = BuildPlayedCase(5, 12);
+    FPlayerCommand MissingMove{};
+    MissingMove.Side = ESide::Black;
+    Case.Commands.push_back(MissingMove);
+    FPlayerCommand Pass{};
+    Pass.Side = ESide::Red;
+    Pass.CommandType = ECommandType::Pass;
+    Case.Commands.push_back(Pass);
+
+    const std::string Line = Differential::FormatCase(Case);
+    FDifferentialCase Parsed{};
+    std::string Error;
+    ASSERT_TRUE(Differential::ParseCase(Line, Parsed, Error)) << Error;
+    EXPECT_EQ(Differential::FormatCase(Parsed), Line);
+
+    const FGameState Expected = FGameStatePacker::Unpack(Case.Start);
+    const FGameState Actual = FGameStatePacker::Unpack(Parsed.Start);
+    EXPECT_EQ(Actual.Pieces, Expected.Pieces);
+    EXPECT_EQ(Actual.BoardCells, Expected.BoardCells);
+    EXPECT_EQ(Actual.CurrentTurn, Expected.CurrentTurn);
+
+    FDifferentialMismatch Mismatch{};
+    EXPECT_TRUE(Differential::ReplayCase(Parsed, FRuleConfig{}, Mismatch)) << Mismatch.Description;
+
+    EXPECT_FALSE(Differential::ParseCase("turn=R pass=0 turn-index=0 pieces=00 commands=", Parsed, Error));
+    EXPECT_FALSE(Differential::ParseCase(Line + ",R99:0000", Parsed, Error));
+}
+
+TEST(DifferentialTests, ShouldMinimizeFailingCaseToEssentialCommandAndPiece)
+{
+    const FDifferentialCase Case = BuildPlayedCase(9, 20);
+    ASSERT_GE(Case.Commands.size(), 10u);
+    const FPlayerCommand Culprit = Case.Commands[6];
+    const FPieceId Witness = [&Case] {
+        for (size_t Index = 0; Index < Case.Start.PieceCount; ++Index)
+        {
+            const FPackedPiece& Piece = Case.Start.Pieces[Index];
+            if (IsAlive(Piece) && static_cast<ERoleType>(Piece.Roles & 0x0F) != ERoleType::King)
+            {
+                return static_cast<FPieceId>(Index);
+            }
+        }
+        return FPieceId{0};
+    }();
+
+    // Stand-in for an engine bug that needs one particular command and one particular piece on the board.
+    auto StillFails = [&Culprit, Witness](const FDifferentialCase& Candidate) {
+        const bool bHasCulprit = std::any_of(Candidate.Commands.begin(), Candidate.Commands.end(), [&Culprit](const FPlayerCommand& Command) {
+            return Command.Side == Culprit.Side && Command.Move.has_value() && Command.Move->PieceId == Culprit.Move->PieceId &&
+                   Command.Move->To == Culprit.Move->To;
+        });
+        return bHasCulprit && IsAlive(Candidate.Start.Pieces[Witness]);
+    };
+
+    const FDifferentialCase Minimized = Differential::MinimizeCase(Case, StillFails);
+    ASSERT_EQ(Minimized.Commands.size(), 1u);
+    EXPECT_EQ(Minimized.Commands[0].Move->PieceId, Culprit.Move->PieceId);
+
+    for (size_t Index = 0; Index < Minimized.Start.PieceCount; ++Index)
+    {
+        const FPackedPiece& Piece = Minimized.Start.Pieces[Index];
+        const bool bKing = static_cast<ERoleType>(Piece.Roles & 0x0F) == ERoleType::King;
+        EXPECT_EQ(IsAlive(Piece), bKing || Index == Witness) << "piece " << Index;
+    }
+}
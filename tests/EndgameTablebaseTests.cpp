@@ -0,0 +1,369 @@
+#include "CoreRules/AlphaBetaSearch.h"
+#include "CoreRules/TablebaseGenerator.h"
+#include "Perft/Perft.h"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct FPlacedPiece
+{
+    FPieceId PieceId = 0;
+    FBoardPos Pos{};
+    bool bFrozen = false;
+};
+
+// Keeps only the listed pieces, revealed on the given cells.
+FMatchReferee BuildRevealedEndgame(const std::vector<FPlacedPiece>& PlacedPieces, ESide SideToMove)
+{
+    static const FPackedGameState BattleState = Perft::BuildBattleReferee(*Perft::FindSetup("Standard")).ExportPackedState();
+
+    FPackedGameState Packed = BattleState;
+    Packed.CurrentTurn = SideToMove;
+    Packed.BoardCells.fill(FPackedGameState::EmptyCell);
+    for (FPackedPiece& Piece : Packed.Pieces)
+    {
+        Piece.Cell = FPackedPiece::OffBoardCell;
+        Piece.Flags &= static_cast<uint8_t>(~(FPackedPiece::AliveFlag | FPackedPiece::FrozenFlag));
+    }
+    for (const FPlacedPiece& Placed : PlacedPieces)
+    {
+        const uint8_t Cell = static_cast<uint8_t>(Placed.Pos.Y * 9 + Placed.Pos.X);
+        FPackedPiece& Piece = Packed.Pieces[Placed.PieceId];
+        Piece.Cell = Cell;
+        Piece.Flags |= FPackedPiece::AliveFlag | FPackedPiece::RevealedFlag | (Placed.bFrozen ? FPackedPiece::FrozenFlag : 0);
+        Packed.BoardCells[Cell] = static_cast<uint8_t>(Placed.PieceId);
+    }
+    Packed.PositionHash = FMatchReferee::ComputePositionHash(FGameStatePacker::Unpack(Packed));
+
+    FMatchReferee Referee;
+    Referee.ImportPackedState(Packed);
+    return Referee;
+}
+
+FBoardPos ToPos(uint8_t Cell)
+{
+    return FBoardPos{static_cast<int8_t>(Cell % 9), static_cast<int8_t>(Cell / 9)};
+}
+
+FTablebaseMaterial ParseMaterial(std::string_view Name)
+{
+    std::string Error;
+    const std::optional<FTablebaseMaterial> Material = FTablebaseMaterial::Parse(Name, &Error);
+    EXPECT_TRUE(Material.has_value()) << Error;
+    return Material.value();
+}
+
+FTablebaseProbeResult MakeResult(ETablebaseOutcome Outcome, int32_t Distance)
+{
+    FTablebaseProbeResult Result{};
+    Result.Outcome = Outcome;
+    Result.Distance = Distance;
+    return Result;
+}
+
+// The value the side to move should get from its successors' probes: win through the fastest lost reply, lose at the
+// slowest won reply when every reply wins, and pass on when stuck.
+FTablebaseProbeResult ComputeFromSuccessors(const FEndgameTablebase& Tablebase, FMatchReferee& Referee)
+{
+    const ESide Side = Referee.GetState().CurrentTurn;
+    const std::vector<FMoveAction> Moves = Referee.GenerateLegalMoves(Side);
+    if (Moves.empty())
+    {
+        if (Referee.IsSideInCheck(Side))
+        {
+            return MakeResult(ETablebaseOutcome::Loss, 0);
+        }
+        if (!Referee.HasAnyLegalMove(Side == ESide::Red ? ESide::Black : ESide::Red))
+        {
+            return {};
+        }
+
+        FMoveUndo Undo{};
+        FTablebaseProbeResult Reply{};
+        Referee.MakePass(Undo);
+        EXPECT_TRUE(Tablebase.Probe(Referee, Reply));
+        Referee.UnmakePass(Undo);
+        switch (Reply.Outcome)
+        {
+        case ETablebaseOutcome::Win:
+            return MakeResult(ETablebaseOutcome::Loss, Reply.Distance + 1);
+        case ETablebaseOutcome::Loss:
+            return MakeResult(ETablebaseOutcome::Win, Reply.Distance + 1);
+        default:
+            return {};
+        }
+    }
+
+    int32_t FastestLoss = std::numeric_limits<int32_t>::max();
+    int32_t SlowestWin = 0;
+    bool bEveryReplyWins = true;
+    for (const FMoveAction& Move : Moves)
+    {
+        FMoveUndo Undo{};
+        FTablebaseProbeResult Reply{};
+        Referee.MakeMove(Move, Undo);
+        EXPECT_TRUE(Tablebase.Probe(Referee, Reply));
+        Referee.UnmakeMove(Undo);
+
+        bEveryReplyWins = bEveryReplyWins && Reply.Outcome == ETablebaseOutcome::Win;
+        if (Reply.Outcome == ETablebaseOutcome::Loss)
+        {
+            FastestLoss = std::min(FastestLoss, Reply.Distance);
+        }
+        else if (Reply.Outcome == ETablebaseOutcome::Win)
+        {
+            SlowestWin = std::max(SlowestWin, Reply.Distance);
+        }
+    }
+
+    if (FastestLoss != std::numeric_limits<int32_t>::max())
+    {
+        return MakeResult(ETablebaseOutcome::Win, FastestLoss + 1);
+    }
+    return bEveryReplyWins ? MakeResult(ETablebaseOutcome::Loss, SlowestWin + 1) : FTablebaseProbeResult{};
+}
+
+// Checks every Stride-th valid entry of the material against ComputeFromSuccessors; returns how many were checked.
+size_t ExpectEntriesMatchSuccessors(const FEndgameTablebase& Tablebase, const FTablebaseMaterial& Material, uint64_t Stride)
+{
+    static const std::array<std::vector<FPieceId>, 7> RolePieceIds = {{{4}, {3, 5}, {2, 6}, {1, 7}, {0, 8}, {9, 10}, {11, 12, 13, 14, 15}}};
+
+    const FEndgameTable* Table = Tablebase.FindTable(Material);
+    EXPECT_NE(Table, nullptr);
+    if (Table == nullptr)
+    {
+        return 0;
+    }
+
+    std::vector<FPlacedPiece> PlacedPieces(Material.GetPieceCount());
+    std::array<std::array<size_t, 7>, 2> UsedIds{};
+    for (size_t Slot = 0; Slot < PlacedPieces.size(); ++Slot)
+    {
+        const FTablebasePiece& Piece = Material.GetPiece(Slot);
+        const size_t SideIndex = Piece.Side == ESide::Red ? 0 : 1;
+        const size_t RoleIndex = static_cast<size_t>(Piece.Role);
+        PlacedPieces[Slot].PieceId = static_cast<FPieceId>(RolePieceIds[RoleIndex][UsedIds[SideIndex][RoleIndex]++] + SideIndex * 16);
+        PlacedPieces[Slot].bFrozen = Piece.bFrozen;
+    }
+
+    size_t CheckedCount = 0;
+    for (uint64_t Index = 0; Index < Table->GetEntryCount(); Index += Stride)
+    {
+        FTablebaseProbeResult Stored{};
+        if (!FEndgameTable::DecodeEntry(Table->GetEntry(Index), Stored))
+        {
+            continue;
+        }
+
+        FTablebaseMaterial::FCells Cells{};
+        ESide SideToMove = ESide::Red;
+        Material.DecodeIndex(Index, Cells, SideToMove);
+        for (size_t Slot = 0; Slot < PlacedPieces.size(); ++Slot)
+        {
+            PlacedPieces[Slot].Pos = ToPos(Cells[Slot]);
+        }
+        FMatchReferee Referee = BuildRevealedEndgame(PlacedPieces, SideToMove);
+        const FTablebaseProbeResult Expected = ComputeFromSuccessors(Tablebase, Referee);
+        EXPECT_EQ(Stored.Outcome, Expected.Outcome) << Material.GetName() << " index " << Index;
+        EXPECT_EQ(Stored.Distance, Expected.Distance) << Material.GetName() << " index " << Index;
+        if (Stored.Outcome != Expected.Outcome || Stored.Distance != Expected.Distance)
+        {
+            return CheckedCount;
+        }
+        ++CheckedCount;
+    }
+    return CheckedCount;
+}
+}
+
+TEST(EndgameTablebaseTests, ShouldParseMaterialsAndRoundTripIndices)
+{
+    const FTablebaseMaterial Material = ParseMaterial("RK-AK");
+    EXPECT_EQ(Material.GetName(), "KR-KA");
+    EXPECT_EQ(Material.GetKey(), ParseMaterial("KR-KA").GetKey());
+    EXPECT_NE(Material.GetKey(), ParseMaterial("KA-KR").GetKey());
+    ASSERT_EQ(Material.GetPieceCount(), 4u);
+    EXPECT_EQ(Material.GetSlotCells(0).size(), 9u);
+    EXPECT_EQ(Material.GetSlotCells(1).size(), 90u);
+    EXPECT_EQ(Material.GetSlotCells(3).size(), 5u);
+    EXPECT_EQ(Material.GetEntryCount(), 9u * 90u * 9u * 5u * 2u);
+    EXPECT_EQ(Material.WithoutPiece(1).GetName(), "K-KA");
+    EXPECT_EQ(ParseMaterial("k-K").GetSlotCells(0).size(), 81u);
+
+    for (const char* Invalid : {"KR", "R-K", "KK-K", "Kh-K", "KX-K", "KRRR-K", "KRHCP-KAE"})
+    {
+        std::string Error;
+        EXPECT_FALSE(FTablebaseMaterial::Parse(Invalid, &Error).has_value()) << Invalid;
+        EXPECT_FALSE(Error.empty()) << Invalid;
+    }
+
+    for (uint64_t Index = 0; Index < Material.GetEntryCount(); Index += 97)
+    {
+        FTablebaseMaterial::FCells Cells{};
+        ESide SideToMove = ESide::Red;
+        Material.DecodeIndex(Index, Cells, SideToMove);
+        ASSERT_EQ(Material.ComputeIndex(Cells, SideToMove), Index);
+    }
+
+    FTablebaseMaterial::FCells OutsidePalace{};
+    OutsidePalace[0] = 0;
+    EXPECT_EQ(Material.ComputeIndex(OutsidePalace, ESide::Red), FTablebaseMaterial::InvalidIndex);
+}
+
+TEST(EndgameTablebaseTests, ShouldGenerateRookEndingConsistentWithReferee)
+{
+    FTablebaseGeneratorConfig Config{};
+    Config.ThreadCount = 2;
+    FTablebaseGenerator Generator(Config);
+    FEndgameTablebase Tablebase;
+    std::string Error;
+    const FTablebaseMaterial Material = ParseMaterial("KR-K");
+    ASSERT_TRUE(Generator.Generate(Material, Tablebase, Error)) << Error;
+    ASSERT_EQ(Generator.GetGeneratedStats().size(), 2u);
+    EXPECT_EQ(Generator.GetGeneratedStats()[0].Name, "K-K");
+    EXPECT_EQ(Generator.GetGeneratedStats()[1].Name, "KR-K");
+    EXPECT_GT(Generator.GetGeneratedStats()[1].Wins, 0u);
+
+    // Rook 0 to (3,5) mates: the black king cannot step onto file 4 facing the red king.
+    FMatchReferee MateInOne = BuildRevealedEndgame({{4, FBoardPos{4, 0}}, {0, FBoardPos{0, 5}}, {20, FBoardPos{3, 9}}}, ESide::Red);
+    FTablebaseProbeResult Result{};
+    ASSERT_TRUE(Tablebase.Probe(MateInOne, Result));
+    EXPECT_EQ(Result.Outcome, ETablebaseOutcome::Win);
+    EXPECT_EQ(Result.Distance, 1);
+
+    FMatchReferee Mated = BuildRevealedEndgame({{4, FBoardPos{4, 0}}, {0, FBoardPos{3, 5}}, {20, FBoardPos{3, 9}}}, ESide::Black);
+    ASSERT_TRUE(Tablebase.Probe(Mated, Result));
+    EXPECT_EQ(Result.Outcome, ETablebaseOutcome::Loss);
+    EXPECT_EQ(Result.Distance, 0);
+
+    EXPECT_GT(ExpectEntriesMatchSuccessors(Tablebase, Material, 7), 1000u);
+}
+
+TEST(EndgameTablebaseTests, ShouldNeverStoreLossWhenCaptureWins)
+{
+    // KR-KR positions often hold a rook capture into a won sub-table alongside replies that all lose.
+    FTablebaseGeneratorConfig Config{};
+    Config.ThreadCount = 2;
+    FTablebaseGenerator Generator(Config);
+    FEndgameTablebase Tablebase;
+    std::string Error;
+    const FTablebaseMaterial Material = ParseMaterial("KR-KR");
+    ASSERT_TRUE(Generator.Generate(Material, Tablebase, Error)) << Error;
+
+    EXPECT_GT(ExpectEntriesMatchSuccessors(Tablebase, Material, 1), 100000u);
+}
+
+TEST(EndgameTablebaseTests, ShouldHonourFrozenPiecesAndFacingKings)
+{
+    FTablebaseGenerator Generator;
+    FEndgameTablebase Tablebase;
+    std::string Error;
+    ASSERT_TRUE(Generator.Generate(ParseMaterial("k-KR"), Tablebase, Error)) << Error;
+
+    // A frozen king off the palace still faces the enemy king, so this placement cannot arise.
+    FTablebaseProbeResult Result{};
+    FMatchReferee Facing = BuildRevealedEndgame({{4, FBoardPos{4, 3}, true}, {20, FBoardPos{4, 8}}, {16, FBoardPos{0, 9}}}, ESide::Red);
+    EXPECT_FALSE(Tablebase.Probe(Facing, Result));
+
+    // The frozen king cannot step out of the rook's file: mated on the spot.
+    FMatchReferee Checked = BuildRevealedEndgame({{4, FBoardPos{0, 3}, true}, {20, FBoardPos{4, 8}}, {16, FBoardPos{0, 9}}}, ESide::Red);
+    ASSERT_TRUE(Tablebase.Probe(Checked, Result));
+    EXPECT_EQ(Result.Outcome, ETablebaseOutcome::Loss);
+    EXPECT_EQ(Result.Distance, 0);
+
+    // Red can only pass, so Black mates by bringing the rook onto the frozen king's file.
+    FMatchReferee Stuck = BuildRevealedEndgame({{4, FBoardPos{0, 3}, true}, {20, FBoardPos{4, 8}}, {16, FBoardPos{1, 9}}}, ESide::Red);
+    ASSERT_TRUE(Tablebase.Probe(Stuck, Result));
+    EXPECT_EQ(Result.Outcome, ETablebaseOutcome::Loss);
+    EXPECT_EQ(Result.Distance, 2);
+}
+
+TEST(EndgameTablebaseTests, ShouldSaveAndMapTableFiles)
+{
+    FTablebaseGenerator Generator;
+    FEndgameTablebase Generated;
+    std::string Error;
+    const FTablebaseMaterial Material = ParseMaterial("KR-K");
+    ASSERT_TRUE(Generator.Generate(Material, Generated, Error)) << Error;
+
+    const std::filesystem::path Directory = std::filesystem::temp_directory_path() / "StupidChessTablebaseTests";
+    std::filesystem::remove_all(Directory);
+    std::filesystem::create_directories(Directory);
+    const std::string TablePath = (Directory / "KR-K.sctb").string();
+    ASSERT_TRUE(Generated.FindTable(Material)->SaveFile(TablePath, Error)) << Error;
+    ASSERT_TRUE(Generated.FindTable(ParseMaterial("K-K"))->SaveFile((Directory / "K-K.sctb").string(), Error)) << Error;
+
+    FEndgameTablebase Loaded;
+    EXPECT_EQ(Loaded.LoadDirectory(Directory.string(), Error), 2u) << Error;
+    const FEndgameTable* Table = Loaded.FindTable(Material);
+    ASSERT_NE(Table, nullptr);
+    EXPECT_TRUE(Table->IsMapped());
+    ASSERT_EQ(Table->GetEntryCount(), Material.GetEntryCount());
+    for (uint64_t Index = 0; Index < Table->GetEntryCount(); ++Index)
+    {
+        ASSERT_EQ(Table->GetEntry(Index), Generated.FindTable(Material)->GetEntry(Index));
+    }
+
+    {
+        std::fstream File(TablePath, std::ios::in | std::ios::out | std::ios::binary);
+        File.seekp(100);
+        File.put(static_cast<char>(0x7E));
+    }
+    EXPECT_EQ(FEndgameTable::LoadFile(TablePath, Error), nullptr);
+    EXPECT_NE(Error.find("checksum"), std::string::npos);
+    std::filesystem::remove_all(Directory);
+}
+
+TEST(EndgameTablebaseTests, ShouldScoreSearchLeavesAndAdjudicateFromTablebase)
+{
+    FTablebaseGenerator Generator;
+    FEndgameTablebase Tablebase;
+    std::string Error;
+    const FTablebaseMaterial Material = ParseMaterial("KR-K");
+    ASSERT_TRUE(Generator.Generate(Material, Tablebase, Error)) << Error;
+    const int32_t LongestDistance = Generator.GetGeneratedStats().back().LongestDistance;
+    ASSERT_GE(LongestDistance, 5);
+
+    // The deepest red win, far beyond what a depth-2 search sees on its own.
+    const FEndgameTable* Table = Tablebase.FindTable(Material);
+    uint64_t DeepWinIndex = FTablebaseMaterial::InvalidIndex;
+    for (uint64_t Index = 0; Index < Table->GetEntryCount() && DeepWinIndex == FTablebaseMaterial::InvalidIndex; Index += 2)
+    {
+        FTablebaseProbeResult Stored{};
+        if (FEndgameTable::DecodeEntry(Table->GetEntry(Index), Stored) && Stored.Outcome == ETablebaseOutcome::Win &&
+            Stored.Distance >= LongestDistance - 1)
+        {
+            DeepWinIndex = Index;
+        }
+    }
+    ASSERT_NE(DeepWinIndex, FTablebaseMaterial::InvalidIndex);
+
+    FTablebaseMaterial::FCells Cells{};
+    ESide SideToMove = ESide::Red;
+    Material.DecodeIndex(DeepWinIndex, Cells, SideToMove);
+    FMatchReferee Referee = BuildRevealedEndgame({{4, ToPos(Cells[0])}, {0, ToPos(Cells[1])}, {20, ToPos(Cells[2])}}, SideToMove);
+    FTablebaseProbeResult RootResult{};
+    ASSERT_TRUE(Tablebase.Probe(Referee, RootResult));
+
+    FAlphaBetaSearch Search(1);
+    Search.SetTablebase(&Tablebase);
+    FSearchLimits Limits{};
+    Limits.MaxDepth = 2;
+    Limits.TimeBudgetMs = 0;
+    const FSearchResult SearchResult = Search.Search(Referee, Limits);
+    EXPECT_EQ(SearchResult.Score, FAlphaBetaSearch::MateScore - RootResult.Distance);
+
+    EXPECT_TRUE(Referee.Adjudicate(EGameResult::RedWin, EEndReason::Tablebase).bAccepted);
+    EXPECT_EQ(Referee.GetState().Phase, EGamePhase::GameOver);
+    EXPECT_EQ(Referee.GetState().EndReason, EEndReason::Tablebase);
+    EXPECT_FALSE(Referee.Adjudicate(EGameResult::BlackWin, EEndReason::Tablebase).bAccepted);
+    EXPECT_FALSE(Tablebase.Probe(Referee, RootResult));
+}
@@ -0,0 +1,89 @@
+#include "CoreRules/IsmctsSearch.h"
+#include "Perft/Perft.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Standard opening after Red's left cannon (9) takes the black horse on (1,9) through the black cannon screen,
+// which reveals the red cannon and leaves Black to move.
+FMatchReferee BuildRedCannonCaptureReferee()
+{
+    FMatchReferee Referee = Perft::BuildBattleReferee(*Perft::FindSetup("Standard"));
+
+    FPlayerCommand Command{};
+    Command.CommandType = ECommandType::Move;
+    Command.Side = ESide::Red;
+    Command.Move = FMoveAction{9, FBoardPos{1, 2}, FBoardPos{1, 9}, std::nullopt};
+    EXPECT_TRUE(Referee.ApplyCommand(Command).bAccepted);
+    return Referee;
+}
+}
+
+TEST(IsmctsSearchTests, ShouldOnlyRedealUnrevealedOpponentIds)
+{
+    const FMatchReferee Referee = BuildRedCannonCaptureReferee();
+    const FGameState& TrueState = Referee.GetState();
+    ASSERT_EQ(TrueState.CurrentTurn, ESide::Black);
+
+    FMatchReferee Sample(Referee.GetRuleConfig());
+    uint64_t RngState = 11;
+    int32_t SamplesWithMovedIds = 0;
+    for (int32_t SampleIndex = 0; SampleIndex < 20; ++SampleIndex)
+    {
+        ASSERT_TRUE(FIsmctsSearch::LoadDeterminization(TrueState, ESide::Black, RngState, 32, Sample));
+        const FGameState& SampleState = Sample.GetState();
+        EXPECT_EQ(SampleState.PositionHash, FMatchReferee::ComputePositionHash(SampleState));
+        EXPECT_GE(SampleState.KingCells[0], 0);
+        EXPECT_FALSE(Sample.IsSideInCheck(ESide::Red));
+
+        bool bMovedId = false;
+        for (size_t Cell = 0; Cell < TrueState.BoardCells.size(); ++Cell)
+        {
+            ASSERT_EQ(SampleState.BoardCells[Cell].has_value(), TrueState.BoardCells[Cell].has_value());
+            if (!TrueState.BoardCells[Cell].has_value())
+            {
+                continue;
+            }
+
+            const FPieceState& TruePiece = TrueState.Pieces[TrueState.BoardCells[Cell].value()];
+            const FPieceState& SamplePiece = SampleState.Pieces[SampleState.BoardCells[Cell].value()];
+            EXPECT_EQ(SamplePiece.Side, TruePiece.Side);
+            EXPECT_EQ(SamplePiece.SurfaceRole, TruePiece.SurfaceRole);
+            EXPECT_EQ(SamplePiece.PieceState, TruePiece.PieceState);
+            if (TruePiece.Side == ESide::Black || TruePiece.PieceState == EPieceState::RevealedActual)
+            {
+                EXPECT_EQ(SamplePiece.PieceId, TruePiece.PieceId);
+            }
+            bMovedId = bMovedId || SamplePiece.PieceId != TruePiece.PieceId;
+        }
+        SamplesWithMovedIds += bMovedId ? 1 : 0;
+    }
+    EXPECT_GT(SamplesWithMovedIds, 0);
+}
+
+TEST(IsmctsSearchTests, ShouldRunIterationBudgetAcrossThreadsAndReturnLegalMove)
+{
+    const FMatchReferee Referee = BuildRedCannonCaptureReferee();
+
+    FIsmctsConfig Config{};
+    Config.ThreadCount = 3;
+    Config.MaxIterations = 300;
+    Config.TimeBudgetMs = 0;
+    const FIsmctsResult Result = FIsmctsSearch(Config).Search(Referee, 5);
+
+    EXPECT_EQ(Result.Iterations, 300u);
+    ASSERT_TRUE(Result.bHasCommand);
+    ASSERT_EQ(Result.BestCommand.CommandType, ECommandType::Move);
+    ASSERT_TRUE(Result.BestCommand.Move.has_value());
+    EXPECT_EQ(Result.BestCommand.Side, ESide::Black);
+    EXPECT_TRUE(Referee.ValidateMove(Result.BestCommand.Move.value()).has_value());
+    EXPECT_GT(Result.BestVisits, 0u);
+
+    Config.ThreadCount = 1;
+    const FIsmctsResult FirstSerial = FIsmctsSearch(Config).Search(Referee, 5);
+    const FIsmctsResult SecondSerial = FIsmctsSearch(Config).Search(Referee, 5);
+    EXPECT_EQ(FirstSerial.BestCommand.Move->PieceId, SecondSerial.BestCommand.Move->PieceId);
+    EXPECT_EQ(FirstSerial.BestCommand.Move->To, SecondSerial.BestCommand.Move->To);
+    EXPECT_EQ(FirstSerial.BestVisits, SecondSerial.BestVisits);
+}
@@ -161,3 +161,110 @@ TEST(MatchSessionTests, ShouldRecordEventsAndSupportSequencePull)
     const std::vector<FMatchEventRecord> FinalEvents = Session.PullEvents(3001, 0);
     EXPECT_EQ(FinalEvents.back().EventType, EMatchEventType::CommandRejected);
 }
+
+TEST(MatchSessionTests, ShouldCacheLegalMovesPerSideUntilTurnAdvances)
+{
+    FInMemoryMatchSession Session(10);
+    ASSERT_TRUE(Session.Join({10, 4001}).bAccepted);
+    ASSERT_TRUE(Session.Join({10, 4002}).bAccepted);
+    EXPECT_TRUE(Session.GetLegalMoves(4001).empty());
+
+    SetupBattlePhase(Session, 4001, 4002);
+
+    const std::vector<FMoveAction> RedMoves = Session.GetLegalMoves(4001);
+    ASSERT_FALSE(RedMoves.empty());
+    for (const FMoveAction& Move : RedMoves)
+    {
+        EXPECT_EQ(Session.GetState().Pieces[Move.PieceId].Side, ESide::Red);
+    }
+    EXPECT_EQ(Session.GetLegalMoves(4001).size(), RedMoves.size());
+    EXPECT_EQ(Session.GetLegalMoveGenerationCount(), static_cast<uint64_t>(1));
+
+    EXPECT_FALSE(Session.GetLegalMoves(4002).empty());
+    EXPECT_EQ(Session.GetLegalMoveGenerationCount(), static_cast<uint64_t>(2));
+    EXPECT_TRUE(Session.GetLegalMoves(9999).empty());
+
+    FPlayerCommand RedMove{};
+    RedMove.CommandType = ECommandType::Move;
+    RedMove.Move = RedMoves.front();
+    ASSERT_TRUE(Session.SubmitCommand(4001, RedMove).bAccepted);
+
+    EXPECT_FALSE(Session.GetLegalMoves(4002).empty());
+    Session.GetLegalMoves(4002);
+    EXPECT_EQ(Session.GetLegalMoveGenerationCount(), static_cast<uint64_t>(3));
+}
+
+TEST(MatchSessionTests, ShouldLogRefereeGameEventsForCaptureAndResign)
+{
+    FInMemoryMatchSession Session(10);
+    ASSERT_TRUE(Session.Join({10, 4001}).bAccepted);
+    ASSERT_TRUE(Session.Join({10, 4002}).bAccepted);
+    SetupBattlePhase(Session, 4001, 4002);
+    const uint64_t SequenceBeforeBattle = Session.GetLatestEventSequence();
+
+    // Red cannon (piece 9) jumps the black cannon and takes the horse on (1,9), revealing itself as a cannon.
+    FPlayerCommand CannonCapture{};
+    CannonCapture.CommandType = ECommandType::Move;
+    CannonCapture.Move = FMoveAction{static_cast<FPieceId>(9), FBoardPos{1, 2}, FBoardPos{1, 9}, std::nullopt};
+    ASSERT_TRUE(Session.SubmitCommand(4001, CannonCapture).bAccepted);
+
+    const FGameEventList& MoveEvents = Session.GetLastGameEvents();
+    ASSERT_EQ(MoveEvents.Size(), static_cast<size_t>(3));
+    EXPECT_EQ(MoveEvents[0].EventType, EGameEventType::PieceMoved);
+    EXPECT_EQ(MoveEvents[0].To, (FBoardPos{1, 9}));
+    EXPECT_EQ(MoveEvents[1].EventType, EGameEventType::PieceCaptured);
+    EXPECT_EQ(MoveEvents[1].PieceId, static_cast<FPieceId>(17));
+    EXPECT_EQ(MoveEvents[1].Role, ERoleType::Horse);
+    EXPECT_EQ(MoveEvents[2].EventType, EGameEventType::PieceRevealed);
+    EXPECT_EQ(MoveEvents[2].Role, ERoleType::Cannon);
+
+    FPlayerCommand Resign{};
+    Resign.CommandType = ECommandType::Resign;
+    ASSERT_TRUE(Session.SubmitCommand(4002, Resign).bAccepted);
+    ASSERT_EQ(Session.GetLastGameEvents().Size(), static_cast<size_t>(1));
+    EXPECT_EQ(Session.GetLastGameEvents()[0].Result, EGameResult::RedWin);
+
+    std::vector<EMatchEventType> EventTypes;
+    for (const FMatchEventRecord& Event : Session.PullEvents(4001, SequenceBeforeBattle))
+    {
+        EventTypes.push_back(Event.EventType);
+    }
+    const std::vector<EMatchEventType> ExpectedEventTypes = {
+        EMatchEventType::MoveApplied,
+        EMatchEventType::PieceCaptured,
+        EMatchEventType::PieceRevealed,
+        EMatchEventType::ResignApplied,
+        EMatchEventType::GameOver};
+    EXPECT_EQ(EventTypes, ExpectedEventTypes);
+}
+
+TEST(MatchSessionTests, ShouldSendHiddenKingCheckOnlyToDefender)
+{
+    FInMemoryMatchSession Session(11);
+    ASSERT_TRUE(Session.Join({11, 5001}).bAccepted);
+    ASSERT_TRUE(Session.Join({11, 5002}).bAccepted);
+    const FSetupPlain BlackSetup = BuildBlackSwappedSetupForVisibilityTest();
+    SetupBattlePhase(Session, 5001, 5002, nullptr, &BlackSetup);
+    const uint64_t SequenceBeforeBattle = Session.GetLatestEventSequence();
+
+    // The hidden black king stands on the horse slot (1,9), behind the black cannon screening red cannon 9, so any
+    // quiet red move leaves it in check.
+    FPlayerCommand PawnMove{};
+    PawnMove.CommandType = ECommandType::Move;
+    PawnMove.Move = FMoveAction{static_cast<FPieceId>(11), FBoardPos{0, 3}, FBoardPos{0, 4}, std::nullopt};
+    ASSERT_TRUE(Session.SubmitCommand(5001, PawnMove).bAccepted);
+
+    const FGameEventList& Events = Session.GetLastGameEvents();
+    ASSERT_EQ(Events.Size(), static_cast<size_t>(2));
+    EXPECT_EQ(Events[1].EventType, EGameEventType::CheckGiven);
+    EXPECT_FALSE(Events[1].To.IsValid());
+
+    const auto CountChecks = [&Session, SequenceBeforeBattle](FPlayerId PlayerId) {
+        const std::vector<FMatchEventRecord> Pulled = Session.PullEvents(PlayerId, SequenceBeforeBattle);
+        return std::count_if(Pulled.begin(), Pulled.end(), [](const FMatchEventRecord& Event) {
+            return Event.EventType == EMatchEventType::CheckGiven;
+        });
+    };
+    EXPECT_EQ(CountChecks(5001), 0);
+    EXPECT_EQ(CountChecks(5002), 1);
+}
@@ -0,0 +1,60 @@
+#include "Perft/Perft.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Entries above this size are left to `StupidChessPerft --verify` so the unit suite stays fast in Debug.
+constexpr uint64_t MaxUnitTestLeafNodes = 20000;
+}
+
+TEST(PerftTests, ShouldMatchStandardXiangqiOpeningCounts)
+{
+    const FPerftSetup* Setup = Perft::FindSetup("Standard");
+    ASSERT_NE(Setup, nullptr);
+
+    const FMatchReferee Referee = Perft::BuildBattleReferee(*Setup);
+    EXPECT_EQ(Perft::CountLeafNodes(Referee, 1), 44u);
+    EXPECT_EQ(Perft::CountLeafNodes(Referee, 2), 1920u);
+}
+
+TEST(PerftTests, ShouldMatchGoldenCounts)
+{
+    std::vector<FPerftGoldenEntry> Entries;
+    std::string Error;
+    ASSERT_TRUE(Perft::LoadGoldenFile(STUPIDCHESS_PERFT_GOLDEN_FILE, Entries, Error)) << Error;
+    ASSERT_FALSE(Entries.empty());
+
+    for (const FPerftGoldenEntry& Entry : Entries)
+    {
+        if (Entry.Nodes > MaxUnitTestLeafNodes)
+        {
+            continue;
+        }
+
+        const FPerftSetup* Setup = Perft::FindSetup(Entry.SetupName);
+        ASSERT_NE(Setup, nullptr) << Entry.SetupName;
+        EXPECT_EQ(Perft::CountLeafNodes(Perft::BuildBattleReferee(*Setup), Entry.Depth), Entry.Nodes)
+            << Entry.SetupName << " depth " << Entry.Depth;
+    }
+}
+
+TEST(PerftTests, ShouldSumDivideToLeafCount)
+{
+    const FPerftSetup* Setup = Perft::FindSetup("RedKingOnHorseSlot");
+    ASSERT_NE(Setup, nullptr);
+
+    const FMatchReferee Referee = Perft::BuildBattleReferee(*Setup);
+    const std::vector<FPerftDivideEntry> Entries = Perft::Divide(Referee, 2);
+    ASSERT_FALSE(Entries.empty());
+
+    uint64_t Total = 0;
+    for (const FPerftDivideEntry& Entry : Entries)
+    {
+        Total += Entry.Nodes;
+    }
+    EXPECT_EQ(Total, Perft::CountLeafNodes(Referee, 2));
+}
@@ -99,3 +99,32 @@ TEST(ProtocolCodecTests, ShouldRoundTripGameOverPayload)
     EXPECT_EQ(Decoded.EndReason, Payload.EndReason);
     EXPECT_EQ(Decoded.TurnIndex, Payload.TurnIndex);
 }
+
+TEST(ProtocolCodecTests, ShouldRoundTripLegalMovesQueryAndPayload)
+{
+    std::string QueryJson;
+    ASSERT_TRUE(ProtocolCodec::EncodeQueryLegalMovesPayload(FProtocolQueryLegalMovesPayload{7001}, QueryJson));
+    FProtocolQueryLegalMovesPayload DecodedQuery{};
+    ASSERT_TRUE(ProtocolCodec::DecodeQueryLegalMovesPayload(QueryJson, DecodedQuery));
+    EXPECT_EQ(DecodedQuery.PlayerId, static_cast<uint64_t>(7001));
+
+    FProtocolLegalMovesPayload Payload{};
+    Payload.Side = static_cast<int32_t>(ESide::Black);
+    Payload.TurnIndex = 5;
+    Payload.Moves.push_back(FProtocolMovePayload{27, 0, 6, 0, 5, false, 0});
+    Payload.Moves.push_back(FProtocolMovePayload{25, 1, 7, 1, 0, true, 1});
+
+    std::string Json;
+    ASSERT_TRUE(ProtocolCodec::EncodeLegalMovesPayload(Payload, Json));
+
+    FProtocolLegalMovesPayload Decoded{};
+    ASSERT_TRUE(ProtocolCodec::DecodeLegalMovesPayload(Json, Decoded));
+    EXPECT_EQ(Decoded.Side, Payload.Side);
+    EXPECT_EQ(Decoded.TurnIndex, Payload.TurnIndex);
+    ASSERT_EQ(Decoded.Moves.size(), static_cast<size_t>(2));
+    EXPECT_EQ(Decoded.Moves[0].PieceId, static_cast<uint16_t>(27));
+    EXPECT_FALSE(Decoded.Moves[0].bHasCapturedPieceId);
+    EXPECT_EQ(Decoded.Moves[1].ToY, 0);
+    EXPECT_TRUE(Decoded.Moves[1].bHasCapturedPieceId);
+    EXPECT_EQ(Decoded.Moves[1].CapturedPieceId, static_cast<uint16_t>(1));
+}
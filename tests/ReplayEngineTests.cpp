@@ -0,0 +1,185 @@
+#include "CoreRules/CommandLog.h"
+#include "CoreRules/ReplayEngine.h"
+#include "SelfPlay/SelfPlay.h"
+#include "Server/MatchSession.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+FPlayerCommand BuildCommand(ESide Side, ECommandType CommandType)
+{
+    FPlayerCommand Command{};
+    Command.Side = Side;
+    Command.CommandType = CommandType;
+    return Command;
+}
+
+std::vector<FRecordedMatch> PlaySelfPlayMatches(uint64_t GameCount)
+{
+    FSelfPlayConfig Config{};
+    Config.GameCount = GameCount;
+    Config.ThreadCount = 2;
+    Config.Seed = 13;
+    Config.MaxPlies = 150;
+
+    std::ostringstream Stream;
+    FGameRecordWriter Writer(Stream, EGameRecordFormat::CommandLog);
+    SelfPlay::Run(Config, SelfPlay::FindPolicyFactory("greedy"), SelfPlay::FindPolicyFactory("random"), &Writer);
+
+    std::vector<FRecordedMatch> Matches;
+    std::istringstream Input(Stream.str());
+    for (std::string Line; std::getline(Input, Line);)
+    {
+        FRecordedMatch Match{};
+        std::string Error;
+        EXPECT_TRUE(FCommandLog::ParseMatch(Line, Match, Error)) << Error;
+        Matches.push_back(std::move(Match));
+    }
+    return Matches;
+}
+} // namespace
+
+TEST(ReplayEngineTests, ShouldRoundTripCommandLogText)
+{
+    FRecordedMatch Match{};
+    Match.MatchId = 42;
+    Match.ExpectedDigest = 0x0123456789ABCDEFULL;
+
+    FPlayerCommand Commit = BuildCommand(ESide::Red, ECommandType::CommitSetup);
+    Commit.SetupCommit = FSetupCommit{ESide::Red, "ab,cd ef%/"};
+    Match.Commands.push_back(Commit);
+    Match.Commands.push_back(BuildCommand(ESide::Black, ECommandType::CommitSetup));
+
+    FPlayerCommand Reveal = BuildCommand(ESide::Black, ECommandType::RevealSetup);
+    Reveal.SetupPlain = FSetupPlain{ESide::Black, {FSetupPlacement{16, FBoardPos{0, 9}}, FSetupPlacement{17, FBoardPos{-1, 12}}}, "n/o.n@ce"};
+    Match.Commands.push_back(Reveal);
+    Match.Commands.push_back(BuildCommand(ESide::Red, ECommandType::RevealSetup));
+
+    FPlayerCommand Move = BuildCommand(ESide::Red, ECommandType::Move);
+    Move.Move = FMoveAction{3, FBoardPos{4, 0}, FBoardPos{4, 1}, std::nullopt};
+    Match.Commands.push_back(Move);
+    FPlayerCommand FarMove = Move;
+    FarMove.Move->To = FBoardPos{4, 10};
+    Match.Commands.push_back(FarMove);
+    Match.Commands.push_back(BuildCommand(ESide::Black, ECommandType::Move));
+    Match.Commands.push_back(BuildCommand(ESide::Black, ECommandType::Pass));
+    Match.Commands.push_back(BuildCommand(ESide::Red, ECommandType::Resign));
+
+    const std::string Line = FCommandLog::FormatMatch(Match);
+    EXPECT_NE(Line.find("R3:4041"), std::string::npos);
+    EXPECT_NE(Line.find("R3:4/0/4/10"), std::string::npos);
+
+    FRecordedMatch Parsed{};
+    std::string Error;
+    ASSERT_TRUE(FCommandLog::ParseMatch(Line, Parsed, Error)) << Error;
+    EXPECT_EQ(Parsed.MatchId, Match.MatchId);
+    EXPECT_EQ(Parsed.ExpectedDigest, Match.ExpectedDigest);
+    ASSERT_EQ(Parsed.Commands.size(), Match.Commands.size());
+    EXPECT_EQ(Parsed.Commands[0].SetupCommit->HashHex, Commit.SetupCommit->HashHex);
+    EXPECT_FALSE(Parsed.Commands[1].SetupCommit.has_value());
+    EXPECT_EQ(Parsed.Commands[2].SetupPlain->Side, ESide::Black);
+    EXPECT_EQ(Parsed.Commands[2].SetupPlain->Nonce, Reveal.SetupPlain->Nonce);
+    EXPECT_EQ(Parsed.Commands[2].SetupPlain->Placements[1].TargetPos, (FBoardPos{-1, 12}));
+    EXPECT_FALSE(Parsed.Commands[3].SetupPlain.has_value());
+    EXPECT_EQ(Parsed.Commands[5].Move->To, (FBoardPos{4, 10}));
+    EXPECT_FALSE(Parsed.Commands[6].Move.has_value());
+    EXPECT_EQ(Parsed.Commands[8].CommandType, ECommandType::Resign);
+    EXPECT_EQ(FCommandLog::FormatMatch(Parsed), Line);
+
+    EXPECT_FALSE(FCommandLog::ParseMatch("match=1", Parsed, Error));
+    EXPECT_FALSE(FCommandLog::ParseMatch("match=1 commands=RP,X3:0000", Parsed, Error));
+    EXPECT_FALSE(FCommandLog::ParseMatch("match=1 commands=RC%4", Parsed, Error));
+    EXPECT_FALSE(FCommandLog::ParseMatch("match=1 commands=R3:000", Parsed, Error));
+    EXPECT_FALSE(FCommandLog::ParseMatch("match=1 commands=RP digest=12", Parsed, Error));
+}
+
+TEST(ReplayEngineTests, ShouldReproduceSelfPlayDigestsFromTextLog)
+{
+    const std::vector<FRecordedMatch> Matches = PlaySelfPlayMatches(16);
+    ASSERT_EQ(Matches.size(), 16u);
+
+    FReplayEngine Engine;
+    for (const FRecordedMatch& Match : Matches)
+    {
+        const FReplayResult Result = Engine.Replay(Match.Commands);
+        ASSERT_TRUE(Match.ExpectedDigest.has_value());
+        EXPECT_EQ(Result.Digest, Match.ExpectedDigest.value()) << "match " << Match.MatchId;
+        EXPECT_EQ(Result.CommandCount, Match.Commands.size());
+        EXPECT_EQ(Result.RejectedCount, 0u);
+        EXPECT_NE(Result.Phase, EGamePhase::SetupCommit);
+    }
+
+    // Reusing the engine must not leak state between matches.
+    FReplayEngine FreshEngine;
+    EXPECT_EQ(FreshEngine.Replay(Matches.back().Commands).Digest, Engine.Replay(Matches.back().Commands).Digest);
+
+    FRecordedMatch Tampered = Matches.front();
+    Tampered.Commands.pop_back();
+    EXPECT_NE(Engine.Replay(Tampered.Commands).Digest, Matches.front().ExpectedDigest.value());
+}
+
+TEST(ReplayEngineTests, ShouldReplaySessionCommandLogWithSessionEvents)
+{
+    FInMemoryMatchSession Session(7);
+    ASSERT_TRUE(Session.Join(FMatchJoinRequest{7, 100}).bAccepted);
+    ASSERT_TRUE(Session.Join(FMatchJoinRequest{7, 200}).bAccepted);
+
+    uint64_t RngState = 3;
+    for (const FPlayerId PlayerId : {FPlayerId{100}, FPlayerId{200}})
+    {
+        FPlayerCommand Commit = BuildCommand(ESide::Red, ECommandType::CommitSetup);
+        Commit.SetupCommit = FSetupCommit{ESide::Red, ""};
+        ASSERT_TRUE(Session.SubmitCommand(PlayerId, Commit).bAccepted);
+    }
+    // Rejected commands are logged too and must replay as rejections.
+    EXPECT_FALSE(Session.SubmitCommand(100, BuildCommand(ESide::Red, ECommandType::Pass)).bAccepted);
+    for (const FPlayerId PlayerId : {FPlayerId{100}, FPlayerId{200}})
+    {
+        const ESide Side = PlayerId == 100 ? ESide::Red : ESide::Black;
+        FPlayerCommand Reveal = BuildCommand(Side, ECommandType::RevealSetup);
+        Reveal.SetupPlain = SelfPlay::BuildRandomSetup(Side, RngState);
+        ASSERT_TRUE(Session.SubmitCommand(PlayerId, Reveal).bAccepted);
+    }
+    for (int32_t Ply = 0; Ply < 6 && Session.GetState().Phase == EGamePhase::Battle; ++Ply)
+    {
+        const FPlayerId PlayerId = Session.GetState().CurrentTurn == ESide::Red ? 100 : 200;
+        const std::vector<FMoveAction> Moves = Session.GetLegalMoves(PlayerId);
+        ASSERT_FALSE(Moves.empty());
+        FPlayerCommand Move = BuildCommand(ESide::Red, ECommandType::Move);
+        Move.Move = Moves[SelfPlay::NextRandom(RngState) % Moves.size()];
+        ASSERT_TRUE(Session.SubmitCommand(PlayerId, Move).bAccepted);
+    }
+    ASSERT_TRUE(Session.SubmitCommand(100, BuildCommand(ESide::Red, ECommandType::Resign)).bAccepted);
+    ASSERT_EQ(Session.GetState().Phase, EGamePhase::GameOver);
+
+    FReplayConfig VerboseConfig{};
+    VerboseConfig.Mode = EReplayMode::Verbose;
+    VerboseConfig.bRecordPlyHashes = true;
+    FReplayEngine VerboseEngine(VerboseConfig);
+    const FReplayResult Verbose = VerboseEngine.Replay(Session.GetCommandLog());
+    EXPECT_EQ(Verbose.FinalStateHash, FReplayEngine::ComputeStateHash(Session.GetState()));
+    EXPECT_EQ(Verbose.Result, Session.GetState().Result);
+    EXPECT_EQ(Verbose.RejectedCount, 1u);
+    EXPECT_EQ(Verbose.PlyHashes.size(), Session.GetCommandLog().size());
+
+    std::vector<std::string> SessionDescriptions;
+    for (const FMatchEventRecord& Event : Session.PullEvents(100, 0))
+    {
+        if (Event.EventType != EMatchEventType::PlayerJoined)
+        {
+            SessionDescriptions.push_back(Event.Description);
+        }
+    }
+    EXPECT_EQ(Verbose.EventDescriptions, SessionDescriptions);
+
+    FReplayEngine FastEngine;
+    const FReplayResult Fast = FastEngine.Replay(Session.GetCommandLog());
+    EXPECT_EQ(Fast.Digest, Verbose.Digest);
+    EXPECT_TRUE(Fast.EventDescriptions.empty());
+    EXPECT_TRUE(Fast.PlyHashes.empty());
+}
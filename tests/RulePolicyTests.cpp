@@ -0,0 +1,124 @@
+#include "CoreRules/MatchReferee.h"
+#include "CoreRules/RulePolicy.h"
+#include "SelfPlay/SelfPlay.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+FRuleConfig BuildNoFreezeRuleConfig()
+{
+    FRuleConfig RuleConfig{};
+    RuleConfig.bFreezeIfIllegalAfterReveal = false;
+    return RuleConfig;
+}
+
+void StartRandomBattle(FMatchReferee& Referee, uint64_t& RngState)
+{
+    ASSERT_TRUE(Referee.ApplyCommit({ESide::Red, ""}).bAccepted);
+    ASSERT_TRUE(Referee.ApplyCommit({ESide::Black, ""}).bAccepted);
+    ASSERT_TRUE(Referee.ApplyReveal(SelfPlay::BuildRandomSetup(ESide::Red, RngState)).bAccepted);
+    ASSERT_TRUE(Referee.ApplyReveal(SelfPlay::BuildRandomSetup(ESide::Black, RngState)).bAccepted);
+}
+
+// Plays the same random line through the preset instantiation and the dynamic one; every ply must agree.
+template <typename TPolicy>
+void ExpectPolicyMatchesDynamic(const FRuleConfig& RuleConfig, uint64_t Seed)
+{
+    FMatchReferee PresetReferee(RuleConfig);
+    FMatchReferee DynamicReferee(RuleConfig);
+    uint64_t PresetRngState = Seed;
+    uint64_t DynamicRngState = Seed;
+    StartRandomBattle(PresetReferee, PresetRngState);
+    StartRandomBattle(DynamicReferee, DynamicRngState);
+
+    FMoveList Moves;
+    for (int32_t Ply = 0; Ply < 200; ++Ply)
+    {
+        const ESide Side = PresetReferee.GetState().CurrentTurn;
+        ASSERT_EQ(PresetReferee.CanPass<TPolicy>(Side), DynamicReferee.CanPass<FDynamicRulePolicy>(Side));
+        PresetReferee.GenerateLegalMoves(Side, Moves);
+        if (Moves.IsEmpty())
+        {
+            break;
+        }
+
+        const FMoveAction Move = Moves[SelfPlay::NextRandom(PresetRngState) % Moves.Size()];
+        FMoveUndo PresetUndo{};
+        FMoveUndo DynamicUndo{};
+        PresetReferee.MakeMove<TPolicy>(Move, PresetUndo);
+        DynamicReferee.MakeMove<FDynamicRulePolicy>(Move, DynamicUndo);
+        ASSERT_TRUE(PresetReferee.GetState() == DynamicReferee.GetState()) << "ply " << Ply;
+    }
+}
+} // namespace
+
+TEST(RulePolicyTests, ShouldPickPresetOnlyForMatchingRuleConfig)
+{
+    static_assert(FindRulePolicyKind(FRuleConfig{}) == ERulePolicyKind::Standard);
+
+    EXPECT_EQ(FindRulePolicyKind(BuildNoFreezeRuleConfig()), ERulePolicyKind::NoFreeze);
+
+    FRuleConfig NoPassRuleConfig{};
+    NoPassRuleConfig.bAllowPassWhenNoLegalMove = false;
+    EXPECT_EQ(FindRulePolicyKind(NoPassRuleConfig), ERulePolicyKind::Dynamic);
+
+    EXPECT_EQ(FMatchReferee().GetRulePolicyKind(), ERulePolicyKind::Standard);
+    EXPECT_EQ(FMatchReferee(NoPassRuleConfig).GetRulePolicyKind(), ERulePolicyKind::Dynamic);
+
+    const bool bDoublePassIsDraw = DispatchRulePolicy(ERulePolicyKind::Dynamic, [&]<typename TPolicy>() {
+        return TPolicy::DoublePassIsDraw(NoPassRuleConfig);
+    });
+    EXPECT_TRUE(bDoublePassIsDraw);
+}
+
+TEST(RulePolicyTests, ShouldMatchDynamicPolicyAlongRandomPlayouts)
+{
+    for (uint64_t Seed = 1; Seed <= 8; ++Seed)
+    {
+        ExpectPolicyMatchesDynamic<FStandardRulePolicy>(FRuleConfig{}, Seed);
+        ExpectPolicyMatchesDynamic<FNoFreezeRulePolicy>(BuildNoFreezeRuleConfig(), Seed);
+    }
+}
+
+TEST(RulePolicyTests, ShouldKeepRevealedPieceMovableWithoutFreezeRule)
+{
+    FMatchReferee Referee(BuildNoFreezeRuleConfig());
+    ASSERT_EQ(Referee.GetRulePolicyKind(), ERulePolicyKind::NoFreeze);
+
+    // Move red advisor (piece 3) onto the cannon slot (1,2) so its first move is a cannon capture on (1,9).
+    uint64_t RngState = 5;
+    ASSERT_TRUE(Referee.ApplyCommit({ESide::Red, ""}).bAccepted);
+    ASSERT_TRUE(Referee.ApplyCommit({ESide::Black, ""}).bAccepted);
+    FSetupPlain RedSetup = SelfPlay::BuildRandomSetup(ESide::Red, RngState);
+    FSetupPlain BlackSetup = SelfPlay::BuildRandomSetup(ESide::Black, RngState);
+    const auto FindPlacement = [&RedSetup](auto Predicate) {
+        return std::find_if(RedSetup.Placements.begin(), RedSetup.Placements.end(), Predicate);
+    };
+    const auto Advisor = FindPlacement([](const FSetupPlacement& Placement) { return Placement.PieceId == 3; });
+    const auto CannonSlot = FindPlacement([](const FSetupPlacement& Placement) { return Placement.TargetPos == FBoardPos{1, 2}; });
+    ASSERT_NE(Advisor, RedSetup.Placements.end());
+    ASSERT_NE(CannonSlot, RedSetup.Placements.end());
+    std::swap(Advisor->TargetPos, CannonSlot->TargetPos);
+    ASSERT_TRUE(Referee.ApplyReveal(RedSetup).bAccepted);
+    ASSERT_TRUE(Referee.ApplyReveal(BlackSetup).bAccepted);
+
+    const std::vector<FMoveAction> Moves = Referee.GenerateLegalMoves(ESide::Red);
+    const auto Capture = std::find_if(Moves.begin(), Moves.end(), [](const FMoveAction& Move) {
+        return Move.PieceId == 3 && Move.To == FBoardPos{1, 9};
+    });
+    ASSERT_NE(Capture, Moves.end());
+
+    FPlayerCommand Command{};
+    Command.CommandType = ECommandType::Move;
+    Command.Side = ESide::Red;
+    Command.Move = *Capture;
+    ASSERT_TRUE(Referee.ApplyCommand(Command).bAccepted);
+
+    const FPieceState& Piece = Referee.GetState().Pieces[3];
+    EXPECT_EQ(Piece.PieceState, EPieceState::RevealedActual);
+    EXPECT_FALSE(Piece.bFrozen);
+}
@@ -0,0 +1,61 @@
+#include "SelfPlay/SelfPlay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<std::string> RunAndCollectSortedRecords(int32_t ThreadCount)
+{
+    FSelfPlayConfig Config{};
+    Config.GameCount = 12;
+    Config.ThreadCount = ThreadCount;
+    Config.Seed = 7;
+    Config.MaxPlies = 120;
+
+    std::ostringstream Stream;
+    FGameRecordWriter Writer(Stream);
+    const FSelfPlayStats Stats =
+        SelfPlay::Run(Config, SelfPlay::FindPolicyFactory("greedy"), SelfPlay::FindPolicyFactory("random"), &Writer);
+    EXPECT_EQ(Stats.Games, Config.GameCount);
+    EXPECT_EQ(Stats.RedWins + Stats.BlackWins + Stats.Draws, Config.GameCount);
+
+    std::vector<std::string> Lines;
+    std::istringstream Input(Stream.str());
+    for (std::string Line; std::getline(Input, Line);)
+    {
+        Lines.push_back(Line);
+    }
+    std::sort(Lines.begin(), Lines.end());
+    return Lines;
+}
+}
+
+TEST(SelfPlayTests, ShouldRunEveryTaskExactlyOnceAcrossWorkers)
+{
+    FWorkStealingPool Pool(4);
+    std::vector<std::atomic<int32_t>> RunCounts(257);
+    Pool.Run(RunCounts.size(), [&RunCounts](int32_t WorkerIndex, uint64_t TaskIndex) {
+        EXPECT_GE(WorkerIndex, 0);
+        EXPECT_LT(WorkerIndex, 4);
+        RunCounts[TaskIndex].fetch_add(1);
+    });
+
+    for (const std::atomic<int32_t>& RunCount : RunCounts)
+    {
+        EXPECT_EQ(RunCount.load(), 1);
+    }
+}
+
+TEST(SelfPlayTests, ShouldProduceSameRecordsForAnyThreadCount)
+{
+    const std::vector<std::string> SingleThreadRecords = RunAndCollectSortedRecords(1);
+    ASSERT_EQ(SingleThreadRecords.size(), 12u);
+    EXPECT_EQ(RunAndCollectSortedRecords(3), SingleThreadRecords);
+    EXPECT_EQ(SelfPlay::FindPolicyFactory("unknown"), nullptr);
+}
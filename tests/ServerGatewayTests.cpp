@@ -315,3 +315,47 @@ TEST(ServerGatewayTests, ShouldRouteResignCommandAndEnterGameOver)
     EXPECT_EQ(BlackMessages[2].GameOver->Result, static_cast<int32_t>(EGameResult::BlackWin));
     EXPECT_EQ(BlackMessages[2].GameOver->EndReason, static_cast<int32_t>(EEndReason::Resign));
 }
+
+TEST(ServerGatewayTests, ShouldAnswerLegalMovesQueryOnlyToRequester)
+{
+    FInMemoryMatchService Service;
+    FInMemoryServerMessageSink Sink;
+    FServerTransportAdapter Adapter(&Service, &Sink);
+    FServerGateway Gateway(&Adapter);
+
+    std::string RedJoinJson;
+    ASSERT_TRUE(ProtocolCodec::EncodeJoinPayload({606, 8801}, RedJoinJson));
+    ASSERT_TRUE(Gateway.ProcessEnvelope(BuildEnvelope(EProtocolMessageType::C2S_Join, 1, 606, RedJoinJson)));
+
+    std::string BlackJoinJson;
+    ASSERT_TRUE(ProtocolCodec::EncodeJoinPayload({606, 8802}, BlackJoinJson));
+    ASSERT_TRUE(Gateway.ProcessEnvelope(BuildEnvelope(EProtocolMessageType::C2S_Join, 2, 606, BlackJoinJson)));
+
+    uint64_t Sequence = 3;
+    ASSERT_TRUE(SetupBattlePhase(Gateway, 606, 8801, 8802, Sequence));
+
+    Sink.Clear();
+
+    std::string QueryJson;
+    ASSERT_TRUE(ProtocolCodec::EncodeQueryLegalMovesPayload({8802}, QueryJson));
+    EXPECT_TRUE(Gateway.ProcessEnvelope(BuildEnvelope(EProtocolMessageType::C2S_QueryLegalMoves, Sequence++, 606, QueryJson)));
+
+    EXPECT_TRUE(Sink.PullMessages(8801).empty());
+    const std::vector<FOutboundProtocolMessage> BlackMessages = Sink.PullMessages(8802);
+    ASSERT_EQ(BlackMessages.size(), static_cast<size_t>(1));
+    EXPECT_EQ(BlackMessages[0].Envelope.MessageType, EProtocolMessageType::S2C_LegalMoves);
+    ASSERT_TRUE(BlackMessages[0].LegalMoves.has_value());
+    EXPECT_EQ(BlackMessages[0].LegalMoves->Side, static_cast<int32_t>(ESide::Black));
+    EXPECT_FALSE(BlackMessages[0].LegalMoves->Moves.empty());
+
+    FProtocolLegalMovesPayload Decoded{};
+    ASSERT_TRUE(ProtocolCodec::DecodeLegalMovesPayload(BlackMessages[0].Envelope.PayloadJson, Decoded));
+    EXPECT_EQ(Decoded.Moves.size(), BlackMessages[0].LegalMoves->Moves.size());
+
+    std::string UnknownQueryJson;
+    ASSERT_TRUE(ProtocolCodec::EncodeQueryLegalMovesPayload({8899}, UnknownQueryJson));
+    EXPECT_FALSE(Gateway.ProcessEnvelope(BuildEnvelope(EProtocolMessageType::C2S_QueryLegalMoves, Sequence++, 606, UnknownQueryJson)));
+    const std::vector<FOutboundProtocolMessage> UnknownMessages = Sink.PullMessages(8899);
+    ASSERT_EQ(UnknownMessages.size(), static_cast<size_t>(1));
+    EXPECT_EQ(UnknownMessages[0].Envelope.MessageType, EProtocolMessageType::S2C_Error);
+}
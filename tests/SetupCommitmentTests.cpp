@@ -0,0 +1,207 @@
+#include "CoreRules/MatchReferee.h"
+#include "CoreRules/SetupCommitment.h"
+#include "CoreRules/Sha256.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr std::array<ESha256Backend, 3> AllBackends = {ESha256Backend::Portable, ESha256Backend::ShaNi, ESha256Backend::Avx2};
+
+std::span<const uint8_t> AsBytes(const std::string& Text)
+{
+    return std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Text.data()), Text.size());
+}
+
+FSetupPlain BuildStandardSetup(ESide Side, const char* Nonce)
+{
+    // Back rank, cannons and soldiers in the red layout; black mirrors the rows.
+    static constexpr std::array<FBoardPos, 16> RedSlots = {{
+        {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0},
+        {8, 0}, {1, 2}, {7, 2}, {0, 3}, {2, 3}, {4, 3}, {6, 3}, {8, 3},
+    }};
+
+    FSetupPlain Setup{};
+    Setup.Side = Side;
+    Setup.Nonce = Nonce;
+    const int32_t BasePieceId = Side == ESide::Red ? 0 : 16;
+    for (int32_t Index = 0; Index < 16; ++Index)
+    {
+        FBoardPos Pos = RedSlots[Index];
+        if (Side == ESide::Black)
+        {
+            Pos.Y = static_cast<int8_t>(9 - Pos.Y);
+        }
+        Setup.Placements.push_back(FSetupPlacement{static_cast<FPieceId>(BasePieceId + Index), Pos});
+    }
+    return Setup;
+}
+} // namespace
+
+TEST(SetupCommitmentTests, ShouldMatchKnownSha256VectorsOnEveryBackend)
+{
+    const std::string MillionA(1000000, 'a');
+    const std::array<std::pair<std::string, const char*>, 4> Vectors = {{
+        {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+        {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+         "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+        {MillionA, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+    }};
+
+    for (const ESha256Backend Backend : AllBackends)
+    {
+        for (const auto& [Message, Expected] : Vectors)
+        {
+            EXPECT_EQ(FSetupCommitment::ToHex(FSha256::Hash(AsBytes(Message), Backend)), Expected)
+                << "backend " << static_cast<int32_t>(Backend) << ", length " << Message.size();
+        }
+    }
+}
+
+TEST(SetupCommitmentTests, ShouldHashIncrementalUpdatesLikeOneShot)
+{
+    std::string Message;
+    for (int32_t Index = 0; Index < 1000; ++Index)
+    {
+        Message.push_back(static_cast<char>(Index * 31 + 7));
+    }
+
+    for (const ESha256Backend Backend : AllBackends)
+    {
+        for (const size_t ChunkSize : {size_t{1}, size_t{7}, size_t{63}, size_t{64}, size_t{65}, size_t{200}})
+        {
+            FSha256 Hasher(Backend);
+            for (size_t Offset = 0; Offset < Message.size(); Offset += ChunkSize)
+            {
+                Hasher.Update(AsBytes(Message).subspan(Offset, std::min(ChunkSize, Message.size() - Offset)));
+            }
+            EXPECT_EQ(Hasher.Finish(), FSha256::Hash(AsBytes(Message), ESha256Backend::Portable)) << "chunk " << ChunkSize;
+        }
+    }
+}
+
+TEST(SetupCommitmentTests, ShouldHashBatchesLikeSingleMessages)
+{
+    // Lengths cover every padding boundary and give uneven group sizes per block count.
+    std::vector<std::string> Payloads;
+    for (int32_t Length = 0; Length <= 200; Length += 3)
+    {
+        std::string Payload;
+        for (int32_t Index = 0; Index < Length; ++Index)
+        {
+            Payload.push_back(static_cast<char>(Length + Index * 13));
+        }
+        Payloads.push_back(Payload);
+    }
+
+    std::vector<std::span<const uint8_t>> Messages;
+    for (const std::string& Payload : Payloads)
+    {
+        Messages.push_back(AsBytes(Payload));
+    }
+
+    for (const ESha256Backend Backend : AllBackends)
+    {
+        std::vector<FSha256Digest> Digests(Messages.size());
+        FSha256::HashBatch(Messages, Digests, Backend);
+        for (size_t Index = 0; Index < Messages.size(); ++Index)
+        {
+            EXPECT_EQ(Digests[Index], FSha256::Hash(Messages[Index], ESha256Backend::Portable))
+                << "backend " << static_cast<int32_t>(Backend) << ", length " << Messages[Index].size();
+        }
+    }
+}
+
+TEST(SetupCommitmentTests, ShouldSerializeFixedLayout)
+{
+    FSetupPlain Setup{};
+    Setup.Side = ESide::Black;
+    Setup.Nonce = "ab";
+    Setup.Placements = {FSetupPlacement{300, {2, 9}}, FSetupPlacement{17, {8, 6}}};
+
+    std::vector<uint8_t> Bytes;
+    FSetupCommitment::Serialize(Setup, Bytes);
+
+    const std::vector<uint8_t> Expected = {
+        FSetupCommitment::LayoutVersion, 1, 2, 0,
+        17, 0, 8, 6,
+        44, 1, 2, 9,
+        2, 0, 0, 0, 'a', 'b'};
+    EXPECT_EQ(Bytes, Expected);
+    EXPECT_EQ(FSetupCommitment::ComputeDigest(Setup), FSha256::Hash(Bytes));
+}
+
+TEST(SetupCommitmentTests, ShouldIgnorePlacementOrderAndAcceptUppercaseHex)
+{
+    const FSetupPlain Setup = BuildStandardSetup(ESide::Red, "RedNonce");
+    FSetupPlain Shuffled = Setup;
+    std::reverse(Shuffled.Placements.begin(), Shuffled.Placements.end());
+
+    const std::string Hash = FSetupCommitment::BuildCommitHash(Setup);
+    EXPECT_EQ(Hash.size(), 64u);
+    EXPECT_EQ(FSetupCommitment::BuildCommitHash(Shuffled), Hash);
+
+    std::string Upper = Hash;
+    std::transform(Upper.begin(), Upper.end(), Upper.begin(), [](char C) { return static_cast<char>(std::toupper(C)); });
+    EXPECT_TRUE(FSetupCommitment::VerifyCommit({ESide::Red, Upper}, Shuffled));
+    EXPECT_FALSE(FSetupCommitment::VerifyCommit({ESide::Red, Hash.substr(1)}, Setup));
+    EXPECT_FALSE(FSetupCommitment::VerifyCommit({ESide::Red, "zz" + Hash.substr(2)}, Setup));
+
+    FSetupPlain OtherNonce = Setup;
+    OtherNonce.Nonce = "RedNonce2";
+    EXPECT_FALSE(FSetupCommitment::VerifyCommit({ESide::Red, Hash}, OtherNonce));
+}
+
+TEST(SetupCommitmentTests, ShouldVerifyCommitBatchPerEntry)
+{
+    std::vector<FSetupPlain> Reveals;
+    std::vector<FSetupCommit> Commits;
+    for (int32_t Index = 0; Index < 20; ++Index)
+    {
+        const ESide Side = Index % 2 == 0 ? ESide::Red : ESide::Black;
+        const std::string Nonce = "Nonce" + std::to_string(Index);
+        Reveals.push_back(BuildStandardSetup(Side, Nonce.c_str()));
+        Commits.push_back(FSetupCommit{Side, FSetupCommitment::BuildCommitHash(Reveals.back())});
+    }
+    // Tamper with a placement, a nonce and a hash.
+    std::swap(Reveals[3].Placements[0].TargetPos, Reveals[3].Placements[1].TargetPos);
+    Reveals[8].Nonce += "x";
+    Commits[15].HashHex = "HashA";
+
+    const std::vector<bool> Results = FSetupCommitment::VerifyCommits(Commits, Reveals);
+    ASSERT_EQ(Results.size(), Reveals.size());
+    for (size_t Index = 0; Index < Results.size(); ++Index)
+    {
+        EXPECT_EQ(Results[Index], Index != 3 && Index != 8 && Index != 15) << "entry " << Index;
+        EXPECT_EQ(Results[Index], FSetupCommitment::VerifyCommit(Commits[Index], Reveals[Index]));
+    }
+}
+
+TEST(SetupCommitmentTests, ShouldRevealAgainstRealCommitHash)
+{
+    const FSetupPlain RedSetup = BuildStandardSetup(ESide::Red, "RedNonce");
+    const FSetupPlain BlackSetup = BuildStandardSetup(ESide::Black, "BlackNonce");
+
+    FMatchReferee MatchReferee;
+    ASSERT_TRUE(MatchReferee.ApplyCommit({ESide::Red, FSetupCommitment::BuildCommitHash(RedSetup)}).bAccepted);
+    ASSERT_TRUE(MatchReferee.ApplyCommit({ESide::Black, FSetupCommitment::BuildCommitHash(BlackSetup)}).bAccepted);
+
+    FSetupPlain CheatingBlack = BlackSetup;
+    std::swap(CheatingBlack.Placements[0].PieceId, CheatingBlack.Placements[4].PieceId);
+    const FCommandResult Mismatch = MatchReferee.ApplyReveal(CheatingBlack);
+    EXPECT_FALSE(Mismatch.bAccepted);
+    EXPECT_EQ(Mismatch.ErrorCode, "ERR_COMMIT_MISMATCH");
+
+    EXPECT_TRUE(MatchReferee.ApplyReveal(RedSetup).bAccepted);
+    EXPECT_TRUE(MatchReferee.ApplyReveal(BlackSetup).bAccepted);
+    EXPECT_EQ(MatchReferee.GetState().Phase, EGamePhase::Battle);
+}
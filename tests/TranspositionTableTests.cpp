@@ -0,0 +1,143 @@
+#include "CoreRules/TranspositionTable.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+FTranspositionData MakeData(int32_t Depth, int16_t Score)
+{
+    FTranspositionData Data{};
+    Data.Score = Score;
+    Data.Depth = static_cast<int8_t>(Depth);
+    Data.Bound = ETranspositionBound::Lower;
+    Data.MovePieceId = 3;
+    Data.MoveToCell = 40;
+    return Data;
+}
+
+// Payload derived from the key so a reader can tell whether a hit returned another key's data.
+FTranspositionData MakeDataForKey(uint64_t Key)
+{
+    FTranspositionData Data{};
+    Data.Score = static_cast<int16_t>(Key >> 7);
+    Data.Depth = static_cast<int8_t>((Key >> 23) & 0x3F);
+    Data.Bound = ETranspositionBound::Exact;
+    Data.MovePieceId = static_cast<uint8_t>((Key >> 29) & 0x1F);
+    Data.MoveToCell = static_cast<uint8_t>((Key >> 34) % 90);
+    return Data;
+}
+}
+
+TEST(TranspositionTableTests, ShouldProbeOnlyVerifiedKeys)
+{
+    FTranspositionTable Table(1);
+    EXPECT_FALSE(Table.IsStatsEnabled());
+    Table.SetStatsEnabled(true);
+    EXPECT_EQ(Table.GetSizeBytes(), size_t{1} << 20);
+    EXPECT_EQ(Table.GetBucketCount() * FTranspositionTable::BucketSize, Table.GetSizeBytes());
+
+    const uint64_t Key = 0x123456789abcdef0ull;
+    Table.Store(Key, MakeData(7, -250));
+
+    FTranspositionData Data{};
+    ASSERT_TRUE(Table.Probe(Key, Data));
+    EXPECT_EQ(Data.Score, -250);
+    EXPECT_EQ(Data.Depth, 7);
+    EXPECT_EQ(Data.Bound, ETranspositionBound::Lower);
+    EXPECT_EQ(Data.MovePieceId, 3);
+    EXPECT_EQ(Data.MoveToCell, 40);
+
+    // Same bucket, different key.
+    EXPECT_FALSE(Table.Probe(Key + Table.GetBucketCount(), Data));
+
+    const FTranspositionTableStats Stats = Table.GetStats();
+    EXPECT_EQ(Stats.Probes, 2u);
+    EXPECT_EQ(Stats.Hits, 1u);
+    EXPECT_EQ(Stats.Stores, 1u);
+    EXPECT_DOUBLE_EQ(Stats.GetHitRate(), 0.5);
+
+    Table.Clear();
+    EXPECT_FALSE(Table.Probe(Key, Data));
+
+    Table.SetStatsEnabled(false);
+    Table.ResetStats();
+    Table.Store(Key, MakeData(7, -250));
+    EXPECT_TRUE(Table.Probe(Key, Data));
+    EXPECT_EQ(Table.GetStats().Probes, 0u);
+    EXPECT_EQ(Table.GetStats().Stores, 0u);
+}
+
+TEST(TranspositionTableTests, ShouldReplaceShallowestEntryAndAgeOldSearches)
+{
+    FTranspositionTable Table(1);
+    Table.SetStatsEnabled(true);
+    const uint64_t Stride = Table.GetBucketCount();
+    const int32_t Depths[4] = {10, 2, 8, 6};
+    for (uint64_t Index = 0; Index < 4; ++Index)
+    {
+        Table.Store(1 + Index * Stride, MakeData(Depths[Index], 0));
+    }
+
+    FTranspositionData Data{};
+    Table.Store(1 + 4 * Stride, MakeData(5, 0));
+    EXPECT_FALSE(Table.Probe(1 + 1 * Stride, Data));
+    EXPECT_TRUE(Table.Probe(1 + 4 * Stride, Data));
+    EXPECT_EQ(Table.GetStats().Collisions, 1u);
+
+    // After two searches the depth-10 entry is worth 10 - 16 and goes first; a shallower fresh entry survives.
+    Table.NewSearch();
+    Table.NewSearch();
+    Table.Store(1 + 2 * Stride, MakeData(8, 0));
+    Table.Store(1 + 3 * Stride, MakeData(6, 0));
+    Table.Store(1 + 4 * Stride, MakeData(5, 0));
+    Table.Store(1 + 5 * Stride, MakeData(1, 0));
+    EXPECT_FALSE(Table.Probe(1, Data));
+    EXPECT_TRUE(Table.Probe(1 + 2 * Stride, Data));
+    EXPECT_TRUE(Table.Probe(1 + 5 * Stride, Data));
+    EXPECT_EQ(Table.GetStats().Collisions, 1u);
+}
+
+TEST(TranspositionTableTests, ShouldNeverReturnTornEntriesUnderConcurrentAccess)
+{
+    // A single bucket maximizes contention between writers.
+    FTranspositionTable Table(0);
+    ASSERT_EQ(Table.GetBucketCount(), 1u);
+    Table.SetStatsEnabled(true);
+
+    std::atomic<int32_t> MismatchCount{0};
+    std::vector<std::thread> Threads;
+    for (uint64_t ThreadIndex = 0; ThreadIndex < 4; ++ThreadIndex)
+    {
+        Threads.emplace_back([&Table, &MismatchCount, ThreadIndex] {
+            uint64_t Key = 0x9e3779b97f4a7c15ull * (ThreadIndex + 1);
+            for (int32_t Iteration = 0; Iteration < 20000; ++Iteration)
+            {
+                Key = Key * 6364136223846793005ull + 1442695040888963407ull;
+                const uint64_t ProbeKey = Key % 64;
+                Table.Store(ProbeKey, MakeDataForKey(ProbeKey));
+
+                FTranspositionData Data{};
+                if (Table.Probe(ProbeKey, Data))
+                {
+                    const FTranspositionData Expected = MakeDataForKey(ProbeKey);
+                    if (Data.Score != Expected.Score || Data.Depth != Expected.Depth ||
+                        Data.MovePieceId != Expected.MovePieceId || Data.MoveToCell != Expected.MoveToCell)
+                    {
+                        MismatchCount.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    EXPECT_EQ(MismatchCount.load(), 0);
+    EXPECT_EQ(Table.GetStats().Stores, 80000u);
+}
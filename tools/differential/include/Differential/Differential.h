@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreRules/CoreTypes.h"
+#include "CoreRules/PackedGameState.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct FDifferentialConfig
+{
+    uint64_t GameCount = 1000;
+    // 0 uses std::thread::hardware_concurrency().
+    int32_t ThreadCount = 0;
+    uint64_t Seed = 1;
+    uint32_t MaxPlies = 300;
+    // Percent of games that start from a scrambled position instead of a fresh random setup.
+    uint32_t AdversarialPercent = 50;
+    // Percent of plies that also try a random, usually illegal, command on copies of both engines.
+    uint32_t ProbePercent = 25;
+    // Keeps at most this many divergences; every divergent game is still counted.
+    uint32_t MaxRecordedDivergences = 8;
+    bool bMinimize = true;
+    FRuleConfig RuleConfig{};
+};
+
+// A battle position plus the commands played from it: enough to replay a divergence on both engines. Start's
+// position hash is ignored and recomputed on load.
+struct FDifferentialCase
+{
+    FPackedGameState Start{};
+    std::vector<FPlayerCommand> Commands;
+};
+
+// Where a replay first saw the engines disagree. CommandCount is how many commands had been applied (0 means the
+// start position itself).
+struct FDifferentialMismatch
+{
+    size_t CommandCount = 0;
+    std::string Description;
+};
+
+struct FDifferentialDivergence
+{
+    uint64_t GameIndex = 0;
+    uint64_t Seed = 0;
+    FDifferentialCase Case;
+    FDifferentialMismatch Mismatch;
+};
+
+struct FDifferentialStats
+{
+    uint64_t Games = 0;
+    uint64_t AdversarialGames = 0;
+    uint64_t Plies = 0;
+    uint64_t Probes = 0;
+    uint64_t DivergentGames = 0;
+    std::vector<FDifferentialDivergence> Divergences;
+    double Seconds = 0.0;
+};
+
+// Plays games through the optimized FMatchReferee and the frozen FReferenceReferee in lock step. Before the first
+// command and after every command it compares the rule-visible state, the optimized incremental position hash
+// against a full recomputation over the reference state, both sides' legal move sets and check status, and pass
+// permission; every command's acceptance and error code must match as well.
+namespace Differential
+{
+// Fresh commit/reveal with random setups for both sides.
+FPackedGameState BuildRandomStart(uint64_t& RngState, const FRuleConfig& RuleConfig);
+// Random setups, then pieces other than the kings removed, pieces moved (half of them onto a rank or file through
+// a king, so cannon screens, pins and facing kings are common), pieces revealed with the freeze rule applied, and a
+// random side to move. Kings stay hidden unless revealed like any other piece. Positions where the side that just
+// moved is left in check are redrawn.
+FPackedGameState BuildAdversarialStart(uint64_t& RngState, const FRuleConfig& RuleConfig);
+
+// True when both engines agree on the whole case; otherwise fills OutMismatch with the first disagreement.
+bool ReplayCase(const FDifferentialCase& Case, const FRuleConfig& RuleConfig, FDifferentialMismatch& OutMismatch);
+
+// Shrinks a failing case while StillFails holds: drops every command after the failing one, then tries removing
+// single commands and single non-king pieces until no removal keeps it failing.
+FDifferentialCase MinimizeCase(const FDifferentialCase& Case, const std::function<bool(const FDifferentialCase&)>& StillFails);
+// MinimizeCase with "ReplayCase reports a mismatch" as the predicate.
+FDifferentialCase MinimizeCase(const FDifferentialCase& Case, const FRuleConfig& RuleConfig);
+
+// Games run on a FWorkStealingPool; game N uses SelfPlay::GetGameSeed(Config.Seed, N), so a divergence reproduces
+// from its game index alone.
+FDifferentialStats Run(const FDifferentialConfig& Config);
+
+// One line: "turn=<R|B> pass=<n> turn-index=<n> pieces=<32 x CCRRFF hex> commands=<c>,<c>,..." with the packed
+// cell, roles and flags of each piece. A command is its side (R/B) followed by a move in the self-play record
+// notation "<PieceId>:<FromX><FromY><ToX><ToY>", "P" for a pass, "R" for a resignation or "M" for a move command
+// without a move.
+std::string FormatCase(const FDifferentialCase& Case);
+bool ParseCase(const std::string& Line, FDifferentialCase& OutCase, std::string& OutError);
+}
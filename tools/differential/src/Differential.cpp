@@ -0,0 +1,821 @@
+#include "Differential/Differential.h"
+
+#include "CoreRules/BoardGeometry.h"
+#include "CoreRules/MatchReferee.h"
+#include "Differential/ReferenceReferee.h"
+#include "SelfPlay/SelfPlay.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+constexpr uint8_t AllSetupFlags = FPackedGameState::RedCommittedFlag | FPackedGameState::BlackCommittedFlag |
+                                  FPackedGameState::RedRevealedFlag | FPackedGameState::BlackRevealedFlag;
+constexpr size_t PieceCount = 32;
+
+using SelfPlay::NextRandom;
+
+uint64_t NextBelow(uint64_t& RngState, uint64_t Bound)
+{
+    return NextRandom(RngState) % Bound;
+}
+
+int32_t ToSideIndex(ESide Side) noexcept
+{
+    return Side == ESide::Red ? 0 : 1;
+}
+
+ESide GetOppositeSide(ESide Side) noexcept
+{
+    return Side == ESide::Red ? ESide::Black : ESide::Red;
+}
+
+const char* SideToString(ESide Side)
+{
+    return Side == ESide::Red ? "Red" : "Black";
+}
+
+FPlayerCommand BuildCommand(ECommandType CommandType, ESide Side, std::optional<FMoveAction> Move = std::nullopt)
+{
+    FPlayerCommand Command{};
+    Command.CommandType = CommandType;
+    Command.Side = Side;
+    Command.Move = Move;
+    return Command;
+}
+
+auto GetMoveKey(const FMoveAction& Move)
+{
+    return std::make_tuple(Move.PieceId, Move.From.X, Move.From.Y, Move.To.X, Move.To.Y, Move.CapturedPieceId.value_or(0xFFFF));
+}
+
+std::string DescribeMove(const FMoveAction& Move)
+{
+    std::ostringstream Stream;
+    Stream << Move.PieceId << ':' << static_cast<int32_t>(Move.From.X) << static_cast<int32_t>(Move.From.Y)
+           << static_cast<int32_t>(Move.To.X) << static_cast<int32_t>(Move.To.Y);
+    if (Move.CapturedPieceId.has_value())
+    {
+        Stream << 'x' << Move.CapturedPieceId.value();
+    }
+    return Stream.str();
+}
+
+bool IsRolePositionLegal(ERoleType Role, ESide Side, int32_t Cell)
+{
+    const int32_t SideIndex = ToSideIndex(Side);
+    switch (Role)
+    {
+    case ERoleType::King:
+        return BoardGeometry.Palace[SideIndex][Cell];
+    case ERoleType::Advisor:
+        return BoardGeometry.AdvisorPoint[SideIndex][Cell];
+    case ERoleType::Elephant:
+        return BoardGeometry.ElephantPoint[SideIndex][Cell];
+    default:
+        return true;
+    }
+}
+
+// Battle state of a fresh commit/reveal; both setups are drawn from RngState.
+FGameState BuildSetupState(uint64_t& RngState, const FRuleConfig& RuleConfig)
+{
+    FMatchReferee Referee(RuleConfig);
+    Referee.ApplyCommit(FSetupCommit{ESide::Red, ""});
+    Referee.ApplyCommit(FSetupCommit{ESide::Black, ""});
+    Referee.ApplyReveal(SelfPlay::BuildRandomSetup(ESide::Red, RngState));
+    Referee.ApplyReveal(SelfPlay::BuildRandomSetup(ESide::Black, RngState));
+    return Referee.GetState();
+}
+
+FPackedGameState PackWithFreshHash(FGameState State)
+{
+    State.PositionHash = FMatchReferee::ComputePositionHash(State);
+    return FGameStatePacker::Pack(State);
+}
+
+// Kings are never removed from scrambled positions, so the actual-role king is always on the board.
+FBoardPos FindKingPos(const FGameState& State, ESide Side)
+{
+    for (const FPieceState& Piece : State.Pieces)
+    {
+        if (Piece.bAlive && Piece.Side == Side && Piece.ActualRole == ERoleType::King)
+        {
+            return Piece.Pos;
+        }
+    }
+    return FBoardPos{0, 0};
+}
+
+void RemoveFromBoard(FGameState& State, FPieceState& Piece)
+{
+    if (Piece.Pos.IsValid())
+    {
+        State.BoardCells[static_cast<size_t>(Piece.Pos.Y * 9 + Piece.Pos.X)] = std::nullopt;
+    }
+    Piece.Pos = FBoardPos{};
+    Piece.bAlive = false;
+    Piece.bFrozen = false;
+}
+
+bool CompareRuleStates(const FGameState& Optimized, const FGameState& Reference, std::string& OutDescription)
+{
+    std::ostringstream Stream;
+    if (Optimized.Phase != Reference.Phase || Optimized.Result != Reference.Result || Optimized.EndReason != Reference.EndReason)
+    {
+        Stream << "phase/result differ: optimized " << static_cast<int32_t>(Optimized.Phase) << '/'
+               << static_cast<int32_t>(Optimized.Result) << '/' << static_cast<int32_t>(Optimized.EndReason)
+               << ", reference " << static_cast<int32_t>(Reference.Phase) << '/' << static_cast<int32_t>(Reference.Result)
+               << '/' << static_cast<int32_t>(Reference.EndReason);
+    }
+    else if (Optimized.CurrentTurn != Reference.CurrentTurn || Optimized.PassCount != Reference.PassCount ||
+             Optimized.TurnIndex != Reference.TurnIndex)
+    {
+        Stream << "turn state differs: optimized " << SideToString(Optimized.CurrentTurn) << " pass=" << Optimized.PassCount
+               << " index=" << Optimized.TurnIndex << ", reference " << SideToString(Reference.CurrentTurn)
+               << " pass=" << Reference.PassCount << " index=" << Reference.TurnIndex;
+    }
+    else if (Optimized.bRedCommitted != Reference.bRedCommitted || Optimized.bBlackCommitted != Reference.bBlackCommitted ||
+             Optimized.bRedRevealed != Reference.bRedRevealed || Optimized.bBlackRevealed != Reference.bBlackRevealed)
+    {
+        Stream << "setup flags differ";
+    }
+    else if (Optimized.Pieces.size() != Reference.Pieces.size())
+    {
+        Stream << "piece count differs: optimized " << Optimized.Pieces.size() << ", reference " << Reference.Pieces.size();
+    }
+    else
+    {
+        for (size_t Index = 0; Index < Optimized.Pieces.size(); ++Index)
+        {
+            if (!(Optimized.Pieces[Index] == Reference.Pieces[Index]))
+            {
+                Stream << "piece " << Index << " differs";
+                break;
+            }
+        }
+        for (size_t Cell = 0; Stream.tellp() == 0 && Cell < Optimized.BoardCells.size(); ++Cell)
+        {
+            if (Optimized.BoardCells[Cell] != Reference.BoardCells[Cell])
+            {
+                Stream << "board cell " << Cell << " differs";
+            }
+        }
+    }
+
+    OutDescription = Stream.str();
+    return OutDescription.empty();
+}
+
+// Both engines in lock step. Every public query the optimized referee shares with the reference is compared.
+struct FEnginePair
+{
+    explicit FEnginePair(const FRuleConfig& RuleConfig)
+        : Optimized(RuleConfig)
+        , Reference(RuleConfig)
+    {
+    }
+
+    void Load(const FPackedGameState& Start)
+    {
+        Optimized.ImportPackedState(PackWithFreshHash(FGameStatePacker::Unpack(Start)));
+        Reference.LoadState(Optimized.GetState());
+    }
+
+    bool Compare(std::string& OutDescription) const
+    {
+        if (!CompareRuleStates(Optimized.GetState(), Reference.GetState(), OutDescription))
+        {
+            return false;
+        }
+
+        const uint64_t ExpectedHash = FMatchReferee::ComputePositionHash(Reference.GetState());
+        if (Optimized.GetState().PositionHash != ExpectedHash)
+        {
+            OutDescription = "position hash differs from a full recomputation over the reference state";
+            return false;
+        }
+
+        for (const ESide Side : {ESide::Red, ESide::Black})
+        {
+            if (!CompareLegalMoves(Side, OutDescription))
+            {
+                return false;
+            }
+            if (Optimized.IsSideInCheck(Side) != Reference.IsSideInCheck(Side))
+            {
+                OutDescription = std::string("check status differs for ") + SideToString(Side) + ": optimized " +
+                                 (Optimized.IsSideInCheck(Side) ? "in check" : "not in check");
+                return false;
+            }
+            if (Optimized.CanPass(Side) != Reference.CanPass(Side))
+            {
+                OutDescription = std::string("pass permission differs for ") + SideToString(Side) + ": optimized " +
+                                 (Optimized.CanPass(Side) ? "can pass" : "cannot pass");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CompareLegalMoves(ESide Side, std::string& OutDescription) const
+    {
+        std::vector<FMoveAction> OptimizedMoves = Optimized.GenerateLegalMoves(Side);
+        std::vector<FMoveAction> ReferenceMoves = Reference.GenerateLegalMoves(Side);
+        auto IsLess = [](const FMoveAction& Lhs, const FMoveAction& Rhs) { return GetMoveKey(Lhs) < GetMoveKey(Rhs); };
+        std::sort(OptimizedMoves.begin(), OptimizedMoves.end(), IsLess);
+        std::sort(ReferenceMoves.begin(), ReferenceMoves.end(), IsLess);
+
+        const auto [OptimizedIt, ReferenceIt] = std::mismatch(
+            OptimizedMoves.begin(), OptimizedMoves.end(), ReferenceMoves.begin(), ReferenceMoves.end(),
+            [](const FMoveAction& Lhs, const FMoveAction& Rhs) { return GetMoveKey(Lhs) == GetMoveKey(Rhs); });
+        if (OptimizedIt == OptimizedMoves.end() && ReferenceIt == ReferenceMoves.end())
+        {
+            return true;
+        }
+
+        // The smaller key at the first mismatch is the move only one engine generated.
+        const bool bOptimizedExtra =
+            ReferenceIt == ReferenceMoves.end() || (OptimizedIt != OptimizedMoves.end() && IsLess(*OptimizedIt, *ReferenceIt));
+        OutDescription = std::string("legal moves differ for ") + SideToString(Side) + ": " +
+                         (bOptimizedExtra ? "only optimized generates " + DescribeMove(*OptimizedIt)
+                                          : "only reference generates " + DescribeMove(*ReferenceIt)) +
+                         " (optimized " + std::to_string(OptimizedMoves.size()) + ", reference " +
+                         std::to_string(ReferenceMoves.size()) + " moves)";
+        return false;
+    }
+
+    bool Apply(const FPlayerCommand& Command, std::string& OutDescription)
+    {
+        const FCommandResult OptimizedResult = Optimized.ApplyCommand(Command);
+        const FCommandResult ReferenceResult = Reference.ApplyCommand(Command);
+        if (OptimizedResult.bAccepted != ReferenceResult.bAccepted || OptimizedResult.ErrorCode != ReferenceResult.ErrorCode)
+        {
+            OutDescription = "command result differs: optimized " +
+                             (OptimizedResult.bAccepted ? std::string("accepted") : OptimizedResult.ErrorCode) + ", reference " +
+                             (ReferenceResult.bAccepted ? std::string("accepted") : ReferenceResult.ErrorCode);
+            return false;
+        }
+        return Compare(OutDescription);
+    }
+
+    FMatchReferee Optimized;
+    FReferenceReferee Reference;
+};
+
+// A random command that is usually illegal: wrong squares, wrong side, passes with moves available, or a missing
+// payload. Coordinates always stay on the board so the command survives FormatCase.
+FPlayerCommand BuildProbeCommand(const FGameState& State, uint64_t& RngState)
+{
+    const ESide Turn = State.CurrentTurn;
+    const uint64_t Kind = NextBelow(RngState, 20);
+    if (Kind == 0)
+    {
+        return BuildCommand(ECommandType::Pass, Turn);
+    }
+    if (Kind == 1)
+    {
+        return BuildCommand(ECommandType::Move, Turn);
+    }
+    if (Kind == 2)
+    {
+        return BuildCommand(ECommandType::Pass, GetOppositeSide(Turn));
+    }
+
+    const FPieceState& Piece = State.Pieces[NextBelow(RngState, State.Pieces.size())];
+    FMoveAction Move{};
+    Move.PieceId = Piece.PieceId;
+    Move.From = Piece.Pos;
+    if (!Move.From.IsValid() || NextBelow(RngState, 8) == 0)
+    {
+        Move.From = FBoardPos{static_cast<int8_t>(NextBelow(RngState, 9)), static_cast<int8_t>(NextBelow(RngState, 10))};
+    }
+    Move.To = FBoardPos{static_cast<int8_t>(NextBelow(RngState, 9)), static_cast<int8_t>(NextBelow(RngState, 10))};
+    return BuildCommand(ECommandType::Move, Kind == 3 ? GetOppositeSide(Turn) : Turn, Move);
+}
+
+struct FGameOutcome
+{
+    bool bAdversarial = false;
+    uint64_t Plies = 0;
+    uint64_t Probes = 0;
+    bool bDiverged = false;
+    FDifferentialDivergence Divergence;
+};
+
+FGameOutcome PlayGame(uint64_t GameIndex, const FDifferentialConfig& Config)
+{
+    FGameOutcome Outcome{};
+    const uint64_t Seed = SelfPlay::GetGameSeed(Config.Seed, GameIndex);
+    uint64_t RngState = Seed;
+    Outcome.bAdversarial = NextBelow(RngState, 100) < Config.AdversarialPercent;
+
+    FDifferentialCase Case{};
+    Case.Start = Outcome.bAdversarial ? Differential::BuildAdversarialStart(RngState, Config.RuleConfig)
+                                      : Differential::BuildRandomStart(RngState, Config.RuleConfig);
+
+    FEnginePair Pair(Config.RuleConfig);
+    Pair.Load(Case.Start);
+    std::string Description;
+    bool bAgree = Pair.Compare(Description);
+    while (bAgree && Pair.Optimized.GetState().Phase == EGamePhase::Battle && Outcome.Plies < Config.MaxPlies)
+    {
+        const FGameState& State = Pair.Optimized.GetState();
+        if (NextBelow(RngState, 100) < Config.ProbePercent)
+        {
+            ++Outcome.Probes;
+            const FPlayerCommand Probe = BuildProbeCommand(State, RngState);
+            FEnginePair Copy = Pair;
+            if (!Copy.Apply(Probe, Description))
+            {
+                Case.Commands.push_back(Probe);
+                bAgree = false;
+                break;
+            }
+        }
+
+        const ESide Turn = State.CurrentTurn;
+        const std::vector<FMoveAction> Moves = Pair.Reference.GenerateLegalMoves(Turn);
+        FPlayerCommand Command{};
+        if (Moves.empty())
+        {
+            Command = BuildCommand(Pair.Reference.CanPass(Turn) ? ECommandType::Pass : ECommandType::Resign, Turn);
+        }
+        else
+        {
+            // Only PieceId/From/To identify a move; dropping the capture keeps the command identical to its text form.
+            FMoveAction Move = Moves[NextBelow(RngState, Moves.size())];
+            Move.CapturedPieceId.reset();
+            Command = BuildCommand(ECommandType::Move, Turn, Move);
+        }
+
+        Case.Commands.push_back(Command);
+        ++Outcome.Plies;
+        bAgree = Pair.Apply(Command, Description);
+    }
+
+    if (bAgree)
+    {
+        return Outcome;
+    }
+
+    Outcome.bDiverged = true;
+    Outcome.Divergence.GameIndex = GameIndex;
+    Outcome.Divergence.Seed = Seed;
+    Outcome.Divergence.Case = Config.bMinimize ? Differential::MinimizeCase(Case, Config.RuleConfig) : Case;
+    if (Differential::ReplayCase(Outcome.Divergence.Case, Config.RuleConfig, Outcome.Divergence.Mismatch))
+    {
+        // Only reachable if an engine is not deterministic; keep what the game itself saw.
+        Outcome.Divergence.Case = Case;
+        Outcome.Divergence.Mismatch = FDifferentialMismatch{Case.Commands.size(), "not reproducible on replay: " + Description};
+    }
+    return Outcome;
+}
+
+bool RemoveCommands(FDifferentialCase& Case, const std::function<bool(const FDifferentialCase&)>& StillFails)
+{
+    bool bChanged = false;
+    for (size_t Chunk = std::max<size_t>(Case.Commands.size() / 2, 1); !Case.Commands.empty(); Chunk /= 2)
+    {
+        for (size_t Begin = 0; Begin < Case.Commands.size();)
+        {
+            FDifferentialCase Candidate = Case;
+            const size_t End = std::min(Begin + Chunk, Candidate.Commands.size());
+            Candidate.Commands.erase(Candidate.Commands.begin() + static_cast<std::ptrdiff_t>(Begin),
+                                     Candidate.Commands.begin() + static_cast<std::ptrdiff_t>(End));
+            if (StillFails(Candidate))
+            {
+                Case = std::move(Candidate);
+                bChanged = true;
+            }
+            else
+            {
+                Begin += Chunk;
+            }
+        }
+        if (Chunk == 1)
+        {
+            break;
+        }
+    }
+    return bChanged;
+}
+
+bool RemovePieces(FDifferentialCase& Case, const std::function<bool(const FDifferentialCase&)>& StillFails)
+{
+    bool bChanged = false;
+    for (size_t Index = 0; Index < Case.Start.PieceCount; ++Index)
+    {
+        const FPackedPiece& Piece = Case.Start.Pieces[Index];
+        if ((Piece.Flags & FPackedPiece::AliveFlag) == 0 || static_cast<ERoleType>(Piece.Roles & 0x0F) == ERoleType::King)
+        {
+            continue;
+        }
+
+        FDifferentialCase Candidate = Case;
+        FPackedPiece& Removed = Candidate.Start.Pieces[Index];
+        if (Removed.Cell != FPackedPiece::OffBoardCell)
+        {
+            Candidate.Start.BoardCells[Removed.Cell] = FPackedGameState::EmptyCell;
+        }
+        Removed.Cell = FPackedPiece::OffBoardCell;
+        Removed.Flags = static_cast<uint8_t>(Removed.Flags & ~(FPackedPiece::AliveFlag | FPackedPiece::FrozenFlag));
+        if (StillFails(Candidate))
+        {
+            Case = std::move(Candidate);
+            bChanged = true;
+        }
+    }
+    return bChanged;
+}
+
+bool ParseUnsigned(const std::string& Text, uint64_t& OutValue)
+{
+    if (Text.empty() || Text.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+    OutValue = std::strtoull(Text.c_str(), nullptr, 10);
+    return true;
+}
+
+bool ParseCommand(const std::string& Token, FPlayerCommand& OutCommand)
+{
+    if (Token.size() < 2 || (Token[0] != 'R' && Token[0] != 'B'))
+    {
+        return false;
+    }
+    OutCommand = FPlayerCommand{};
+    OutCommand.Side = Token[0] == 'R' ? ESide::Red : ESide::Black;
+    const std::string Body = Token.substr(1);
+    if (Body == "P" || Body == "R" || Body == "M")
+    {
+        OutCommand.CommandType = Body == "P" ? ECommandType::Pass : (Body == "R" ? ECommandType::Resign : ECommandType::Move);
+        return true;
+    }
+
+    const size_t Colon = Body.find(':');
+    uint64_t PieceId = 0;
+    if (Colon == std::string::npos || !ParseUnsigned(Body.substr(0, Colon), PieceId) || PieceId >= PieceCount)
+    {
+        return false;
+    }
+    const std::string Squares = Body.substr(Colon + 1);
+    if (Squares.size() != 4 || Squares.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+
+    FMoveAction Move{};
+    Move.PieceId = static_cast<FPieceId>(PieceId);
+    Move.From = FBoardPos{static_cast<int8_t>(Squares[0] - '0'), static_cast<int8_t>(Squares[1] - '0')};
+    Move.To = FBoardPos{static_cast<int8_t>(Squares[2] - '0'), static_cast<int8_t>(Squares[3] - '0')};
+    if (!Move.From.IsValid() || !Move.To.IsValid())
+    {
+        return false;
+    }
+    OutCommand.CommandType = ECommandType::Move;
+    OutCommand.Move = Move;
+    return true;
+}
+
+int32_t HexValue(char C)
+{
+    if (C >= '0' && C <= '9')
+    {
+        return C - '0';
+    }
+    if (C >= 'a' && C <= 'f')
+    {
+        return C - 'a' + 10;
+    }
+    return -1;
+}
+} // namespace
+
+namespace Differential
+{
+FPackedGameState BuildRandomStart(uint64_t& RngState, const FRuleConfig& RuleConfig)
+{
+    return PackWithFreshHash(BuildSetupState(RngState, RuleConfig));
+}
+
+FPackedGameState BuildAdversarialStart(uint64_t& RngState, const FRuleConfig& RuleConfig)
+{
+    for (;;)
+    {
+        FGameState State = BuildSetupState(RngState, RuleConfig);
+
+        const uint64_t RemoveCount = NextBelow(RngState, 24);
+        for (uint64_t Attempt = 0; Attempt < RemoveCount; ++Attempt)
+        {
+            FPieceState& Piece = State.Pieces[NextBelow(RngState, State.Pieces.size())];
+            if (Piece.bAlive && Piece.ActualRole != ERoleType::King)
+            {
+                RemoveFromBoard(State, Piece);
+            }
+        }
+
+        for (FPieceState& Piece : State.Pieces)
+        {
+            if (!Piece.bAlive || NextBelow(RngState, 2) == 0)
+            {
+                continue;
+            }
+
+            // Half of the moves land on a rank or file through a king, where screens and pins decide legality.
+            int32_t X = static_cast<int32_t>(NextBelow(RngState, 9));
+            int32_t Y = static_cast<int32_t>(NextBelow(RngState, 10));
+            if (NextBelow(RngState, 2) == 0)
+            {
+                const FBoardPos KingPos = FindKingPos(State, NextBelow(RngState, 2) == 0 ? ESide::Red : ESide::Black);
+                if (NextBelow(RngState, 2) == 0)
+                {
+                    X = KingPos.X;
+                }
+                else
+                {
+                    Y = KingPos.Y;
+                }
+            }
+            const FBoardPos To{static_cast<int8_t>(X), static_cast<int8_t>(Y)};
+            std::optional<FPieceId>& Target = State.BoardCells[static_cast<size_t>(Y * 9 + X)];
+            if (Target.has_value())
+            {
+                continue;
+            }
+            State.BoardCells[static_cast<size_t>(Piece.Pos.Y * 9 + Piece.Pos.X)] = std::nullopt;
+            Target = Piece.PieceId;
+            Piece.Pos = To;
+        }
+
+        for (FPieceState& Piece : State.Pieces)
+        {
+            if (!Piece.bAlive || NextBelow(RngState, 10) >= 3)
+            {
+                continue;
+            }
+            // Same transition as a first capture: the piece is revealed where it stands and frozen if its actual role
+            // may not stand there.
+            Piece.PieceState = EPieceState::RevealedActual;
+            Piece.bHasCaptured = true;
+            Piece.bFrozen = RuleConfig.bFreezeIfIllegalAfterReveal &&
+                            !IsRolePositionLegal(Piece.ActualRole, Piece.Side, Piece.Pos.Y * 9 + Piece.Pos.X);
+        }
+
+        State.CurrentTurn = NextBelow(RngState, 2) == 0 ? ESide::Red : ESide::Black;
+        State.PassCount = NextBelow(RngState, 10) == 0 ? 1 : 0;
+        State.TurnIndex = NextBelow(RngState, 200);
+
+        // Only the cached fields are stale here; the reference engine ignores them.
+        FReferenceReferee Reference(RuleConfig);
+        Reference.LoadState(State);
+        if (!Reference.IsSideInCheck(GetOppositeSide(State.CurrentTurn)))
+        {
+            return PackWithFreshHash(std::move(State));
+        }
+    }
+}
+
+bool ReplayCase(const FDifferentialCase& Case, const FRuleConfig& RuleConfig, FDifferentialMismatch& OutMismatch)
+{
+    FEnginePair Pair(RuleConfig);
+    Pair.Load(Case.Start);
+    std::string Description;
+    if (!Pair.Compare(Description))
+    {
+        OutMismatch = FDifferentialMismatch{0, Description};
+        return false;
+    }
+    for (size_t Index = 0; Index < Case.Commands.size(); ++Index)
+    {
+        if (!Pair.Apply(Case.Commands[Index], Description))
+        {
+            OutMismatch = FDifferentialMismatch{Index + 1, Description};
+            return false;
+        }
+    }
+    return true;
+}
+
+FDifferentialCase MinimizeCase(const FDifferentialCase& Case, const std::function<bool(const FDifferentialCase&)>& StillFails)
+{
+    FDifferentialCase Minimized = Case;
+    if (!StillFails(Minimized))
+    {
+        return Minimized;
+    }
+
+    // Removing a piece can make earlier commands unnecessary and the other way round, so alternate until stable.
+    bool bChanged = true;
+    while (bChanged)
+    {
+        bChanged = RemoveCommands(Minimized, StillFails);
+        bChanged = RemovePieces(Minimized, StillFails) || bChanged;
+    }
+    return Minimized;
+}
+
+FDifferentialCase MinimizeCase(const FDifferentialCase& Case, const FRuleConfig& RuleConfig)
+{
+    FDifferentialCase Truncated = Case;
+    FDifferentialMismatch Mismatch{};
+    if (!ReplayCase(Truncated, RuleConfig, Mismatch))
+    {
+        Truncated.Commands.resize(Mismatch.CommandCount);
+    }
+
+    return MinimizeCase(Truncated, [&RuleConfig](const FDifferentialCase& Candidate) {
+        FDifferentialMismatch CandidateMismatch{};
+        return !ReplayCase(Candidate, RuleConfig, CandidateMismatch);
+    });
+}
+
+FDifferentialStats Run(const FDifferentialConfig& Config)
+{
+    const int32_t ThreadCount =
+        Config.ThreadCount > 0 ? Config.ThreadCount : static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    FWorkStealingPool Pool(ThreadCount);
+    std::vector<FDifferentialStats> WorkerStats(static_cast<size_t>(Pool.GetThreadCount()));
+
+    const auto StartTime = std::chrono::steady_clock::now();
+    Pool.Run(Config.GameCount, [&WorkerStats, &Config](int32_t WorkerIndex, uint64_t GameIndex) {
+        FGameOutcome Outcome = PlayGame(GameIndex, Config);
+        FDifferentialStats& Stats = WorkerStats[static_cast<size_t>(WorkerIndex)];
+        ++Stats.Games;
+        Stats.AdversarialGames += Outcome.bAdversarial ? 1 : 0;
+        Stats.Plies += Outcome.Plies;
+        Stats.Probes += Outcome.Probes;
+        if (Outcome.bDiverged)
+        {
+            ++Stats.DivergentGames;
+            Stats.Divergences.push_back(std::move(Outcome.Divergence));
+        }
+    });
+
+    FDifferentialStats Stats{};
+    for (FDifferentialStats& Worker : WorkerStats)
+    {
+        Stats.Games += Worker.Games;
+        Stats.AdversarialGames += Worker.AdversarialGames;
+        Stats.Plies += Worker.Plies;
+        Stats.Probes += Worker.Probes;
+        Stats.DivergentGames += Worker.DivergentGames;
+        for (FDifferentialDivergence& Divergence : Worker.Divergences)
+        {
+            Stats.Divergences.push_back(std::move(Divergence));
+        }
+    }
+
+    // Keep the lowest game indices so the report does not depend on thread scheduling.
+    std::sort(Stats.Divergences.begin(), Stats.Divergences.end(),
+              [](const FDifferentialDivergence& Lhs, const FDifferentialDivergence& Rhs) { return Lhs.GameIndex < Rhs.GameIndex; });
+    if (Stats.Divergences.size() > Config.MaxRecordedDivergences)
+    {
+        Stats.Divergences.resize(Config.MaxRecordedDivergences);
+    }
+    Stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    return Stats;
+}
+
+std::string FormatCase(const FDifferentialCase& Case)
+{
+    static constexpr char Digits[] = "0123456789abcdef";
+    std::ostringstream Stream;
+    Stream << "turn=" << (Case.Start.CurrentTurn == ESide::Red ? 'R' : 'B') << " pass=" << Case.Start.PassCount
+           << " turn-index=" << Case.Start.TurnIndex << " pieces=";
+    for (size_t Index = 0; Index < PieceCount; ++Index)
+    {
+        const FPackedPiece& Piece = Case.Start.Pieces[Index];
+        for (const uint8_t Byte : {Piece.Cell, Piece.Roles, Piece.Flags})
+        {
+            Stream << Digits[Byte >> 4] << Digits[Byte & 0x0F];
+        }
+    }
+
+    Stream << " commands=";
+    for (size_t Index = 0; Index < Case.Commands.size(); ++Index)
+    {
+        const FPlayerCommand& Command = Case.Commands[Index];
+        Stream << (Index == 0 ? "" : ",") << (Command.Side == ESide::Red ? 'R' : 'B');
+        if (Command.CommandType != ECommandType::Move)
+        {
+            Stream << (Command.CommandType == ECommandType::Pass ? 'P' : 'R');
+        }
+        else if (!Command.Move.has_value())
+        {
+            Stream << 'M';
+        }
+        else
+        {
+            FMoveAction Move = Command.Move.value();
+            Move.CapturedPieceId.reset();
+            Stream << DescribeMove(Move);
+        }
+    }
+    return Stream.str();
+}
+
+bool ParseCase(const std::string& Line, FDifferentialCase& OutCase, std::string& OutError)
+{
+    FDifferentialCase Case{};
+    Case.Start.Phase = EGamePhase::Battle;
+    Case.Start.SetupFlags = AllSetupFlags;
+    Case.Start.PieceCount = static_cast<uint8_t>(PieceCount);
+    Case.Start.BoardCells.fill(FPackedGameState::EmptyCell);
+
+    std::istringstream Stream(Line);
+    std::string Field;
+    std::array<bool, 5> bSeen{};
+    while (Stream >> Field)
+    {
+        const size_t Equals = Field.find('=');
+        const std::string Key = Field.substr(0, Equals);
+        const std::string Value = Equals == std::string::npos ? std::string() : Field.substr(Equals + 1);
+        uint64_t Number = 0;
+        if (Key == "turn" && (Value == "R" || Value == "B"))
+        {
+            Case.Start.CurrentTurn = Value == "R" ? ESide::Red : ESide::Black;
+            bSeen[0] = true;
+        }
+        else if (Key == "pass" && ParseUnsigned(Value, Number) && Number <= 2)
+        {
+            Case.Start.PassCount = static_cast<int32_t>(Number);
+            bSeen[1] = true;
+        }
+        else if (Key == "turn-index" && ParseUnsigned(Value, Number))
+        {
+            Case.Start.TurnIndex = Number;
+            bSeen[2] = true;
+        }
+        else if (Key == "pieces" && Value.size() == PieceCount * 6)
+        {
+            for (size_t Index = 0; Index < PieceCount; ++Index)
+            {
+                std::array<uint8_t, 3> Bytes{};
+                for (size_t ByteIndex = 0; ByteIndex < Bytes.size(); ++ByteIndex)
+                {
+                    const int32_t High = HexValue(Value[Index * 6 + ByteIndex * 2]);
+                    const int32_t Low = HexValue(Value[Index * 6 + ByteIndex * 2 + 1]);
+                    if (High < 0 || Low < 0)
+                    {
+                        OutError = "Invalid hex digit in pieces.";
+                        return false;
+                    }
+                    Bytes[ByteIndex] = static_cast<uint8_t>((High << 4) | Low);
+                }
+
+                FPackedPiece& Piece = Case.Start.Pieces[Index];
+                Piece = FPackedPiece{Bytes[0], Bytes[1], Bytes[2]};
+                if (Piece.Cell == FPackedPiece::OffBoardCell)
+                {
+                    continue;
+                }
+                if (Piece.Cell >= Case.Start.BoardCells.size() || Case.Start.BoardCells[Piece.Cell] != FPackedGameState::EmptyCell)
+                {
+                    OutError = "Piece " + std::to_string(Index) + " has an invalid or shared cell.";
+                    return false;
+                }
+                Case.Start.BoardCells[Piece.Cell] = static_cast<uint8_t>(Index);
+            }
+            bSeen[3] = true;
+        }
+        else if (Key == "commands")
+        {
+            std::istringstream Commands(Value);
+            std::string Token;
+            while (std::getline(Commands, Token, ','))
+            {
+                FPlayerCommand Command{};
+                if (!ParseCommand(Token, Command))
+                {
+                    OutError = "Invalid command '" + Token + "'.";
+                    return false;
+                }
+                Case.Commands.push_back(Command);
+            }
+            bSeen[4] = true;
+        }
+        else
+        {
+            OutError = "Invalid field '" + Field + "'.";
+            return false;
+        }
+    }
+
+    if (std::find(bSeen.begin(), bSeen.end(), false) != bSeen.end())
+    {
+        OutError = "Case line needs turn, pass, turn-index, pieces and commands.";
+        return false;
+    }
+    OutCase = std::move(Case);
+    return true;
+}
+}
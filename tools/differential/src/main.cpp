@@ -0,0 +1,163 @@
+#include "Differential/Differential.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+struct FDifferentialOptions
+{
+    FDifferentialConfig Config{};
+    std::string ReplayPath;
+    std::string OutputPath;
+};
+
+void PrintUsage()
+{
+    std::cout << "Usage: StupidChessDifferential [--games <n>] [--threads <n>] [--seed <n>] [--max-plies <n>]\n"
+              << "                               [--adversarial <percent>] [--probe <percent>] [--no-minimize]\n"
+              << "                               [--out <case-file>]\n"
+              << "       StupidChessDifferential --replay <case-file>" << std::endl;
+}
+
+bool ParseOptions(int Argc, char** Argv, FDifferentialOptions& OutOptions)
+{
+    for (int Index = 1; Index < Argc; ++Index)
+    {
+        const std::string Arg = Argv[Index];
+        const bool bHasValue = Index + 1 < Argc;
+        if (Arg == "--games" && bHasValue)
+        {
+            OutOptions.Config.GameCount = std::strtoull(Argv[++Index], nullptr, 10);
+        }
+        else if (Arg == "--threads" && bHasValue)
+        {
+            OutOptions.Config.ThreadCount = std::atoi(Argv[++Index]);
+        }
+        else if (Arg == "--seed" && bHasValue)
+        {
+            OutOptions.Config.Seed = std::strtoull(Argv[++Index], nullptr, 10);
+        }
+        else if (Arg == "--max-plies" && bHasValue)
+        {
+            OutOptions.Config.MaxPlies = static_cast<uint32_t>(std::strtoul(Argv[++Index], nullptr, 10));
+        }
+        else if (Arg == "--adversarial" && bHasValue)
+        {
+            OutOptions.Config.AdversarialPercent = static_cast<uint32_t>(std::strtoul(Argv[++Index], nullptr, 10));
+        }
+        else if (Arg == "--probe" && bHasValue)
+        {
+            OutOptions.Config.ProbePercent = static_cast<uint32_t>(std::strtoul(Argv[++Index], nullptr, 10));
+        }
+        else if (Arg == "--no-minimize")
+        {
+            OutOptions.Config.bMinimize = false;
+        }
+        else if (Arg == "--replay" && bHasValue)
+        {
+            OutOptions.ReplayPath = Argv[++Index];
+        }
+        else if (Arg == "--out" && bHasValue)
+        {
+            OutOptions.OutputPath = Argv[++Index];
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return OutOptions.Config.ThreadCount >= 0;
+}
+
+// Every non-empty line of the file is one case; returns the number of cases that still diverge, or -1 on a read or
+// parse error.
+int Replay(const std::string& Path, const FRuleConfig& RuleConfig)
+{
+    std::ifstream Stream(Path);
+    if (!Stream)
+    {
+        std::cerr << "Cannot open case file: " << Path << std::endl;
+        return -1;
+    }
+
+    int Failures = 0;
+    std::string Line;
+    for (int LineNumber = 1; std::getline(Stream, Line); ++LineNumber)
+    {
+        if (Line.empty())
+        {
+            continue;
+        }
+
+        FDifferentialCase Case{};
+        std::string Error;
+        if (!Differential::ParseCase(Line, Case, Error))
+        {
+            std::cerr << Path << ':' << LineNumber << ": " << Error << std::endl;
+            return -1;
+        }
+
+        FDifferentialMismatch Mismatch{};
+        if (Differential::ReplayCase(Case, RuleConfig, Mismatch))
+        {
+            std::cout << "line " << LineNumber << ": engines agree over " << Case.Commands.size() << " commands" << std::endl;
+        }
+        else
+        {
+            ++Failures;
+            std::cout << "line " << LineNumber << ": diverged after " << Mismatch.CommandCount << " commands: "
+                      << Mismatch.Description << std::endl;
+        }
+    }
+    return Failures;
+}
+}
+
+int main(int Argc, char** Argv)
+{
+    FDifferentialOptions Options{};
+    if (!ParseOptions(Argc, Argv, Options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    if (!Options.ReplayPath.empty())
+    {
+        const int Failures = Replay(Options.ReplayPath, Options.Config.RuleConfig);
+        return Failures == 0 ? 0 : 1;
+    }
+
+    const FDifferentialStats Stats = Differential::Run(Options.Config);
+    const double PliesPerSecond = Stats.Seconds > 0.0 ? static_cast<double>(Stats.Plies) / Stats.Seconds : 0.0;
+    std::cout << "games=" << Stats.Games << " adversarial=" << Stats.AdversarialGames << " plies=" << Stats.Plies
+              << " probes=" << Stats.Probes << " divergent=" << Stats.DivergentGames << std::endl
+              << "time=" << Stats.Seconds << "s plies/s=" << static_cast<uint64_t>(PliesPerSecond) << std::endl;
+
+    std::ofstream OutputStream;
+    if (!Options.OutputPath.empty() && !Stats.Divergences.empty())
+    {
+        OutputStream.open(Options.OutputPath, std::ios::out | std::ios::trunc);
+        if (!OutputStream)
+        {
+            std::cerr << "Cannot open case file: " << Options.OutputPath << std::endl;
+            return 1;
+        }
+    }
+
+    for (const FDifferentialDivergence& Divergence : Stats.Divergences)
+    {
+        const std::string CaseLine = Differential::FormatCase(Divergence.Case);
+        std::cout << "game=" << Divergence.GameIndex << " seed=" << Divergence.Seed << " after="
+                  << Divergence.Mismatch.CommandCount << ": " << Divergence.Mismatch.Description << std::endl
+                  << "  " << CaseLine << std::endl;
+        if (OutputStream.is_open())
+        {
+            OutputStream << CaseLine << '\n';
+        }
+    }
+    return Stats.DivergentGames == 0 ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreRules/MatchReferee.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct FPerftSetup
+{
+    std::string Name;
+    FSetupPlain RedSetup;
+    FSetupPlain BlackSetup;
+};
+
+struct FPerftDivideEntry
+{
+    FPlayerCommand Command{};
+    uint64_t Nodes = 0;
+};
+
+struct FPerftGoldenEntry
+{
+    std::string SetupName;
+    int32_t Depth = 0;
+    uint64_t Nodes = 0;
+};
+
+namespace Perft
+{
+// Named reveal setups covering standard play, an opening check, a reveal+freeze capture and shuffled roles.
+const std::vector<FPerftSetup>& GetStandardSetups();
+const FPerftSetup* FindSetup(const std::string& Name);
+
+// Runs commit (empty hash) and reveal for both sides; the returned referee is in Battle phase.
+FMatchReferee BuildBattleReferee(const FPerftSetup& Setup, FRuleConfig RuleConfig = {});
+
+// Battle actions for the side to move: every legal move, plus Pass when CanPass allows it.
+std::vector<FPlayerCommand> GenerateActions(const FMatchReferee& Referee);
+
+// Leaf nodes at Depth plies, applying every action through ApplyCommand. Terminal positions before Depth
+// contribute no leaves.
+uint64_t CountLeafNodes(const FMatchReferee& Referee, int32_t Depth);
+std::vector<FPerftDivideEntry> Divide(const FMatchReferee& Referee, int32_t Depth);
+
+std::string FormatCommand(const FPlayerCommand& Command);
+
+// Golden file lines: "<SetupName> <Depth> <Nodes>"; blank lines and lines starting with '#' are ignored.
+bool LoadGoldenFile(const std::string& Path, std::vector<FPerftGoldenEntry>& OutEntries, std::string& OutError);
+}
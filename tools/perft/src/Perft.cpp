@@ -0,0 +1,264 @@
+#include "Perft/Perft.h"
+
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+constexpr std::array<FBoardPos, 16> PerftRedSetupSlots = {{
+    {0, 0},
+    {1, 0},
+    {2, 0},
+    {3, 0},
+    {4, 0},
+    {5, 0},
+    {6, 0},
+    {7, 0},
+    {8, 0},
+    {1, 2},
+    {7, 2},
+    {0, 3},
+    {2, 3},
+    {4, 3},
+    {6, 3},
+    {8, 3},
+}};
+
+using FPieceOrder = std::array<FPieceId, 16>;
+
+FPieceOrder BuildIdentityOrder(ESide Side)
+{
+    FPieceOrder PieceOrder{};
+    const int32_t BasePieceId = Side == ESide::Red ? 0 : 16;
+    for (int32_t Index = 0; Index < 16; ++Index)
+    {
+        PieceOrder[Index] = static_cast<FPieceId>(BasePieceId + Index);
+    }
+    return PieceOrder;
+}
+
+FPieceOrder BuildSwappedOrder(ESide Side, int32_t SlotA, int32_t SlotB)
+{
+    FPieceOrder PieceOrder = BuildIdentityOrder(Side);
+    std::swap(PieceOrder[SlotA], PieceOrder[SlotB]);
+    return PieceOrder;
+}
+
+// Deterministic full shuffle: slot i receives local piece (i * Stride + Offset) % 16 for odd Stride.
+FPieceOrder BuildStridedOrder(ESide Side, int32_t Stride, int32_t Offset)
+{
+    FPieceOrder PieceOrder{};
+    const int32_t BasePieceId = Side == ESide::Red ? 0 : 16;
+    for (int32_t Index = 0; Index < 16; ++Index)
+    {
+        PieceOrder[Index] = static_cast<FPieceId>(BasePieceId + (Index * Stride + Offset) % 16);
+    }
+    return PieceOrder;
+}
+
+FSetupPlain BuildSetup(ESide Side, const FPieceOrder& PieceOrder)
+{
+    FSetupPlain Setup{};
+    Setup.Side = Side;
+    Setup.Nonce = Side == ESide::Red ? "PerftRed" : "PerftBlack";
+    Setup.Placements.reserve(16);
+    for (int32_t SlotIndex = 0; SlotIndex < 16; ++SlotIndex)
+    {
+        FBoardPos Pos = PerftRedSetupSlots[SlotIndex];
+        if (Side == ESide::Black)
+        {
+            Pos.Y = static_cast<int8_t>(9 - Pos.Y);
+        }
+        Setup.Placements.push_back(FSetupPlacement{PieceOrder[SlotIndex], Pos});
+    }
+    return Setup;
+}
+
+FPerftSetup MakeSetup(std::string Name, const FPieceOrder& RedOrder, const FPieceOrder& BlackOrder)
+{
+    return FPerftSetup{std::move(Name), BuildSetup(ESide::Red, RedOrder), BuildSetup(ESide::Black, BlackOrder)};
+}
+
+std::vector<FPerftSetup> BuildStandardSetups()
+{
+    std::vector<FPerftSetup> Setups;
+    Setups.push_back(MakeSetup("Standard", BuildIdentityOrder(ESide::Red), BuildIdentityOrder(ESide::Black)));
+    // Red king on the horse slot is checked through the red cannon screen from the first ply.
+    Setups.push_back(MakeSetup("RedKingOnHorseSlot", BuildSwappedOrder(ESide::Red, 1, 4), BuildIdentityOrder(ESide::Black)));
+    // Red advisor on the cannon slot reveals and freezes on its first capture.
+    Setups.push_back(MakeSetup("RedAdvisorOnCannonSlot", BuildSwappedOrder(ESide::Red, 3, 9), BuildIdentityOrder(ESide::Black)));
+    // Black king hidden as the centre pawn stands on the open file in front of the red king.
+    Setups.push_back(MakeSetup("BlackKingOnPawnSlot", BuildIdentityOrder(ESide::Red), BuildSwappedOrder(ESide::Black, 4, 13)));
+    Setups.push_back(MakeSetup("Shuffled", BuildStridedOrder(ESide::Red, 5, 3), BuildStridedOrder(ESide::Black, 7, 11)));
+    return Setups;
+}
+
+char SideToChar(ESide Side)
+{
+    return Side == ESide::Red ? 'r' : 'b';
+}
+}
+
+namespace Perft
+{
+const std::vector<FPerftSetup>& GetStandardSetups()
+{
+    static const std::vector<FPerftSetup> Setups = BuildStandardSetups();
+    return Setups;
+}
+
+const FPerftSetup* FindSetup(const std::string& Name)
+{
+    for (const FPerftSetup& Setup : GetStandardSetups())
+    {
+        if (Setup.Name == Name)
+        {
+            return &Setup;
+        }
+    }
+    return nullptr;
+}
+
+FMatchReferee BuildBattleReferee(const FPerftSetup& Setup, FRuleConfig RuleConfig)
+{
+    FMatchReferee Referee(RuleConfig);
+    Referee.ApplyCommit({ESide::Red, ""});
+    Referee.ApplyCommit({ESide::Black, ""});
+    Referee.ApplyReveal(Setup.RedSetup);
+    Referee.ApplyReveal(Setup.BlackSetup);
+    return Referee;
+}
+
+std::vector<FPlayerCommand> GenerateActions(const FMatchReferee& Referee)
+{
+    std::vector<FPlayerCommand> Actions;
+    const FGameState& State = Referee.GetState();
+    if (State.Phase != EGamePhase::Battle)
+    {
+        return Actions;
+    }
+
+    const std::vector<FMoveAction> Moves = Referee.GenerateLegalMoves(State.CurrentTurn);
+    Actions.reserve(Moves.size() + 1);
+    for (const FMoveAction& Move : Moves)
+    {
+        FPlayerCommand Command{};
+        Command.CommandType = ECommandType::Move;
+        Command.Side = State.CurrentTurn;
+        Command.Move = Move;
+        Actions.push_back(Command);
+    }
+
+    if (Referee.CanPass(State.CurrentTurn))
+    {
+        FPlayerCommand Command{};
+        Command.CommandType = ECommandType::Pass;
+        Command.Side = State.CurrentTurn;
+        Actions.push_back(Command);
+    }
+
+    return Actions;
+}
+
+uint64_t CountLeafNodes(const FMatchReferee& Referee, int32_t Depth)
+{
+    if (Depth <= 0)
+    {
+        return 1;
+    }
+
+    uint64_t Nodes = 0;
+    for (const FPlayerCommand& Action : GenerateActions(Referee))
+    {
+        FMatchReferee Child = Referee;
+        if (!Child.ApplyCommand(Action).bAccepted)
+        {
+            continue;
+        }
+        Nodes += CountLeafNodes(Child, Depth - 1);
+    }
+    return Nodes;
+}
+
+std::vector<FPerftDivideEntry> Divide(const FMatchReferee& Referee, int32_t Depth)
+{
+    std::vector<FPerftDivideEntry> Entries;
+    if (Depth <= 0)
+    {
+        return Entries;
+    }
+
+    for (const FPlayerCommand& Action : GenerateActions(Referee))
+    {
+        FMatchReferee Child = Referee;
+        if (!Child.ApplyCommand(Action).bAccepted)
+        {
+            continue;
+        }
+        Entries.push_back(FPerftDivideEntry{Action, CountLeafNodes(Child, Depth - 1)});
+    }
+    return Entries;
+}
+
+std::string FormatCommand(const FPlayerCommand& Command)
+{
+    std::ostringstream Stream;
+    Stream << SideToChar(Command.Side) << ' ';
+    if (Command.CommandType == ECommandType::Pass)
+    {
+        Stream << "pass";
+    }
+    else if (Command.CommandType == ECommandType::Move && Command.Move.has_value())
+    {
+        const FMoveAction& Move = Command.Move.value();
+        Stream << "#" << Move.PieceId << ' '
+               << static_cast<int32_t>(Move.From.X) << ',' << static_cast<int32_t>(Move.From.Y) << '-'
+               << static_cast<int32_t>(Move.To.X) << ',' << static_cast<int32_t>(Move.To.Y);
+        if (Move.CapturedPieceId.has_value())
+        {
+            Stream << " x#" << Move.CapturedPieceId.value();
+        }
+    }
+    else
+    {
+        Stream << "command " << static_cast<int32_t>(Command.CommandType);
+    }
+    return Stream.str();
+}
+
+bool LoadGoldenFile(const std::string& Path, std::vector<FPerftGoldenEntry>& OutEntries, std::string& OutError)
+{
+    std::ifstream File(Path);
+    if (!File.is_open())
+    {
+        OutError = "Cannot open golden file: " + Path;
+        return false;
+    }
+
+    OutEntries.clear();
+    std::string Line;
+    int32_t LineNumber = 0;
+    while (std::getline(File, Line))
+    {
+        ++LineNumber;
+        const size_t FirstChar = Line.find_first_not_of(" \t\r");
+        if (FirstChar == std::string::npos || Line[FirstChar] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream LineStream(Line);
+        FPerftGoldenEntry Entry{};
+        if (!(LineStream >> Entry.SetupName >> Entry.Depth >> Entry.Nodes))
+        {
+            OutError = "Malformed golden entry at line " + std::to_string(LineNumber);
+            return false;
+        }
+        OutEntries.push_back(Entry);
+    }
+
+    return true;
+}
+}
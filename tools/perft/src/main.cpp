@@ -0,0 +1,163 @@
+#include "Perft/Perft.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct FPerftOptions
+{
+    std::string SetupName = "all";
+    int32_t Depth = 3;
+    bool bDivide = false;
+    std::string GoldenPath;
+};
+
+void PrintUsage()
+{
+    std::cout << "Usage: StupidChessPerft [--setup <name>|all] [--depth <n>] [--divide] [--verify <golden-file>]\n"
+              << "Setups:";
+    for (const FPerftSetup& Setup : Perft::GetStandardSetups())
+    {
+        std::cout << ' ' << Setup.Name;
+    }
+    std::cout << std::endl;
+}
+
+bool ParseOptions(int Argc, char** Argv, FPerftOptions& OutOptions)
+{
+    for (int Index = 1; Index < Argc; ++Index)
+    {
+        const std::string Arg = Argv[Index];
+        const bool bHasValue = Index + 1 < Argc;
+        if (Arg == "--setup" && bHasValue)
+        {
+            OutOptions.SetupName = Argv[++Index];
+        }
+        else if (Arg == "--depth" && bHasValue)
+        {
+            OutOptions.Depth = std::atoi(Argv[++Index]);
+        }
+        else if (Arg == "--divide")
+        {
+            OutOptions.bDivide = true;
+        }
+        else if (Arg == "--verify" && bHasValue)
+        {
+            OutOptions.GoldenPath = Argv[++Index];
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return OutOptions.Depth >= 0;
+}
+
+double ToSeconds(std::chrono::steady_clock::duration Duration)
+{
+    return std::chrono::duration<double>(Duration).count();
+}
+
+void PrintThroughput(uint64_t Nodes, double Seconds)
+{
+    const double NodesPerSecond = Seconds > 0.0 ? static_cast<double>(Nodes) / Seconds : 0.0;
+    std::cout << "  nodes=" << Nodes << " time=" << Seconds << "s nps=" << static_cast<uint64_t>(NodesPerSecond) << std::endl;
+}
+
+int RunSetup(const FPerftSetup& Setup, const FPerftOptions& Options)
+{
+    const FMatchReferee Referee = Perft::BuildBattleReferee(Setup);
+    std::cout << Setup.Name << " depth " << Options.Depth << std::endl;
+
+    const auto StartTime = std::chrono::steady_clock::now();
+    uint64_t Nodes = 0;
+    if (Options.bDivide)
+    {
+        for (const FPerftDivideEntry& Entry : Perft::Divide(Referee, Options.Depth))
+        {
+            std::cout << "  " << Perft::FormatCommand(Entry.Command) << ": " << Entry.Nodes << std::endl;
+            Nodes += Entry.Nodes;
+        }
+    }
+    else
+    {
+        Nodes = Perft::CountLeafNodes(Referee, Options.Depth);
+    }
+    PrintThroughput(Nodes, ToSeconds(std::chrono::steady_clock::now() - StartTime));
+    return 0;
+}
+
+int RunVerify(const std::string& GoldenPath)
+{
+    std::vector<FPerftGoldenEntry> Entries;
+    std::string Error;
+    if (!Perft::LoadGoldenFile(GoldenPath, Entries, Error))
+    {
+        std::cerr << Error << std::endl;
+        return 1;
+    }
+
+    int32_t FailureCount = 0;
+    uint64_t TotalNodes = 0;
+    const auto StartTime = std::chrono::steady_clock::now();
+    for (const FPerftGoldenEntry& Entry : Entries)
+    {
+        const FPerftSetup* Setup = Perft::FindSetup(Entry.SetupName);
+        if (Setup == nullptr)
+        {
+            std::cerr << "Unknown setup in golden file: " << Entry.SetupName << std::endl;
+            ++FailureCount;
+            continue;
+        }
+
+        const uint64_t Nodes = Perft::CountLeafNodes(Perft::BuildBattleReferee(*Setup), Entry.Depth);
+        TotalNodes += Nodes;
+        const bool bMatch = Nodes == Entry.Nodes;
+        std::cout << (bMatch ? "[ OK ] " : "[FAIL] ") << Entry.SetupName << " depth " << Entry.Depth
+                  << " expected=" << Entry.Nodes << " actual=" << Nodes << std::endl;
+        if (!bMatch)
+        {
+            ++FailureCount;
+        }
+    }
+
+    PrintThroughput(TotalNodes, ToSeconds(std::chrono::steady_clock::now() - StartTime));
+    return FailureCount == 0 ? 0 : 1;
+}
+}
+
+int main(int Argc, char** Argv)
+{
+    FPerftOptions Options{};
+    if (!ParseOptions(Argc, Argv, Options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    if (!Options.GoldenPath.empty())
+    {
+        return RunVerify(Options.GoldenPath);
+    }
+
+    if (Options.SetupName == "all")
+    {
+        for (const FPerftSetup& Setup : Perft::GetStandardSetups())
+        {
+            RunSetup(Setup, Options);
+        }
+        return 0;
+    }
+
+    const FPerftSetup* Setup = Perft::FindSetup(Options.SetupName);
+    if (Setup == nullptr)
+    {
+        PrintUsage();
+        return 2;
+    }
+    return RunSetup(*Setup, Options);
+}
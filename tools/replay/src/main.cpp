@@ -0,0 +1,249 @@
+#include "CoreRules/CommandLog.h"
+#include "CoreRules/EndgameTablebase.h"
+#include "CoreRules/ReplayEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct FReplayOptions
+{
+    std::string LogPath;
+    std::string TablebaseDirectory;
+    // 0 uses std::thread::hardware_concurrency().
+    int32_t ThreadCount = 0;
+    bool bVerbose = false;
+    bool bPrintHashes = false;
+};
+
+enum class EReplayLineStatus : uint8_t
+{
+    Blank,
+    Matched,
+    NoDigest,
+    Mismatched,
+    ParseError
+};
+
+// Only what the report needs survives the worker; commands are dropped as soon as the line has been replayed.
+struct FReplayLineOutcome
+{
+    EReplayLineStatus Status = EReplayLineStatus::Matched;
+    uint64_t MatchId = 0;
+    uint32_t CommandCount = 0;
+    uint64_t Digest = 0;
+    uint64_t ExpectedDigest = 0;
+    std::string Error;
+    std::string Details;
+};
+
+void PrintUsage()
+{
+    std::cout << "Usage: StupidChessReplay --log <command-log> [--threads <n>] [--tablebase <dir>] [--verbose] [--hashes]"
+              << std::endl;
+}
+
+bool ParseOptions(int Argc, char** Argv, FReplayOptions& OutOptions)
+{
+    for (int Index = 1; Index < Argc; ++Index)
+    {
+        const std::string Arg = Argv[Index];
+        const bool bHasValue = Index + 1 < Argc;
+        if (Arg == "--log" && bHasValue)
+        {
+            OutOptions.LogPath = Argv[++Index];
+        }
+        else if (Arg == "--threads" && bHasValue)
+        {
+            OutOptions.ThreadCount = std::atoi(Argv[++Index]);
+        }
+        else if (Arg == "--tablebase" && bHasValue)
+        {
+            OutOptions.TablebaseDirectory = Argv[++Index];
+        }
+        else if (Arg == "--verbose")
+        {
+            OutOptions.bVerbose = true;
+        }
+        else if (Arg == "--hashes")
+        {
+            OutOptions.bPrintHashes = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !OutOptions.LogPath.empty() && OutOptions.ThreadCount >= 0;
+}
+
+std::string ToHex(uint64_t Value)
+{
+    std::ostringstream Stream;
+    Stream << std::hex;
+    Stream.width(16);
+    Stream.fill('0');
+    Stream << Value;
+    return Stream.str();
+}
+
+std::vector<std::string_view> SplitLines(std::string_view Text)
+{
+    std::vector<std::string_view> Lines;
+    while (!Text.empty())
+    {
+        const size_t End = Text.find('\n');
+        Lines.push_back(Text.substr(0, End));
+        Text.remove_prefix(End == std::string_view::npos ? Text.size() : End + 1);
+    }
+    return Lines;
+}
+
+FReplayLineOutcome ReplayLine(std::string_view Line, FReplayEngine& Engine, FRecordedMatch& Match, const FReplayOptions& Options)
+{
+    FReplayLineOutcome Outcome{};
+    if (!FCommandLog::ParseMatch(Line, Match, Outcome.Error))
+    {
+        Outcome.Status = EReplayLineStatus::ParseError;
+        return Outcome;
+    }
+
+    const FReplayResult Result = Engine.Replay(Match.Commands);
+    Outcome.MatchId = Match.MatchId;
+    Outcome.CommandCount = Result.CommandCount;
+    Outcome.Digest = Result.Digest;
+    Outcome.ExpectedDigest = Match.ExpectedDigest.value_or(0);
+    Outcome.Status = !Match.ExpectedDigest.has_value()                 ? EReplayLineStatus::NoDigest
+                     : Match.ExpectedDigest.value() == Result.Digest ? EReplayLineStatus::Matched
+                                                                     : EReplayLineStatus::Mismatched;
+
+    for (size_t Index = 0; Index < Match.Commands.size() && (Options.bVerbose || Options.bPrintHashes); ++Index)
+    {
+        Outcome.Details += "  " + std::to_string(Index) + ' ' + FCommandLog::FormatCommand(Match.Commands[Index]);
+        if (Options.bPrintHashes)
+        {
+            Outcome.Details += ' ' + ToHex(Result.PlyHashes[Index]);
+        }
+        Outcome.Details += '\n';
+    }
+    for (const std::string& Description : Result.EventDescriptions)
+    {
+        Outcome.Details += "  event: " + Description + '\n';
+    }
+    return Outcome;
+}
+}
+
+int main(int Argc, char** Argv)
+{
+    FReplayOptions Options{};
+    if (!ParseOptions(Argc, Argv, Options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::ifstream Stream(Options.LogPath, std::ios::binary);
+    if (!Stream)
+    {
+        std::cerr << "Cannot open command log: " << Options.LogPath << std::endl;
+        return 1;
+    }
+    const std::string Text((std::istreambuf_iterator<char>(Stream)), std::istreambuf_iterator<char>());
+
+    FEndgameTablebase Tablebase;
+    std::string Error;
+    if (!Options.TablebaseDirectory.empty() && Tablebase.LoadDirectory(Options.TablebaseDirectory, Error) == 0)
+    {
+        std::cerr << (Error.empty() ? "No tablebase files in " + Options.TablebaseDirectory : Error) << std::endl;
+        return 1;
+    }
+
+    FReplayConfig ReplayConfig{};
+    ReplayConfig.Mode = Options.bVerbose ? EReplayMode::Verbose : EReplayMode::Fast;
+    ReplayConfig.bRecordPlyHashes = Options.bPrintHashes;
+    ReplayConfig.Tablebase = Options.TablebaseDirectory.empty() ? nullptr : &Tablebase;
+
+    const std::vector<std::string_view> Lines = SplitLines(Text);
+    std::vector<FReplayLineOutcome> Outcomes(Lines.size());
+    const int32_t ThreadCount =
+        Options.ThreadCount > 0 ? Options.ThreadCount : static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1u));
+
+    const auto StartTime = std::chrono::steady_clock::now();
+    std::atomic<size_t> NextLine{0};
+    auto Worker = [&] {
+        FReplayEngine Engine(ReplayConfig);
+        FRecordedMatch Match{};
+        for (size_t LineIndex = NextLine.fetch_add(1); LineIndex < Lines.size(); LineIndex = NextLine.fetch_add(1))
+        {
+            const std::string_view Line = Lines[LineIndex];
+            if (Line.empty() || Line == "\r")
+            {
+                Outcomes[LineIndex].Status = EReplayLineStatus::Blank;
+                continue;
+            }
+            Outcomes[LineIndex] = ReplayLine(Line, Engine, Match, Options);
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    for (int32_t Index = 1; Index < ThreadCount; ++Index)
+    {
+        Threads.emplace_back(Worker);
+    }
+    Worker();
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+    uint64_t Matches = 0;
+    uint64_t Commands = 0;
+    uint64_t Mismatched = 0;
+    uint64_t ParseErrors = 0;
+    for (size_t LineIndex = 0; LineIndex < Outcomes.size(); ++LineIndex)
+    {
+        const FReplayLineOutcome& Outcome = Outcomes[LineIndex];
+        if (Outcome.Status == EReplayLineStatus::ParseError)
+        {
+            ++ParseErrors;
+            std::cout << Options.LogPath << ':' << LineIndex + 1 << ": " << Outcome.Error << std::endl;
+            continue;
+        }
+        if (Outcome.Status == EReplayLineStatus::Blank)
+        {
+            continue;
+        }
+
+        ++Matches;
+        Commands += Outcome.CommandCount;
+        if (Outcome.Status == EReplayLineStatus::Mismatched)
+        {
+            ++Mismatched;
+            std::cout << "match=" << Outcome.MatchId << " line=" << LineIndex + 1 << ": digest " << ToHex(Outcome.Digest)
+                      << " expected " << ToHex(Outcome.ExpectedDigest) << std::endl;
+        }
+        else if (!Outcome.Details.empty())
+        {
+            std::cout << "match=" << Outcome.MatchId << " digest=" << ToHex(Outcome.Digest) << std::endl;
+        }
+        std::cout << Outcome.Details;
+    }
+
+    const double CommandsPerSecond = Seconds > 0.0 ? static_cast<double>(Commands) / Seconds : 0.0;
+    std::cout << "matches=" << Matches << " commands=" << Commands << " mismatched=" << Mismatched
+              << " parse-errors=" << ParseErrors << std::endl
+              << "time=" << Seconds << "s commands/s=" << static_cast<uint64_t>(CommandsPerSecond) << std::endl;
+    return Mismatched == 0 && ParseErrors == 0 ? 0 : 1;
+}
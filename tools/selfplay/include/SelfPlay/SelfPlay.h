@@ -0,0 +1,173 @@
+#pragma once
+
+#include "CoreRules/AlphaBetaSearch.h"
+#include "CoreRules/CommandLog.h"
+#include "CoreRules/IsmctsSearch.h"
+#include "CoreRules/MatchReferee.h"
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Chooses the command for the side to move. Policies see the full referee state and get the game's RNG so that
+// a game replays identically for the same seed no matter which worker runs it. One instance is created per
+// worker thread, so implementations may keep per-thread caches without locking.
+class IMovePolicy
+{
+public:
+    virtual ~IMovePolicy() = default;
+    // Called before each game so per-game caches do not make results depend on which worker ran earlier games.
+    virtual void OnGameStart() {}
+    virtual FPlayerCommand ChooseCommand(FMatchReferee& Referee, uint64_t& RngState) = 0;
+};
+
+using FMovePolicyFactory = std::function<std::unique_ptr<IMovePolicy>()>;
+
+// Uniform over legal moves; passes when allowed and resigns otherwise.
+class FRandomMovePolicy final : public IMovePolicy
+{
+public:
+    FPlayerCommand ChooseCommand(FMatchReferee& Referee, uint64_t& RngState) override;
+};
+
+// Takes the capture of the most valuable visible role (ties broken at random), else a random move.
+class FGreedyCapturePolicy final : public IMovePolicy
+{
+public:
+    FPlayerCommand ChooseCommand(FMatchReferee& Referee, uint64_t& RngState) override;
+};
+
+// Alpha-beta search over one determinization of the mover's view (FAlphaBetaSearch::SearchFromView), so it never
+// reads the opponent's hidden roles. Self-play uses a node budget rather than a clock so games stay reproducible.
+class FSearchMovePolicy final : public IMovePolicy
+{
+public:
+    explicit FSearchMovePolicy(const FSearchLimits& InLimits);
+
+    void OnGameStart() override;
+    FPlayerCommand ChooseCommand(FMatchReferee& Referee, uint64_t& RngState) override;
+
+private:
+    FSearchLimits Limits;
+    FAlphaBetaSearch Search;
+};
+
+// Information-set MCTS that only uses the mover's player view. Self-play runs it on one thread with an iteration
+// budget and a seed drawn from the game RNG so games stay reproducible.
+class FIsmctsMovePolicy final : public IMovePolicy
+{
+public:
+    explicit FIsmctsMovePolicy(const FIsmctsConfig& InConfig);
+
+    FPlayerCommand ChooseCommand(FMatchReferee& Referee, uint64_t& RngState) override;
+
+private:
+    FIsmctsSearch Search;
+};
+
+struct FSelfPlayConfig
+{
+    uint64_t GameCount = 100;
+    // 0 uses std::thread::hardware_concurrency().
+    int32_t ThreadCount = 0;
+    uint64_t Seed = 1;
+    // Games reaching this many plies (moves and passes) stop as truncated draws.
+    uint32_t MaxPlies = 400;
+    FRuleConfig RuleConfig{};
+};
+
+struct FSelfPlayGameRecord
+{
+    uint64_t GameIndex = 0;
+    uint64_t Seed = 0;
+    FSetupPlain RedSetup;
+    FSetupPlain BlackSetup;
+    std::vector<FPlayerCommand> Commands;
+    EGameResult Result = EGameResult::Ongoing;
+    EEndReason EndReason = EEndReason::None;
+    bool bTruncated = false;
+    // FReplayEngine digest of the game as BuildRecordedMatch lays it out, taken while playing.
+    uint64_t ReplayDigest = 0;
+};
+
+struct FSelfPlayStats
+{
+    uint64_t Games = 0;
+    uint64_t Plies = 0;
+    uint64_t RedWins = 0;
+    uint64_t BlackWins = 0;
+    uint64_t Draws = 0;
+    uint64_t Truncated = 0;
+    double Seconds = 0.0;
+
+    void Merge(const FSelfPlayStats& Other) noexcept;
+};
+
+enum class EGameRecordFormat : uint8_t
+{
+    // SelfPlay::FormatRecord lines.
+    Record,
+    // FCommandLog::FormatMatch lines of SelfPlay::BuildRecordedMatch, replayable by StupidChessReplay.
+    CommandLog
+};
+
+// Streams one text line per finished game; safe to call from every worker.
+class FGameRecordWriter
+{
+public:
+    explicit FGameRecordWriter(std::ostream& InStream, EGameRecordFormat InFormat = EGameRecordFormat::Record);
+    void Write(const FSelfPlayGameRecord& Record);
+
+private:
+    std::mutex Mutex;
+    std::ostream& Stream;
+    EGameRecordFormat Format = EGameRecordFormat::Record;
+};
+
+// Fixed set of tasks spread over per-worker deques. A worker pops its own deque from the back and, once empty,
+// steals from the front of the others; Run returns when every task has finished.
+class FWorkStealingPool
+{
+public:
+    explicit FWorkStealingPool(int32_t InThreadCount);
+
+    int32_t GetThreadCount() const noexcept;
+    void Run(uint64_t TaskCount, const std::function<void(int32_t WorkerIndex, uint64_t TaskIndex)>& Task);
+
+private:
+    int32_t ThreadCount = 1;
+};
+
+namespace SelfPlay
+{
+uint64_t NextRandom(uint64_t& RngState) noexcept;
+uint64_t GetGameSeed(uint64_t BaseSeed, uint64_t GameIndex) noexcept;
+FSetupPlain BuildRandomSetup(ESide Side, uint64_t& RngState);
+
+// Plays one game from commit/reveal to the end (or MaxPlies) on the given referee.
+FSelfPlayGameRecord PlayGame(
+    FMatchReferee& Referee,
+    IMovePolicy& RedPolicy,
+    IMovePolicy& BlackPolicy,
+    uint64_t GameIndex,
+    const FSelfPlayConfig& Config);
+
+// Records are written in completion order; each carries its game index and seed.
+FSelfPlayStats Run(
+    const FSelfPlayConfig& Config,
+    const FMovePolicyFactory& RedPolicyFactory,
+    const FMovePolicyFactory& BlackPolicyFactory,
+    FGameRecordWriter* RecordWriter = nullptr);
+
+// Known names: "random", "greedy", "search", "ismcts". Returns an empty factory for unknown names.
+FMovePolicyFactory FindPolicyFactory(const std::string& Name);
+
+std::string FormatRecord(const FSelfPlayGameRecord& Record);
+// The game as the command stream a session would have seen: empty commits, both reveals, then the recorded
+// commands. MatchId is the game index and ExpectedDigest the record's ReplayDigest.
+FRecordedMatch BuildRecordedMatch(const FSelfPlayGameRecord& Record);
+}
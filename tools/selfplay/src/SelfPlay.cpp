@@ -0,0 +1,510 @@
+#include "SelfPlay/SelfPlay.h"
+
+#include "CoreRules/RandomSetup.h"
+#include "CoreRules/ReplayEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace
+{
+int32_t GetRoleValue(ERoleType Role)
+{
+    switch (Role)
+    {
+    case ERoleType::King:
+        return 100;
+    case ERoleType::Rook:
+        return 9;
+    case ERoleType::Cannon:
+        return 5;
+    case ERoleType::Horse:
+        return 4;
+    case ERoleType::Advisor:
+    case ERoleType::Elephant:
+        return 2;
+    case ERoleType::Pawn:
+        return 1;
+    }
+    return 0;
+}
+
+FPlayerCommand BuildNoMoveCommand(const FMatchReferee& Referee, ESide Side)
+{
+    FPlayerCommand Command{};
+    Command.Side = Side;
+    Command.CommandType = Referee.CanPass(Side) ? ECommandType::Pass : ECommandType::Resign;
+    return Command;
+}
+
+FPlayerCommand BuildMoveCommand(ESide Side, const FMoveAction& Move)
+{
+    FPlayerCommand Command{};
+    Command.Side = Side;
+    Command.CommandType = ECommandType::Move;
+    Command.Move = Move;
+    return Command;
+}
+
+const char* ResultToString(EGameResult Result)
+{
+    switch (Result)
+    {
+    case EGameResult::Ongoing:
+        return "Ongoing";
+    case EGameResult::RedWin:
+        return "RedWin";
+    case EGameResult::BlackWin:
+        return "BlackWin";
+    case EGameResult::Draw:
+        return "Draw";
+    }
+    return "Unknown";
+}
+
+const char* EndReasonToString(EEndReason EndReason)
+{
+    switch (EndReason)
+    {
+    case EEndReason::None:
+        return "None";
+    case EEndReason::Checkmate:
+        return "Checkmate";
+    case EEndReason::Resign:
+        return "Resign";
+    case EEndReason::Timeout:
+        return "Timeout";
+    case EEndReason::DoublePassDraw:
+        return "DoublePassDraw";
+    case EEndReason::RuleViolation:
+        return "RuleViolation";
+    case EEndReason::Tablebase:
+        return "Tablebase";
+    }
+    return "Unknown";
+}
+
+FSearchLimits BuildSelfPlaySearchLimits()
+{
+    FSearchLimits Limits{};
+    Limits.MaxNodes = 20000;
+    Limits.TimeBudgetMs = 0;
+    return Limits;
+}
+
+FIsmctsConfig BuildSelfPlayIsmctsConfig()
+{
+    FIsmctsConfig Config{};
+    Config.ThreadCount = 1;
+    Config.MaxIterations = 1000;
+    Config.TimeBudgetMs = 0;
+    return Config;
+}
+
+struct FWorkerQueue
+{
+    std::mutex Mutex;
+    std::deque<uint64_t> Tasks;
+};
+}
+
+FPlayerCommand FRandomMovePolicy::ChooseCommand(FMatchReferee& Referee, uint64_t& RngState)
+{
+    const ESide Side = Referee.GetState().CurrentTurn;
+    FMoveList LegalMoves;
+    Referee.GenerateLegalMoves(Side, LegalMoves);
+    if (LegalMoves.IsEmpty())
+    {
+        return BuildNoMoveCommand(Referee, Side);
+    }
+    return BuildMoveCommand(Side, LegalMoves[SelfPlay::NextRandom(RngState) % LegalMoves.Size()]);
+}
+
+FPlayerCommand FGreedyCapturePolicy::ChooseCommand(FMatchReferee& Referee, uint64_t& RngState)
+{
+    const FGameState& State = Referee.GetState();
+    const ESide Side = State.CurrentTurn;
+    FMoveList LegalMoves;
+    Referee.GenerateLegalMoves(Side, LegalMoves);
+    if (LegalMoves.IsEmpty())
+    {
+        return BuildNoMoveCommand(Referee, Side);
+    }
+
+    int32_t BestValue = 0;
+    FMoveList BestMoves;
+    for (const FMoveAction& Move : LegalMoves)
+    {
+        int32_t Value = 0;
+        if (Move.CapturedPieceId.has_value())
+        {
+            const FPieceState& Victim = State.Pieces[Move.CapturedPieceId.value()];
+            Value = GetRoleValue(Victim.PieceState == EPieceState::RevealedActual ? Victim.ActualRole : Victim.SurfaceRole);
+        }
+
+        if (Value > BestValue)
+        {
+            BestValue = Value;
+            BestMoves.Clear();
+        }
+        if (Value == BestValue)
+        {
+            BestMoves.PushBack(Move);
+        }
+    }
+    return BuildMoveCommand(Side, BestMoves[SelfPlay::NextRandom(RngState) % BestMoves.Size()]);
+}
+
+FSearchMovePolicy::FSearchMovePolicy(const FSearchLimits& InLimits)
+    : Limits(InLimits)
+    , Search(1)
+{
+}
+
+void FSearchMovePolicy::OnGameStart()
+{
+    Search.Clear();
+}
+
+FPlayerCommand FSearchMovePolicy::ChooseCommand(FMatchReferee& Referee, uint64_t& RngState)
+{
+    const FSearchResult Result = Search.SearchFromView(Referee, Limits, SelfPlay::NextRandom(RngState));
+    if (!Result.bHasCommand)
+    {
+        return BuildNoMoveCommand(Referee, Referee.GetState().CurrentTurn);
+    }
+    return Result.BestCommand;
+}
+
+FIsmctsMovePolicy::FIsmctsMovePolicy(const FIsmctsConfig& InConfig)
+    : Search(InConfig)
+{
+}
+
+FPlayerCommand FIsmctsMovePolicy::ChooseCommand(FMatchReferee& Referee, uint64_t& RngState)
+{
+    const FIsmctsResult Result = Search.Search(Referee, SelfPlay::NextRandom(RngState));
+    if (!Result.bHasCommand)
+    {
+        return BuildNoMoveCommand(Referee, Referee.GetState().CurrentTurn);
+    }
+    return Result.BestCommand;
+}
+
+void FSelfPlayStats::Merge(const FSelfPlayStats& Other) noexcept
+{
+    Games += Other.Games;
+    Plies += Other.Plies;
+    RedWins += Other.RedWins;
+    BlackWins += Other.BlackWins;
+    Draws += Other.Draws;
+    Truncated += Other.Truncated;
+}
+
+FGameRecordWriter::FGameRecordWriter(std::ostream& InStream, EGameRecordFormat InFormat)
+    : Stream(InStream)
+    , Format(InFormat)
+{
+}
+
+void FGameRecordWriter::Write(const FSelfPlayGameRecord& Record)
+{
+    const std::string Line = Format == EGameRecordFormat::CommandLog ? FCommandLog::FormatMatch(SelfPlay::BuildRecordedMatch(Record))
+                                                                     : SelfPlay::FormatRecord(Record);
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Stream << Line << '\n';
+}
+
+FWorkStealingPool::FWorkStealingPool(int32_t InThreadCount)
+    : ThreadCount(std::max(InThreadCount, 1))
+{
+}
+
+int32_t FWorkStealingPool::GetThreadCount() const noexcept
+{
+    return ThreadCount;
+}
+
+void FWorkStealingPool::Run(uint64_t TaskCount, const std::function<void(int32_t WorkerIndex, uint64_t TaskIndex)>& Task)
+{
+    std::vector<FWorkerQueue> Queues(static_cast<size_t>(ThreadCount));
+    for (uint64_t TaskIndex = 0; TaskIndex < TaskCount; ++TaskIndex)
+    {
+        Queues[TaskIndex % Queues.size()].Tasks.push_back(TaskIndex);
+    }
+
+    auto PopOwn = [&Queues](int32_t WorkerIndex, uint64_t& OutTask) {
+        FWorkerQueue& Queue = Queues[static_cast<size_t>(WorkerIndex)];
+        std::lock_guard<std::mutex> Lock(Queue.Mutex);
+        if (Queue.Tasks.empty())
+        {
+            return false;
+        }
+        OutTask = Queue.Tasks.back();
+        Queue.Tasks.pop_back();
+        return true;
+    };
+
+    auto Steal = [&Queues, this](int32_t WorkerIndex, uint64_t& OutTask) {
+        for (int32_t Offset = 1; Offset < ThreadCount; ++Offset)
+        {
+            FWorkerQueue& Victim = Queues[static_cast<size_t>((WorkerIndex + Offset) % ThreadCount)];
+            std::lock_guard<std::mutex> Lock(Victim.Mutex);
+            if (!Victim.Tasks.empty())
+            {
+                OutTask = Victim.Tasks.front();
+                Victim.Tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // No task is ever enqueued after start, so a worker that finds every deque empty can retire.
+    auto WorkerLoop = [&PopOwn, &Steal, &Task](int32_t WorkerIndex) {
+        uint64_t TaskIndex = 0;
+        while (PopOwn(WorkerIndex, TaskIndex) || Steal(WorkerIndex, TaskIndex))
+        {
+            Task(WorkerIndex, TaskIndex);
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    Threads.reserve(static_cast<size_t>(ThreadCount - 1));
+    for (int32_t WorkerIndex = 1; WorkerIndex < ThreadCount; ++WorkerIndex)
+    {
+        Threads.emplace_back(WorkerLoop, WorkerIndex);
+    }
+    WorkerLoop(0);
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+}
+
+namespace SelfPlay
+{
+uint64_t NextRandom(uint64_t& RngState) noexcept
+{
+    return NextSplitMix64(RngState);
+}
+
+uint64_t GetGameSeed(uint64_t BaseSeed, uint64_t GameIndex) noexcept
+{
+    uint64_t State = BaseSeed ^ (GameIndex * 0xd1b54a32d192ed03ull);
+    return NextRandom(State);
+}
+
+FSetupPlain BuildRandomSetup(ESide Side, uint64_t& RngState)
+{
+    return ::BuildRandomSetup(Side, RngState);
+}
+
+FSelfPlayGameRecord PlayGame(
+    FMatchReferee& Referee,
+    IMovePolicy& RedPolicy,
+    IMovePolicy& BlackPolicy,
+    uint64_t GameIndex,
+    const FSelfPlayConfig& Config)
+{
+    FSelfPlayGameRecord Record{};
+    Record.GameIndex = GameIndex;
+    Record.Seed = GetGameSeed(Config.Seed, GameIndex);
+    uint64_t RngState = Record.Seed;
+
+    Record.RedSetup = ::BuildRandomSetup(ESide::Red, RngState);
+    Record.BlackSetup = ::BuildRandomSetup(ESide::Black, RngState);
+    const FGameState& State = Referee.GetState();
+    Record.ReplayDigest = FReplayEngine::DigestSeed;
+    auto ChainState = [&Record, &State] {
+        Record.ReplayDigest = FReplayEngine::ChainDigest(Record.ReplayDigest, FReplayEngine::ComputeStateHash(State));
+    };
+
+    Referee.ResetNewMatch();
+    Referee.ApplyCommit(FSetupCommit{ESide::Red, ""});
+    ChainState();
+    Referee.ApplyCommit(FSetupCommit{ESide::Black, ""});
+    ChainState();
+    Referee.ApplyReveal(Record.RedSetup);
+    ChainState();
+    Referee.ApplyReveal(Record.BlackSetup);
+    ChainState();
+
+    RedPolicy.OnGameStart();
+    BlackPolicy.OnGameStart();
+
+    while (State.Phase == EGamePhase::Battle)
+    {
+        if (Record.Commands.size() >= Config.MaxPlies)
+        {
+            Record.bTruncated = true;
+            break;
+        }
+
+        IMovePolicy& Policy = State.CurrentTurn == ESide::Red ? RedPolicy : BlackPolicy;
+        const FPlayerCommand Command = Policy.ChooseCommand(Referee, RngState);
+        if (!Referee.ApplyCommand(Command).bAccepted)
+        {
+            // A policy bug must not stall the run; score it as a resignation.
+            FPlayerCommand Resign{};
+            Resign.CommandType = ECommandType::Resign;
+            Resign.Side = State.CurrentTurn;
+            Referee.ApplyCommand(Resign);
+            ChainState();
+            Record.Commands.push_back(Resign);
+            break;
+        }
+        ChainState();
+        Record.Commands.push_back(Command);
+    }
+
+    Record.Result = Record.bTruncated ? EGameResult::Draw : State.Result;
+    Record.EndReason = State.EndReason;
+    return Record;
+}
+
+FSelfPlayStats Run(
+    const FSelfPlayConfig& Config,
+    const FMovePolicyFactory& RedPolicyFactory,
+    const FMovePolicyFactory& BlackPolicyFactory,
+    FGameRecordWriter* RecordWriter)
+{
+    const int32_t ThreadCount =
+        Config.ThreadCount > 0 ? Config.ThreadCount : static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    FWorkStealingPool Pool(ThreadCount);
+
+    struct FWorkerContext
+    {
+        FMatchReferee Referee;
+        std::unique_ptr<IMovePolicy> RedPolicy;
+        std::unique_ptr<IMovePolicy> BlackPolicy;
+        FSelfPlayStats Stats;
+    };
+
+    std::vector<FWorkerContext> Workers(static_cast<size_t>(Pool.GetThreadCount()));
+    for (FWorkerContext& Worker : Workers)
+    {
+        Worker.Referee = FMatchReferee(Config.RuleConfig);
+        Worker.RedPolicy = RedPolicyFactory();
+        Worker.BlackPolicy = BlackPolicyFactory();
+    }
+
+    const auto StartTime = std::chrono::steady_clock::now();
+    Pool.Run(Config.GameCount, [&Workers, &Config, RecordWriter](int32_t WorkerIndex, uint64_t GameIndex) {
+        FWorkerContext& Worker = Workers[static_cast<size_t>(WorkerIndex)];
+        const FSelfPlayGameRecord Record = PlayGame(Worker.Referee, *Worker.RedPolicy, *Worker.BlackPolicy, GameIndex, Config);
+
+        ++Worker.Stats.Games;
+        Worker.Stats.Plies += Record.Commands.size();
+        Worker.Stats.Truncated += Record.bTruncated ? 1 : 0;
+        Worker.Stats.RedWins += Record.Result == EGameResult::RedWin ? 1 : 0;
+        Worker.Stats.BlackWins += Record.Result == EGameResult::BlackWin ? 1 : 0;
+        Worker.Stats.Draws += Record.Result == EGameResult::Draw ? 1 : 0;
+        if (RecordWriter != nullptr)
+        {
+            RecordWriter->Write(Record);
+        }
+    });
+
+    FSelfPlayStats Stats{};
+    for (const FWorkerContext& Worker : Workers)
+    {
+        Stats.Merge(Worker.Stats);
+    }
+    Stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    return Stats;
+}
+
+FMovePolicyFactory FindPolicyFactory(const std::string& Name)
+{
+    if (Name == "random")
+    {
+        return [] { return std::make_unique<FRandomMovePolicy>(); };
+    }
+    if (Name == "greedy")
+    {
+        return [] { return std::make_unique<FGreedyCapturePolicy>(); };
+    }
+    if (Name == "search")
+    {
+        return [] { return std::make_unique<FSearchMovePolicy>(BuildSelfPlaySearchLimits()); };
+    }
+    if (Name == "ismcts")
+    {
+        return [] { return std::make_unique<FIsmctsMovePolicy>(BuildSelfPlayIsmctsConfig()); };
+    }
+    return {};
+}
+
+// One line per game: header fields, both setups as piece ids in slot order, then the command list where a move
+// is "<PieceId>:<FromX><FromY><ToX><ToY>", "P" is a pass and "R" a resignation.
+std::string FormatRecord(const FSelfPlayGameRecord& Record)
+{
+    std::ostringstream Stream;
+    Stream << "game=" << Record.GameIndex << " seed=" << Record.Seed << " result=" << ResultToString(Record.Result)
+           << " reason=" << EndReasonToString(Record.EndReason) << " truncated=" << (Record.bTruncated ? 1 : 0)
+           << " plies=" << Record.Commands.size();
+
+    auto WriteSetup = [&Stream](const char* Label, const FSetupPlain& Setup) {
+        Stream << ' ' << Label << '=';
+        for (size_t Index = 0; Index < Setup.Placements.size(); ++Index)
+        {
+            Stream << (Index == 0 ? "" : ",") << Setup.Placements[Index].PieceId;
+        }
+    };
+    WriteSetup("red", Record.RedSetup);
+    WriteSetup("black", Record.BlackSetup);
+
+    Stream << " moves=";
+    for (size_t Index = 0; Index < Record.Commands.size(); ++Index)
+    {
+        const FPlayerCommand& Command = Record.Commands[Index];
+        Stream << (Index == 0 ? "" : " ");
+        if (Command.CommandType == ECommandType::Move && Command.Move.has_value())
+        {
+            const FMoveAction& Move = Command.Move.value();
+            Stream << Move.PieceId << ':' << static_cast<int32_t>(Move.From.X) << static_cast<int32_t>(Move.From.Y)
+                   << static_cast<int32_t>(Move.To.X) << static_cast<int32_t>(Move.To.Y);
+        }
+        else
+        {
+            Stream << (Command.CommandType == ECommandType::Pass ? "P" : "R");
+        }
+    }
+    return Stream.str();
+}
+
+FRecordedMatch BuildRecordedMatch(const FSelfPlayGameRecord& Record)
+{
+    FRecordedMatch Match{};
+    Match.MatchId = Record.GameIndex;
+    Match.ExpectedDigest = Record.ReplayDigest;
+    Match.Commands.reserve(Record.Commands.size() + 4);
+
+    for (const ESide Side : {ESide::Red, ESide::Black})
+    {
+        FPlayerCommand Commit{};
+        Commit.Side = Side;
+        Commit.CommandType = ECommandType::CommitSetup;
+        Commit.SetupCommit = FSetupCommit{Side, ""};
+        Match.Commands.push_back(std::move(Commit));
+    }
+    for (const FSetupPlain* Setup : {&Record.RedSetup, &Record.BlackSetup})
+    {
+        FPlayerCommand Reveal{};
+        Reveal.Side = Setup->Side;
+        Reveal.CommandType = ECommandType::RevealSetup;
+        Reveal.SetupPlain = *Setup;
+        Match.Commands.push_back(std::move(Reveal));
+    }
+    Match.Commands.insert(Match.Commands.end(), Record.Commands.begin(), Record.Commands.end());
+    return Match;
+}
+}
@@ -0,0 +1,123 @@
+#include "SelfPlay/SelfPlay.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+struct FSelfPlayOptions
+{
+    FSelfPlayConfig Config{};
+    std::string RedPolicyName = "random";
+    std::string BlackPolicyName = "random";
+    std::string OutputPath;
+    EGameRecordFormat OutputFormat = EGameRecordFormat::Record;
+};
+
+void PrintUsage()
+{
+    std::cout << "Usage: StupidChessSelfPlay [--games <n>] [--threads <n>] [--seed <n>] [--max-plies <n>]\n"
+              << "                           [--red <policy>] [--black <policy>] [--out <record-file>]\n"
+              << "                           [--format record|command-log]\n"
+              << "Policies: random greedy search ismcts" << std::endl;
+}
+
+bool ParseOptions(int Argc, char** Argv, FSelfPlayOptions& OutOptions)
+{
+    for (int Index = 1; Index < Argc; ++Index)
+    {
+        const std::string Arg = Argv[Index];
+        const bool bHasValue = Index + 1 < Argc;
+        if (Arg == "--games" && bHasValue)
+        {
+            OutOptions.Config.GameCount = std::strtoull(Argv[++Index], nullptr, 10);
+        }
+        else if (Arg == "--threads" && bHasValue)
+        {
+            OutOptions.Config.ThreadCount = std::atoi(Argv[++Index]);
+        }
+        else if (Arg == "--seed" && bHasValue)
+        {
+            OutOptions.Config.Seed = std::strtoull(Argv[++Index], nullptr, 10);
+        }
+        else if (Arg == "--max-plies" && bHasValue)
+        {
+            OutOptions.Config.MaxPlies = static_cast<uint32_t>(std::strtoul(Argv[++Index], nullptr, 10));
+        }
+        else if (Arg == "--red" && bHasValue)
+        {
+            OutOptions.RedPolicyName = Argv[++Index];
+        }
+        else if (Arg == "--black" && bHasValue)
+        {
+            OutOptions.BlackPolicyName = Argv[++Index];
+        }
+        else if (Arg == "--out" && bHasValue)
+        {
+            OutOptions.OutputPath = Argv[++Index];
+        }
+        else if (Arg == "--format" && bHasValue)
+        {
+            const std::string Format = Argv[++Index];
+            if (Format != "record" && Format != "command-log")
+            {
+                return false;
+            }
+            OutOptions.OutputFormat = Format == "record" ? EGameRecordFormat::Record : EGameRecordFormat::CommandLog;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return OutOptions.Config.ThreadCount >= 0;
+}
+
+void PrintStats(const FSelfPlayStats& Stats)
+{
+    const double Seconds = Stats.Seconds > 0.0 ? Stats.Seconds : 0.0;
+    const double GamesPerSecond = Seconds > 0.0 ? static_cast<double>(Stats.Games) / Seconds : 0.0;
+    const double PliesPerSecond = Seconds > 0.0 ? static_cast<double>(Stats.Plies) / Seconds : 0.0;
+    std::cout << "games=" << Stats.Games << " red=" << Stats.RedWins << " black=" << Stats.BlackWins
+              << " draw=" << Stats.Draws << " truncated=" << Stats.Truncated << std::endl
+              << "plies=" << Stats.Plies << " time=" << Seconds << "s games/s=" << GamesPerSecond
+              << " plies/s=" << static_cast<uint64_t>(PliesPerSecond) << std::endl;
+}
+}
+
+int main(int Argc, char** Argv)
+{
+    FSelfPlayOptions Options{};
+    if (!ParseOptions(Argc, Argv, Options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    const FMovePolicyFactory RedPolicyFactory = SelfPlay::FindPolicyFactory(Options.RedPolicyName);
+    const FMovePolicyFactory BlackPolicyFactory = SelfPlay::FindPolicyFactory(Options.BlackPolicyName);
+    if (!RedPolicyFactory || !BlackPolicyFactory)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::ofstream OutputStream;
+    std::unique_ptr<FGameRecordWriter> RecordWriter;
+    if (!Options.OutputPath.empty())
+    {
+        OutputStream.open(Options.OutputPath, std::ios::out | std::ios::trunc);
+        if (!OutputStream)
+        {
+            std::cerr << "Cannot open record file: " << Options.OutputPath << std::endl;
+            return 1;
+        }
+        RecordWriter = std::make_unique<FGameRecordWriter>(OutputStream, Options.OutputFormat);
+    }
+
+    const FSelfPlayStats Stats = SelfPlay::Run(Options.Config, RedPolicyFactory, BlackPolicyFactory, RecordWriter.get());
+    PrintStats(Stats);
+    return 0;
+}
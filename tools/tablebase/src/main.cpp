@@ -0,0 +1,96 @@
+#include "CoreRules/TablebaseGenerator.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct FTablebaseOptions
+{
+    std::vector<std::string> MaterialNames;
+    FTablebaseGeneratorConfig Config{};
+    std::string OutputDirectory = ".";
+};
+
+void PrintUsage()
+{
+    std::cout << "Usage: StupidChessTablebase --material <red>-<black> [--material ...] [--threads <n>] [--out <dir>]\n"
+              << "Pieces: K A E H R C P, lowercase for frozen (k a e), e.g. KR-KA or Ka-KH" << std::endl;
+}
+
+bool ParseOptions(int Argc, char** Argv, FTablebaseOptions& OutOptions)
+{
+    for (int Index = 1; Index < Argc; ++Index)
+    {
+        const std::string Arg = Argv[Index];
+        const bool bHasValue = Index + 1 < Argc;
+        if (Arg == "--material" && bHasValue)
+        {
+            OutOptions.MaterialNames.push_back(Argv[++Index]);
+        }
+        else if (Arg == "--threads" && bHasValue)
+        {
+            OutOptions.Config.ThreadCount = std::atoi(Argv[++Index]);
+        }
+        else if (Arg == "--out" && bHasValue)
+        {
+            OutOptions.OutputDirectory = Argv[++Index];
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !OutOptions.MaterialNames.empty() && OutOptions.Config.ThreadCount >= 1;
+}
+
+void PrintStats(const FTablebaseGenerationStats& Stats)
+{
+    std::cout << Stats.Name << ": entries=" << Stats.Entries << " win=" << Stats.Wins << " loss=" << Stats.Losses
+              << " draw=" << Stats.Draws << " invalid=" << Stats.Invalid << " longest=" << Stats.LongestDistance
+              << " time=" << Stats.Seconds << "s" << std::endl;
+}
+}
+
+int main(int Argc, char** Argv)
+{
+    FTablebaseOptions Options{};
+    if (!ParseOptions(Argc, Argv, Options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    FEndgameTablebase Tablebase;
+    std::string Error;
+    Tablebase.LoadDirectory(Options.OutputDirectory, Error);
+
+    FTablebaseGenerator Generator(Options.Config);
+    for (const std::string& MaterialName : Options.MaterialNames)
+    {
+        const std::optional<FTablebaseMaterial> Material = FTablebaseMaterial::Parse(MaterialName, &Error);
+        if (!Material.has_value() || !Generator.Generate(Material.value(), Tablebase, Error))
+        {
+            std::cerr << MaterialName << ": " << Error << std::endl;
+            return 1;
+        }
+    }
+
+    std::filesystem::create_directories(Options.OutputDirectory);
+    for (const FTablebaseGenerationStats& Stats : Generator.GetGeneratedStats())
+    {
+        PrintStats(Stats);
+
+        const FEndgameTable* Table = Tablebase.FindTable(FTablebaseMaterial::Parse(Stats.Name).value());
+        const std::string Path = (std::filesystem::path(Options.OutputDirectory) / (Stats.Name + ".sctb")).string();
+        if (!Table->SaveFile(Path, Error))
+        {
+            std::cerr << Error << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}